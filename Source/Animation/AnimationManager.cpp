@@ -9,158 +9,401 @@ Player strings into PlayerEntity, MenuItems into Interface, etc.
 ********************************************/
 
 #include "AnimationManager.h"
-#include "RenderMethod.h"
-#include "Mesh.h"
-#include "MathDX.h"
+#include "CAtlasPacker.h"
+#include "CParseAnimation.h"
+#include "CParseAnimEvents.h"
 #include <algorithm>
+#include <chrono>
+#include <fstream>
 
 
 namespace gen
 {
-	extern ID3D10Device* g_pd3dDevice;
 	extern const  string MediaFolder;
+
+	//Cooked file layout: SCookedHeader, then the sequence records (one per slot), the frame records and the string data
+	//The header holds the size and write time of the XML file it was cooked from, so edits to the XML are picked up
+	//Change CookedVersion whenever the record layout or the animation enums change
+	static const TUInt32 CookedMagic = 0x434d4e41; // "ANMC"
+	static const TUInt32 CookedVersion = 1;
+	struct SCookedHeader
+	{
+		TUInt32 magic;
+		TUInt32 version;
+		TUInt64 xmlSize;
+		TUInt64 xmlWriteTime;
+		TUInt32 numSequences;
+		TUInt32 numFrames;
+		TUInt32 stringBytes;
+		TUInt32 sequencesOffset;
+		TUInt32 framesOffset;
+		TUInt32 stringsOffset;
+	};
+
 	/////////////////////////////////////
 	// Constructors/Destructors
 
-	// Constructor reserves space for entities and UID hash map, also sets first UID
+	// Constructor reserves space for the database and points it at the (empty) owned arrays
 	CAnimationManager::CAnimationManager()
+		: m_AnimEvents(2, PlayerAnimationTypes), m_HitBoxes(2, PlayerAnimationTypes), m_HurtBoxes(2, PlayerAnimationTypes)
 	{
-		JotaroAnims_Right->reserve(1024);
-		JotaroAnims_Left->reserve(1024);
-
-		DioAnimsLeft->reserve(512);
-		DioAnimsRight->reserve(512);
+		m_OwnedSequences.resize(SequenceSlotCount);
+		m_OwnedFrames.reserve(4096);
+		m_OwnedStrings.reserve(256 * 1024);
+		m_LoadSeconds = 0.0;
+		UseOwnedDatabase();
 
 		BlankTextureName = MediaFolder + "blank.png";
-		for (int i = 0; i < LastMonsterTypes; i++)
-		{
-			MonsterAnimationsRight[i]->reserve(128);
-			MonsterAnimationsLeft[i]->reserve(128);
-		}
-
 	}
 
 	CAnimationManager::~CAnimationManager()
 	{
 
 	}
-	//Setter function(Parser->Manager)
-	//Manager serves as a transition operator, which takes and loads, nothing else. Also capable of returning a string of choice.
-	void CAnimationManager::PushAnimation(AnimationSequence sequence, bool isPlayerJotaro, bool isFacingRight, PlayerAnimationType type)
+
+	//Load the animation database from the cooked file if it is up to date, otherwise from the XML
+	bool CAnimationManager::LoadAnimations(const string& xmlFileName, const string& cookedFileName)
 	{
-		if (isPlayerJotaro && isFacingRight)
+		if (m_CookedFile.IsOpen() || !m_OwnedFrames.empty())
 		{
-			JotaroAnims_Right[type] = sequence;
-			return;
+			return true;
 		}
-		else if (isPlayerJotaro && !isFacingRight)
+
+		chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+		bool loaded = LoadCooked(cookedFileName, xmlFileName);
+		if (!loaded)
 		{
-			JotaroAnims_Left[type] = sequence;
-			return;
+			//Animations.xml is a stream of start tags - a sequence ends at its frame marked Last and closing tags are not
+			//used - so expat always stops at the end with an unclosed element. Whatever was read is used, and cooked
+			CParseAnimation parser(this);
+			parser.ParseFile(xmlFileName);
+			loaded = m_NumFrames > 0;
+			if (loaded)
+			{
+				SaveCooked(cookedFileName, xmlFileName);
+			}
 		}
-		else if (!isPlayerJotaro && isFacingRight)
+		if (loaded)
 		{
-			DioAnimsRight[type] = sequence;
-			return;
+			ResolveFullPaths();
 		}
-		else if (!isPlayerJotaro && !isFacingRight)
+		m_LoadSeconds = chrono::duration<TFloat64>(chrono::high_resolution_clock::now() - start).count();
+		return loaded;
+	}
+
+	//Map the cooked file and use its arrays in place. Every offset is checked so a damaged file can't be read out of bounds
+	bool CAnimationManager::LoadCooked(const string& cookedFileName, const string& xmlFileName)
+	{
+		TUInt64 xmlSize, xmlWriteTime;
+		if (!CMappedFile::GetFileStamp(xmlFileName, &xmlSize, &xmlWriteTime) || !m_CookedFile.Open(cookedFileName))
+		{
+			return false;
+		}
+
+		const TUInt8* data = m_CookedFile.GetData();
+		TUInt32 size = m_CookedFile.GetSize();
+		const SCookedHeader* header = reinterpret_cast<const SCookedHeader*>(data);
+		bool valid = size >= sizeof(SCookedHeader) &&
+		             header->magic == CookedMagic && header->version == CookedVersion &&
+		             header->xmlSize == xmlSize && header->xmlWriteTime == xmlWriteTime &&
+		             header->numSequences == SequenceSlotCount && header->stringBytes > 0 &&
+		             header->sequencesOffset + header->numSequences * sizeof(SAnimSequenceRecord) <= size &&
+		             header->framesOffset + static_cast<TUInt64>(header->numFrames) * sizeof(SAnimFrameRecord) <= size &&
+		             header->stringsOffset + static_cast<TUInt64>(header->stringBytes) <= size &&
+		             data[header->stringsOffset + header->stringBytes - 1] == 0;
+		if (valid)
 		{
-			DioAnimsLeft[type] = sequence;
-			return;
+			const SAnimSequenceRecord* sequences = reinterpret_cast<const SAnimSequenceRecord*>(data + header->sequencesOffset);
+			const SAnimFrameRecord* frames = reinterpret_cast<const SAnimFrameRecord*>(data + header->framesOffset);
+			for (TUInt32 slot = 0; slot < header->numSequences && valid; slot++)
+			{
+				valid = static_cast<TUInt64>(sequences[slot].firstFrame) + sequences[slot].numFrames <= header->numFrames;
+			}
+			for (TUInt32 frame = 0; frame < header->numFrames && valid; frame++)
+			{
+				valid = frames[frame].pathOffset < header->stringBytes;
+			}
 		}
+		if (!valid)
+		{
+			m_CookedFile.Close();
+			return false;
+		}
+
+		m_Sequences = reinterpret_cast<const SAnimSequenceRecord*>(data + header->sequencesOffset);
+		m_Frames = reinterpret_cast<const SAnimFrameRecord*>(data + header->framesOffset);
+		m_Strings = reinterpret_cast<const char*>(data + header->stringsOffset);
+		m_NumFrames = header->numFrames;
+		m_StringBytes = header->stringBytes;
+		return true;
 	}
 
-	void CAnimationManager::PushUIAnimation(AnimationSequence sequence, bool isPlayerJotaro, bool isFacingRight, PlayerUIAnimationTypes type)
+	//Write the database in use out as a cooked file, stamped with the XML file it came from
+	bool CAnimationManager::SaveCooked(const string& cookedFileName, const string& xmlFileName)
 	{
-		if (isPlayerJotaro && isFacingRight)
+		SCookedHeader header;
+		if (!CMappedFile::GetFileStamp(xmlFileName, &header.xmlSize, &header.xmlWriteTime))
 		{
-			JotaroUIAnims_Right[type] = sequence;
-			return;
+			return false;
 		}
-		else if (isPlayerJotaro && !isFacingRight)
+		header.magic = CookedMagic;
+		header.version = CookedVersion;
+		header.numSequences = SequenceSlotCount;
+		header.numFrames = m_NumFrames;
+		header.stringBytes = m_StringBytes;
+		header.sequencesOffset = sizeof(SCookedHeader);
+		header.framesOffset = header.sequencesOffset + SequenceSlotCount * sizeof(SAnimSequenceRecord);
+		header.stringsOffset = header.framesOffset + m_NumFrames * sizeof(SAnimFrameRecord);
+
+		ofstream file(cookedFileName.c_str(), ios::out | ios::binary | ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(m_Sequences), SequenceSlotCount * sizeof(SAnimSequenceRecord));
+		file.write(reinterpret_cast<const char*>(m_Frames), m_NumFrames * sizeof(SAnimFrameRecord));
+		file.write(m_Strings, m_StringBytes);
+		return file.good();
+	}
+
+	//Slots - players first (Jotaro right, Jotaro left, Dio right, Dio left), then monsters, player UI and menus
+	TUInt32 CAnimationManager::PlayerSlot(int type, bool isPlayerJotaro, bool isFacingRight)
+	{
+		return ((isPlayerJotaro ? 0 : 2) + (isFacingRight ? 0 : 1)) * PlayerAnimationTypes + type;
+	}
+	TUInt32 CAnimationManager::MonsterSlot(int monsterType, int animType, bool isFacingRight)
+	{
+		return PlayerSequenceSlots + (monsterType * MonsterAnimTypeCount + animType) * 2 + (isFacingRight ? 0 : 1);
+	}
+	TUInt32 CAnimationManager::UISlot(int type, bool isPlayerJotaro, bool isFacingRight)
+	{
+		return PlayerSequenceSlots + MonsterSequenceSlots + ((isPlayerJotaro ? 0 : 2) + (isFacingRight ? 0 : 1)) * PlayerUIAnimsCount + type;
+	}
+	TUInt32 CAnimationManager::MenuSlot(int type)
+	{
+		return PlayerSequenceSlots + MonsterSequenceSlots + UISequenceSlots + type;
+	}
+
+	//Store a parsed sequence in the given slot. A slot that is pushed again keeps the latest sequence
+	void CAnimationManager::PushSequence(TUInt32 slot, const AnimationSequence& sequence)
+	{
+		m_OwnedSequences[slot].firstFrame = static_cast<TUInt32>(m_OwnedFrames.size());
+		m_OwnedSequences[slot].numFrames = static_cast<TUInt32>(sequence.size());
+		for (TUInt32 frame = 0; frame < sequence.size(); frame++)
 		{
-			JotaroUIAnims_Left[type] = sequence;
-			return;
+			SAnimFrameRecord record;
+			record.id = sequence[frame].first;
+
+			map<string, TUInt32>::iterator interned = m_InternedStrings.find(sequence[frame].second);
+			if (interned != m_InternedStrings.end())
+			{
+				record.pathOffset = interned->second;
+			}
+			else
+			{
+				record.pathOffset = static_cast<TUInt32>(m_OwnedStrings.size());
+				m_OwnedStrings.insert(m_OwnedStrings.end(), sequence[frame].second.begin(), sequence[frame].second.end());
+				m_OwnedStrings.push_back(0);
+				m_InternedStrings[sequence[frame].second] = record.pathOffset;
+			}
+			m_OwnedFrames.push_back(record);
 		}
-		else if (!isPlayerJotaro && isFacingRight)
+		UseOwnedDatabase();
+	}
+
+	//View of a sequence in the database, empty until the full paths have been resolved
+	CAnimSequenceView CAnimationManager::GetSequenceView(TUInt32 slot)
+	{
+		const SAnimSequenceRecord& sequence = m_Sequences[slot];
+		if (sequence.numFrames == 0 || m_FrameFullPaths.size() != m_NumFrames)
 		{
-			DioUIAnims_Right[type] = sequence;
-			return;
+			return CAnimSequenceView();
 		}
-		else if (!isPlayerJotaro && !isFacingRight)
+		return CAnimSequenceView(m_Frames + sequence.firstFrame, &m_FrameFullPaths[sequence.firstFrame], m_Strings, sequence.numFrames);
+	}
+	const char* CAnimationManager::GetFramePath(TUInt32 slot, int frame)
+	{
+		if (frame < 0 || static_cast<TUInt32>(frame) >= m_Sequences[slot].numFrames)
 		{
-			DioUIAnims_Left[type] = sequence;
-			return;
+			return "";
 		}
+		return m_Strings + m_Frames[m_Sequences[slot].firstFrame + frame].pathOffset;
 	}
-	//The animations have type, player affinity, orientation and the vector itself. When called it loads the chosen vector from parser to chosen vector in PlayerEntity.
-	//Getter function (Manager->Entity)
-	AnimationSequence CAnimationManager::GetAnimSequence(int type, bool isPlayerJotaro, bool isFacingRight)
+	const string& CAnimationManager::GetFrameFullPath(TUInt32 slot, int frame)
 	{
-		if (isPlayerJotaro && isFacingRight)
+		if (frame < 0 || static_cast<TUInt32>(frame) >= m_Sequences[slot].numFrames || m_FrameFullPaths.size() != m_NumFrames)
 		{
-			return JotaroAnims_Right[type];
+			return m_EmptyPath;
 		}
-		else if (isPlayerJotaro && !isFacingRight)
+		return *m_FrameFullPaths[m_Sequences[slot].firstFrame + frame];
+	}
+
+	//Point the database at the manager's own arrays. Called after each push as the vectors may have moved
+	void CAnimationManager::UseOwnedDatabase()
+	{
+		static const char emptyString = 0;
+		m_Sequences = &m_OwnedSequences[0];
+		m_Frames = m_OwnedFrames.empty() ? 0 : &m_OwnedFrames[0];
+		m_Strings = m_OwnedStrings.empty() ? &emptyString : &m_OwnedStrings[0];
+		m_NumFrames = static_cast<TUInt32>(m_OwnedFrames.size());
+		m_StringBytes = static_cast<TUInt32>(m_OwnedStrings.size());
+	}
+
+	//Build the full path of every frame, so animating never has to join the media folder to a path
+	//Frames sharing a string share its full path. All the strings are made before any are pointed to, so none move afterwards
+	void CAnimationManager::ResolveFullPaths()
+	{
+		map<TUInt32, TUInt32> pathIndex;
+		vector<TUInt32> framePathIndex(m_NumFrames);
+		for (TUInt32 frame = 0; frame < m_NumFrames; frame++)
 		{
-			return JotaroAnims_Left[type];
+			map<TUInt32, TUInt32>::iterator found = pathIndex.find(m_Frames[frame].pathOffset);
+			if (found == pathIndex.end())
+			{
+				found = pathIndex.insert(make_pair(m_Frames[frame].pathOffset, static_cast<TUInt32>(pathIndex.size()))).first;
+			}
+			framePathIndex[frame] = found->second;
 		}
-		else if (!isPlayerJotaro && isFacingRight)
+
+		m_FullPaths.resize(pathIndex.size());
+		for (map<TUInt32, TUInt32>::iterator path = pathIndex.begin(); path != pathIndex.end(); ++path)
 		{
-			return DioAnimsRight[type];
+			m_FullPaths[path->second] = MediaFolder + (m_Strings + path->first);
 		}
-		else if (!isPlayerJotaro && !isFacingRight)
+		m_FrameFullPaths.resize(m_NumFrames);
+		for (TUInt32 frame = 0; frame < m_NumFrames; frame++)
 		{
-			return DioAnimsLeft[type];
+			m_FrameFullPaths[frame] = &m_FullPaths[framePathIndex[frame]];
 		}
 	}
-	AnimationSequence CAnimationManager::GetMonsterAnimSequence(int type, int animtype, bool isFacingRight)
+
+	//Setter function(Parser->Manager)
+	//Manager serves as a transition operator, which takes and loads, nothing else. Also capable of returning a string of choice.
+	void CAnimationManager::PushAnimation(AnimationSequence sequence, bool isPlayerJotaro, bool isFacingRight, PlayerAnimationType type)
+	{
+		PushSequence(PlayerSlot(type, isPlayerJotaro, isFacingRight), sequence);
+	}
+
+	void CAnimationManager::PushUIAnimation(AnimationSequence sequence, bool isPlayerJotaro, bool isFacingRight, PlayerUIAnimationTypes type)
 	{
-		if (isFacingRight)
-			return MonsterAnimationsRight[type][animtype];
-		else
-			return MonsterAnimationsLeft[type][animtype];
+		PushSequence(UISlot(type, isPlayerJotaro, isFacingRight), sequence);
+	}
+	//The animations have type, player affinity, orientation and the vector itself. When called it loads the chosen vector from parser to chosen vector in PlayerEntity.
+	//Getter function (Manager->Entity)
+	CAnimSequenceView CAnimationManager::GetAnimSequence(int type, bool isPlayerJotaro, bool isFacingRight)
+	{
+		return GetSequenceView(PlayerSlot(type, isPlayerJotaro, isFacingRight));
+	}
+	CAnimSequenceView CAnimationManager::GetMonsterAnimSequence(int type, int animtype, bool isFacingRight)
+	{
+		return GetSequenceView(MonsterSlot(type, animtype, isFacingRight));
 	}
 	string CAnimationManager::GetMenuUIAnimFrame(int frameNum, int animtype)
 	{
-		return MenuAnims[animtype][frameNum].second;
+		return GetFramePath(MenuSlot(animtype), frameNum);
+	}
+	const string& CAnimationManager::GetMenuUIAnimFullPath(int frameNum, int animtype)
+	{
+		return GetFrameFullPath(MenuSlot(animtype), frameNum);
 	}
 	void CAnimationManager::PushMonsterAnimation(AnimationSequence sequence, int monsterType, int monsterAnim, bool isFacingRight)
-	 {
-		
-		if (isFacingRight)
-		{
-			MonsterAnimationsRight[monsterType][monsterAnim] = sequence;
-			return;
-		}
-		else
-			MonsterAnimationsLeft[monsterType][monsterAnim] = sequence;
-		return;
-     }
+	{
+		PushSequence(MonsterSlot(monsterType, monsterAnim, isFacingRight), sequence);
+	}
 	void CAnimationManager::PushMenuUIAnimation(AnimationSequence sequence, MenuUIAnimationTypes type)
 	{
-		MenuAnims[type] = sequence;
+		PushSequence(MenuSlot(type), sequence);
 	}
 	string CAnimationManager::GetPlayerUITexturePath(int type, int position, bool isPlayerJotaro, bool isFacingRight)
 	{
-		if (isPlayerJotaro && isFacingRight)
+		return GetFramePath(UISlot(type, isPlayerJotaro, isFacingRight), position);
+	}
+	const string& CAnimationManager::GetPlayerUITextureFullPath(int type, int position, bool isPlayerJotaro, bool isFacingRight)
+	{
+		return GetFrameFullPath(UISlot(type, isPlayerJotaro, isFacingRight), position);
+	}
+
+	//Sprite atlases
+	//Each character gets its own atlases, so a fight only touches the atlases of the two fighters. Menu sequences are video sized frames, those stay as separate textures
+	static const char* AtlasGroupNames[] = { "Jotaro", "Dio", "Monster", "PlayerUI" };
+	static const TUInt32 NumAtlasGroups = sizeof(AtlasGroupNames) / sizeof(AtlasGroupNames[0]);
+
+	void CAnimationManager::GetAtlasFrameFiles(vector<string>* files, vector<TUInt32>* groupSizes)
+	{
+		const TUInt32 groupStart[NumAtlasGroups] = { PlayerSlot(0, true, true), PlayerSlot(0, false, true), MonsterSlot(0, 0, true), UISlot(0, true, true) };
+		const TUInt32 groupEnd[NumAtlasGroups] = { PlayerSlot(0, false, true), MonsterSlot(0, 0, true), UISlot(0, true, true), MenuSlot(0) };
+		files->clear();
+		groupSizes->clear();
+		for (TUInt32 group = 0; group < NumAtlasGroups; group++)
+		{
+			TUInt32 groupFirst = static_cast<TUInt32>(files->size());
+			for (TUInt32 slot = groupStart[group]; slot < groupEnd[group]; slot++)
+			{
+				for (TUInt32 frame = 0; frame < m_Sequences[slot].numFrames; frame++)
+				{
+					files->push_back(MediaFolder + GetFramePath(slot, frame));
+				}
+			}
+			groupSizes->push_back(static_cast<TUInt32>(files->size()) - groupFirst);
+		}
+	}
+
+	//The table is saved with a key made from the name, size and write time of every frame file, checking it costs one
+	//file stat per frame rather than reading any images
+	bool CAnimationManager::LoadAtlasTable(const string& fileName)
+	{
+		vector<string> files;
+		vector<TUInt32> groupSizes;
+		GetAtlasFrameFiles(&files, &groupSizes);
+		return m_AtlasTable.Load(fileName, CAtlasTable::MakeSourceKey(files));
+	}
+	TUInt32 CAnimationManager::BuildAtlasTable(const string& fileName)
+	{
+		vector<string> files;
+		vector<TUInt32> groupSizes;
+		GetAtlasFrameFiles(&files, &groupSizes);
+
+		CAtlasPacker packer;
+		TUInt32 file = 0;
+		for (TUInt32 group = 0; group < NumAtlasGroups; group++)
 		{
-			return JotaroUIAnims_Right[type][position].second;
-			
+			packer.BeginGroup(AtlasGroupNames[group]);
+			for (TUInt32 groupFile = 0; groupFile < groupSizes[group]; groupFile++, file++)
+			{
+				//Frames that can't be read are left out and keep using their own texture
+				packer.AddFrame(files[file]);
+			}
 		}
-		else if (isPlayerJotaro && !isFacingRight)
+
+		TUInt32 numPacked = packer.Pack(&m_AtlasTable);
+		m_AtlasTable.SetSourceKey(CAtlasTable::MakeSourceKey(files));
+		m_AtlasTable.Save(fileName);
+		return numPacked;
+	}
+
+	//Frame events, hitboxes and hurtboxes
+	//Characters are numbered 0 for Jotaro and 1 for Dio, each event table sequence is as long as the character's right facing sequence
+	bool CAnimationManager::LoadAnimEvents(const string& xmlFileName)
+	{
+		if (m_AnimEvents.IsCompiled())
 		{
-			return JotaroUIAnims_Left[type][position].second;
+			return true;
 		}
-		else if (!isPlayerJotaro && isFacingRight)
+
+		CParseAnimEvents parser(&m_AnimEvents, &m_HitBoxes, &m_HurtBoxes);
+		if (!parser.ParseFile(xmlFileName))
 		{
-			return DioUIAnims_Right[type][position].second;
+			m_AnimEvents.Clear();
+			m_HitBoxes.Clear();
+			m_HurtBoxes.Clear();
+			return false;
 		}
-		else if (!isPlayerJotaro && !isFacingRight)
+		TUInt32 frameCounts[2 * PlayerAnimationTypes];
+		for (int type = 0; type < PlayerAnimationTypes; type++)
 		{
-			return DioUIAnims_Left[type][position].second;
+			frameCounts[type] = m_Sequences[PlayerSlot(type, true, true)].numFrames;
+			frameCounts[PlayerAnimationTypes + type] = m_Sequences[PlayerSlot(type, false, true)].numFrames;
 		}
+		m_AnimEvents.Compile(frameCounts);
+		m_HitBoxes.Compile(frameCounts);
+		m_HurtBoxes.Compile(frameCounts);
+		return true;
 	}
 } // namespace gen
-
-
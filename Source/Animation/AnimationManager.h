@@ -13,13 +13,63 @@ Responsible for animations
 using namespace std;
 
 #include "CHashTable.h"
+#include "CAtlasTable.h"
+#include "CMappedFile.h"
+#include "CAnimEventTable.h"
+#include "CFrameBoxTable.h"
 //new types to help organize the data
 typedef pair<int, string> AnimPair;
 typedef vector<AnimPair> AnimationSequence;
-typedef pair<int, vector<int>> HitFrames;
-typedef vector<HitFrames> HitDetectorInfo;
 namespace gen
 {
+	//Frame record of the animation database, the same layout is used in memory and in the cooked file
+	struct SAnimFrameRecord
+	{
+		TInt32  id;
+		TUInt32 pathOffset; //Offset of the zero terminated path in the string data
+	};
+
+	//Lightweight view of one sequence in the animation database - just pointers and a count, so it is free to copy
+	//and reading a frame never allocates. Full paths (media folder included) are resolved once when the database loads
+	//Frame numbers must be less than size(), as with vector. Views stay valid for the life of the animation manager
+	class CAnimSequenceView
+	{
+	public:
+		CAnimSequenceView()
+			: m_Frames(0), m_FullPaths(0), m_Strings(0), m_NumFrames(0) {}
+		CAnimSequenceView(const SAnimFrameRecord* frames, const string* const* fullPaths, const char* strings, TUInt32 numFrames)
+			: m_Frames(frames), m_FullPaths(fullPaths), m_Strings(strings), m_NumFrames(numFrames) {}
+
+		TUInt32 size() const
+		{
+			return m_NumFrames;
+		}
+		bool empty() const
+		{
+			return m_NumFrames == 0;
+		}
+
+		TInt32 GetFrameId(TUInt32 frame) const
+		{
+			return m_Frames[frame].id;
+		}
+		//Path relative to the media folder, as written in the XML
+		const char* GetPath(TUInt32 frame) const
+		{
+			return m_Strings + m_Frames[frame].pathOffset;
+		}
+		//Path including the media folder, ready to load
+		const string& GetFullPath(TUInt32 frame) const
+		{
+			return *m_FullPaths[frame];
+		}
+
+	private:
+		const SAnimFrameRecord* m_Frames;
+		const string* const*    m_FullPaths;
+		const char*             m_Strings;
+		TUInt32                 m_NumFrames;
+	};
 	
 
 	//Whole selection of player animation types, each one has around 50 different sequences
@@ -113,6 +163,14 @@ namespace gen
 			static const TInt32 AttackAnimsPlayerFinish = Stando_Ult_1;
 			static const TInt32 PlayerUIAnimsCount = LastPlayerUIAnims;
 
+			//Every sequence has a fixed slot in the animation database - both characters and facings of each player
+			//animation, each facing of each monster animation, and so on
+			static const TInt32 PlayerSequenceSlots = 2 * 2 * PlayerAnimationTypes;
+			static const TInt32 MonsterSequenceSlots = MonsterTypeCount * MonsterAnimTypeCount * 2;
+			static const TInt32 UISequenceSlots = 2 * 2 * PlayerUIAnimsCount;
+			static const TInt32 MenuSequenceSlots = MenuUIAnimationTypeCount;
+			static const TInt32 SequenceSlotCount = PlayerSequenceSlots + MonsterSequenceSlots + UISequenceSlots + MenuSequenceSlots;
+
 	class CAnimationManager
 	{
 		/////////////////////////////////////
@@ -129,14 +187,35 @@ namespace gen
 		// Destructor
 		~CAnimationManager();
 
+		//Load the animation database. Uses the cooked binary file if it was made from the current XML file, otherwise
+		//parses the XML and cooks it for next time. Only loads once, later calls return straight away
+		bool LoadAnimations(const string& xmlFileName, const string& cookedFileName);
+
+		//Cooked database - a flat binary of all sequences that is memory mapped and used in place
+		//LoadCooked fails if the file is missing, from an older version, or was made from a different XML file
+		bool LoadCooked(const string& cookedFileName, const string& xmlFileName);
+		bool SaveCooked(const string& cookedFileName, const string& xmlFileName);
+
+		//Startup timing of the last LoadAnimations, and whether it came from the cooked file
+		TFloat64 GetLoadSeconds()
+		{
+			return m_LoadSeconds;
+		}
+		bool WasLoadedFromCooked()
+		{
+			return m_CookedFile.IsOpen();
+		}
+
 		//Parser function
 		void PushAnimation(AnimationSequence sequence, bool isPlayerJotaro, bool isFacingRight, PlayerAnimationType type);
 		void PushMonsterAnimation(AnimationSequence sequence, int monsterType, int monsterAnim, bool isFacingRight);
 		void PushUIAnimation(AnimationSequence sequence, bool isPlayerJotaro, bool isFacingRight, PlayerUIAnimationTypes type);
 		void PushMenuUIAnimation(AnimationSequence sequence, MenuUIAnimationTypes type);
-		AnimationSequence GetAnimSequence(int type, bool isPlayerJotaro, bool isFacingRight);
-		AnimationSequence GetMonsterAnimSequence(int monstertype, int animtype, bool isFacingRight);
+		CAnimSequenceView GetAnimSequence(int type, bool isPlayerJotaro, bool isFacingRight);
+		CAnimSequenceView GetMonsterAnimSequence(int monstertype, int animtype, bool isFacingRight);
 		string GetMenuUIAnimFrame(int frameNum, int animType);
+		//Menu frame including the media folder, empty if there is no such frame
+		const string& GetMenuUIAnimFullPath(int frameNum, int animType);
 	private:
 
 
@@ -146,22 +225,62 @@ namespace gen
 
 		string BlankTextureName;
 
-		AnimationSequence JotaroAnims_Right[PlayerAnimationTypes];
-		AnimationSequence JotaroAnims_Left[PlayerAnimationTypes];
-
-		AnimationSequence DioAnimsRight[PlayerAnimationTypes];
-		AnimationSequence DioAnimsLeft[PlayerAnimationTypes];
-
-		AnimationSequence MonsterAnimationsRight[MonsterTypeCount][MonsterAnimTypeCount];
-		AnimationSequence MonsterAnimationsLeft[MonsterTypeCount][MonsterAnimTypeCount];
-
-		AnimationSequence JotaroUIAnims_Right[PlayerUIAnimsCount];
-		AnimationSequence JotaroUIAnims_Left[PlayerUIAnimsCount];
-
-		AnimationSequence DioUIAnims_Right[PlayerUIAnimsCount];
-		AnimationSequence DioUIAnims_Left[PlayerUIAnimsCount];
-
-		AnimationSequence MenuAnims[MenuUIAnimationTypeCount];
+		//Sequence record, the same layout is used in memory and in the cooked file
+		struct SAnimSequenceRecord
+		{
+			TUInt32 firstFrame;
+			TUInt32 numFrames;
+		};
+
+		//Slot of each kind of sequence
+		static TUInt32 PlayerSlot(int type, bool isPlayerJotaro, bool isFacingRight);
+		static TUInt32 MonsterSlot(int monsterType, int animType, bool isFacingRight);
+		static TUInt32 UISlot(int type, bool isPlayerJotaro, bool isFacingRight);
+		static TUInt32 MenuSlot(int type);
+
+		//Store a parsed sequence in the given slot, strings are interned so repeated paths are stored once
+		void PushSequence(TUInt32 slot, const AnimationSequence& sequence);
+		//View of a sequence in the database
+		CAnimSequenceView GetSequenceView(TUInt32 slot);
+		const char* GetFramePath(TUInt32 slot, int frame);
+		const string& GetFrameFullPath(TUInt32 slot, int frame);
+
+		//Point the database at the manager's own arrays (after parsing) 
+		void UseOwnedDatabase();
+		//Build the full path of every frame once the database has loaded
+		void ResolveFullPaths();
+
+		//Frame files packed into the sprite atlases, in packing order, and the number of files in each atlas group
+		void GetAtlasFrameFiles(vector<string>* files, vector<TUInt32>* groupSizes);
+
+		//The database in use - either the arrays below or the mapped cooked file
+		const SAnimSequenceRecord* m_Sequences;
+		const SAnimFrameRecord*    m_Frames;
+		const char*                m_Strings;
+		TUInt32                    m_NumFrames;
+		TUInt32                    m_StringBytes;
+
+		//Database built while parsing the XML
+		vector<SAnimSequenceRecord> m_OwnedSequences;
+		vector<SAnimFrameRecord>    m_OwnedFrames;
+		vector<char>                m_OwnedStrings;
+		map<string, TUInt32>        m_InternedStrings;
+
+		//Full path of each distinct string, and a pointer to the one used by each frame record
+		vector<string>        m_FullPaths;
+		vector<const string*> m_FrameFullPaths;
+		string                m_EmptyPath;
+
+		CMappedFile m_CookedFile;
+		TFloat64    m_LoadSeconds;
+
+		// Position of each frame in the sprite atlases
+		CAtlasTable m_AtlasTable;
+
+		// Per-frame events, hitboxes and hurtboxes of each character's sequences
+		CAnimEventTable m_AnimEvents;
+		CFrameBoxTable  m_HitBoxes;
+		CFrameBoxTable  m_HurtBoxes;
 		/////////////////////////////////////
 		//	Public interface
 	public:
@@ -169,11 +288,54 @@ namespace gen
 		/////////////////////////////////////
 		// Template creation / destruction
 
-		string GetBlankTexturePath()
+		const string& GetBlankTexturePath()
 		{
 			return BlankTextureName;
 		}
 		string GetPlayerUITexturePath(int type, int position, bool isPlayerJotaro, bool isFacingRight);
+		const string& GetPlayerUITextureFullPath(int type, int position, bool isPlayerJotaro, bool isFacingRight);
+
+		/////////////////////////////////////
+		// Sprite atlases
+
+		//Load the atlas table saved by an earlier run, false if missing or out of date - the table is out of date if any
+		//frame file has been added, removed or changed since it was built
+		bool LoadAtlasTable(const string& fileName);
+		//Pack the frames of all loaded sequences (except menu videos) into atlases and save the table, returns frames packed
+		TUInt32 BuildAtlasTable(const string& fileName);
+
+		//Frame lookup - file name (with media folder) to atlas and UV rect. False if the frame is not in an atlas
+		bool GetFrameUV(const string& fileName, SAtlasFrame* frame)
+		{
+			return m_AtlasTable.FindFrame(fileName, frame);
+		}
+		const CAtlasTable& GetAtlasTable()
+		{
+			return m_AtlasTable;
+		}
+
+		/////////////////////////////////////
+		// Frame events
+
+		//Read the per-frame events of the player sequences and compile them into flat tables. Needs the animations
+		//loaded first for the sequence lengths. Only loads once, later calls return straight away
+		bool LoadAnimEvents(const string& xmlFileName);
+
+		//Events of a frame of a player sequence - sets events to the first and returns how many there are
+		TUInt32 GetFrameEvents(int type, bool isPlayerJotaro, int frame, const SAnimEvent** events)
+		{
+			return m_AnimEvents.GetFrameEvents(isPlayerJotaro ? 0 : 1, type, frame, events);
+		}
+
+		//Hitboxes and hurtboxes of the player sequences (loaded with the events), relative to a player facing right
+		const CFrameBoxTable& GetHitBoxes()
+		{
+			return m_HitBoxes;
+		}
+		const CFrameBoxTable& GetHurtBoxes()
+		{
+			return m_HurtBoxes;
+		}
 		
 
 
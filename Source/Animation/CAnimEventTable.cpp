@@ -0,0 +1,94 @@
+/*******************************************
+	CAnimEventTable.cpp
+
+	Per-frame events of the player animation
+	sequences, compiled into flat tables
+********************************************/
+
+#include "CAnimEventTable.h"
+
+namespace gen
+{
+
+CAnimEventTable::CAnimEventTable( TUInt32 numCharacters, TUInt32 numSequences )
+{
+	m_NumCharacters = numCharacters;
+	m_NumSequences = numSequences;
+	Clear();
+}
+
+
+/////////////////////////////////////
+// Building
+
+// Add an event on a range of frames of a sequence
+void CAnimEventTable::AddEvent( TUInt32 character, TUInt32 sequence, TUInt32 firstFrame, TUInt32 lastFrame,
+                                const SAnimEvent& event )
+{
+	if (character >= m_NumCharacters || sequence >= m_NumSequences || firstFrame > lastFrame)
+	{
+		return;
+	}
+	SEventRange range;
+	range.sequenceIndex = character * m_NumSequences + sequence;
+	range.firstFrame = firstFrame;
+	range.lastFrame = lastFrame;
+	range.event = event;
+	m_Ranges.push_back( range );
+}
+
+// Expand the ranges into the flat tables, clipping them to their sequence. Counts the events of each
+// frame first, turns the counts into start indices, then places each event - so events on a frame
+// stay in the order added
+void CAnimEventTable::Compile( const TUInt32* frameCounts )
+{
+	TUInt32 numSequences = m_NumCharacters * m_NumSequences;
+	TUInt32 totalFrames = 0;
+	for (TUInt32 seq = 0; seq < numSequences; ++seq)
+	{
+		m_Sequences[seq].firstFrame = totalFrames;
+		m_Sequences[seq].numFrames = frameCounts[seq];
+		totalFrames += frameCounts[seq];
+	}
+
+	m_FrameFirstEvent.assign( totalFrames + 1, 0 );
+	for (TUInt32 range = 0; range < m_Ranges.size(); ++range)
+	{
+		const SEventRange& r = m_Ranges[range];
+		const SSequence& seq = m_Sequences[r.sequenceIndex];
+		for (TUInt32 frame = r.firstFrame; frame <= r.lastFrame && frame < seq.numFrames; ++frame)
+		{
+			++m_FrameFirstEvent[seq.firstFrame + frame + 1];
+		}
+	}
+	for (TUInt32 frame = 0; frame < totalFrames; ++frame)
+	{
+		m_FrameFirstEvent[frame + 1] += m_FrameFirstEvent[frame];
+	}
+
+	m_Events.resize( m_FrameFirstEvent[totalFrames] );
+	vector<TUInt32> nextEvent( m_FrameFirstEvent.begin(), m_FrameFirstEvent.end() - 1 );
+	for (TUInt32 range = 0; range < m_Ranges.size(); ++range)
+	{
+		const SEventRange& r = m_Ranges[range];
+		const SSequence& seq = m_Sequences[r.sequenceIndex];
+		for (TUInt32 frame = r.firstFrame; frame <= r.lastFrame && frame < seq.numFrames; ++frame)
+		{
+			m_Events[nextEvent[seq.firstFrame + frame]++] = r.event;
+		}
+	}
+
+	m_Ranges.clear();
+}
+
+void CAnimEventTable::Clear()
+{
+	SSequence empty = { 0, 0 };
+	m_Ranges.clear();
+	m_Sequences.assign( m_NumCharacters * m_NumSequences, empty );
+	m_FrameFirstEvent.clear();
+	m_Events.clear();
+}
+
+
+} // namespace gen
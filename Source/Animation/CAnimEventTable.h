@@ -0,0 +1,130 @@
+/*******************************************
+	CAnimEventTable.h
+
+	Per-frame events of the player animation
+	sequences, compiled into flat tables
+********************************************/
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+// What an event does to the player when its frame is shown
+enum EAnimEventType
+{
+	AnimEvent_Move,      // Move forward by value (f_attackMoveDisplacer)
+	AnimEvent_Enlarge,   // Widen the sprite for a wide frame (f_Rescale)
+	AnimEvent_Shrink,    // Return the sprite to normal width
+	AnimEvent_Enlarge2x, // Widen and step forward (f_Rescalex2)
+	AnimEvent_Sound,     // Play player sound number sound
+	AnimEvent_Scale,     // Set the uniform scale of the player to value
+	AnimEvent_Height,    // Set the height of the player to value
+	AnimEvent_Ground,    // Put the player back on the ground
+	AnimEvent_Last,
+};
+
+// A single event, kept small so a frame's events sit together in memory
+struct SAnimEvent
+{
+	TUInt8   type;    // EAnimEventType
+	TInt8    channel; // Sound only - player channel to use, 0 or 1, or -1 for the player's own
+	TUInt16  sound;   // Sound only - PlayerAttackSoundDbTags value
+	TFloat32 value;
+};
+
+
+// Events for every (character, sequence, frame). Events are added as frame ranges while parsing,
+// then Compile expands them into one flat array ordered by character, sequence and frame with a
+// start index per frame. Looking up the events of a frame is then two array reads
+class CAnimEventTable
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	CAnimEventTable( TUInt32 numCharacters, TUInt32 numSequences );
+
+/////////////////////////////////////
+//	Public interface
+public:
+
+	/////////////////////////////////////
+	// Building
+
+	// Add an event on frames firstFrame to lastFrame of a sequence. Ranges past the end of the
+	// sequence are clipped when compiled, so a last frame of ~0 means to the end. Events on the
+	// same frame keep the order they were added
+	void AddEvent( TUInt32 character, TUInt32 sequence, TUInt32 firstFrame, TUInt32 lastFrame,
+	               const SAnimEvent& event );
+
+	// Build the flat tables. frameCounts holds the number of frames of each sequence, indexed by
+	// character * numSequences + sequence. Events added before are discarded afterwards
+	void Compile( const TUInt32* frameCounts );
+
+	bool IsCompiled() const
+	{
+		return !m_FrameFirstEvent.empty();
+	}
+
+	void Clear();
+
+
+	/////////////////////////////////////
+	// Lookup
+
+	// Get the events of a frame, returns the number of events and a pointer to the first
+	TUInt32 GetFrameEvents( TUInt32 character, TUInt32 sequence, TUInt32 frame,
+	                        const SAnimEvent** events ) const
+	{
+		const SSequence& seq = m_Sequences[character * m_NumSequences + sequence];
+		if (frame >= seq.numFrames)
+		{
+			return 0;
+		}
+		TUInt32 index = seq.firstFrame + frame;
+		*events = m_Events.data() + m_FrameFirstEvent[index];
+		return m_FrameFirstEvent[index + 1] - m_FrameFirstEvent[index];
+	}
+
+	TUInt32 GetNumEvents() const
+	{
+		return static_cast<TUInt32>(m_Events.size());
+	}
+
+
+/////////////////////////////////////
+//	Private interface
+private:
+	// Event range as added, before compiling
+	struct SEventRange
+	{
+		TUInt32    sequenceIndex; // character * numSequences + sequence
+		TUInt32    firstFrame;
+		TUInt32    lastFrame;
+		SAnimEvent event;
+	};
+
+	// Where the frames of a sequence start in m_FrameFirstEvent
+	struct SSequence
+	{
+		TUInt32 firstFrame;
+		TUInt32 numFrames;
+	};
+
+	TUInt32 m_NumCharacters;
+	TUInt32 m_NumSequences;
+
+	vector<SEventRange> m_Ranges;
+
+	vector<SSequence>   m_Sequences;      // One per (character, sequence)
+	vector<TUInt32>     m_FrameFirstEvent; // One per frame of every sequence, plus one at the end
+	vector<SAnimEvent>  m_Events;
+};
+
+
+} // namespace gen
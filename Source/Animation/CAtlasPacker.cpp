@@ -0,0 +1,202 @@
+/*******************************************
+	CAtlasPacker.cpp
+
+	Packs animation frames into sprite atlases
+********************************************/
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "CAtlasPacker.h"
+
+namespace gen
+{
+
+namespace
+{
+	struct SFramePlacement
+	{
+		TUInt32 frame;
+		TUInt32 x, y;
+	};
+
+	// Round up to a multiple of four, keeps atlases valid for block compression
+	TUInt32 RoundUp4( TUInt32 value )
+	{
+		return (value + 3) & ~3u;
+	}
+}
+
+
+CAtlasPacker::CAtlasPacker( TUInt32 maxAtlasSize /*= 4096*/, TUInt32 padding /*= 2*/ )
+{
+	m_MaxAtlasSize = maxAtlasSize;
+	m_Padding = padding;
+}
+
+
+// Start a new group of frames
+void CAtlasPacker::BeginGroup( const string& name )
+{
+	SPackGroup group;
+	group.name = name;
+	m_Groups.push_back( group );
+}
+
+// Add a frame to the current group, reading its size from the PNG file
+bool CAtlasPacker::AddFrame( const string& fileName )
+{
+	if (m_AddedFrames.find( fileName ) != m_AddedFrames.end())
+	{
+		return true;
+	}
+
+	TUInt32 width, height;
+	if (!ReadPNGSize( fileName, &width, &height ))
+	{
+		return false;
+	}
+	AddFrame( fileName, width, height );
+	return true;
+}
+
+// Add a frame with a known size
+void CAtlasPacker::AddFrame( const string& fileName, TUInt32 width, TUInt32 height )
+{
+	if (m_AddedFrames.find( fileName ) != m_AddedFrames.end())
+	{
+		return;
+	}
+	if (m_Groups.empty())
+	{
+		BeginGroup( "Atlas" );
+	}
+
+	SPackFrame frame;
+	frame.fileName = fileName;
+	frame.width = width;
+	frame.height = height;
+	m_Groups.back().frames.push_back( frame );
+	m_AddedFrames[fileName] = true;
+}
+
+
+// Pack all frames added so far into the given table, returns the number of frames packed
+TUInt32 CAtlasPacker::Pack( CAtlasTable* table )
+{
+	table->Clear();
+	TUInt32 numPacked = 0;
+	for (TUInt32 group = 0; group < m_Groups.size(); ++group)
+	{
+		numPacked += PackGroup( m_Groups[group], table );
+	}
+	return numPacked;
+}
+
+
+// Read the dimensions of a PNG file from its header. The first chunk of a PNG is always IHDR,
+// which starts with the width and height as big-endian 32-bit values
+bool CAtlasPacker::ReadPNGSize( const string& fileName, TUInt32* width, TUInt32* height )
+{
+	static const TUInt8 kSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+	ifstream file( fileName.c_str(), ios::in | ios::binary );
+	TUInt8 header[24];
+	if (!file || !file.read( reinterpret_cast<char*>(header), sizeof(header) ))
+	{
+		return false;
+	}
+	if (!equal( kSignature, kSignature + 8, header ) ||
+	    header[12] != 'I' || header[13] != 'H' || header[14] != 'D' || header[15] != 'R')
+	{
+		return false;
+	}
+
+	*width  = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+	*height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+	return true;
+}
+
+
+// Sort frames tallest first, so each shelf wastes as little height as possible
+bool CAtlasPacker::FrameTaller( const SPackFrame& frame1, const SPackFrame& frame2 )
+{
+	return frame1.height > frame2.height;
+}
+
+// Shelf pack one group: frames are placed left to right along a shelf, and a new shelf is
+// started above when the row is full. A new atlas is started when the shelves reach the top
+TUInt32 CAtlasPacker::PackGroup( SPackGroup& group, CAtlasTable* table )
+{
+	vector<SPackFrame>& frames = group.frames;
+	stable_sort( frames.begin(), frames.end(), FrameTaller );
+
+	TUInt32 numPacked = 0;
+	TUInt32 atlasIndex = 0;
+	vector<SFramePlacement> placements;
+	TUInt32 shelfX = m_Padding, shelfY = m_Padding, shelfHeight = 0;
+	TUInt32 usedWidth = 0, usedHeight = 0;
+
+	for (TUInt32 frame = 0; frame <= frames.size(); ++frame)
+	{
+		bool lastFrame = (frame == frames.size());
+		bool newAtlas = lastFrame;
+		if (!lastFrame)
+		{
+			// Skip frames that can never fit
+			if (frames[frame].width + 2 * m_Padding > m_MaxAtlasSize ||
+			    frames[frame].height + 2 * m_Padding > m_MaxAtlasSize)
+			{
+				continue;
+			}
+
+			// Move to next shelf, or next atlas, if the frame doesn't fit
+			if (shelfX + frames[frame].width + m_Padding > m_MaxAtlasSize)
+			{
+				shelfX = m_Padding;
+				shelfY += shelfHeight + m_Padding;
+				shelfHeight = 0;
+			}
+			newAtlas = (shelfY + frames[frame].height + m_Padding > m_MaxAtlasSize);
+		}
+
+		// Finish the current atlas, sized to fit just the frames placed in it
+		if (newAtlas && placements.size())
+		{
+			stringstream atlasName;
+			atlasName << group.name << "_" << atlasIndex++;
+			TUInt32 atlas = table->AddAtlas( atlasName.str(), RoundUp4( usedWidth + m_Padding ),
+			                                 RoundUp4( usedHeight + m_Padding ) );
+			for (TUInt32 placed = 0; placed < placements.size(); ++placed)
+			{
+				const SPackFrame& packFrame = frames[placements[placed].frame];
+				table->AddFrame( packFrame.fileName, atlas, placements[placed].x, placements[placed].y,
+				                 packFrame.width, packFrame.height );
+			}
+			numPacked += static_cast<TUInt32>(placements.size());
+
+			placements.clear();
+			shelfX = shelfY = m_Padding;
+			shelfHeight = usedWidth = usedHeight = 0;
+		}
+		if (lastFrame)
+		{
+			break;
+		}
+
+		SFramePlacement placement;
+		placement.frame = frame;
+		placement.x = shelfX;
+		placement.y = shelfY;
+		placements.push_back( placement );
+
+		shelfX += frames[frame].width + m_Padding;
+		shelfHeight = max( shelfHeight, frames[frame].height );
+		usedWidth = max( usedWidth, placement.x + frames[frame].width );
+		usedHeight = max( usedHeight, placement.y + frames[frame].height );
+	}
+	return numPacked;
+}
+
+
+} // namespace gen
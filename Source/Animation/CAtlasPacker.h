@@ -0,0 +1,88 @@
+/*******************************************
+	CAtlasPacker.h
+
+	Packs animation frames into sprite atlases
+********************************************/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+#include "CAtlasTable.h"
+
+namespace gen
+{
+
+// Frames are added in named groups (one per character, say), and frames from different groups
+// never share an atlas. Packing only needs the frame sizes, which are read from the PNG headers,
+// so a table can be built without decoding any images or creating a device
+class CAtlasPacker
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	// Atlases are at most maxAtlasSize pixels square. Frames are separated by padding pixels so
+	// filtering does not pick up texels of neighbouring frames
+	CAtlasPacker( TUInt32 maxAtlasSize = 4096, TUInt32 padding = 2 );
+
+private:
+	// Prevent use of copy constructor and assignment operator (private and not defined)
+	CAtlasPacker( const CAtlasPacker& );
+	CAtlasPacker& operator=( const CAtlasPacker& );
+
+
+/////////////////////////////////////
+//	Public interface
+public:
+
+	// Start a new group of frames, frames added after this are packed into the group's atlases
+	void BeginGroup( const string& name );
+
+	// Add a frame to the current group, reading its size from the PNG file. Frames already added
+	// (to any group) are ignored. Returns false if the size could not be read
+	bool AddFrame( const string& fileName );
+
+	// Add a frame with a known size
+	void AddFrame( const string& fileName, TUInt32 width, TUInt32 height );
+
+	// Pack all frames added so far into the given table. Frames too large for an atlas are left
+	// out of the table. Returns the number of frames packed
+	TUInt32 Pack( CAtlasTable* table );
+
+	// Read the dimensions of a PNG file from its header, returns false if not a PNG
+	static bool ReadPNGSize( const string& fileName, TUInt32* width, TUInt32* height );
+
+
+/////////////////////////////////////
+//	Private interface
+private:
+	struct SPackFrame
+	{
+		string  fileName;
+		TUInt32 width;
+		TUInt32 height;
+	};
+
+	struct SPackGroup
+	{
+		string             name;
+		vector<SPackFrame> frames;
+	};
+
+	static bool FrameTaller( const SPackFrame& frame1, const SPackFrame& frame2 );
+
+	// Shelf pack one group, adding its atlases and frames to the table
+	TUInt32 PackGroup( SPackGroup& group, CAtlasTable* table );
+
+	TUInt32              m_MaxAtlasSize;
+	TUInt32              m_Padding;
+	vector<SPackGroup>   m_Groups;
+	map<string, bool>    m_AddedFrames;
+};
+
+
+} // namespace gen
@@ -0,0 +1,270 @@
+/*******************************************
+	CAtlasTable.cpp
+
+	Table of sprite atlases and the position
+	of every animation frame within them
+********************************************/
+
+#include <fstream>
+#include "CAtlasTable.h"
+#include "CMappedFile.h"
+
+namespace gen
+{
+
+// File layout, all values little-endian as written by the game:
+//   SFileHeader
+//   SFileAtlas  * numAtlases
+//   SFileFrame  * numFrames
+//   string data - names referenced by offset, each zero terminated
+namespace
+{
+	const TUInt32 kFileMagic = 0x534c5441; // "ATLS"
+
+	struct SFileHeader
+	{
+		TUInt32 magic;
+		TUInt32 version;
+		TUInt32 numAtlases;
+		TUInt32 numFrames;
+		TUInt32 stringBytes;
+		TUInt32 padding;
+		TUInt64 sourceKey;
+	};
+
+	struct SFileAtlas
+	{
+		TUInt32 nameOffset;
+		TUInt16 width;
+		TUInt16 height;
+	};
+
+	struct SFileFrame
+	{
+		TUInt32 nameOffset;
+		TUInt16 atlas;
+		TUInt16 x, y;
+		TUInt16 width, height;
+		TUInt16 padding;
+	};
+}
+
+
+/////////////////////////////////////
+// Building
+
+// Add an atlas, returns its index
+TUInt32 CAtlasTable::AddAtlas( const string& name, TUInt32 width, TUInt32 height )
+{
+	SAtlasInfo atlas;
+	atlas.name = name;
+	atlas.width = width;
+	atlas.height = height;
+	m_Atlases.push_back( atlas );
+	return static_cast<TUInt32>(m_Atlases.size() - 1);
+}
+
+// Add a frame at the given pixel rectangle of an atlas
+void CAtlasTable::AddFrame( const string& fileName, TUInt32 atlas, TUInt32 x, TUInt32 y,
+                            TUInt32 width, TUInt32 height )
+{
+	SAtlasFrame frame;
+	frame.atlas = atlas;
+	frame.x = x;
+	frame.y = y;
+	frame.width = width;
+	frame.height = height;
+
+	TFloat32 atlasWidth = static_cast<TFloat32>(m_Atlases[atlas].width);
+	TFloat32 atlasHeight = static_cast<TFloat32>(m_Atlases[atlas].height);
+	frame.uvRect[0] = x / atlasWidth;
+	frame.uvRect[1] = y / atlasHeight;
+	frame.uvRect[2] = width / atlasWidth;
+	frame.uvRect[3] = height / atlasHeight;
+
+	m_FrameIndex[fileName] = static_cast<TUInt32>(m_Frames.size());
+	m_FrameNames.push_back( fileName );
+	m_Frames.push_back( frame );
+}
+
+void CAtlasTable::Clear()
+{
+	m_Atlases.clear();
+	m_FrameNames.clear();
+	m_Frames.clear();
+	m_FrameIndex.clear();
+	m_SourceKey = 0;
+}
+
+
+/////////////////////////////////////
+// Source files
+
+namespace
+{
+	// 64-bit FNV-1a hash, continued from the given hash
+	TUInt64 HashBytes( const void* data, TUInt32 numBytes, TUInt64 hash )
+	{
+		const TUInt8* bytes = static_cast<const TUInt8*>(data);
+		for (TUInt32 byte = 0; byte < numBytes; ++byte)
+		{
+			hash = (hash ^ bytes[byte]) * 0x100000001b3ull;
+		}
+		return hash;
+	}
+}
+
+// Make a key for the current state of the frame files a table is built from
+TUInt64 CAtlasTable::MakeSourceKey( const vector<string>& sourceFiles )
+{
+	TUInt64 key = 0xcbf29ce484222325ull;
+	for (TUInt32 file = 0; file < sourceFiles.size(); ++file)
+	{
+		// Missing files are part of the key too, so a table is rebuilt when one appears
+		TUInt64 stamp[2];
+		if (!CMappedFile::GetFileStamp( sourceFiles[file], &stamp[0], &stamp[1] ))
+		{
+			stamp[0] = stamp[1] = ~0ull;
+		}
+		key = HashBytes( sourceFiles[file].c_str(), static_cast<TUInt32>(sourceFiles[file].size() + 1), key );
+		key = HashBytes( stamp, sizeof(stamp), key );
+	}
+	return key;
+}
+
+
+/////////////////////////////////////
+// Lookup
+
+// Find the atlas position of a frame. Returns false if the frame is not in any atlas
+bool CAtlasTable::FindFrame( const string& fileName, SAtlasFrame* frame ) const
+{
+	map<string, TUInt32>::const_iterator found = m_FrameIndex.find( fileName );
+	if (found == m_FrameIndex.end())
+	{
+		return false;
+	}
+	*frame = m_Frames[found->second];
+	return true;
+}
+
+
+/////////////////////////////////////
+// File access
+
+bool CAtlasTable::Save( const string& fileName ) const
+{
+	ofstream file( fileName.c_str(), ios::out | ios::binary | ios::trunc );
+	if (!file)
+	{
+		return false;
+	}
+
+	// Build string data and records
+	string strings;
+	vector<SFileAtlas> atlases( m_Atlases.size() );
+	for (TUInt32 atlas = 0; atlas < m_Atlases.size(); ++atlas)
+	{
+		atlases[atlas].nameOffset = static_cast<TUInt32>(strings.size());
+		atlases[atlas].width = static_cast<TUInt16>(m_Atlases[atlas].width);
+		atlases[atlas].height = static_cast<TUInt16>(m_Atlases[atlas].height);
+		strings.append( m_Atlases[atlas].name.c_str(), m_Atlases[atlas].name.size() + 1 );
+	}
+	vector<SFileFrame> frames( m_Frames.size() );
+	for (TUInt32 frame = 0; frame < m_Frames.size(); ++frame)
+	{
+		frames[frame].nameOffset = static_cast<TUInt32>(strings.size());
+		frames[frame].atlas = static_cast<TUInt16>(m_Frames[frame].atlas);
+		frames[frame].x = static_cast<TUInt16>(m_Frames[frame].x);
+		frames[frame].y = static_cast<TUInt16>(m_Frames[frame].y);
+		frames[frame].width = static_cast<TUInt16>(m_Frames[frame].width);
+		frames[frame].height = static_cast<TUInt16>(m_Frames[frame].height);
+		frames[frame].padding = 0;
+		strings.append( m_FrameNames[frame].c_str(), m_FrameNames[frame].size() + 1 );
+	}
+
+	SFileHeader header;
+	header.magic = kFileMagic;
+	header.version = kFileVersion;
+	header.numAtlases = static_cast<TUInt32>(atlases.size());
+	header.numFrames = static_cast<TUInt32>(frames.size());
+	header.stringBytes = static_cast<TUInt32>(strings.size());
+	header.padding = 0;
+	header.sourceKey = m_SourceKey;
+
+	file.write( reinterpret_cast<const char*>(&header), sizeof(header) );
+	if (atlases.size()) file.write( reinterpret_cast<const char*>(&atlases[0]), atlases.size() * sizeof(SFileAtlas) );
+	if (frames.size())  file.write( reinterpret_cast<const char*>(&frames[0]), frames.size() * sizeof(SFileFrame) );
+	file.write( strings.data(), strings.size() );
+	return file.good();
+}
+
+bool CAtlasTable::Load( const string& fileName )
+{
+	Clear();
+
+	ifstream file( fileName.c_str(), ios::in | ios::binary );
+	if (!file)
+	{
+		return false;
+	}
+
+	SFileHeader header;
+	if (!file.read( reinterpret_cast<char*>(&header), sizeof(header) ) ||
+	    header.magic != kFileMagic || header.version != kFileVersion)
+	{
+		return false;
+	}
+
+	vector<SFileAtlas> atlases( header.numAtlases );
+	vector<SFileFrame> frames( header.numFrames );
+	vector<char> strings( header.stringBytes + 1, 0 );
+	if (atlases.size()) file.read( reinterpret_cast<char*>(&atlases[0]), atlases.size() * sizeof(SFileAtlas) );
+	if (frames.size())  file.read( reinterpret_cast<char*>(&frames[0]), frames.size() * sizeof(SFileFrame) );
+	file.read( &strings[0], header.stringBytes );
+	if (!file)
+	{
+		return false;
+	}
+
+	// Rebuild the table through the same functions used when packing, so UVs are recalculated
+	for (TUInt32 atlas = 0; atlas < atlases.size(); ++atlas)
+	{
+		if (atlases[atlas].nameOffset >= header.stringBytes)
+		{
+			Clear();
+			return false;
+		}
+		AddAtlas( &strings[atlases[atlas].nameOffset], atlases[atlas].width, atlases[atlas].height );
+	}
+	for (TUInt32 frame = 0; frame < frames.size(); ++frame)
+	{
+		if (frames[frame].nameOffset >= header.stringBytes || frames[frame].atlas >= atlases.size())
+		{
+			Clear();
+			return false;
+		}
+		AddFrame( &strings[frames[frame].nameOffset], frames[frame].atlas, frames[frame].x, frames[frame].y,
+		          frames[frame].width, frames[frame].height );
+	}
+	m_SourceKey = header.sourceKey;
+	return true;
+}
+
+// Load the table, failing if it was not built from frame files with the given source key
+bool CAtlasTable::Load( const string& fileName, TUInt64 sourceKey )
+{
+	if (!Load( fileName ))
+	{
+		return false;
+	}
+	if (m_SourceKey != sourceKey)
+	{
+		Clear();
+		return false;
+	}
+	return true;
+}
+
+
+} // namespace gen
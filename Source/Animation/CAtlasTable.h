@@ -0,0 +1,137 @@
+/*******************************************
+	CAtlasTable.h
+
+	Table of sprite atlases and the position
+	of every animation frame within them
+********************************************/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+// An atlas texture - a named group of frames packed into one image
+struct SAtlasInfo
+{
+	string  name;
+	TUInt32 width;
+	TUInt32 height;
+};
+
+// Where a frame lives: which atlas, its pixel rectangle, and the same rectangle in UV space
+// stored as offset (u,v) and scale (width, height) ready to pass to the shaders
+struct SAtlasFrame
+{
+	TUInt32  atlas;
+	TUInt32  x, y;
+	TUInt32  width, height;
+	TFloat32 uvRect[4];
+};
+
+
+// Lookup from a frame file name to its atlas position. Built by CAtlasPacker, saved to a compact
+// binary file and loaded back on later runs. Has no DirectX dependencies
+class CAtlasTable
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	CAtlasTable() : m_SourceKey( 0 ) {}
+
+/////////////////////////////////////
+//	Public interface
+public:
+
+	/////////////////////////////////////
+	// Building
+
+	// Add an atlas, returns its index
+	TUInt32 AddAtlas( const string& name, TUInt32 width, TUInt32 height );
+
+	// Add a frame at the given pixel rectangle of an atlas. The atlas must already be at its
+	// final size as the UVs are calculated here
+	void AddFrame( const string& fileName, TUInt32 atlas, TUInt32 x, TUInt32 y,
+	               TUInt32 width, TUInt32 height );
+
+	void Clear();
+
+
+	/////////////////////////////////////
+	// Lookup
+
+	// Find the atlas position of a frame. Returns false if the frame is not in any atlas
+	bool FindFrame( const string& fileName, SAtlasFrame* frame ) const;
+
+	TUInt32 GetNumAtlases() const
+	{
+		return static_cast<TUInt32>(m_Atlases.size());
+	}
+	const SAtlasInfo& GetAtlas( TUInt32 atlas ) const
+	{
+		return m_Atlases[atlas];
+	}
+
+	TUInt32 GetNumFrames() const
+	{
+		return static_cast<TUInt32>(m_FrameNames.size());
+	}
+	const string& GetFrameName( TUInt32 frame ) const
+	{
+		return m_FrameNames[frame];
+	}
+	const SAtlasFrame& GetFrame( TUInt32 frame ) const
+	{
+		return m_Frames[frame];
+	}
+
+
+	/////////////////////////////////////
+	// Source files
+
+	// Make a key for the current state of the frame files a table is built from - a hash of the
+	// name, size and last write time of each file in order (missing files included). A table is
+	// out of date if the key saved with it differs from the key of its source files now
+	static TUInt64 MakeSourceKey( const vector<string>& sourceFiles );
+
+	void SetSourceKey( TUInt64 sourceKey )
+	{
+		m_SourceKey = sourceKey;
+	}
+	TUInt64 GetSourceKey() const
+	{
+		return m_SourceKey;
+	}
+
+
+	/////////////////////////////////////
+	// File access
+
+	// Save / load the table as a binary file. Load returns false if the file is missing or is
+	// not a table of the current version. If a source key is given, Load also returns false if
+	// the table was saved with a different key, i.e. any of its frame files have changed
+	bool Save( const string& fileName ) const;
+	bool Load( const string& fileName );
+	bool Load( const string& fileName, TUInt64 sourceKey );
+
+
+/////////////////////////////////////
+//	Private interface
+private:
+	static const TUInt32 kFileVersion = 2;
+
+	vector<SAtlasInfo>    m_Atlases;
+	vector<string>        m_FrameNames;
+	vector<SAtlasFrame>   m_Frames;
+	map<string, TUInt32>  m_FrameIndex; // Frame file name to index in the two vectors above
+	TUInt64               m_SourceKey;
+};
+
+
+} // namespace gen
@@ -0,0 +1,104 @@
+/*******************************************
+	CFrameBoxTable.cpp
+
+	Per-frame hitbox or hurtbox rectangles of
+	the player animation sequences
+********************************************/
+
+#include "CFrameBoxTable.h"
+
+namespace gen
+{
+
+CFrameBoxTable::CFrameBoxTable( TUInt32 numCharacters, TUInt32 numSequences )
+{
+	m_NumCharacters = numCharacters;
+	m_NumSequences = numSequences;
+	Clear();
+}
+
+
+/////////////////////////////////////
+// Building
+
+// Add a box on a range of frames of a sequence
+void CFrameBoxTable::AddBox( TUInt32 character, TUInt32 sequence, TUInt32 firstFrame, TUInt32 lastFrame,
+                             const SFrameBox& box )
+{
+	if (character >= m_NumCharacters || sequence >= m_NumSequences || firstFrame > lastFrame)
+	{
+		return;
+	}
+	SBoxRange range;
+	range.sequenceIndex = character * m_NumSequences + sequence;
+	range.firstFrame = firstFrame;
+	range.lastFrame = lastFrame;
+	range.box = box;
+	m_Ranges.push_back( range );
+}
+
+// Expand the ranges into the flat tables, clipping them to their sequence. Counts the boxes of each
+// frame first, turns the counts into start indices, then places each box
+void CFrameBoxTable::Compile( const TUInt32* frameCounts )
+{
+	TUInt32 numSequences = m_NumCharacters * m_NumSequences;
+	TUInt32 totalFrames = 0;
+	for (TUInt32 seq = 0; seq < numSequences; ++seq)
+	{
+		m_Sequences[seq].firstFrame = totalFrames;
+		m_Sequences[seq].numFrames = frameCounts[seq];
+		totalFrames += frameCounts[seq];
+	}
+
+	m_FrameFirstBox.assign( totalFrames + 1, 0 );
+	for (TUInt32 range = 0; range < m_Ranges.size(); ++range)
+	{
+		const SBoxRange& r = m_Ranges[range];
+		const SSequence& seq = m_Sequences[r.sequenceIndex];
+		for (TUInt32 frame = r.firstFrame; frame <= r.lastFrame && frame < seq.numFrames; ++frame)
+		{
+			++m_FrameFirstBox[seq.firstFrame + frame + 1];
+		}
+	}
+	for (TUInt32 frame = 0; frame < totalFrames; ++frame)
+	{
+		m_FrameFirstBox[frame + 1] += m_FrameFirstBox[frame];
+	}
+
+	TUInt32 numBoxes = m_FrameFirstBox[totalFrames];
+	m_MinX.resize( numBoxes );
+	m_MinY.resize( numBoxes );
+	m_MaxX.resize( numBoxes );
+	m_MaxY.resize( numBoxes );
+	vector<TUInt32> nextBox( m_FrameFirstBox.begin(), m_FrameFirstBox.end() - 1 );
+	for (TUInt32 range = 0; range < m_Ranges.size(); ++range)
+	{
+		const SBoxRange& r = m_Ranges[range];
+		const SSequence& seq = m_Sequences[r.sequenceIndex];
+		for (TUInt32 frame = r.firstFrame; frame <= r.lastFrame && frame < seq.numFrames; ++frame)
+		{
+			TUInt32 box = nextBox[seq.firstFrame + frame]++;
+			m_MinX[box] = r.box.minX;
+			m_MinY[box] = r.box.minY;
+			m_MaxX[box] = r.box.maxX;
+			m_MaxY[box] = r.box.maxY;
+		}
+	}
+
+	m_Ranges.clear();
+}
+
+void CFrameBoxTable::Clear()
+{
+	SSequence empty = { 0, 0 };
+	m_Ranges.clear();
+	m_Sequences.assign( m_NumCharacters * m_NumSequences, empty );
+	m_FrameFirstBox.clear();
+	m_MinX.clear();
+	m_MinY.clear();
+	m_MaxX.clear();
+	m_MaxY.clear();
+}
+
+
+} // namespace gen
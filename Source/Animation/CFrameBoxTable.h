@@ -0,0 +1,130 @@
+/*******************************************
+	CFrameBoxTable.h
+
+	Per-frame hitbox or hurtbox rectangles of
+	the player animation sequences
+********************************************/
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+// A rectangle relative to the player's position, for a player facing right. X is forwards, Y up
+struct SFrameBox
+{
+	TFloat32 minX;
+	TFloat32 minY;
+	TFloat32 maxX;
+	TFloat32 maxY;
+};
+
+
+// Boxes for every (character, sequence, frame), one table for hitboxes and one for hurtboxes.
+// Built the same way as CAnimEventTable - boxes are added as frame ranges, then Compile expands
+// them into flat arrays ordered by character, sequence and frame with a start index per frame.
+// The boxes are stored as an array for each coordinate, ready to be copied into a CBoxSet
+class CFrameBoxTable
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	CFrameBoxTable( TUInt32 numCharacters, TUInt32 numSequences );
+
+/////////////////////////////////////
+//	Public interface
+public:
+
+	/////////////////////////////////////
+	// Building
+
+	// Add a box on frames firstFrame to lastFrame of a sequence. Ranges past the end of the
+	// sequence are clipped when compiled, so a last frame of ~0 means to the end
+	void AddBox( TUInt32 character, TUInt32 sequence, TUInt32 firstFrame, TUInt32 lastFrame,
+	             const SFrameBox& box );
+
+	// Build the flat tables. frameCounts holds the number of frames of each sequence, indexed by
+	// character * numSequences + sequence. Boxes added before are discarded afterwards
+	void Compile( const TUInt32* frameCounts );
+
+	bool IsCompiled() const
+	{
+		return !m_FrameFirstBox.empty();
+	}
+
+	void Clear();
+
+
+	/////////////////////////////////////
+	// Lookup
+
+	// Get the boxes of a frame, returns the number of boxes and sets firstBox to the index of the
+	// first in the coordinate arrays
+	TUInt32 GetFrameBoxes( TUInt32 character, TUInt32 sequence, TUInt32 frame,
+	                       TUInt32* firstBox ) const
+	{
+		if (!IsCompiled() || character >= m_NumCharacters || sequence >= m_NumSequences)
+		{
+			return 0;
+		}
+		const SSequence& seq = m_Sequences[character * m_NumSequences + sequence];
+		if (frame >= seq.numFrames)
+		{
+			return 0;
+		}
+		TUInt32 index = seq.firstFrame + frame;
+		*firstBox = m_FrameFirstBox[index];
+		return m_FrameFirstBox[index + 1] - m_FrameFirstBox[index];
+	}
+
+	// Coordinate arrays, indexed by the box numbers from GetFrameBoxes
+	const TFloat32* GetMinX() const { return m_MinX.data(); }
+	const TFloat32* GetMinY() const { return m_MinY.data(); }
+	const TFloat32* GetMaxX() const { return m_MaxX.data(); }
+	const TFloat32* GetMaxY() const { return m_MaxY.data(); }
+
+	TUInt32 GetNumBoxes() const
+	{
+		return static_cast<TUInt32>(m_MinX.size());
+	}
+
+
+/////////////////////////////////////
+//	Private interface
+private:
+	// Box range as added, before compiling
+	struct SBoxRange
+	{
+		TUInt32   sequenceIndex; // character * numSequences + sequence
+		TUInt32   firstFrame;
+		TUInt32   lastFrame;
+		SFrameBox box;
+	};
+
+	// Where the frames of a sequence start in m_FrameFirstBox
+	struct SSequence
+	{
+		TUInt32 firstFrame;
+		TUInt32 numFrames;
+	};
+
+	TUInt32 m_NumCharacters;
+	TUInt32 m_NumSequences;
+
+	vector<SBoxRange> m_Ranges;
+
+	vector<SSequence> m_Sequences;     // One per (character, sequence)
+	vector<TUInt32>   m_FrameFirstBox; // One per frame of every sequence, plus one at the end
+	vector<TFloat32>  m_MinX;
+	vector<TFloat32>  m_MinY;
+	vector<TFloat32>  m_MaxX;
+	vector<TFloat32>  m_MaxY;
+};
+
+
+} // namespace gen
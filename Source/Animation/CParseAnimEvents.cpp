@@ -0,0 +1,223 @@
+/*******************************************
+	CParseAnimEvents.cpp
+
+	Reads the per-frame events of the player
+	animations from XML into an event table
+********************************************/
+
+#include "CParseAnimEvents.h"
+#include "AnimationManager.h"
+#include "FMODManager.h"
+
+namespace gen
+{
+
+namespace
+{
+	struct SNamedValue
+	{
+		const char* name;
+		TInt32      value;
+	};
+
+	// Characters in the order used by the animation manager
+	const SNamedValue kCharacters[] =
+	{
+		{ "Jotaro", 0 }, { "Dio", 1 },
+	};
+
+	// Sequence element names, the same as in Animations.xml
+	const SNamedValue kSequences[] =
+	{
+		{ "IDLE", Idle },                         { "WALK", Walking },
+		{ "JUMP", Jump },                         { "BLOCK", Block },
+		{ "CROUCH", Crouch },                     { "CROUCH_TURN", Crouch_Turn },
+		{ "CROUCH_BLOCK", Crouch_Block },         { "BLOCK_AIR", Block_Air },
+		{ "TURNAROUND", Turning },                { "STANDUP", Stand_Up },
+		{ "DASH_FW", Dash },                      { "DASH_BW", Dash_Back },
+		{ "SUMMON_STANDO", Summon },              { "SUMMON_STANDO_AIR", Summon_Air },
+		{ "LIGHT_LEG_ATTACK", Light_Leg_Att },    { "LIGHT_CROUCH_ATTACK", Light_Crouch_Att },
+		{ "MEDIUM_ATTACK", Medium_Att },          { "MEDIUM_WALK_ATTACK", Medium_Walk_Att },
+		{ "MEDIUM_CROUCH_ATTACK", Medium_Crouch_Att }, { "MEDIUM_AIR_ATTACK", Medium_Air_Att },
+		{ "HEAVY_ATTACK", Heavy_Att },            { "HEAVY_WALK_ATTACK", Heavy_Walk_Att },
+		{ "HEAVY_CROUCH_ATTACK", Heavy_Crouch_Att }, { "HEAVY_CROUCH_FR_ATTACK", Heavy_Crouch_Fr_Att },
+		{ "HEAVY_AIR_ATTACK", Heavy_Air_Att },    { "THROW", Throw },
+		{ "SPECIAL_ORAORAORA", Special_OraOraOra }, { "SPECIAL_NUMBER_2", Special_Num_2 },
+		{ "SPECIAL_NUMBER_3", Special_Num_3 },    { "SPECIAL_NUMBER_4", Special_Num_4 },
+		{ "ULTIMATE_NUMBER_1", Ult_Num_1 },       { "IS_HIT_LIGHT", Is_Hit_Light },
+		{ "IS_HIT_LIGHT_2", Is_Hit_Light_2 },     { "IS_HIT_MEDIUM", Is_Hit_Medium },
+		{ "IS_HIT_MEDIUM_2", Is_Hit_Medium_2 },   { "IS_HIT_HARD", Is_Hit_Hard },
+		{ "IS_HIT_HARD_2", Is_Hit_Hard_2 },       { "IS_HIT_CROUCH", Is_Hit_Crouch },
+		{ "IS_HIT_CROUCH_2", Is_Hit_Crouch_2 },   { "IS_HIT_AIR", Is_Hit_Air },
+		{ "IS_KILLED", Is_Killed },               { "VICTORY", Victory },
+		{ "VICTORY_2", Victory_2 },               { "INTRO", Intro },
+		{ "INTRO_2", Intro_2 },
+	};
+
+	// Player sounds by their names in FMODManager.h
+	const SNamedValue kSounds[] =
+	{
+		{ "PlayerBasicAttackSound", PlayerBasicAttackSound }, { "PlayerBlockAttackStart", PlayerBlockAttackStart },
+		{ "PlayerBlockAttackSound", PlayerBlockAttackSound }, { "PlayerFootstepSound", PlayerFootstepSound },
+		{ "PlayerJumpSound", PlayerJumpSound },               { "Special_SummonSound", Special_SummonSound },
+		{ "OraOraSpecialSound", OraOraSpecialSound },         { "OraOraSingleHitSound", OraOraSingleHitSound },
+		{ "YareYareTauntSound", YareYareTauntSound },         { "MudaMudaMudaSound", MudaMudaMudaSound },
+		{ "ZaWarudoSound", ZaWarudoSound },                   { "WryyySound", WryyySound },
+		{ "KnivesFlySound", KnivesFlySound },                 { "BloodSplatterSound", BloodSplatterSound },
+		{ "RodaRollaSound", RodaRollaSound },                 { "DoubleUltCollisionEventSound", DoubleUltCollisionEventSound },
+		{ "KonoDioDaSound", KonoDioDaSound },                 { "HellToYouSound", HellToYouSound },
+		{ "DioIntroSound", DioIntroSound },
+	};
+
+	// Event element names, in EAnimEventType order
+	const char* kEventNames[AnimEvent_Last] =
+	{
+		"Move", "Enlarge", "Shrink", "Enlarge2x", "Sound", "Scale", "Height", "Ground",
+	};
+
+	TInt32 FindName( const SNamedValue* table, TUInt32 tableSize, const string& name )
+	{
+		for (TUInt32 i = 0; i < tableSize; ++i)
+		{
+			if (name == table[i].name)
+			{
+				return table[i].value;
+			}
+		}
+		return -1;
+	}
+}
+
+
+/////////////////////////////////////
+// Constructors/Destructors
+
+CParseAnimEvents::CParseAnimEvents( CAnimEventTable* eventTable, CFrameBoxTable* hitBoxes /*= 0*/,
+                                    CFrameBoxTable* hurtBoxes /*= 0*/ )
+{
+	m_EventTable = eventTable;
+	m_HitBoxes = hitBoxes;
+	m_HurtBoxes = hurtBoxes;
+	m_Character = -1;
+	m_Sequence = -1;
+}
+
+
+/////////////////////////////////////
+// Callback functions
+
+void CParseAnimEvents::StartElt( const string& eltName, SAttribute* attrs )
+{
+	if (m_Character < 0)
+	{
+		m_Character = FindCharacter( eltName );
+	}
+	else if (m_Sequence < 0)
+	{
+		m_Sequence = FindSequence( eltName );
+	}
+	else if (!AddEventElt( eltName, attrs ))
+	{
+		AddBoxElt( eltName, attrs );
+	}
+}
+
+void CParseAnimEvents::EndElt( const string& eltName )
+{
+	if (m_Sequence >= 0 && FindSequence( eltName ) == m_Sequence)
+	{
+		m_Sequence = -1;
+	}
+	else if (m_Character >= 0 && FindCharacter( eltName ) == m_Character)
+	{
+		m_Character = -1;
+	}
+}
+
+
+// Add an event element to the table. The frames are given as Frame, or From and To, or neither
+// for every frame of the sequence
+bool CParseAnimEvents::AddEventElt( const string& eltName, SAttribute* attrs )
+{
+	TInt32 type = 0;
+	while (type < AnimEvent_Last && eltName != kEventNames[type])
+	{
+		++type;
+	}
+	if (type == AnimEvent_Last)
+	{
+		return false;
+	}
+
+	SAnimEvent event;
+	event.type = static_cast<TUInt8>(type);
+	event.channel = static_cast<TInt8>(GetAttributeInt( attrs, "Player1", -1 ));
+	event.sound = 0;
+	event.value = GetAttributeFloat( attrs, "Value" );
+	if (type == AnimEvent_Sound)
+	{
+		TInt32 sound = FindSound( GetAttribute( attrs, "Name" ) );
+		if (sound < 0)
+		{
+			return false;
+		}
+		event.sound = static_cast<TUInt16>(sound);
+	}
+
+	TUInt32 firstFrame, lastFrame;
+	GetFrameRange( attrs, &firstFrame, &lastFrame );
+	m_EventTable->AddEvent( m_Character, m_Sequence, firstFrame, lastFrame, event );
+	return true;
+}
+
+// Add a HitBox or HurtBox element to its table. The box is given as X, Y, Width and Height, with
+// the same frame attributes as events
+bool CParseAnimEvents::AddBoxElt( const string& eltName, SAttribute* attrs )
+{
+	CFrameBoxTable* table = eltName == "HitBox" ? m_HitBoxes : eltName == "HurtBox" ? m_HurtBoxes : 0;
+	if (!table)
+	{
+		return false;
+	}
+
+	SFrameBox box;
+	box.minX = GetAttributeFloat( attrs, "X" );
+	box.minY = GetAttributeFloat( attrs, "Y" );
+	box.maxX = box.minX + GetAttributeFloat( attrs, "Width" );
+	box.maxY = box.minY + GetAttributeFloat( attrs, "Height" );
+
+	TUInt32 firstFrame, lastFrame;
+	GetFrameRange( attrs, &firstFrame, &lastFrame );
+	table->AddBox( m_Character, m_Sequence, firstFrame, lastFrame, box );
+	return true;
+}
+
+// Frame range of an event or box element - Frame, or From and To, or neither for every frame
+void CParseAnimEvents::GetFrameRange( SAttribute* attrs, TUInt32* firstFrame, TUInt32* lastFrame )
+{
+	TInt32 frame = GetAttributeInt( attrs, "Frame", -1 );
+	*firstFrame = frame >= 0 ? frame : GetAttributeInt( attrs, "From", 0 );
+	*lastFrame = frame >= 0 ? frame : static_cast<TUInt32>(GetAttributeInt( attrs, "To", -1 ));
+}
+
+
+/////////////////////////////////////
+// Name lookups
+
+TInt32 CParseAnimEvents::FindCharacter( const string& name )
+{
+	return FindName( kCharacters, sizeof(kCharacters) / sizeof(kCharacters[0]), name );
+}
+
+TInt32 CParseAnimEvents::FindSequence( const string& name )
+{
+	return FindName( kSequences, sizeof(kSequences) / sizeof(kSequences[0]), name );
+}
+
+TInt32 CParseAnimEvents::FindSound( const string& name )
+{
+	return FindName( kSounds, sizeof(kSounds) / sizeof(kSounds[0]), name );
+}
+
+
+} // namespace gen
@@ -0,0 +1,75 @@
+/*******************************************
+	CParseAnimEvents.h
+
+	Reads the per-frame events of the player
+	animations from XML into an event table
+********************************************/
+
+#pragma once
+
+#include <string>
+using namespace std;
+
+#include "Defines.h"
+#include "CParseXML.h"
+#include "CAnimEventTable.h"
+#include "CFrameBoxTable.h"
+
+namespace gen
+{
+
+// Parses AnimEvents.xml. Each character element (Jotaro, Dio) holds sequence elements named as in
+// Animations.xml (DASH_FW, HEAVY_ATTACK...), which hold the events:
+//   <Move Frame = "5" Value = "15.0"/>           Move forward on frame 5
+//   <Shrink From = "2" To = "4"/>                Frames 2 to 4
+//   <Move Value = "-1.0"/>                       Every frame
+//   <Sound Frame = "0" Name = "PlayerFootstepSound" Player1 = "0"/>
+// Player1 on a sound picks the sound channel, by default the channel of the player animating.
+// The same elements hold the hitboxes and hurtboxes, given as a rectangle from the player's
+// position facing right, X forwards and Y up:
+//   <HitBox From = "3" To = "5" X = "5.0" Y = "10.0" Width = "25.0" Height = "15.0"/>
+//   <HurtBox X = "-10.0" Y = "0.0" Width = "20.0" Height = "40.0"/>
+class CParseAnimEvents : public CParseXML
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	// Events are added to the given table, characters numbered as in character names below. Boxes
+	// are added to the box tables if given
+	CParseAnimEvents( CAnimEventTable* eventTable, CFrameBoxTable* hitBoxes = 0,
+	                  CFrameBoxTable* hurtBoxes = 0 );
+
+/////////////////////////////////////
+//	Private interface
+private:
+	// Callback function called when the parser meets the start of a new element (the opening tag)
+	void StartElt( const string& eltName, SAttribute* attrs );
+
+	// Callback function called when the parser meets the end of an element (the closing tag)
+	void EndElt( const string& eltName );
+
+	// Add an event element to the table, false if the element is not an event
+	bool AddEventElt( const string& eltName, SAttribute* attrs );
+
+	// Add a HitBox or HurtBox element to its table, false if the element is not a box
+	bool AddBoxElt( const string& eltName, SAttribute* attrs );
+
+	// Frame range of an event or box element
+	static void GetFrameRange( SAttribute* attrs, TUInt32* firstFrame, TUInt32* lastFrame );
+
+	// Name lookups, return -1 if the name is unknown
+	static TInt32 FindCharacter( const string& name );
+	static TInt32 FindSequence( const string& name );
+	static TInt32 FindSound( const string& name );
+
+	CAnimEventTable* m_EventTable;
+	CFrameBoxTable*  m_HitBoxes;
+	CFrameBoxTable*  m_HurtBoxes;
+
+	// Current character and sequence, -1 outside of them
+	TInt32 m_Character;
+	TInt32 m_Sequence;
+};
+
+
+} // namespace gen
@@ -3,7 +3,6 @@
 ///////////////////////////////////////////////////////////
 
 #include "BaseMath.h"
-#include "Entity.h"
 #include "CParseAnimation.h"
 
 namespace gen
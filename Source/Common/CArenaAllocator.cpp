@@ -0,0 +1,149 @@
+/**************************************************************************************************
+	Module:       CArenaAllocator.cpp
+
+	Arena allocator handing out 16-byte aligned memory from large blocks
+
+	See header file for further notes
+**************************************************************************************************/
+
+#include <string.h>
+
+#include "CArenaAllocator.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+
+// Constructor takes the size of the blocks to allocate from the system. No blocks are allocated
+// until the first allocation
+CArenaAllocator::CArenaAllocator( const TUInt32 iBlockSize /*= 64 * 1024*/ )
+	: m_kiBlockSize( AlignedSize( iBlockSize ) )
+{
+	m_iCurrentBlock = 0;
+	m_iOffset = 0;
+	m_iNumAllocations = 0;
+	memset( m_apFreeLists, 0, sizeof(m_apFreeLists) );
+}
+
+// Destructor releases all the blocks
+CArenaAllocator::~CArenaAllocator()
+{
+	for (TUInt32 iBlock = 0; iBlock < m_Blocks.size(); ++iBlock)
+	{
+		delete[] m_Blocks[iBlock].pMemory;
+	}
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+
+// Allocate the given number of bytes. Reuses freed memory of the same size if there is any,
+// otherwise takes the next bytes of the current block
+void* CArenaAllocator::Allocate( TUInt32 iBytes )
+{
+	iBytes = AlignedSize( iBytes );
+	++m_iNumAllocations;
+
+	SFreeEntry*& pFreeList = FreeList( iBytes );
+	if (pFreeList)
+	{
+		SFreeEntry* pEntry = pFreeList;
+		pFreeList = pEntry->pNext;
+		return pEntry;
+	}
+
+	if (m_iCurrentBlock >= m_Blocks.size() ||
+	    m_iOffset + iBytes > m_Blocks[m_iCurrentBlock].iSize)
+	{
+		NextBlock( iBytes );
+	}
+	void* pMemory = m_Blocks[m_iCurrentBlock].pAligned + m_iOffset;
+	m_iOffset += iBytes;
+	return pMemory;
+}
+
+// Free memory from Allocate, it is put on the free list for its size
+void CArenaAllocator::Free( void* pMemory, TUInt32 iBytes )
+{
+	if (!pMemory)
+	{
+		return;
+	}
+	--m_iNumAllocations;
+
+	SFreeEntry*& pFreeList = FreeList( AlignedSize( iBytes ) );
+	SFreeEntry* pEntry = static_cast<SFreeEntry*>(pMemory);
+	pEntry->pNext = pFreeList;
+	pFreeList = pEntry;
+}
+
+// Release all allocations at once. The blocks are kept and allocated from again from the start
+void CArenaAllocator::Reset()
+{
+	m_iCurrentBlock = 0;
+	m_iOffset = 0;
+	m_iNumAllocations = 0;
+	memset( m_apFreeLists, 0, sizeof(m_apFreeLists) );
+	m_LargeFreeLists.clear();
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+
+// Return the free list for the given aligned size. Large sizes not seen before get an empty list
+CArenaAllocator::SFreeEntry*& CArenaAllocator::FreeList( TUInt32 iBytes )
+{
+	if (iBytes <= kiMaxSmallSize)
+	{
+		return m_apFreeLists[iBytes / kiAlignment];
+	}
+	for (TUInt32 iList = 0; iList < m_LargeFreeLists.size(); ++iList)
+	{
+		if (m_LargeFreeLists[iList].iSize == iBytes)
+		{
+			return m_LargeFreeLists[iList].pFirst;
+		}
+	}
+	SLargeFreeList list = { iBytes, 0 };
+	m_LargeFreeLists.push_back( list );
+	return m_LargeFreeLists.back().pFirst;
+}
+
+// Move to the next block with at least the given number of bytes. Blocks that are too small are
+// skipped (until the next reset), a new block is allocated if there are no more blocks
+void CArenaAllocator::NextBlock( TUInt32 iBytes )
+{
+	if (m_iCurrentBlock < m_Blocks.size())
+	{
+		++m_iCurrentBlock;
+	}
+	while (m_iCurrentBlock < m_Blocks.size() && m_Blocks[m_iCurrentBlock].iSize < iBytes)
+	{
+		++m_iCurrentBlock;
+	}
+	m_iOffset = 0;
+	if (m_iCurrentBlock < m_Blocks.size())
+	{
+		return;
+	}
+
+	// Over-allocate to leave room to align the start of the block
+	SBlock block;
+	block.iSize = iBytes > m_kiBlockSize ? iBytes : m_kiBlockSize;
+	block.pMemory = new TUInt8[block.iSize + kiAlignment - 1];
+	GEN_ASSERT( block.pMemory, "Fatal memory error allocating arena block" );
+	size_t iAddress = reinterpret_cast<size_t>(block.pMemory);
+	block.pAligned = block.pMemory + ((kiAlignment - iAddress % kiAlignment) % kiAlignment);
+	m_Blocks.push_back( block );
+	m_iCurrentBlock = static_cast<TUInt32>(m_Blocks.size()) - 1;
+}
+
+
+} // namespace gen
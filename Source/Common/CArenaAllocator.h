@@ -0,0 +1,142 @@
+/**************************************************************************************************
+	Module:       CArenaAllocator.h
+
+	Arena allocator handing out 16-byte aligned memory from large blocks. Allocating usually just
+	moves an offset along the current block, so many small allocations cost very few calls to the
+	system allocator and end up next to each other in memory. The 16-byte alignment allows SIMD
+	loads and stores on the memory
+
+	Freed memory is kept on a free list for its size and reused by allocations of that size. Small
+	sizes index their free list directly, larger sizes search a short list of the sizes freed so
+	far - callers free only a few distinct large sizes, e.g. one per mesh. Everything is released
+	at once with Reset, which keeps the blocks for reuse and takes the same time however many
+	allocations were made
+**************************************************************************************************/
+
+#ifndef GEN_C_ARENA_ALLOCATOR_H_INCLUDED
+#define GEN_C_ARENA_ALLOCATOR_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+#include "Error.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	CArenaAllocator class
+---------------------------------------------------------------------------------------------*/
+
+// Memory from the arena is raw - constructors and destructors are not called. Memory stays valid
+// until it is freed or the arena is reset, it never moves
+class CArenaAllocator
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Constructor takes the size of the blocks to allocate from the system, an allocation larger
+	// than this gets a block to itself
+	CArenaAllocator( const TUInt32 iBlockSize = 64 * 1024 );
+
+	// Destructor releases all the blocks
+	~CArenaAllocator();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CArenaAllocator( const CArenaAllocator& );
+	CArenaAllocator& operator=( const CArenaAllocator& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Alignment of all allocations
+	static const TUInt32 kiAlignment = 16;
+
+	// Allocate the given number of bytes
+	void* Allocate( TUInt32 iBytes );
+
+	// Free memory from Allocate, the size must be the same as was allocated. The memory is reused
+	// by later allocations of the same size
+	void Free( void* pMemory, TUInt32 iBytes );
+
+	// Release all allocations at once, keeping the blocks for new allocations
+	void Reset();
+
+
+	// Number of blocks allocated from the system - i.e. the number of system allocations made
+	TUInt32 GetNumBlocks() const
+	{
+		return static_cast<TUInt32>(m_Blocks.size());
+	}
+
+	// Number of allocations currently not freed
+	TUInt32 GetNumAllocations() const
+	{
+		return m_iNumAllocations;
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// Largest allocation with a free list indexed directly by size, there is one for each multiple
+	// of the alignment up to this size
+	static const TUInt32 kiMaxSmallSize = 4096;
+	static const TUInt32 kiNumFreeLists = kiMaxSmallSize / kiAlignment + 1;
+
+	// A block of memory from the system
+	struct SBlock
+	{
+		TUInt8* pMemory;  // As allocated
+		TUInt8* pAligned; // Start of aligned memory
+		TUInt32 iSize;    // Size of aligned memory
+	};
+
+	// A freed allocation on a free list, stored in the freed memory itself
+	struct SFreeEntry
+	{
+		SFreeEntry* pNext;
+	};
+
+	// Free list for a size above kiMaxSmallSize
+	struct SLargeFreeList
+	{
+		TUInt32     iSize;
+		SFreeEntry* pFirst;
+	};
+
+	// Return the free list for the given aligned size
+	SFreeEntry*& FreeList( TUInt32 iBytes );
+
+	// Round a size up to a multiple of the alignment
+	static TUInt32 AlignedSize( TUInt32 iBytes )
+	{
+		return iBytes == 0 ? kiAlignment : (iBytes + kiAlignment - 1) & ~(kiAlignment - 1);
+	}
+
+	// Move to a block with at least the given number of bytes, allocating one if needed
+	void NextBlock( TUInt32 iBytes );
+
+
+	const TUInt32  m_kiBlockSize;
+
+	vector<SBlock> m_Blocks;
+	TUInt32        m_iCurrentBlock; // Block being allocated from
+	TUInt32        m_iOffset;       // Offset of next allocation in the current block
+
+	SFreeEntry*    m_apFreeLists[kiNumFreeLists]; // Indexed by size / alignment
+	vector<SLargeFreeList> m_LargeFreeLists;     // Sizes above kiMaxSmallSize, in the order first freed
+	TUInt32        m_iNumAllocations;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_ARENA_ALLOCATOR_H_INCLUDED
@@ -0,0 +1,97 @@
+/**************************************************************************************************
+	Module:       CBoxSet.cpp
+
+	A set of axis aligned rectangles in the XY plane, with a test for the overlaps between two sets
+
+	See header file for further notes
+**************************************************************************************************/
+
+#include <float.h>
+#include <xmmintrin.h>
+
+#include "CBoxSet.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+
+// Remove all boxes, the arrays keep their memory
+void CBoxSet::Clear()
+{
+	m_iNumBoxes = 0;
+	m_afMinX.clear();
+	m_afMinY.clear();
+	m_afMaxX.clear();
+	m_afMaxY.clear();
+	m_aiOwners.clear();
+}
+
+// Add a box with the owner it belongs to, returns its index. Starting a new block adds four empty
+// boxes, which the new box and the next three replace
+TUInt32 CBoxSet::Add( TUInt32 iOwner, TFloat32 fMinX, TFloat32 fMinY, TFloat32 fMaxX, TFloat32 fMaxY )
+{
+	if (m_iNumBoxes % kiBlockSize == 0)
+	{
+		m_afMinX.resize( m_iNumBoxes + kiBlockSize, FLT_MAX );
+		m_afMinY.resize( m_iNumBoxes + kiBlockSize, FLT_MAX );
+		m_afMaxX.resize( m_iNumBoxes + kiBlockSize, -FLT_MAX );
+		m_afMaxY.resize( m_iNumBoxes + kiBlockSize, -FLT_MAX );
+		m_aiOwners.resize( m_iNumBoxes + kiBlockSize, 0 );
+	}
+	m_afMinX[m_iNumBoxes] = fMinX;
+	m_afMinY[m_iNumBoxes] = fMinY;
+	m_afMaxX[m_iNumBoxes] = fMaxX;
+	m_afMaxY[m_iNumBoxes] = fMaxY;
+	m_aiOwners[m_iNumBoxes] = iOwner;
+	return m_iNumBoxes++;
+}
+
+
+// Find the overlapping pairs of boxes with different owners. Each box in this set is compared
+// against a block of four boxes of the other set with SSE, giving a four bit mask of the overlaps.
+// Most masks are zero, the owners are only checked for the overlaps found
+TUInt32 CBoxSet::FindOverlaps( const CBoxSet& other, SBoxOverlap* pOverlaps, TUInt32 iMaxOverlaps ) const
+{
+	TUInt32 iNumOverlaps = 0;
+	TUInt32 iOtherEnd = static_cast<TUInt32>(other.m_afMinX.size()); // Includes the padding
+	for (TUInt32 iBox = 0; iBox < m_iNumBoxes; ++iBox)
+	{
+		__m128 minX = _mm_set1_ps( m_afMinX[iBox] );
+		__m128 minY = _mm_set1_ps( m_afMinY[iBox] );
+		__m128 maxX = _mm_set1_ps( m_afMaxX[iBox] );
+		__m128 maxY = _mm_set1_ps( m_afMaxY[iBox] );
+		for (TUInt32 iBlock = 0; iBlock < iOtherEnd; iBlock += kiBlockSize)
+		{
+			__m128 overlapX = _mm_and_ps( _mm_cmple_ps( minX, _mm_loadu_ps( &other.m_afMaxX[iBlock] ) ),
+			                              _mm_cmple_ps( _mm_loadu_ps( &other.m_afMinX[iBlock] ), maxX ) );
+			__m128 overlapY = _mm_and_ps( _mm_cmple_ps( minY, _mm_loadu_ps( &other.m_afMaxY[iBlock] ) ),
+			                              _mm_cmple_ps( _mm_loadu_ps( &other.m_afMinY[iBlock] ), maxY ) );
+			int iMask = _mm_movemask_ps( _mm_and_ps( overlapX, overlapY ) );
+			if (iMask == 0)
+			{
+				continue;
+			}
+
+			for (TUInt32 iLane = 0; iLane < kiBlockSize; ++iLane)
+			{
+				if ((iMask & (1 << iLane)) && other.m_aiOwners[iBlock + iLane] != m_aiOwners[iBox])
+				{
+					if (iNumOverlaps == iMaxOverlaps)
+					{
+						return iNumOverlaps;
+					}
+					pOverlaps[iNumOverlaps].iBox = iBox;
+					pOverlaps[iNumOverlaps].iOtherBox = iBlock + iLane;
+					++iNumOverlaps;
+				}
+			}
+		}
+	}
+	return iNumOverlaps;
+}
+
+
+} // namespace gen
@@ -0,0 +1,105 @@
+/**************************************************************************************************
+	Module:       CBoxSet.h
+
+	A set of axis aligned rectangles in the XY plane, e.g. the hitboxes of all fighters this tick,
+	with a test for the overlaps between two sets
+
+	The rectangles are stored as an array for each coordinate, padded to a multiple of four with
+	empty rectangles, so the overlap test compares one rectangle against four others at a time
+	using SSE. Each rectangle has an owner, rectangles with the same owner are never reported as
+	overlapping (a fighter doesn't hit itself)
+**************************************************************************************************/
+
+#ifndef GEN_C_BOX_SET_H_INCLUDED
+#define GEN_C_BOX_SET_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Overlaps
+---------------------------------------------------------------------------------------------*/
+
+// An overlapping pair, as the index of a box in the set tested and in the other set
+struct SBoxOverlap
+{
+	TUInt32 iBox;
+	TUInt32 iOtherBox;
+};
+
+
+/*---------------------------------------------------------------------------------------------
+	CBoxSet class
+---------------------------------------------------------------------------------------------*/
+
+class CBoxSet
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	CBoxSet()
+	{
+		Clear();
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CBoxSet( const CBoxSet& );
+	CBoxSet& operator=( const CBoxSet& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Remove all boxes, the arrays keep their memory
+	void Clear();
+
+	// Add a box with the owner it belongs to, returns its index
+	TUInt32 Add( TUInt32 iOwner, TFloat32 fMinX, TFloat32 fMinY, TFloat32 fMaxX, TFloat32 fMaxY );
+
+	TUInt32 GetNumBoxes() const
+	{
+		return m_iNumBoxes;
+	}
+
+	TUInt32 GetOwner( TUInt32 iBox ) const
+	{
+		return m_aiOwners[iBox];
+	}
+
+
+	// Find the pairs of a box in this set and a box in the other set that overlap (or touch) and
+	// have different owners. Writes up to the given number of pairs, in order of the boxes in
+	// this set, and returns the number written
+	TUInt32 FindOverlaps( const CBoxSet& other, SBoxOverlap* pOverlaps, TUInt32 iMaxOverlaps ) const;
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// Boxes are added to the arrays four at a time
+	static const TUInt32 kiBlockSize = 4;
+
+	TUInt32          m_iNumBoxes;
+
+	// Padded to a multiple of the block size with empty boxes, which overlap nothing
+	vector<TFloat32> m_afMinX;
+	vector<TFloat32> m_afMinY;
+	vector<TFloat32> m_afMaxX;
+	vector<TFloat32> m_afMaxY;
+	vector<TUInt32>  m_aiOwners;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_BOX_SET_H_INCLUDED
@@ -0,0 +1,208 @@
+/**************************************************************************************************
+	Module:       CBroadphaseGrid.cpp
+
+	Broadphase for collision detection using a uniform grid
+
+	See header file for further notes
+**************************************************************************************************/
+
+#include <math.h>
+
+#include "CBroadphaseGrid.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+
+// Constructor takes the size of the grid cells
+CBroadphaseGrid::CBroadphaseGrid( TFloat32 fCellSize )
+	: m_kfCellSize( fCellSize )
+{
+	Clear();
+	Build();
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+
+// Remove all objects, ready to add this frame's objects. The arrays keep their memory
+void CBroadphaseGrid::Clear()
+{
+	m_aObjects.clear();
+}
+
+// Add an object with an ID that is returned in its pairs, a circle in the XY plane, its
+// collision group and the groups it collides with
+void CBroadphaseGrid::Add( TUInt32 iID, TFloat32 fX, TFloat32 fY, TFloat32 fRadius,
+                           TUInt32 iGroup, TUInt32 iCollidesWith )
+{
+	SObject object;
+	object.iID = iID;
+	object.iGroup = iGroup;
+	object.iCollidesWith = iCollidesWith;
+	object.fMinX = fX - fRadius;
+	object.fMinY = fY - fRadius;
+	object.fMaxX = fX + fRadius;
+	object.fMaxY = fY + fRadius;
+	m_aObjects.push_back( object );
+}
+
+// Put the objects added into the grid cells. The grid covers the bounding boxes of all the
+// objects, with cells made larger if there would be too many cells for the number of objects.
+// The objects are counting sorted into the cells, each cell's objects stay in the order added
+void CBroadphaseGrid::Build()
+{
+	m_iPairCell = 0;
+	m_iPairI = 0;
+	m_iPairJ = 1;
+
+	TUInt32 iNumObjects = static_cast<TUInt32>(m_aObjects.size());
+	if (iNumObjects == 0)
+	{
+		m_iCellsX = m_iCellsY = 0;
+		m_aCellStarts.assign( 1, 0 );
+		return;
+	}
+
+	// Area covered by the objects
+	m_fGridMinX = m_aObjects[0].fMinX;
+	m_fGridMinY = m_aObjects[0].fMinY;
+	TFloat32 fGridMaxX = m_aObjects[0].fMaxX;
+	TFloat32 fGridMaxY = m_aObjects[0].fMaxY;
+	for (TUInt32 iObject = 1; iObject < iNumObjects; ++iObject)
+	{
+		const SObject& object = m_aObjects[iObject];
+		if (object.fMinX < m_fGridMinX) m_fGridMinX = object.fMinX;
+		if (object.fMinY < m_fGridMinY) m_fGridMinY = object.fMinY;
+		if (object.fMaxX > fGridMaxX)   fGridMaxX = object.fMaxX;
+		if (object.fMaxY > fGridMaxY)   fGridMaxY = object.fMaxY;
+	}
+
+	// Size the grid, allowing a few cells per object
+	TFloat32 fWidth = fGridMaxX - m_fGridMinX;
+	TFloat32 fHeight = fGridMaxY - m_fGridMinY;
+	TFloat32 fMaxCells = static_cast<TFloat32>(4 * iNumObjects + 16);
+	m_fGridCellSize = m_kfCellSize;
+	TFloat32 fNumCells = (fWidth / m_fGridCellSize + 1.0f) * (fHeight / m_fGridCellSize + 1.0f);
+	if (fNumCells > fMaxCells)
+	{
+		m_fGridCellSize *= sqrtf( fNumCells / fMaxCells );
+	}
+	m_iCellsX = static_cast<TUInt32>(fWidth / m_fGridCellSize) + 1;
+	m_iCellsY = static_cast<TUInt32>(fHeight / m_fGridCellSize) + 1;
+	TUInt32 iNumCells = m_iCellsX * m_iCellsY;
+
+	// Count the objects in each cell
+	m_aCellStarts.assign( iNumCells + 1, 0 );
+	TUInt32 iNumEntries = 0;
+	for (TUInt32 iObject = 0; iObject < iNumObjects; ++iObject)
+	{
+		SObject& object = m_aObjects[iObject];
+		object.iCellMinX = CellCoord( object.fMinX, m_fGridMinX, m_iCellsX );
+		object.iCellMinY = CellCoord( object.fMinY, m_fGridMinY, m_iCellsY );
+		object.iCellMaxX = CellCoord( object.fMaxX, m_fGridMinX, m_iCellsX );
+		object.iCellMaxY = CellCoord( object.fMaxY, m_fGridMinY, m_iCellsY );
+		for (TUInt32 iY = object.iCellMinY; iY <= object.iCellMaxY; ++iY)
+		{
+			for (TUInt32 iX = object.iCellMinX; iX <= object.iCellMaxX; ++iX)
+			{
+				++m_aCellStarts[iY * m_iCellsX + iX];
+			}
+		}
+		iNumEntries += (object.iCellMaxX - object.iCellMinX + 1) *
+		               (object.iCellMaxY - object.iCellMinY + 1);
+	}
+
+	// Make each cell's start the end of its objects, then fill the cells from the back, which
+	// leaves the starts correct
+	TUInt32 iEnd = 0;
+	for (TUInt32 iCell = 0; iCell < iNumCells; ++iCell)
+	{
+		iEnd += m_aCellStarts[iCell];
+		m_aCellStarts[iCell] = iEnd;
+	}
+	m_aCellStarts[iNumCells] = iEnd;
+	m_aCellObjects.resize( iNumEntries );
+	for (TUInt32 iObject = iNumObjects; iObject-- > 0;)
+	{
+		const SObject& object = m_aObjects[iObject];
+		for (TUInt32 iY = object.iCellMinY; iY <= object.iCellMaxY; ++iY)
+		{
+			for (TUInt32 iX = object.iCellMinX; iX <= object.iCellMaxX; ++iX)
+			{
+				m_aCellObjects[--m_aCellStarts[iY * m_iCellsX + iX]] = iObject;
+			}
+		}
+	}
+}
+
+// Get the next batch of pairs with overlapping bounding boxes. Objects covering several cells
+// share more than one cell, a pair is only returned from the cell holding the corner of the
+// overlap of their cell ranges
+TUInt32 CBroadphaseGrid::GetPairs( SBroadphasePair* pPairs, TUInt32 iMaxPairs )
+{
+	TUInt32 iNumPairs = 0;
+	TUInt32 iNumCells = m_iCellsX * m_iCellsY;
+	while (m_iPairCell < iNumCells)
+	{
+		TUInt32 iCellX = m_iPairCell % m_iCellsX;
+		TUInt32 iCellY = m_iPairCell / m_iCellsX;
+		TUInt32 iStart = m_aCellStarts[m_iPairCell];
+		TUInt32 iCount = m_aCellStarts[m_iPairCell + 1] - iStart;
+		while (m_iPairI + 1 < iCount)
+		{
+			const SObject& a = m_aObjects[m_aCellObjects[iStart + m_iPairI]];
+			while (m_iPairJ < iCount)
+			{
+				if (iNumPairs == iMaxPairs)
+				{
+					return iNumPairs;
+				}
+				const SObject& b = m_aObjects[m_aCellObjects[iStart + m_iPairJ]];
+				++m_iPairJ;
+
+				if (((a.iGroup & b.iCollidesWith) || (b.iGroup & a.iCollidesWith)) &&
+				    a.fMinX <= b.fMaxX && b.fMinX <= a.fMaxX &&
+				    a.fMinY <= b.fMaxY && b.fMinY <= a.fMaxY &&
+				    (a.iCellMinX > b.iCellMinX ? a.iCellMinX : b.iCellMinX) == iCellX &&
+				    (a.iCellMinY > b.iCellMinY ? a.iCellMinY : b.iCellMinY) == iCellY)
+				{
+					pPairs[iNumPairs].iA = a.iID;
+					pPairs[iNumPairs].iB = b.iID;
+					++iNumPairs;
+				}
+			}
+			++m_iPairI;
+			m_iPairJ = m_iPairI + 1;
+		}
+		++m_iPairCell;
+		m_iPairI = 0;
+		m_iPairJ = 1;
+	}
+	return iNumPairs;
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+
+// Cell coordinate of a position along an axis, positions outside the grid use the edge cells
+TUInt32 CBroadphaseGrid::CellCoord( TFloat32 fPos, TFloat32 fGridMin, TUInt32 iNumCells ) const
+{
+	TFloat32 fCell = (fPos - fGridMin) / m_fGridCellSize;
+	if (fCell <= 0.0f)
+	{
+		return 0;
+	}
+	TUInt32 iCell = static_cast<TUInt32>(fCell);
+	return iCell < iNumCells ? iCell : iNumCells - 1;
+}
+
+
+} // namespace gen
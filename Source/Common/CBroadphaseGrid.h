@@ -0,0 +1,134 @@
+/**************************************************************************************************
+	Module:       CBroadphaseGrid.h
+
+	Broadphase for collision detection - finds the pairs of objects that may be colliding so only
+	those pairs need an exact test. Objects are circles in the XY plane, put in the cells of a
+	uniform grid covered by their bounding boxes. Only objects sharing a cell can collide
+
+	The grid is rebuilt from scratch each frame: add all the objects, build, then get the pairs.
+	Building is a counting sort of the objects into cells, so takes linear time and allocates no
+	memory once the arrays have grown. Pairs are returned in batches into an array supplied by the
+	caller, each pair once only
+
+	Each object is in a collision group and has a mask of the groups it collides with, pairs where
+	neither object collides with the other's group are not returned (e.g. monster vs monster)
+**************************************************************************************************/
+
+#ifndef GEN_C_BROADPHASE_GRID_H_INCLUDED
+#define GEN_C_BROADPHASE_GRID_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Broadphase pairs
+---------------------------------------------------------------------------------------------*/
+
+// A pair of objects that may be colliding, as the IDs they were added with. A is the object
+// added first
+struct SBroadphasePair
+{
+	TUInt32 iA;
+	TUInt32 iB;
+};
+
+
+/*---------------------------------------------------------------------------------------------
+	CBroadphaseGrid class
+---------------------------------------------------------------------------------------------*/
+
+class CBroadphaseGrid
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Constructor takes the size of the grid cells, which is best around the diameter of the
+	// objects. The grid only covers the objects added, and has at most a few cells per object -
+	// the cells are made larger if the objects are spread out
+	CBroadphaseGrid( TFloat32 fCellSize );
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CBroadphaseGrid( const CBroadphaseGrid& );
+	CBroadphaseGrid& operator=( const CBroadphaseGrid& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Remove all objects, ready to add this frame's objects
+	void Clear();
+
+	// Add an object with an ID that is returned in its pairs, a circle in the XY plane, its
+	// collision group (a single bit) and the groups it collides with
+	void Add( TUInt32 iID, TFloat32 fX, TFloat32 fY, TFloat32 fRadius,
+	          TUInt32 iGroup, TUInt32 iCollidesWith );
+
+	// Put the objects added into the grid cells, ready to get pairs
+	void Build();
+
+	// Get the next batch of pairs with overlapping bounding boxes into the given array. Returns
+	// the number of pairs, less than the maximum when all pairs have been returned
+	TUInt32 GetPairs( SBroadphasePair* pPairs, TUInt32 iMaxPairs );
+
+
+	TUInt32 GetNumObjects() const
+	{
+		return static_cast<TUInt32>(m_aObjects.size());
+	}
+
+	// Number of cells in the grid from the last Build
+	TUInt32 GetNumCells() const
+	{
+		return m_iCellsX * m_iCellsY;
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// An object with its bounding box and the range of cells it covers
+	struct SObject
+	{
+		TUInt32  iID;
+		TUInt32  iGroup;
+		TUInt32  iCollidesWith;
+		TFloat32 fMinX, fMinY, fMaxX, fMaxY;
+		TUInt32  iCellMinX, iCellMinY, iCellMaxX, iCellMaxY;
+	};
+
+	// Cell coordinate of a position along an axis, positions outside the grid use the edge cells
+	TUInt32 CellCoord( TFloat32 fPos, TFloat32 fGridMin, TUInt32 iNumCells ) const;
+
+
+	const TFloat32   m_kfCellSize;
+
+	vector<SObject>  m_aObjects;
+
+	// Grid from the last Build. The objects in cell c are m_aCellObjects from m_aCellStarts[c]
+	// to m_aCellStarts[c + 1], as indexes into m_aObjects
+	TFloat32         m_fGridMinX, m_fGridMinY;
+	TFloat32         m_fGridCellSize;
+	TUInt32          m_iCellsX, m_iCellsY;
+	vector<TUInt32>  m_aCellStarts;
+	vector<TUInt32>  m_aCellObjects;
+
+	// Position of GetPairs - the next pair to test is objects i and j of the cell
+	TUInt32          m_iPairCell;
+	TUInt32          m_iPairI;
+	TUInt32          m_iPairJ;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_BROADPHASE_GRID_H_INCLUDED
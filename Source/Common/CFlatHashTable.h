@@ -0,0 +1,565 @@
+/**************************************************************************************************
+	Module:       CFlatHashTable.h
+
+	Open addressing hash table with the same interface as CHashTable. All key/value pairs are held
+	in a single contiguous array of slots rather than in a list per bucket, so inserting a key
+	allocates no memory (except when the table grows) and a look-up reads neighbouring slots
+	rather than following list pointers
+
+	Collisions are resolved with Robin Hood linear probing: each key is stored as close as possible
+	to the slot its hash selects (its "home" slot), and on insertion a key that is further from its
+	home slot takes the place of one that is closer. This keeps probe sequences short and lets a
+	look-up stop as soon as it meets a key closer to home than the one being searched for. Keys are
+	removed by shifting the following keys back a slot, so no "deleted" markers are left behind
+
+	The table can optionally be resized incrementally, keeping the old slot array alongside the new
+	one and moving a few slots across with each insert or remove, so no single insert pays for
+	rehashing the whole table
+**************************************************************************************************/
+
+#ifndef GEN_C_FLAT_HASH_TABLE_H_INCLUDED
+#define GEN_C_FLAT_HASH_TABLE_H_INCLUDED
+
+#include <iostream>
+using namespace std;
+
+#include "Defines.h"
+#include "Error.h"
+#include "CHashTable.h" // Hash traits and hash functions
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	CFlatHashTable class
+---------------------------------------------------------------------------------------------*/
+
+// Template restrictions are as for CHashTable - keys must have operator== and operator=, values
+// must have operator=, and keys must not contain pointers unless the hash traits handle them.
+// Additionally both keys and values must be default constructible, as the slot array holds a key
+// and value in every slot, used or not
+//
+// Set kbStats to collect look-up counters for GetStats, at a small cost to every look-up
+template <class TKeyType, class TValueType, class THashTraits = CHashTraits<TKeyType>,
+          bool kbStats = false>
+class CFlatHashTable
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Constructor takes initial table size, the maximum load factor before the table is resized
+	// and the number of slots to move per operation when resizing. The size is rounded up to a
+	// power of 2. Robin Hood probing copes well with high load factors, but the default is kept
+	// the same as CHashTable
+	CFlatHashTable
+	(
+		const TUInt32  iInitialSize,          // Initial size for the hash table (number of slots)
+		const TFloat32 fMaxLoadFactor = 0.7f, // Maximum load factor
+		const TUInt32  iResizeStep = 0        // Slots moved per operation, 0 to resize in one go
+	) : m_kiResizeStep( iResizeStep ), m_kfMaxLoadFactor( fMaxLoadFactor )
+	{
+		GEN_GUARD;
+
+		// Allocate initial slot array, all slots empty
+		m_iSize = HashTableSize( iInitialSize );
+		m_aSlots = new TSlot[m_iSize];
+		GEN_ASSERT( m_aSlots, "Fatal memory error reserving hash table memory" );
+
+		// Starting with no hash table entries and not resizing
+		m_iNumEntries = 0;
+		m_aOldSlots = 0;
+		m_iOldSize = 0;
+		m_iNextOldSlot = 0;
+		m_iMaxResizeMoves = 0;
+		m_iNumResizes = 0;
+
+		GEN_ENDGUARD;
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CFlatHashTable( const CFlatHashTable& );
+	CFlatHashTable& operator=( const CFlatHashTable& );
+
+public:
+	// Destructor to free hash table memory
+	~CFlatHashTable()
+	{
+		delete[] m_aSlots;
+		delete[] m_aOldSlots;
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Looks up value associated with given key and puts in in given pointer. Returns true if
+	// the key was found
+	bool LookUpKey
+	(
+		const TKeyType& key,
+		TValueType*     pValue
+	) const
+	{
+		const TSlot* pSlot = FindSlot( key );
+		if (!pSlot)
+		{
+			return false;
+		}
+
+		// Found key, copy its value out and return true
+		*pValue = pSlot->value;
+		return true;
+	}
+
+
+	// Add the given key-value pair to the table, if the key already exists, just update its value
+	void SetKeyValue
+	(
+		const TKeyType&   key,
+		const TValueType& value
+	)
+	{
+		// Continue any resize in progress
+		ResizeStep();
+
+		// If key already exists, simply update the value associated with it
+		TSlot* pSlot = FindSlot( key );
+		if (pSlot)
+		{
+			pSlot->value = value;
+			return;
+		}
+
+		// Check loading of table - if too full, then double it in size. There must always be an
+		// empty slot left to end the probe, whatever the load factor
+		if (m_iNumEntries + 1 > m_iSize * m_kfMaxLoadFactor || m_iNumEntries + 1 >= m_iSize)
+		{
+			Resize( m_iSize * 2 );
+		}
+
+		// New keys always go in the new slot array if resizing
+		InsertNewKey( key, value );
+		++m_iNumEntries;
+	}
+
+
+	// Remove the given key (and associated value) from the table, returns false if not found
+	bool RemoveKey( const TKeyType& key )
+	{
+		// Continue any resize in progress
+		ResizeStep();
+
+		TUInt32 iSlot = FindSlot( m_aSlots, m_iSize, key );
+		if (iSlot != kNotFound)
+		{
+			RemoveSlot( m_aSlots, m_iSize, iSlot );
+		}
+		else
+		{
+			// Keys not yet moved are still in the old slot array
+			if (m_aOldSlots)
+			{
+				iSlot = FindSlot( m_aOldSlots, m_iOldSize, key );
+			}
+			if (iSlot == kNotFound)
+			{
+				m_Counters.CountLookUp( false );
+				return false;
+			}
+			RemoveSlot( m_aOldSlots, m_iOldSize, iSlot );
+		}
+		m_Counters.CountLookUp( true );
+
+		// Decrease number of table entries - note that table is never resized downwards
+		--m_iNumEntries;
+
+		return true;
+	}
+
+
+	// Remove all keys and associated values
+	void RemoveAllKeys()
+	{
+		for (TUInt32 iSlot = 0; iSlot < m_iSize; ++iSlot)
+		{
+			m_aSlots[iSlot].iProbe = 0;
+		}
+		m_iNumEntries = 0;
+
+		// Any resize in progress is complete - there is nothing left to move
+		delete[] m_aOldSlots;
+		m_aOldSlots = 0;
+	}
+
+
+	// Whether the table is part way through an incremental resize
+	bool IsResizing() const
+	{
+		return m_aOldSlots != 0;
+	}
+
+	// Largest number of key/value pairs moved between slot arrays by a single operation. This is
+	// the worst case resize cost of an insert or remove, so it shows whether the resize step is
+	// small enough. Without incremental resizing it is the largest table that has been resized
+	TUInt32 GetMaxResizeMoves() const
+	{
+		return m_iMaxResizeMoves;
+	}
+
+
+	// Fill in a report on the table - occupancy, probe lengths and look-up counters (if enabled)
+	void GetStats( SHashTableStats* pStats ) const
+	{
+		pStats->iSize = m_iSize;
+		pStats->iNumEntries = m_iNumEntries;
+		pStats->fLoadFactor = static_cast<TFloat32>(m_iNumEntries) / m_iSize;
+		pStats->iNumResizes = m_iNumResizes;
+		pStats->iMaxResizeMoves = m_iMaxResizeMoves;
+
+		// Histogram of probe lengths, including keys not yet moved by a resize in progress
+		pStats->szHistogram = "probe_length";
+		pStats->aiHistogram.clear();
+		AddProbeLengths( m_aSlots, m_iSize, &pStats->aiHistogram );
+		if (m_aOldSlots)
+		{
+			AddProbeLengths( m_aOldSlots, m_iOldSize, &pStats->aiHistogram );
+		}
+
+		m_Counters.GetCounts( pStats );
+	}
+
+	// Reset the look-up counters
+	void ResetStats()
+	{
+		m_Counters.Reset();
+	}
+
+
+	// Output a table illustrating the probe length of each used slot - how many slots past its
+	// home slot each key is stored. Ideally this is 0 for almost every key, '.' marks empty slots
+	void OutputDistribution() const
+	{
+		cout << "Hash Table Distribution:" << endl << endl;
+
+		TUInt32 iTotalProbe = 0;
+		TUInt32 iMaxProbe = 0;
+		for (TUInt32 iSlot = 0; iSlot < m_iSize; ++iSlot)
+		{
+			if (m_aSlots[iSlot].iProbe == 0)
+			{
+				cout << '.';
+				continue;
+			}
+
+			TUInt32 iProbe = m_aSlots[iSlot].iProbe - 1;
+			if (iProbe < 10)
+			{
+				cout << iProbe;
+			}
+			else
+			{
+				cout << '+'; // Output '+' for 10 or more
+			}
+			iTotalProbe += iProbe;
+			if (iProbe > iMaxProbe)
+			{
+				iMaxProbe = iProbe;
+			}
+		}
+		cout << endl << "% used slots: " << 100.0f * static_cast<float>(m_iNumEntries) / m_iSize;
+		if (m_iNumEntries > 0)
+		{
+			cout << endl << "Average probe length: "
+			     << static_cast<float>(iTotalProbe) / m_iNumEntries;
+		}
+		cout << endl << "Maximum probe length: " << iMaxProbe << endl;
+		cout << endl;
+	}
+
+/*-----------------------------------------------------------------------------------------
+	Private interface
+-----------------------------------------------------------------------------------------*/
+private:
+
+	/*---------------------------------------------------------------------------------------------
+		Types
+	---------------------------------------------------------------------------------------------*/
+
+	// A slot in the table. The probe value is 0 for an empty slot, otherwise 1 + the distance of
+	// the slot from the key's home slot. Kept with the key so a probe touches a single slot
+	struct TSlot
+	{
+		TKeyType   key;
+		TValueType value;
+		TUInt32    iProbe;
+
+		TSlot() : iProbe( 0 ) {}
+	};
+
+	// Returned by FindSlot when the key is not in the table
+	static const TUInt32 kNotFound = 0xffffffff;
+
+
+	/*---------------------------------------------------------------------------------------------
+		Support functions
+	---------------------------------------------------------------------------------------------*/
+
+	// Find the home slot for the given key in a slot array of the given size - the slot it is
+	// stored in if there are no collisions
+	TUInt32 HomeSlot
+	(
+		const TKeyType& key,
+		const TUInt32   iTableSize
+	) const
+	{
+		return THashTraits::Hash( key ) & (iTableSize - 1);
+	}
+
+	// Slot after the given one, wrapping at the end of the array
+	TUInt32 NextSlot
+	(
+		const TUInt32 iSlot,
+		const TUInt32 iTableSize
+	) const
+	{
+		return (iSlot + 1) & (iTableSize - 1);
+	}
+
+
+	// Find the slot holding the given key in the given slot array, returns kNotFound if the key
+	// is not there
+	TUInt32 FindSlot
+	(
+		const TSlot*    aSlots,
+		const TUInt32   iTableSize,
+		const TKeyType& key
+	) const
+	{
+		TUInt32 iSlot = HomeSlot( key, iTableSize );
+		TUInt32 iProbe = 1;
+
+		// Robin Hood ordering means that once we meet a key closer to its home slot than we are
+		// to ours (or an empty slot, probe 0), our key cannot be further along
+		while (aSlots[iSlot].iProbe >= iProbe)
+		{
+			if (aSlots[iSlot].iProbe == iProbe && key == aSlots[iSlot].key)
+			{
+				m_Counters.CountProbes( iProbe );
+				return iSlot;
+			}
+			iSlot = NextSlot( iSlot, iTableSize );
+			++iProbe;
+		}
+		m_Counters.CountProbes( iProbe );
+		return kNotFound;
+	}
+
+	// Find the slot holding the given key, looking in the old slot array too if a resize is in
+	// progress. Returns 0 if the key is not in the table
+	TSlot* FindSlot( const TKeyType& key ) const
+	{
+		TUInt32 iSlot = FindSlot( m_aSlots, m_iSize, key );
+		if (iSlot != kNotFound)
+		{
+			m_Counters.CountLookUp( true );
+			return &m_aSlots[iSlot];
+		}
+		if (m_aOldSlots)
+		{
+			iSlot = FindSlot( m_aOldSlots, m_iOldSize, key );
+			if (iSlot != kNotFound)
+			{
+				m_Counters.CountLookUp( true );
+				return &m_aOldSlots[iSlot];
+			}
+		}
+		m_Counters.CountLookUp( false );
+		return 0;
+	}
+
+
+	// Insert a key known not to be in the table into the current slot array, there must be at
+	// least one empty slot. Does not update the number of entries
+	void InsertNewKey
+	(
+		const TKeyType&   key,
+		const TValueType& value
+	)
+	{
+		TSlot newSlot;
+		newSlot.key = key;
+		newSlot.value = value;
+		newSlot.iProbe = 1;
+
+		TUInt32 iSlot = HomeSlot( key, m_iSize );
+		while (m_aSlots[iSlot].iProbe != 0)
+		{
+			// Take the place of any key closer to home than the one being inserted, and carry on
+			// to find a new slot for the displaced key instead
+			if (m_aSlots[iSlot].iProbe < newSlot.iProbe)
+			{
+				TSlot displaced = m_aSlots[iSlot];
+				m_aSlots[iSlot] = newSlot;
+				newSlot = displaced;
+			}
+			iSlot = NextSlot( iSlot, m_iSize );
+			++newSlot.iProbe;
+		}
+		m_aSlots[iSlot] = newSlot;
+	}
+
+
+	// Empty a used slot of the given slot array. Does not update the number of entries
+	void RemoveSlot
+	(
+		TSlot*        aSlots,
+		const TUInt32 iTableSize,
+		TUInt32       iSlot
+	)
+	{
+		// Backward shift deletion: move each following key that is not in its home slot back by
+		// one, stopping at an empty slot or a key already at home. This leaves the slots exactly
+		// as if the removed key had never been inserted
+		TUInt32 iNext = NextSlot( iSlot, iTableSize );
+		while (aSlots[iNext].iProbe > 1)
+		{
+			aSlots[iSlot].key = aSlots[iNext].key;
+			aSlots[iSlot].value = aSlots[iNext].value;
+			aSlots[iSlot].iProbe = aSlots[iNext].iProbe - 1;
+			iSlot = iNext;
+			iNext = NextSlot( iNext, iTableSize );
+		}
+		aSlots[iSlot].iProbe = 0;
+	}
+
+
+	// Resize the hash table. Without a resize step all keys are moved to the new slot array now,
+	// otherwise the old slot array is kept and its slots are moved a few at a time by each insert
+	// or remove (ResizeStep). A resize still in progress is completed first
+	void Resize( const TUInt32 iNewSize )
+	{
+		GEN_GUARD;
+
+		if (m_aOldSlots)
+		{
+			MoveOldSlots( m_iOldSize );
+		}
+
+		// Current slots become the old slot array and a new set of empty slots is created
+		++m_iNumResizes;
+		m_aOldSlots = m_aSlots;
+		m_iOldSize = m_iSize;
+		m_iNextOldSlot = 0;
+		m_iSize = iNewSize;
+		m_aSlots = new TSlot[m_iSize];
+		GEN_ASSERT( m_aSlots, "Fatal memory error reserving hash table memory" );
+
+		if (m_kiResizeStep == 0)
+		{
+			MoveOldSlots( m_iOldSize );
+		}
+
+		GEN_ENDGUARD;
+	}
+
+	// Add the probe length of each used slot in the given slot array to a histogram
+	void AddProbeLengths
+	(
+		const TSlot*     aSlots,
+		const TUInt32    iTableSize,
+		vector<TUInt32>* paiHistogram
+	) const
+	{
+		for (TUInt32 iSlot = 0; iSlot < iTableSize; ++iSlot)
+		{
+			if (aSlots[iSlot].iProbe != 0)
+			{
+				TUInt32 iProbe = aSlots[iSlot].iProbe - 1;
+				if (iProbe >= paiHistogram->size())
+				{
+					paiHistogram->resize( iProbe + 1, 0 );
+				}
+				++(*paiHistogram)[iProbe];
+			}
+		}
+	}
+
+	// Move the next few slots of the old slot array to the new one if a resize is in progress
+	void ResizeStep()
+	{
+		if (m_aOldSlots)
+		{
+			MoveOldSlots( m_kiResizeStep );
+		}
+	}
+
+	// Move up to the given number of slots from the old slot array to the new one, deleting the
+	// old array when all have been moved. Each key is removed from the old array as it is moved,
+	// which shifts the rest of its cluster back, so all keys whose home slot is before the next
+	// old slot have been moved and look-ups in the old array still work
+	void MoveOldSlots( const TUInt32 iNumSlots )
+	{
+		TUInt32 iMoves = 0;
+		TUInt32 iLastSlot = m_iNextOldSlot + iNumSlots;
+		if (iLastSlot > m_iOldSize)
+		{
+			iLastSlot = m_iOldSize;
+		}
+		for (; m_iNextOldSlot < iLastSlot; ++m_iNextOldSlot)
+		{
+			while (m_aOldSlots[m_iNextOldSlot].iProbe != 0)
+			{
+				InsertNewKey( m_aOldSlots[m_iNextOldSlot].key, m_aOldSlots[m_iNextOldSlot].value );
+				RemoveSlot( m_aOldSlots, m_iOldSize, m_iNextOldSlot );
+				++iMoves;
+			}
+		}
+		if (iMoves > m_iMaxResizeMoves)
+		{
+			m_iMaxResizeMoves = iMoves;
+		}
+
+		if (m_iNextOldSlot == m_iOldSize)
+		{
+			delete[] m_aOldSlots;
+			m_aOldSlots = 0;
+		}
+	}
+
+
+	/*---------------------------------------------------------------------------------------------
+		Data
+	---------------------------------------------------------------------------------------------*/
+
+	TSlot*  m_aSlots;      // Dynamically allocated array of slots
+	TUInt32 m_iSize;       // Size (capacity) of the table - number of slots
+	TUInt32 m_iNumEntries; // Number of key/value pairs in the table (in both arrays if resizing)
+
+	// While resizing incrementally the previous slots are kept until all their key/value pairs
+	// have been moved to the new slots. Slots before the next old slot are empty
+	TSlot*  m_aOldSlots;       // Previous slot array, 0 when not resizing
+	TUInt32 m_iOldSize;        // Number of previous slots
+	TUInt32 m_iNextOldSlot;    // Next previous slot to move
+	TUInt32 m_iMaxResizeMoves; // Most key/value pairs moved by one operation
+	TUInt32 m_iNumResizes;     // Number of times the table has grown
+
+	// Look-up counters, empty unless statistics are enabled. Look-ups are logically const
+	mutable CHashCounters<kbStats> m_Counters;
+
+	// Number of old slots moved by each insert or remove while resizing, if 0 the table is
+	// resized all in one go
+	const TUInt32 m_kiResizeStep;
+
+	// If table becomes too full, then it is increased in size. The max load factor defines how
+	// full it needs to be before this happens. The table is never decreased in size
+	const TFloat32 m_kfMaxLoadFactor;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_FLAT_HASH_TABLE_H_INCLUDED
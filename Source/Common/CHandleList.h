@@ -0,0 +1,154 @@
+/**************************************************************************************************
+	Module:       CHandleList.h
+
+	List of handles (see CHandleTable.h) to a group of objects, e.g. all the objects of a kind, in
+	the order they were added. Freed objects are not taken out of the list one at a time, which
+	would move the rest of the list down each time. Instead the list counts them and a single
+	compaction later takes out every handle that is no longer valid, keeping the others in order
+
+	Code stepping through the list registers as a reader. Compaction is put off while there are
+	readers, so a reader's position in the list is never invalidated - it skips freed objects
+**************************************************************************************************/
+
+#ifndef GEN_C_HANDLE_LIST_H_INCLUDED
+#define GEN_C_HANDLE_LIST_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	CHandleList class
+---------------------------------------------------------------------------------------------*/
+
+class CHandleList
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Constructor creates an empty list
+	CHandleList() : m_iNumRemoved( 0 ), m_iNumReaders( 0 ) {}
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Add a handle to the end of the list
+	void Add( const TUInt32 hHandle )
+	{
+		m_Handles.push_back( hHandle );
+	}
+
+	// Note that the object of one of the handles in the list has been freed. Returns true for the
+	// first removal since the list was last compacted, so the caller can keep track of the lists
+	// needing compaction
+	bool NoteRemoval()
+	{
+		return m_iNumRemoved++ == 0;
+	}
+
+	// Take out the handles that are no longer valid in the given table (anything with an IsValid
+	// function taking a handle), keeping the others in order. Returns false, doing nothing, if
+	// there are readers
+	template <class THandleTable>
+	bool Compact( const THandleTable& table )
+	{
+		if (m_iNumReaders)
+		{
+			return false;
+		}
+		TUInt32 iNumKept = 0;
+		for (TUInt32 iHandle = 0; iHandle < m_Handles.size(); ++iHandle)
+		{
+			if (table.IsValid( m_Handles[iHandle] ))
+			{
+				m_Handles[iNumKept++] = m_Handles[iHandle];
+			}
+		}
+		m_Handles.resize( iNumKept );
+		m_iNumRemoved = 0;
+		return true;
+	}
+
+	// Empty the list, there must be no readers
+	void Clear()
+	{
+		m_Handles.clear();
+		m_iNumRemoved = 0;
+	}
+
+
+	// Number of handles in the list, including freed ones not yet compacted out
+	TUInt32 GetSize() const
+	{
+		return static_cast<TUInt32>(m_Handles.size());
+	}
+
+	// Number of freed objects noted since the list was last compacted
+	TUInt32 GetNumRemoved() const
+	{
+		return m_iNumRemoved;
+	}
+
+	// Whether at least half the list is freed objects
+	bool IsMostlyRemoved() const
+	{
+		return m_iNumRemoved * 2 >= m_Handles.size();
+	}
+
+	// Return the handle at the given position
+	TUInt32 operator[]( const TUInt32 iPos ) const
+	{
+		return m_Handles[iPos];
+	}
+
+	// Access to the handles to reorder them, e.g. to sort them. Handles must not be added or
+	// removed this way
+	vector<TUInt32>& Handles()
+	{
+		return m_Handles;
+	}
+
+	// Memory reserved for the handles in bytes
+	TUInt32 GetMemory() const
+	{
+		return static_cast<TUInt32>(m_Handles.capacity() * sizeof(TUInt32));
+	}
+
+
+	// Register / unregister code stepping through the list, compaction waits until there are no
+	// readers
+	void OpenReader()
+	{
+		++m_iNumReaders;
+	}
+	void CloseReader()
+	{
+		--m_iNumReaders;
+	}
+	bool HasReaders() const
+	{
+		return m_iNumReaders != 0;
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	vector<TUInt32> m_Handles;
+	TUInt32         m_iNumRemoved;
+	TUInt32         m_iNumReaders;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_HANDLE_LIST_H_INCLUDED
@@ -0,0 +1,170 @@
+/**************************************************************************************************
+	Module:       CHandleTable.h
+
+	Table of generational handles to objects kept in a packed array. A handle is a 32-bit value
+	whose low bits select a slot in the table and whose high bits are a generation count. The slot
+	holds the handle it currently belongs to and the index of the object in the caller's array, so
+	looking a handle up is one array read and one compare - no hashing and no probing
+
+	Freeing a handle increases the generation count of its slot before the slot is reused, so a
+	freed handle never matches its slot again (until the count wraps round after 4096 reuses of
+	the same slot). Each slot can also carry data of the caller's choosing
+**************************************************************************************************/
+
+#ifndef GEN_C_HANDLE_TABLE_H_INCLUDED
+#define GEN_C_HANDLE_TABLE_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+#include "Error.h"
+
+namespace gen
+{
+
+// Handles have 20 bits of slot index, allowing just over a million objects. A slot index of all
+// 1s is never used, so kiNoHandle is never a valid handle
+const TUInt32 kiHandleSlotBits = 20;
+const TUInt32 kiHandleSlotMask = (1 << kiHandleSlotBits) - 1;
+const TUInt32 kiNoHandle = 0xffffffff;
+
+
+/*---------------------------------------------------------------------------------------------
+	CHandleTable class
+---------------------------------------------------------------------------------------------*/
+
+// TSlotData is held in every slot, used or not, so must be default constructible. It is not
+// cleared when a slot is reused
+template <class TSlotData>
+class CHandleTable
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Constructor takes the number of slots to reserve memory for
+	CHandleTable( const TUInt32 iInitialSlots = 0 )
+	{
+		m_Slots.reserve( iInitialSlots );
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CHandleTable( const CHandleTable& );
+	CHandleTable& operator=( const CHandleTable& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Get a handle for an object at the given index in the caller's array. Reuses the most
+	// recently freed slot if there is one, otherwise adds a slot, whose first handle is just its
+	// index - so the first handles issued are 0, 1, 2...
+	TUInt32 New( const TUInt32 iIndex )
+	{
+		TUInt32 hHandle = Reserve();
+		Activate( hHandle, iIndex );
+		return hHandle;
+	}
+
+	// Get a handle without making it valid, e.g. for an object that will be created later. Use
+	// Activate to make it valid or Free to give it back
+	TUInt32 Reserve()
+	{
+		TUInt32 hHandle;
+		if (!m_FreeHandles.empty())
+		{
+			hHandle = m_FreeHandles.back();
+			m_FreeHandles.pop_back();
+		}
+		else
+		{
+			GEN_ASSERT( m_Slots.size() < kiHandleSlotMask, "Too many handles" );
+			hHandle = static_cast<TUInt32>(m_Slots.size());
+			m_Slots.push_back( SSlot() );
+		}
+		m_Slots[hHandle & kiHandleSlotMask].hHandle = kiNoHandle;
+		return hHandle;
+	}
+
+	// Make a reserved handle valid, pointing at the given index
+	void Activate( const TUInt32 hHandle, const TUInt32 iIndex )
+	{
+		SSlot& slot = m_Slots[hHandle & kiHandleSlotMask];
+		slot.hHandle = hHandle;
+		slot.iIndex = iIndex;
+	}
+
+	// Free a valid or reserved handle, future look-ups of it will fail. The slot's next handle
+	// has the generation count increased
+	void Free( const TUInt32 hHandle )
+	{
+		m_Slots[hHandle & kiHandleSlotMask].hHandle = kiNoHandle;
+		m_FreeHandles.push_back( hHandle + (1 << kiHandleSlotBits) );
+	}
+
+
+	// Return whether the handle is valid, i.e. issued and not freed since
+	bool IsValid( const TUInt32 hHandle ) const
+	{
+		TUInt32 iSlot = hHandle & kiHandleSlotMask;
+		return iSlot < m_Slots.size() && m_Slots[iSlot].hHandle == hHandle;
+	}
+
+	// Return / set the index of the object with the given valid handle
+	TUInt32 GetIndex( const TUInt32 hHandle ) const
+	{
+		return m_Slots[hHandle & kiHandleSlotMask].iIndex;
+	}
+	void SetIndex( const TUInt32 hHandle, const TUInt32 iIndex )
+	{
+		m_Slots[hHandle & kiHandleSlotMask].iIndex = iIndex;
+	}
+
+	// Return the data of the slot of a valid or reserved handle
+	TSlotData& Data( const TUInt32 hHandle )
+	{
+		return m_Slots[hHandle & kiHandleSlotMask].data;
+	}
+	const TSlotData& Data( const TUInt32 hHandle ) const
+	{
+		return m_Slots[hHandle & kiHandleSlotMask].data;
+	}
+
+
+	// Number of slots in the table, used or free
+	TUInt32 GetNumSlots() const
+	{
+		return static_cast<TUInt32>(m_Slots.size());
+	}
+
+	// Number of free slots waiting to be reused
+	TUInt32 GetNumFreeSlots() const
+	{
+		return static_cast<TUInt32>(m_FreeHandles.size());
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	struct SSlot
+	{
+		TUInt32   hHandle; // Handle using this slot, kiNoHandle if the slot is free or reserved
+		TUInt32   iIndex;  // Index of the object in the caller's array
+		TSlotData data;
+	};
+	vector<SSlot> m_Slots;
+
+	// Handles to use for free slots, already with the next generation
+	vector<TUInt32> m_FreeHandles;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_HANDLE_TABLE_H_INCLUDED
@@ -3,14 +3,16 @@
 	Author:       Laurent Noel
 
 	Hash table class storing keys and associated values, supporting quick lookup of a value for a
-	given a key. A hashing function is needed for the mapping and can be specified through the
-	constructor
+	given a key. A hashing function is needed for the mapping and comes from the hash traits
+	template parameter, which by default picks a suitable hash for the key type
 
 	See header file for further notes
 
 	Copyright 2007, University of Central Lancashire and Laurent Noel
 **************************************************************************************************/
 
+#include <string.h>
+
 #include "CHashTable.h"
 
 namespace gen
@@ -56,4 +58,130 @@ TUInt32 JOneAtATimeHash( const TUInt8* pKey, const TUInt32 iKeyLen )
 }
 
 
+// Hashing function for longer keys, based on the xxHash64 rounds. Each step mixes a 64-bit word of
+// the key into one of four independent lanes, so there is no dependency from one word to the next
+// within a 32 byte block. Remaining words and bytes are mixed into a single lane at the end
+namespace
+{
+	const TUInt64 kPrime1 = 0x9e3779b185ebca87ull;
+	const TUInt64 kPrime2 = 0xc2b2ae3d27d4eb4full;
+	const TUInt64 kPrime3 = 0x165667b19e3779f9ull;
+
+	inline TUInt64 RotateLeft( const TUInt64 iValue, const int iBits )
+	{
+		return (iValue << iBits) | (iValue >> (64 - iBits));
+	}
+
+	inline TUInt64 ReadWord( const TUInt8* pData )
+	{
+		TUInt64 iWord;
+		memcpy( &iWord, pData, sizeof(iWord) ); // Key data may not be aligned
+		return iWord;
+	}
+
+	inline TUInt64 HashRound( const TUInt64 iLane, const TUInt64 iWord )
+	{
+		return RotateLeft( iLane + iWord * kPrime2, 31 ) * kPrime1;
+	}
+}
+
+TUInt32 BlockHash( const TUInt8* pKey, const TUInt32 iKeyLen )
+{
+	const TUInt8* pEnd = pKey + iKeyLen;
+	TUInt64 iHash;
+
+	if (iKeyLen >= 32)
+	{
+		TUInt64 aLanes[4] = { kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1 };
+		while (pEnd - pKey >= 32)
+		{
+			aLanes[0] = HashRound( aLanes[0], ReadWord( pKey ) );
+			aLanes[1] = HashRound( aLanes[1], ReadWord( pKey + 8 ) );
+			aLanes[2] = HashRound( aLanes[2], ReadWord( pKey + 16 ) );
+			aLanes[3] = HashRound( aLanes[3], ReadWord( pKey + 24 ) );
+			pKey += 32;
+		}
+		iHash = RotateLeft( aLanes[0], 1 ) + RotateLeft( aLanes[1], 7 ) +
+		        RotateLeft( aLanes[2], 12 ) + RotateLeft( aLanes[3], 18 );
+	}
+	else
+	{
+		iHash = kPrime3;
+	}
+	iHash += iKeyLen;
+
+	while (pEnd - pKey >= 8)
+	{
+		iHash ^= HashRound( 0, ReadWord( pKey ) );
+		iHash = RotateLeft( iHash, 27 ) * kPrime1 + kPrime2;
+		pKey += 8;
+	}
+	while (pKey < pEnd)
+	{
+		iHash ^= *pKey * kPrime3;
+		iHash = RotateLeft( iHash, 11 ) * kPrime1;
+		++pKey;
+	}
+
+	// Final mix so every bit of the key affects the low bits used as a table index
+	return MixHash( iHash );
+}
+
+
+
+/*------------------------------------------------------------------------------------------------
+	Statistics
+ ------------------------------------------------------------------------------------------------*/
+
+// Write the report as a single JSON object
+void SHashTableStats::WriteJSON( ostream& out ) const
+{
+	out << "{ \"size\": " << iSize
+	    << ", \"entries\": " << iNumEntries
+	    << ", \"load_factor\": " << fLoadFactor
+	    << ", \"resizes\": " << iNumResizes
+	    << ", \"max_resize_moves\": " << iMaxResizeMoves
+	    << ", \"histogram_type\": \"" << szHistogram << "\""
+	    << ", \"histogram\": [";
+	for (TUInt32 i = 0; i < aiHistogram.size(); ++i)
+	{
+		out << (i ? ", " : "") << aiHistogram[i];
+	}
+	out << "]";
+	if (bCounted)
+	{
+		out << ", \"lookups\": " << iLookUps
+		    << ", \"hits\": " << iHits
+		    << ", \"misses\": " << iMisses
+		    << ", \"probes\": " << iProbes
+		    << ", \"average_probes\": " << fAverageProbes;
+	}
+	out << " }" << endl;
+}
+
+// Write the report as CSV, one "name,value" line per value with a header line first
+void SHashTableStats::WriteCSV( ostream& out ) const
+{
+	out << "name,value" << endl;
+	out << "size," << iSize << endl;
+	out << "entries," << iNumEntries << endl;
+	out << "load_factor," << fLoadFactor << endl;
+	out << "resizes," << iNumResizes << endl;
+	out << "max_resize_moves," << iMaxResizeMoves << endl;
+	out << "histogram_type," << szHistogram << endl;
+	for (TUInt32 i = 0; i < aiHistogram.size(); ++i)
+	{
+		out << "histogram_" << i << "," << aiHistogram[i] << endl;
+	}
+	if (bCounted)
+	{
+		out << "lookups," << iLookUps << endl;
+		out << "hits," << iHits << endl;
+		out << "misses," << iMisses << endl;
+		out << "probes," << iProbes << endl;
+		out << "average_probes," << fAverageProbes << endl;
+	}
+}
+
+
 } // namespace gen
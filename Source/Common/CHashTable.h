@@ -3,7 +3,8 @@
 	Author:       Laurent Noel
 
 	Hash table class storing keys and associated values, supporting quick lookup of a value for a
-	given a key. A hashing function is needed for the mapping and is specified for the constructor
+	given a key. A hashing function is needed for the mapping and is specified by a hash traits
+	template parameter, which by default picks a suitable hash for the key type
 	
 	This is a template class, which allows any types for keys and values. E.g. to implement entity
 	UIDs the key is an integer (the UID), and the value is an entity pointer. For a phonebook, the
@@ -20,6 +21,7 @@
 #include <math.h>
 #include <iostream>
 #include <list>
+#include <vector>
 using namespace std;
 
 #include "Defines.h"
@@ -46,6 +48,212 @@ TUInt32 AddUpHash( const TUInt8* pKey, const TUInt32 iKeyLen );
 // distribution of indexes (few collisions)
 TUInt32 JOneAtATimeHash( const TUInt8* pKey, const TUInt32 iKeyLen );
 
+// Hashing function for longer keys - works on 32 bytes at a time in four independent 64-bit
+// lanes (which the compiler can overlap or vectorise), rather than one byte at a time
+TUInt32 BlockHash( const TUInt8* pKey, const TUInt32 iKeyLen );
+
+
+// Integer mixing functions - every bit of the key affects every bit of the hash, so the low bits
+// alone can be used as an index (see power-of-2 table sizes below)
+inline TUInt32 MixHash( TUInt32 iKey )
+{
+	iKey ^= iKey >> 16;
+	iKey *= 0x85ebca6b;
+	iKey ^= iKey >> 13;
+	iKey *= 0xc2b2ae35;
+	iKey ^= iKey >> 16;
+	return iKey;
+}
+
+inline TUInt32 MixHash( TUInt64 iKey )
+{
+	iKey ^= iKey >> 33;
+	iKey *= 0xff51afd7ed558ccdull;
+	iKey ^= iKey >> 33;
+	iKey *= 0xc4ceb9fe1a85ec53ull;
+	iKey ^= iKey >> 33;
+	return static_cast<TUInt32>(iKey);
+}
+
+
+/*------------------------------------------------------------------------------------------------
+	Hash traits
+ ------------------------------------------------------------------------------------------------*/
+
+// The hash tables take a hash traits class as a template parameter, giving the hashing function
+// to use for the key type as a static Hash function. The function is chosen at compile time, so
+// it is called directly (and usually inlined) rather than through a function pointer.
+//
+// By default keys are hashed as a sequence of raw bytes, but the traits are specialised for
+// integers (mixed directly) and strings (the characters are hashed, not the string object, which
+// contains pointers). Specialise CHashTraits for any other key type that contains pointers
+template <class TKeyType>
+struct CHashTraits
+{
+	static TUInt32 Hash( const TKeyType& key )
+	{
+		const TUInt8* pKeyData = reinterpret_cast<const TUInt8*>(&key);
+		return sizeof(TKeyType) < 16 ? JOneAtATimeHash( pKeyData, sizeof(TKeyType) ) :
+		                               BlockHash( pKeyData, sizeof(TKeyType) );
+	}
+};
+
+template <> struct CHashTraits<TUInt32>
+{
+	static TUInt32 Hash( const TUInt32 key ) { return MixHash( key ); }
+};
+
+template <> struct CHashTraits<TInt32>
+{
+	static TUInt32 Hash( const TInt32 key ) { return MixHash( static_cast<TUInt32>(key) ); }
+};
+
+template <> struct CHashTraits<TUInt64>
+{
+	static TUInt32 Hash( const TUInt64 key ) { return MixHash( key ); }
+};
+
+template <> struct CHashTraits<TInt64>
+{
+	static TUInt32 Hash( const TInt64 key ) { return MixHash( static_cast<TUInt64>(key) ); }
+};
+
+template <> struct CHashTraits<string>
+{
+	static TUInt32 Hash( const string& key )
+	{
+		return BlockHash( reinterpret_cast<const TUInt8*>(key.data()), static_cast<TUInt32>(key.length()) );
+	}
+};
+
+// Pointer keys are hashed by address
+template <class TPointedType>
+struct CHashTraits<TPointedType*>
+{
+	static TUInt32 Hash( TPointedType* const key )
+	{
+		return MixHash( static_cast<TUInt64>(reinterpret_cast<size_t>(key)) );
+	}
+};
+
+// Traits to hash keys as raw bytes with one of the hashing functions above, e.g.
+// CHashTable<TEntityUID, TUInt32, CByteHashTraits<TEntityUID, JOneAtATimeHash> >
+template <class TKeyType, THashFunction pfHashFunction>
+struct CByteHashTraits
+{
+	static TUInt32 Hash( const TKeyType& key )
+	{
+		return pfHashFunction( reinterpret_cast<const TUInt8*>(&key), sizeof(TKeyType) );
+	}
+};
+
+
+// Hash tables sizes are kept to powers of 2 so a hash is converted to an index with a bitwise and
+// rather than the (much slower) integer modulus operator. Returns the smallest power of 2 that is
+// at least the given size
+inline TUInt32 HashTableSize( const TUInt32 iMinSize )
+{
+	TUInt32 iSize = 1;
+	while (iSize < iMinSize)
+	{
+		iSize <<= 1;
+	}
+	return iSize;
+}
+
+
+/*------------------------------------------------------------------------------------------------
+	Statistics
+ ------------------------------------------------------------------------------------------------*/
+
+// Report of the occupancy and performance of a hash table, filled in by GetStats on the tables.
+// Can be written out as JSON or CSV to tune table sizes and hash functions from real runs
+struct SHashTableStats
+{
+	TUInt32  iSize;           // Number of buckets / slots
+	TUInt32  iNumEntries;     // Number of key/value pairs
+	TFloat32 fLoadFactor;     // Entries per bucket / slot
+	TUInt32  iNumResizes;     // Number of times the table has grown
+	TUInt32  iMaxResizeMoves; // Most key/value pairs moved by one operation while resizing
+
+	// Histogram of the table layout, aiHistogram[n] is the number of buckets holding n keys
+	// (CHashTable), or the number of keys stored n slots past their home slot (CFlatHashTable)
+	const char*     szHistogram; // What the histogram counts, "bucket_length" or "probe_length"
+	vector<TUInt32> aiHistogram;
+
+	// Look-up counters, only collected by tables with statistics enabled. Every search for a key
+	// is counted, including those made by SetKeyValue and RemoveKey. Probes are the number of
+	// keys compared, or slots examined
+	bool     bCounted; // False if the table doesn't collect counters (counters below are 0)
+	TUInt64  iLookUps;
+	TUInt64  iHits;
+	TUInt64  iMisses;
+	TUInt64  iProbes;
+	TFloat32 fAverageProbes; // Probes per look-up
+
+	// Write the report as a single JSON object
+	void WriteJSON( ostream& out ) const;
+
+	// Write the report as CSV, one "name,value" line per value with a header line first. The
+	// histogram is written as lines "histogram_<n>,count"
+	void WriteCSV( ostream& out ) const;
+};
+
+
+// Look-up counters kept by the hash tables. The tables take a template flag to enable statistics,
+// when disabled this empty version is used and the counting compiles away to nothing
+template <bool kbEnabled>
+struct CHashCounters
+{
+	void Reset() {}
+	void CountProbes( const TUInt32 /*iProbes*/ ) {}
+	void CountLookUp( const bool /*bHit*/ ) {}
+
+	void GetCounts( SHashTableStats* pStats ) const
+	{
+		pStats->bCounted = false;
+		pStats->iLookUps = pStats->iHits = pStats->iMisses = pStats->iProbes = 0;
+		pStats->fAverageProbes = 0.0f;
+	}
+};
+
+template <>
+struct CHashCounters<true>
+{
+	TUInt64 iLookUps;
+	TUInt64 iHits;
+	TUInt64 iProbes;
+
+	CHashCounters() { Reset(); }
+
+	void Reset()
+	{
+		iLookUps = iHits = iProbes = 0;
+	}
+	void CountProbes( const TUInt32 iNumProbes )
+	{
+		iProbes += iNumProbes;
+	}
+	void CountLookUp( const bool bHit )
+	{
+		++iLookUps;
+		if (bHit)
+		{
+			++iHits;
+		}
+	}
+
+	void GetCounts( SHashTableStats* pStats ) const
+	{
+		pStats->bCounted = true;
+		pStats->iLookUps = iLookUps;
+		pStats->iHits = iHits;
+		pStats->iMisses = iLookUps - iHits;
+		pStats->iProbes = iProbes;
+		pStats->fAverageProbes = iLookUps ? static_cast<TFloat32>(iProbes) / iLookUps : 0.0f;
+	}
+};
+
 
 /*---------------------------------------------------------------------------------------------
 	CHashTable class
@@ -63,10 +271,14 @@ TUInt32 JOneAtATimeHash( const TUInt8* pKey, const TUInt32 iKeyLen );
 // (keys and values are STL strings) - these are standard types have both == and = defined.
 // However, in other cases we may need to implement/overload the == and = operators or the
 // class would not compile.
-// A further restriction is that keys must not contain pointers (although values can). This is
-// because the hash function treats keys as a sequence of raw bytes, pointers are not followed
-// and the data pointed at will not be hashed
-template <class TKeyType, class TValueType>
+// A further restriction is that keys must not contain pointers (although values can), unless
+// the hash traits for the key type handle them (as they do for strings). This is because the
+// default hash treats keys as a sequence of raw bytes, pointers are not followed and the data
+// pointed at will not be hashed
+//
+// Set kbStats to collect look-up counters for GetStats, at a small cost to every look-up
+template <class TKeyType, class TValueType, class THashTraits = CHashTraits<TKeyType>,
+          bool kbStats = false>
 class CHashTable
 {
 
@@ -74,24 +286,30 @@ class CHashTable
 	Constructors / Destructore
 ---------------------------------------------------------------------------------------------*/
 public:
-	// Constructor takes initial table size, a hashing function, and the maximum load factor
-	// before the table is resized - see data section at end
+	// Constructor takes initial table size, the maximum load factor before the table is resized
+	// and the number of buckets to move per operation when resizing - see data section at end.
+	// The size is rounded up to a power of 2
 	CHashTable
 	(
-		const TUInt32  iInitialSize,         // Initial size for the hash table
-		THashFunction  pfHashFunction,       // Hashing function to use
-		const TFloat32 fMaxLoadFactor = 0.7f // Maximum load factor
-	) : m_kfMaxLoadFactor( fMaxLoadFactor ), m_kpfHashFunction( pfHashFunction )
+		const TUInt32  iInitialSize,          // Initial size for the hash table
+		const TFloat32 fMaxLoadFactor = 0.7f, // Maximum load factor
+		const TUInt32  iResizeStep = 0        // Buckets moved per operation, 0 to resize in one go
+	) : m_kiResizeStep( iResizeStep ), m_kfMaxLoadFactor( fMaxLoadFactor )
 	{
 		GEN_GUARD;
 
 		// Allocate initial hash table array
-		m_iSize = iInitialSize;
+		m_iSize = HashTableSize( iInitialSize );
 		m_aBuckets = new TBucket[m_iSize];
 		GEN_ASSERT( m_aBuckets, "Fatal memory error reserving hash table memory" );
 
-		// Starting with no hash table entries
+		// Starting with no hash table entries and not resizing
 		m_iNumEntries = 0;
+		m_aOldBuckets = 0;
+		m_iOldSize = 0;
+		m_iNextOldBucket = 0;
+		m_iMaxResizeMoves = 0;
+		m_iNumResizes = 0;
 
 		GEN_ENDGUARD;
 	}
@@ -109,6 +327,7 @@ public:
 	~CHashTable()
 	{
 		delete[] m_aBuckets;
+		delete[] m_aOldBuckets;
 	}
 
 
@@ -124,14 +343,9 @@ public:
 		TValueType*     pValue
 	)
 	{
-		// Find the index of the bucket associated with this key (will use hashing function)
-		TUInt32 iBucket = FindBucket( key );
-
-		// Search the bucket to find the the given key
-		TKeyValuePairIter itKeyValuePair = FindKeyValuePair( iBucket, key );
-
-		// Not found (reached end of list), return false
-		if (itKeyValuePair == m_aBuckets[iBucket].end())
+		// Search the bucket associated with this key (will use hashing function)
+		TKeyValuePairIter itKeyValuePair;
+		if (!FindKeyValuePair( key, &itKeyValuePair ))
 		{
 			return false;
 		}
@@ -149,12 +363,12 @@ public:
 		const TValueType& value
 	)
 	{
-		// Find the index of the bucket associated with this key (will use hashing function)
-		TUInt32 iBucket = FindBucket( key );
+		// Continue any resize in progress
+		ResizeStep();
 
-		// See if given key already exists in the bucket 
-		TKeyValuePairIter itKeyValuePair = FindKeyValuePair( iBucket, key );
-		if (itKeyValuePair != m_aBuckets[iBucket].end())
+		// See if given key already exists
+		TKeyValuePairIter itKeyValuePair;
+		if (FindKeyValuePair( key, &itKeyValuePair ))
 		{
 			// If key already exists, simply update the value associated with it
 			itKeyValuePair->value = value;
@@ -165,14 +379,14 @@ public:
 			if (m_iNumEntries > m_iSize * m_kfMaxLoadFactor)
 			{
 				Resize( m_iSize * 2 );
-				iBucket = FindBucket( key ); // Find new bucket for key after resizing
 			}
 
-			// Create a new key/value pair and add it to the list in this bucket
+			// Create a new key/value pair and add it to the list in its bucket (always in the new
+			// table if resizing)
 			TKeyValuePair newPair;
 			newPair.key = key;
 			newPair.value = value;
-			m_aBuckets[iBucket].push_back( newPair );
+			m_aBuckets[FindBucket( key )].push_back( newPair );
 
 			// Increase total number of entries in hash table
 			++m_iNumEntries;
@@ -183,20 +397,21 @@ public:
 	// Remove the given key (and associated value) from the table, returns false if not found
 	bool RemoveKey(	const TKeyType& key )
 	{
-		// Find the index of the bucket associated with this key (will use hashing function)
-		TUInt32 iBucket = FindBucket( key );
+		// Continue any resize in progress
+		ResizeStep();
 
 		// Search the bucket to find the the given key
-		TKeyValuePairIter itKeyValuePair = FindKeyValuePair( iBucket, key );
+		TKeyValuePairIter itKeyValuePair;
+		TBucket* pBucket = FindKeyValuePair( key, &itKeyValuePair );
 
 		// If not found then nothing to do
-		if (itKeyValuePair == m_aBuckets[iBucket].end())
+		if (!pBucket)
 		{   
 			return false;
 		}
 
 		// Remove the found key from the bucket
-		m_aBuckets[iBucket].erase( itKeyValuePair );
+		pBucket->erase( itKeyValuePair );
 
 		// Decrease number of table entries - note that table is never resized downwards
 		--m_iNumEntries; 
@@ -212,6 +427,59 @@ public:
 		{
 			m_aBuckets[iBucket].clear();
 		}
+		m_iNumEntries = 0;
+
+		// Any resize in progress is complete - there is nothing left to move
+		delete[] m_aOldBuckets;
+		m_aOldBuckets = 0;
+	}
+
+
+	// Whether the table is part way through an incremental resize
+	bool IsResizing() const
+	{
+		return m_aOldBuckets != 0;
+	}
+
+	// Largest number of key/value pairs moved between tables by a single operation. This is the
+	// worst case resize cost of an insert or remove, so it shows whether the resize step is small
+	// enough. Without incremental resizing it is the largest table that has been resized
+	TUInt32 GetMaxResizeMoves() const
+	{
+		return m_iMaxResizeMoves;
+	}
+
+
+	// Fill in a report on the table - occupancy, bucket lengths and look-up counters (if enabled)
+	void GetStats( SHashTableStats* pStats ) const
+	{
+		pStats->iSize = m_iSize;
+		pStats->iNumEntries = m_iNumEntries;
+		pStats->fLoadFactor = static_cast<TFloat32>(m_iNumEntries) / m_iSize;
+		pStats->iNumResizes = m_iNumResizes;
+		pStats->iMaxResizeMoves = m_iMaxResizeMoves;
+
+		// Histogram of bucket lengths in the current buckets (keys not yet moved by a resize in
+		// progress are not included)
+		pStats->szHistogram = "bucket_length";
+		pStats->aiHistogram.clear();
+		for (TUInt32 iBucket = 0; iBucket < m_iSize; ++iBucket)
+		{
+			TUInt32 iLength = static_cast<TUInt32>(m_aBuckets[iBucket].size());
+			if (iLength >= pStats->aiHistogram.size())
+			{
+				pStats->aiHistogram.resize( iLength + 1, 0 );
+			}
+			++pStats->aiHistogram[iLength];
+		}
+
+		m_Counters.GetCounts( pStats );
+	}
+
+	// Reset the look-up counters
+	void ResetStats()
+	{
+		m_Counters.Reset();
 	}
 
 
@@ -287,76 +555,161 @@ private:
 		Support functions
 	---------------------------------------------------------------------------------------------*/
 
-	// Find the index of the bucket that should contain the given key
-	TUInt32 FindBucket(	const TKeyType& key	) const
+	// Find the index of the bucket that should contain the given key, for a table of the given size
+	TUInt32 FindBucket
+	(
+		const TKeyType& key,
+		const TUInt32   iTableSize
+	) const
 	{
-		// Get a pointer to the key as raw bytes - this cast is OK for this kind of purpose
-		const TUInt8* pKeyData = reinterpret_cast<const TUInt8*>(&key);
-
-		// Use hashing function to convert key data to a single 4-byte integer
-		TUInt32 iIndex = m_kpfHashFunction( pKeyData, sizeof(TKeyType) );
+		// Use hashing function from the traits to convert key to a single 4-byte integer
+		TUInt32 iIndex = THashTraits::Hash( key );
 		
-		// Convert this 4-byte hash value to a bucket index. We have m_iSize buckets, so just
-		// use the integer modulus operator. Could use faster bitwise operator if number of
-		// buckets was a power of 2, but will deal with the general case here
-		iIndex %= m_iSize;
+		// Convert this 4-byte hash value to a bucket index. The number of buckets is a power of
+		// 2, so the modulus is just the low bits of the hash
+		iIndex &= iTableSize - 1;
 
 		return iIndex;
 	}
 
+	// Find the index of the bucket in the current table that should contain the given key
+	TUInt32 FindBucket( const TKeyType& key ) const
+	{
+		return FindBucket( key, m_iSize );
+	}
+
 
 	// Find the key/value pair associated with the given key in the given bucket
 	// Returns the end of list iterator if not found
 	TKeyValuePairIter FindKeyValuePair
 	(
-		const int       iBucket,
+		TBucket&        bucket,
 		const TKeyType& key
 	) const
 	{
 		// Start at beginning of bucket and step through each key/value pair
-		TKeyValuePairIter itKeyValuePair = m_aBuckets[iBucket].begin();
-		while (itKeyValuePair != m_aBuckets[iBucket].end())
+		TUInt32 iProbes = 0;
+		TKeyValuePairIter itKeyValuePair = bucket.begin();
+		while (itKeyValuePair != bucket.end())
 		{
 			// If we find a matching key, then quit loop
+			++iProbes;
 			if (key == itKeyValuePair->key)
 			{
 				break;
 			}
 			++itKeyValuePair;
 		}
+		m_Counters.CountProbes( iProbes );
 
 		// Return found key/value pair, or end of list iterator if not found
 		return itKeyValuePair;
 	}
 
-	// Resize the hash table - reinserts all keys
+	// Find the key/value pair associated with the given key, looking in the old table too if a
+	// resize is in progress. Returns the bucket containing the pair, or 0 if not found
+	TBucket* FindKeyValuePair
+	(
+		const TKeyType&    key,
+		TKeyValuePairIter* pitKeyValuePair
+	) const
+	{
+		TBucket* pBucket = &m_aBuckets[FindBucket( key )];
+		*pitKeyValuePair = FindKeyValuePair( *pBucket, key );
+		if (*pitKeyValuePair != pBucket->end())
+		{
+			m_Counters.CountLookUp( true );
+			return pBucket;
+		}
+
+		// Keys not yet moved are still in the old table
+		if (m_aOldBuckets)
+		{
+			TUInt32 iOldBucket = FindBucket( key, m_iOldSize );
+			if (iOldBucket >= m_iNextOldBucket)
+			{
+				pBucket = &m_aOldBuckets[iOldBucket];
+				*pitKeyValuePair = FindKeyValuePair( *pBucket, key );
+				if (*pitKeyValuePair != pBucket->end())
+				{
+					m_Counters.CountLookUp( true );
+					return pBucket;
+				}
+			}
+		}
+		m_Counters.CountLookUp( false );
+		return 0;
+	}
+
+
+	// Resize the hash table. Without a resize step all keys are moved to the new table now,
+	// otherwise the old table is kept and its buckets are moved a few at a time by each insert
+	// or remove (ResizeStep). A resize still in progress is completed first
 	void Resize( const TUInt32 iNewSize )
 	{
 		GEN_GUARD;
 
-		// Store old buckets and size
-		TUInt32 iOldSize = m_iSize;
-		TBucket* aOldBuckets = m_aBuckets;
+		if (m_aOldBuckets)
+		{
+			MoveOldBuckets( m_iOldSize );
+		}
 
-		// Update size and create new set of buckets
+		// Current buckets become the old table and a new set of buckets is created
+		++m_iNumResizes;
+		m_aOldBuckets = m_aBuckets;
+		m_iOldSize = m_iSize;
+		m_iNextOldBucket = 0;
 		m_iSize = iNewSize;
 		m_aBuckets = new TBucket[m_iSize];
 		GEN_ASSERT( m_aBuckets, "Fatal memory error reserving hash table memory" );
 
-		// Go through old buckets and set each key/value pair into new buckets
-		m_iNumEntries = 0;
-		for (TUInt32 iBucket = 0; iBucket < iOldSize; ++iBucket)
+		if (m_kiResizeStep == 0)
 		{
-			while (aOldBuckets[iBucket].size())
+			MoveOldBuckets( m_iOldSize );
+		}
+
+		GEN_ENDGUARD;
+	}
+
+	// Move the next few buckets of the old table to the new one if a resize is in progress
+	void ResizeStep()
+	{
+		if (m_aOldBuckets)
+		{
+			MoveOldBuckets( m_kiResizeStep );
+		}
+	}
+
+	// Move up to the given number of buckets from the old table to the new one, deleting the old
+	// table when all have been moved. List nodes are spliced across, so no memory is allocated
+	void MoveOldBuckets( const TUInt32 iNumBuckets )
+	{
+		TUInt32 iMoves = 0;
+		TUInt32 iLastBucket = m_iNextOldBucket + iNumBuckets;
+		if (iLastBucket > m_iOldSize)
+		{
+			iLastBucket = m_iOldSize;
+		}
+		for (; m_iNextOldBucket < iLastBucket; ++m_iNextOldBucket)
+		{
+			TBucket& oldBucket = m_aOldBuckets[m_iNextOldBucket];
+			while (!oldBucket.empty())
 			{
-				SetKeyValue( aOldBuckets[iBucket].front().key, aOldBuckets[iBucket].front().value );
-				aOldBuckets[iBucket].pop_front(); // Delete each old key/value pair after it is copied
+				TBucket& newBucket = m_aBuckets[FindBucket( oldBucket.front().key )];
+				newBucket.splice( newBucket.end(), oldBucket, oldBucket.begin() );
+				++iMoves;
 			}
 		}
+		if (iMoves > m_iMaxResizeMoves)
+		{
+			m_iMaxResizeMoves = iMoves;
+		}
 
-		delete[] aOldBuckets;
-
-		GEN_ENDGUARD;
+		if (m_iNextOldBucket == m_iOldSize)
+		{
+			delete[] m_aOldBuckets;
+			m_aOldBuckets = 0;
+		}
 	}
 
 
@@ -366,11 +719,22 @@ private:
 
 	TBucket* m_aBuckets;    // Dynamically allocated array of buckets of key/value pairs
 	TUInt32  m_iSize;       // Size (capacity) of the table - number of buckets
-	TUInt32  m_iNumEntries; // Number of key/value pairs in the table
-
-	// Hash function to use is stored as a function pointer - converts a key given as a
-	// sequence of bytes into a 4-byte unsigned integer
-	const THashFunction m_kpfHashFunction;
+	TUInt32  m_iNumEntries; // Number of key/value pairs in the table (in both tables if resizing)
+
+	// While resizing incrementally the previous buckets are kept until all their key/value pairs
+	// have been moved to the new buckets. Buckets before the next old bucket have been moved
+	TBucket* m_aOldBuckets;    // Previous buckets, 0 when not resizing
+	TUInt32  m_iOldSize;       // Number of previous buckets
+	TUInt32  m_iNextOldBucket; // Next previous bucket to move
+	TUInt32  m_iMaxResizeMoves; // Most key/value pairs moved by one operation
+	TUInt32  m_iNumResizes;     // Number of times the table has grown
+
+	// Look-up counters, empty unless statistics are enabled. Look-ups are logically const
+	mutable CHashCounters<kbStats> m_Counters;
+
+	// Number of old buckets moved by each insert or remove while resizing, if 0 the table is
+	// resized all in one go
+	const TUInt32 m_kiResizeStep;
 
 	// If table becomes too full, then it is increased in size to avoid hash collisions. The max
 	// load factor defines how full it needs to be before this happens. In this implementation, the
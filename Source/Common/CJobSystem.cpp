@@ -0,0 +1,183 @@
+/**************************************************************************************************
+	Module:       CJobSystem.cpp
+
+	Job system running work across a fixed pool of threads with work stealing
+
+	See header file for further notes
+**************************************************************************************************/
+
+#include "CJobSystem.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+
+// Constructor takes the number of threads including the calling thread, 0 for one per hardware
+// thread. Starts the worker threads, which sleep until there is work
+CJobSystem::CJobSystem( TUInt32 iNumThreads /*= 0*/ )
+{
+	if (iNumThreads == 0)
+	{
+		iNumThreads = thread::hardware_concurrency();
+		if (iNumThreads == 0)
+		{
+			iNumThreads = 1;
+		}
+	}
+	m_iNumThreads = iNumThreads;
+	m_aQueues = new SJobQueue[m_iNumThreads];
+	m_pJob = 0;
+	m_iNumQueued = 0;
+	m_iNumPending = 0;
+	m_bQuit = false;
+
+	// The calling thread is thread 0, start the others
+	for (TUInt32 iThread = 1; iThread < m_iNumThreads; ++iThread)
+	{
+		m_Workers.push_back( thread( &CJobSystem::WorkerMain, this, iThread ) );
+	}
+}
+
+// Destructor stops the worker threads
+CJobSystem::~CJobSystem()
+{
+	{
+		lock_guard<mutex> lock( m_WakeLock );
+		m_bQuit = true;
+	}
+	m_Wake.notify_all();
+	for (TUInt32 iWorker = 0; iWorker < m_Workers.size(); ++iWorker)
+	{
+		m_Workers[iWorker].join();
+	}
+	delete[] m_aQueues;
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+
+// Run the given function over the indices 0 to iCount-1 in jobs of up to iGrainSize indices. The
+// jobs are dealt out to the thread queues in turn, then the calling thread runs jobs along with
+// the workers until all are complete
+void CJobSystem::ParallelFor( TUInt32 iCount, TUInt32 iGrainSize, const TJobFunction& job )
+{
+	if (iCount == 0)
+	{
+		return;
+	}
+	if (iGrainSize == 0)
+	{
+		iGrainSize = 1;
+	}
+
+	// Single thread or single job, no need to involve the workers
+	if (m_iNumThreads == 1 || iCount <= iGrainSize)
+	{
+		job( 0, iCount );
+		return;
+	}
+
+	m_pJob = &job;
+	TUInt32 iNumJobs = (iCount + iGrainSize - 1) / iGrainSize;
+	m_iNumPending = iNumJobs;
+
+	// Count the jobs before queueing them, so a worker taking one early doesn't take the count
+	// below zero. The count is changed under the lock so no sleeping worker misses it
+	{
+		lock_guard<mutex> lock( m_WakeLock );
+		m_iNumQueued = iNumJobs;
+	}
+	for (TUInt32 iJob = 0; iJob < iNumJobs; ++iJob)
+	{
+		SJob newJob;
+		newJob.iBegin = iJob * iGrainSize;
+		newJob.iEnd = (iCount - newJob.iBegin > iGrainSize) ? newJob.iBegin + iGrainSize : iCount;
+
+		SJobQueue& queue = m_aQueues[iJob % m_iNumThreads];
+		lock_guard<mutex> lock( queue.Lock );
+		queue.Jobs.push_back( newJob );
+	}
+
+	m_Wake.notify_all();
+
+	// Help until all jobs have been taken, then wait for the last ones to finish
+	while (m_iNumPending > 0)
+	{
+		if (!RunJob( 0 ))
+		{
+			this_thread::yield();
+		}
+	}
+	m_pJob = 0;
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+
+// Take a job from the back of the given thread's queue, or failing that the front of another
+// thread's queue (starting with the next thread along). Runs it and returns true, or returns
+// false if all queues were empty
+bool CJobSystem::RunJob( TUInt32 iThread )
+{
+	SJob job;
+	bool bFound = false;
+	for (TUInt32 iVictim = 0; iVictim < m_iNumThreads && !bFound; ++iVictim)
+	{
+		SJobQueue& queue = m_aQueues[(iThread + iVictim) % m_iNumThreads];
+		lock_guard<mutex> lock( queue.Lock );
+		if (!queue.Jobs.empty())
+		{
+			if (iVictim == 0)
+			{
+				job = queue.Jobs.back();
+				queue.Jobs.pop_back();
+			}
+			else
+			{
+				job = queue.Jobs.front();
+				queue.Jobs.pop_front();
+			}
+			bFound = true;
+		}
+	}
+	if (!bFound)
+	{
+		return false;
+	}
+
+	--m_iNumQueued;
+	(*m_pJob)( job.iBegin, job.iEnd );
+	--m_iNumPending;
+	return true;
+}
+
+// Main function of the worker threads - run jobs while there are any, otherwise sleep until
+// more are queued or the job system is destroyed
+void CJobSystem::WorkerMain( TUInt32 iThread )
+{
+	while (true)
+	{
+		{
+			unique_lock<mutex> lock( m_WakeLock );
+			while (!m_bQuit && m_iNumQueued == 0)
+			{
+				m_Wake.wait( lock );
+			}
+			if (m_bQuit)
+			{
+				return;
+			}
+		}
+		while (RunJob( iThread )) {}
+	}
+}
+
+
+} // namespace gen
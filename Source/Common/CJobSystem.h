@@ -0,0 +1,116 @@
+/**************************************************************************************************
+	Module:       CJobSystem.h
+
+	Job system running work across a fixed pool of threads, one per hardware thread. Work is given
+	as a range of indices which is split into jobs. Each thread has its own queue of jobs, taking
+	jobs from the back of its own queue and, when that is empty, stealing from the front of the
+	other threads' queues, so threads that finish early help with the remaining work
+
+	The thread that submits the work also runs jobs until all are done, so a job system with one
+	thread runs everything on the calling thread with no other threads created
+**************************************************************************************************/
+
+#ifndef GEN_C_JOB_SYSTEM_H_INCLUDED
+#define GEN_C_JOB_SYSTEM_H_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	CJobSystem class
+---------------------------------------------------------------------------------------------*/
+
+// Jobs of a ParallelFor may run in any order and on any thread, so each job must only write data
+// belonging to its own indices. ParallelFor must not be called from inside a job
+class CJobSystem
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Function run by a job, for the indices from iBegin up to (not including) iEnd
+	typedef function<void( TUInt32 iBegin, TUInt32 iEnd )> TJobFunction;
+
+	// Constructor takes the number of threads including the calling thread, 0 for one per
+	// hardware thread
+	CJobSystem( TUInt32 iNumThreads = 0 );
+
+	// Destructor stops the worker threads
+	~CJobSystem();
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CJobSystem( const CJobSystem& );
+	CJobSystem& operator=( const CJobSystem& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Run the given function over the indices 0 to iCount-1, in jobs of up to iGrainSize indices
+	// spread across the threads. Returns when all jobs are complete
+	void ParallelFor( TUInt32 iCount, TUInt32 iGrainSize, const TJobFunction& job );
+
+	// Number of threads including the calling thread
+	TUInt32 GetNumThreads() const
+	{
+		return m_iNumThreads;
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// A range of indices to run the current function over
+	struct SJob
+	{
+		TUInt32 iBegin;
+		TUInt32 iEnd;
+	};
+
+	// Queue of jobs for a thread, the owning thread uses the back and other threads the front
+	struct SJobQueue
+	{
+		mutex        Lock;
+		deque<SJob>  Jobs;
+	};
+
+	// Take a job from the given thread's queue, or steal one from another queue. Runs it and
+	// returns true, or returns false if there were no jobs
+	bool RunJob( TUInt32 iThread );
+
+	// Main function of the worker threads - run jobs, sleeping while there are none
+	void WorkerMain( TUInt32 iThread );
+
+
+	TUInt32              m_iNumThreads;
+	vector<thread>       m_Workers;
+	SJobQueue*           m_aQueues;     // One per thread, index 0 for the calling thread
+
+	const TJobFunction*  m_pJob;        // Function of the current ParallelFor
+	atomic<TUInt32>      m_iNumQueued;  // Jobs in the queues
+	atomic<TUInt32>      m_iNumPending; // Jobs not yet completed
+
+	mutex                m_WakeLock;    // Workers sleep on m_Wake when there are no jobs
+	condition_variable   m_Wake;
+	bool                 m_bQuit;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_JOB_SYSTEM_H_INCLUDED
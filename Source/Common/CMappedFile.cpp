@@ -0,0 +1,107 @@
+/**************************************************************************************************
+	Module:       CMappedFile.cpp
+
+	Read-only memory mapped file
+**************************************************************************************************/
+
+#include "CMappedFile.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+
+CMappedFile::CMappedFile()
+{
+	m_File = INVALID_HANDLE_VALUE;
+	m_Mapping = NULL;
+	m_View = 0;
+	m_Size = 0;
+}
+
+CMappedFile::~CMappedFile()
+{
+	Close();
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+
+// Map the given file for reading, closing any file already open. Returns false on failure
+bool CMappedFile::Open( const string& fileName )
+{
+	Close();
+
+	m_File = CreateFile( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+	                     FILE_ATTRIBUTE_NORMAL, NULL );
+	if (m_File == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	// Empty files cannot be mapped, and files over 4GB are not supported
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx( m_File, &size ) || size.QuadPart == 0 || size.HighPart != 0)
+	{
+		Close();
+		return false;
+	}
+	m_Size = size.LowPart;
+
+	m_Mapping = CreateFileMapping( m_File, NULL, PAGE_READONLY, 0, 0, NULL );
+	if (!m_Mapping)
+	{
+		Close();
+		return false;
+	}
+	m_View = MapViewOfFile( m_Mapping, FILE_MAP_READ, 0, 0, 0 );
+	if (!m_View)
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+// Unmap and close the file
+void CMappedFile::Close()
+{
+	if (m_View)
+	{
+		UnmapViewOfFile( m_View );
+		m_View = 0;
+	}
+	if (m_Mapping)
+	{
+		CloseHandle( m_Mapping );
+		m_Mapping = NULL;
+	}
+	if (m_File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle( m_File );
+		m_File = INVALID_HANDLE_VALUE;
+	}
+	m_Size = 0;
+}
+
+
+// Get the size and last write time of a file without opening it
+bool CMappedFile::GetFileStamp( const string& fileName, TUInt64* size, TUInt64* writeTime )
+{
+	WIN32_FILE_ATTRIBUTE_DATA fileData;
+	if (!GetFileAttributesEx( fileName.c_str(), GetFileExInfoStandard, &fileData ))
+	{
+		return false;
+	}
+	*size = (static_cast<TUInt64>(fileData.nFileSizeHigh) << 32) | fileData.nFileSizeLow;
+	*writeTime = (static_cast<TUInt64>(fileData.ftLastWriteTime.dwHighDateTime) << 32) |
+	             fileData.ftLastWriteTime.dwLowDateTime;
+	return true;
+}
+
+
+} // namespace gen
@@ -0,0 +1,81 @@
+/**************************************************************************************************
+	Module:       CMappedFile.h
+
+	Read-only memory mapped file. The file contents are accessed directly through a pointer, with
+	pages loaded by the OS as they are touched, so large data files need no read or copy on load
+**************************************************************************************************/
+
+#ifndef GEN_C_MAPPED_FILE_H_INCLUDED
+#define GEN_C_MAPPED_FILE_H_INCLUDED
+
+#include <string>
+using namespace std;
+
+#include <windows.h>
+#include "Defines.h"
+
+namespace gen
+{
+
+class CMappedFile
+{
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	CMappedFile();
+
+	// Destructor unmaps the file if still open
+	~CMappedFile();
+
+private:
+	// Prevent use of copy constructor and assignment operator (private and not defined)
+	CMappedFile( const CMappedFile& );
+	CMappedFile& operator=( const CMappedFile& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+
+	// Map the given file for reading, closing any file already open. Returns false on failure
+	bool Open( const string& fileName );
+
+	// Unmap and close the file
+	void Close();
+
+	bool IsOpen() const
+	{
+		return m_View != 0;
+	}
+
+	// Access the file contents - valid until the file is closed
+	const TUInt8* GetData() const
+	{
+		return static_cast<const TUInt8*>(m_View);
+	}
+	TUInt32 GetSize() const
+	{
+		return m_Size;
+	}
+
+	// Get the size and last write time of a file without opening it, used to tell whether data
+	// derived from the file is out of date. Returns false if the file does not exist
+	static bool GetFileStamp( const string& fileName, TUInt64* size, TUInt64* writeTime );
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	HANDLE      m_File;
+	HANDLE      m_Mapping;
+	const void* m_View;
+	TUInt32     m_Size;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_MAPPED_FILE_H_INCLUDED
@@ -0,0 +1,166 @@
+/**************************************************************************************************
+	Module:       CNameIndex.h
+
+	Index from names to the handles (see CHandleTable.h) of the objects with each name. Several
+	objects may share a name - a hash table maps each name to the first object added with it and
+	the others are chained after it in the order they were added
+
+	The chain links are held in an array indexed by handle slot, doubly linked, with the first
+	object's back link pointing at the last. So adding an object at the end of its chain and
+	removing any object from its chain take one hash table look-up and no walk along the chain
+**************************************************************************************************/
+
+#ifndef GEN_C_NAME_INDEX_H_INCLUDED
+#define GEN_C_NAME_INDEX_H_INCLUDED
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+#include "CFlatHashTable.h"
+#include "CHandleTable.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	CNameIndex class
+---------------------------------------------------------------------------------------------*/
+
+// Set kbStats to collect look-up counters for the name table, reported by GetStats
+template <bool kbStats = false>
+class CNameIndex
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Constructor takes the initial size of the name table and the number of handle slots to
+	// reserve links for
+	CNameIndex( const TUInt32 iInitialNames, const TUInt32 iInitialSlots = 0 )
+		: m_Names( iInitialNames )
+	{
+		m_Links.reserve( iInitialSlots );
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CNameIndex( const CNameIndex& );
+	CNameIndex& operator=( const CNameIndex& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Add an object to the end of the chain for its name. The handle must not be in the index
+	void Add( const TUInt32 hHandle, const string& name )
+	{
+		TUInt32 iSlot = hHandle & kiHandleSlotMask;
+		if (iSlot >= m_Links.size())
+		{
+			m_Links.resize( iSlot + 1 );
+		}
+		SLinks& links = m_Links[iSlot];
+		links.hNext = kiNoHandle;
+
+		TUInt32 hFirst;
+		if (!m_Names.LookUpKey( name, &hFirst ))
+		{
+			m_Names.SetKeyValue( name, hHandle );
+			links.hPrev = hHandle;
+			return;
+		}
+		SLinks& firstLinks = m_Links[hFirst & kiHandleSlotMask];
+		links.hPrev = firstLinks.hPrev;
+		m_Links[firstLinks.hPrev & kiHandleSlotMask].hNext = hHandle;
+		firstLinks.hPrev = hHandle;
+	}
+
+	// Remove an object from the chain for its name. The name must be the one it was added with
+	void Remove( const TUInt32 hHandle, const string& name )
+	{
+		TUInt32 hFirst;
+		if (!m_Names.LookUpKey( name, &hFirst ))
+		{
+			return;
+		}
+		const SLinks& links = m_Links[hHandle & kiHandleSlotMask];
+		if (hHandle == hFirst)
+		{
+			// The next object (if any) takes its place in the name table, linked back to the last
+			if (links.hNext == kiNoHandle)
+			{
+				m_Names.RemoveKey( name );
+			}
+			else
+			{
+				m_Names.SetKeyValue( name, links.hNext );
+				m_Links[links.hNext & kiHandleSlotMask].hPrev = links.hPrev;
+			}
+			return;
+		}
+
+		m_Links[links.hPrev & kiHandleSlotMask].hNext = links.hNext;
+		if (links.hNext == kiNoHandle)
+		{
+			m_Links[hFirst & kiHandleSlotMask].hPrev = links.hPrev; // Removing the last object
+		}
+		else
+		{
+			m_Links[links.hNext & kiHandleSlotMask].hPrev = links.hPrev;
+		}
+	}
+
+	// Remove all names and objects
+	void RemoveAll()
+	{
+		m_Names.RemoveAllKeys();
+	}
+
+
+	// Return the first object added with the given name, or kiNoHandle if there is none
+	TUInt32 GetFirst( const string& name ) const
+	{
+		TUInt32 hFirst;
+		return m_Names.LookUpKey( name, &hFirst ) ? hFirst : kiNoHandle;
+	}
+
+	// Return the object added after the given one with the same name, or kiNoHandle if it is the
+	// last. The handle must be in the index
+	TUInt32 GetNext( const TUInt32 hHandle ) const
+	{
+		return m_Links[hHandle & kiHandleSlotMask].hNext;
+	}
+
+
+	// Fill in a report on the name table. Look-up counters are only collected if kbStats is set
+	void GetStats( SHashTableStats* pStats ) const
+	{
+		m_Names.GetStats( pStats );
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// Chain links for the object using a handle slot. The first object's previous link is the
+	// last object in the chain, the last object's next link is kiNoHandle
+	struct SLinks
+	{
+		TUInt32 hNext;
+		TUInt32 hPrev;
+	};
+	vector<SLinks> m_Links;
+
+	// First object with each name
+	CFlatHashTable<string, TUInt32, CHashTraits<string>, kbStats> m_Names;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_NAME_INDEX_H_INCLUDED
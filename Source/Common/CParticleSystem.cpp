@@ -0,0 +1,344 @@
+/**************************************************************************************************
+	Module:       CParticleSystem.cpp
+
+	CPU particle system with a fixed pool of emitters
+
+	See header file for further notes
+**************************************************************************************************/
+
+#include <emmintrin.h>
+
+#include "CParticleSystem.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+
+// Constructor takes the maximum number of emitters and particles per emitter. The particle
+// arrays are zeroed so the unused lanes of the last block of four are always valid numbers
+CParticleSystem::CParticleSystem( TUInt32 iMaxEmitters, TUInt32 iParticlesPerEmitter )
+	: m_kiMaxEmitters( iMaxEmitters > 0 ? iMaxEmitters : 1 ),
+	  m_kiParticlesPerEmitter( iParticlesPerEmitter > 0 ? (iParticlesPerEmitter + 3) & ~3u : 4 )
+{
+	m_aEmitters.resize( m_kiMaxEmitters );
+	m_aiFreeEmitters.reserve( m_kiMaxEmitters );
+
+	TUInt32 iNumParticles = m_kiMaxEmitters * m_kiParticlesPerEmitter;
+	m_afPosX.resize( iNumParticles, 0.0f );
+	m_afPosY.resize( iNumParticles, 0.0f );
+	m_afPosZ.resize( iNumParticles, 0.0f );
+	m_afVelX.resize( iNumParticles, 0.0f );
+	m_afVelY.resize( iNumParticles, 0.0f );
+	m_afVelZ.resize( iNumParticles, 0.0f );
+	m_afLife.resize( iNumParticles, 0.0f );
+	m_afSize.resize( iNumParticles, 0.0f );
+	m_aiColour.resize( iNumParticles, 0 );
+
+	Clear();
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+
+// Start an emitter from the free list and spawn its burst
+TUInt32 CParticleSystem::StartEmitter( const SParticleEmitterDesc& desc )
+{
+	if (m_aiFreeEmitters.empty())
+	{
+		return kiNoEmitter;
+	}
+	TUInt32 iEmitter = m_aiFreeEmitters.back();
+	m_aiFreeEmitters.pop_back();
+
+	SEmitter& emitter = m_aEmitters[iEmitter];
+	emitter.desc = desc;
+	if (emitter.desc.fLifetime <= 0.0f)
+	{
+		emitter.desc.fLifetime = 0.001f;
+	}
+	// Colours outside 0 to 1 would overflow into the next channel when packed
+	for (int c = 0; c < 4; ++c)
+	{
+		TFloat32& fStart = emitter.desc.afStartColour[c];
+		TFloat32& fEnd = emitter.desc.afEndColour[c];
+		fStart = fStart < 0.0f ? 0.0f : (fStart > 1.0f ? 1.0f : fStart);
+		fEnd = fEnd < 0.0f ? 0.0f : (fEnd > 1.0f ? 1.0f : fEnd);
+	}
+	emitter.bActive = true;
+	emitter.bEmitting = desc.fDuration > 0.0f && desc.fRate > 0.0f;
+	emitter.iNumParticles = 0;
+	emitter.fTimeLeft = desc.fDuration;
+	emitter.fSpawnCarry = 0.0f;
+	emitter.iRandom = 0x9e3779b9u * (iEmitter + 1);
+	SpawnParticles( iEmitter, desc.iBurst );
+	return iEmitter;
+}
+
+// Stop an emitter spawning particles
+void CParticleSystem::StopEmitter( TUInt32 iEmitter )
+{
+	if (iEmitter < m_kiMaxEmitters)
+	{
+		m_aEmitters[iEmitter].bEmitting = false;
+	}
+}
+
+// Move where an emitter spawns particles
+void CParticleSystem::MoveEmitter( TUInt32 iEmitter, TFloat32 fX, TFloat32 fY, TFloat32 fZ )
+{
+	if (iEmitter < m_kiMaxEmitters)
+	{
+		m_aEmitters[iEmitter].desc.fPosX = fX;
+		m_aEmitters[iEmitter].desc.fPosY = fY;
+		m_aEmitters[iEmitter].desc.fPosZ = fZ;
+	}
+}
+
+// Remove all emitters and particles, all emitters go on the free list with the lowest numbers
+// at the top
+void CParticleSystem::Clear()
+{
+	m_aiFreeEmitters.clear();
+	for (TUInt32 iEmitter = m_kiMaxEmitters; iEmitter-- > 0;)
+	{
+		m_aEmitters[iEmitter].bActive = false;
+		m_aEmitters[iEmitter].bEmitting = false;
+		m_aEmitters[iEmitter].iNumParticles = 0;
+		m_aiFreeEmitters.push_back( iEmitter );
+	}
+}
+
+// Update each active emitter, in parallel if a job system is given. Each emitter only changes
+// its own data, so emitters that have finished are freed afterwards on this thread
+void CParticleSystem::Update( TFloat32 fUpdateTime, CJobSystem* pJobs )
+{
+	if (pJobs)
+	{
+		pJobs->ParallelFor( m_kiMaxEmitters, 1, [this, fUpdateTime]( TUInt32 iBegin, TUInt32 iEnd )
+		{
+			for (TUInt32 iEmitter = iBegin; iEmitter < iEnd; ++iEmitter)
+			{
+				UpdateEmitter( iEmitter, fUpdateTime );
+			}
+		} );
+	}
+	else
+	{
+		for (TUInt32 iEmitter = 0; iEmitter < m_kiMaxEmitters; ++iEmitter)
+		{
+			UpdateEmitter( iEmitter, fUpdateTime );
+		}
+	}
+
+	for (TUInt32 iEmitter = 0; iEmitter < m_kiMaxEmitters; ++iEmitter)
+	{
+		SEmitter& emitter = m_aEmitters[iEmitter];
+		if (emitter.bActive && !emitter.bEmitting && emitter.iNumParticles == 0)
+		{
+			emitter.bActive = false;
+			m_aiFreeEmitters.push_back( iEmitter );
+		}
+	}
+}
+
+// Number of live particles over all emitters
+TUInt32 CParticleSystem::GetTotalParticles() const
+{
+	TUInt32 iTotal = 0;
+	for (TUInt32 iEmitter = 0; iEmitter < m_kiMaxEmitters; ++iEmitter)
+	{
+		iTotal += m_aEmitters[iEmitter].iNumParticles;
+	}
+	return iTotal;
+}
+
+// Write the instance data of an emitter's particles
+TUInt32 CParticleSystem::WriteInstances( TUInt32 iEmitter, SParticleInstance* pInstances ) const
+{
+	TUInt32 iNum = m_aEmitters[iEmitter].iNumParticles;
+	TUInt32 iBase = iEmitter * m_kiParticlesPerEmitter;
+	for (TUInt32 i = 0; i < iNum; ++i)
+	{
+		pInstances[i].fX = m_afPosX[iBase + i];
+		pInstances[i].fY = m_afPosY[iBase + i];
+		pInstances[i].fZ = m_afPosZ[iBase + i];
+		pInstances[i].fSize = m_afSize[iBase + i];
+		pInstances[i].iColour = m_aiColour[iBase + i];
+	}
+	return iNum;
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+
+// Update the particles of one emitter four at a time - apply gravity, move, age, then set size
+// and colour from how far through its life each particle is. Blocks are a multiple of four so
+// the last group may include unused particles, which are updated but never drawn. Then dead
+// particles are removed and new ones spawned
+void CParticleSystem::UpdateEmitter( TUInt32 iEmitter, TFloat32 fUpdateTime )
+{
+	SEmitter& emitter = m_aEmitters[iEmitter];
+	if (!emitter.bActive)
+	{
+		return;
+	}
+	const SParticleEmitterDesc& desc = emitter.desc;
+
+	TUInt32 iBase = iEmitter * m_kiParticlesPerEmitter;
+	TUInt32 iEnd = iBase + ((emitter.iNumParticles + 3) & ~3u);
+	TFloat32* pPosX = &m_afPosX[0];
+	TFloat32* pPosY = &m_afPosY[0];
+	TFloat32* pPosZ = &m_afPosZ[0];
+	TFloat32* pVelX = &m_afVelX[0];
+	TFloat32* pVelY = &m_afVelY[0];
+	TFloat32* pVelZ = &m_afVelZ[0];
+	TFloat32* pLife = &m_afLife[0];
+	TFloat32* pSize = &m_afSize[0];
+	TUInt32*  pColour = &m_aiColour[0];
+
+	const __m128 time = _mm_set1_ps( fUpdateTime );
+	const __m128 gravity = _mm_set1_ps( desc.fGravity * fUpdateTime );
+	const __m128 invLifetime = _mm_set1_ps( 1.0f / desc.fLifetime );
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 startSize = _mm_set1_ps( desc.fStartSize );
+	const __m128 sizeRange = _mm_set1_ps( desc.fEndSize - desc.fStartSize );
+	__m128 startColour[4], colourRange[4];
+	for (int c = 0; c < 4; ++c)
+	{
+		startColour[c] = _mm_set1_ps( desc.afStartColour[c] * 255.0f );
+		colourRange[c] = _mm_set1_ps( (desc.afEndColour[c] - desc.afStartColour[c]) * 255.0f );
+	}
+
+	for (TUInt32 i = iBase; i < iEnd; i += 4)
+	{
+		__m128 velX = _mm_loadu_ps( pVelX + i );
+		__m128 velY = _mm_sub_ps( _mm_loadu_ps( pVelY + i ), gravity );
+		__m128 velZ = _mm_loadu_ps( pVelZ + i );
+		_mm_storeu_ps( pVelY + i, velY );
+		_mm_storeu_ps( pPosX + i, _mm_add_ps( _mm_loadu_ps( pPosX + i ), _mm_mul_ps( velX, time ) ) );
+		_mm_storeu_ps( pPosY + i, _mm_add_ps( _mm_loadu_ps( pPosY + i ), _mm_mul_ps( velY, time ) ) );
+		_mm_storeu_ps( pPosZ + i, _mm_add_ps( _mm_loadu_ps( pPosZ + i ), _mm_mul_ps( velZ, time ) ) );
+
+		__m128 life = _mm_sub_ps( _mm_loadu_ps( pLife + i ), time );
+		_mm_storeu_ps( pLife + i, life );
+
+		// Fraction of life gone, 0 to 1
+		__m128 age = _mm_sub_ps( one, _mm_mul_ps( life, invLifetime ) );
+		age = _mm_min_ps( _mm_max_ps( age, zero ), one );
+		_mm_storeu_ps( pSize + i, _mm_add_ps( startSize, _mm_mul_ps( sizeRange, age ) ) );
+
+		__m128i colour = _mm_cvtps_epi32( _mm_add_ps( startColour[0], _mm_mul_ps( colourRange[0], age ) ) );
+		for (int c = 1; c < 4; ++c)
+		{
+			__m128i channel = _mm_cvtps_epi32( _mm_add_ps( startColour[c], _mm_mul_ps( colourRange[c], age ) ) );
+			colour = _mm_or_si128( colour, _mm_slli_epi32( channel, 8 * c ) );
+		}
+		_mm_storeu_si128( reinterpret_cast<__m128i*>(pColour + i), colour );
+	}
+
+	// Remove dead particles, the particle moved in is checked next
+	TUInt32 i = 0;
+	while (i < emitter.iNumParticles)
+	{
+		if (pLife[iBase + i] <= 0.0f)
+		{
+			MoveLast( iEmitter, i );
+		}
+		else
+		{
+			++i;
+		}
+	}
+
+	if (emitter.bEmitting)
+	{
+		emitter.fSpawnCarry += desc.fRate * fUpdateTime;
+		TUInt32 iCount = static_cast<TUInt32>(emitter.fSpawnCarry);
+		emitter.fSpawnCarry -= static_cast<TFloat32>(iCount);
+		SpawnParticles( iEmitter, iCount );
+
+		emitter.fTimeLeft -= fUpdateTime;
+		if (emitter.fTimeLeft <= 0.0f)
+		{
+			emitter.bEmitting = false;
+		}
+	}
+}
+
+// Spawn particles at the emitter's position with randomised velocities, starting at the
+// beginning of their life
+void CParticleSystem::SpawnParticles( TUInt32 iEmitter, TUInt32 iCount )
+{
+	SEmitter& emitter = m_aEmitters[iEmitter];
+	const SParticleEmitterDesc& desc = emitter.desc;
+	TUInt32 iSpace = m_kiParticlesPerEmitter - emitter.iNumParticles;
+	if (iCount > iSpace)
+	{
+		iCount = iSpace;
+	}
+
+	TUInt32 iColour = PackColour( desc.afStartColour );
+	TUInt32 i = iEmitter * m_kiParticlesPerEmitter + emitter.iNumParticles;
+	for (TUInt32 iEnd = i + iCount; i < iEnd; ++i)
+	{
+		m_afPosX[i] = desc.fPosX;
+		m_afPosY[i] = desc.fPosY;
+		m_afPosZ[i] = desc.fPosZ;
+		m_afVelX[i] = desc.fVelX + desc.fVelSpread * RandomSigned( emitter.iRandom );
+		m_afVelY[i] = desc.fVelY + desc.fVelSpread * RandomSigned( emitter.iRandom );
+		m_afVelZ[i] = desc.fVelZ + desc.fVelSpread * RandomSigned( emitter.iRandom );
+		m_afLife[i] = desc.fLifetime;
+		m_afSize[i] = desc.fStartSize;
+		m_aiColour[i] = iColour;
+	}
+	emitter.iNumParticles += iCount;
+}
+
+// Move the last particle of an emitter into the given element, removing the particle there
+void CParticleSystem::MoveLast( TUInt32 iEmitter, TUInt32 iParticle )
+{
+	TUInt32 iBase = iEmitter * m_kiParticlesPerEmitter;
+	TUInt32 iTo = iBase + iParticle;
+	TUInt32 iFrom = iBase + --m_aEmitters[iEmitter].iNumParticles;
+	m_afPosX[iTo] = m_afPosX[iFrom];
+	m_afPosY[iTo] = m_afPosY[iFrom];
+	m_afPosZ[iTo] = m_afPosZ[iFrom];
+	m_afVelX[iTo] = m_afVelX[iFrom];
+	m_afVelY[iTo] = m_afVelY[iFrom];
+	m_afVelZ[iTo] = m_afVelZ[iFrom];
+	m_afLife[iTo] = m_afLife[iFrom];
+	m_afSize[iTo] = m_afSize[iFrom];
+	m_aiColour[iTo] = m_aiColour[iFrom];
+}
+
+// Random number from -1 to 1, xorshift on the given state
+TFloat32 CParticleSystem::RandomSigned( TUInt32& iState )
+{
+	iState ^= iState << 13;
+	iState ^= iState >> 17;
+	iState ^= iState << 5;
+	return static_cast<TFloat32>(iState >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+// Pack an RGBA colour from 0 to 1 into a 32 bit colour, red in the low byte
+TUInt32 CParticleSystem::PackColour( const TFloat32* afColour )
+{
+	TUInt32 iColour = 0;
+	for (int c = 0; c < 4; ++c)
+	{
+		TFloat32 fChannel = afColour[c] < 0.0f ? 0.0f : (afColour[c] > 1.0f ? 1.0f : afColour[c]);
+		iColour |= static_cast<TUInt32>(fChannel * 255.0f + 0.5f) << (8 * c);
+	}
+	return iColour;
+}
+
+
+} // namespace gen
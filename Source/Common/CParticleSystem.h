@@ -0,0 +1,191 @@
+/**************************************************************************************************
+	Module:       CParticleSystem.h
+
+	CPU particle system with a fixed pool of emitters, e.g. blood from hits
+
+	Each emitter owns a block of particles of fixed size, and its live particles are packed at
+	the start of the block. Particle properties are stored as an array for each property, so the
+	update works on four particles at a time with SSE - moving them, ageing them and working out
+	their size and colour from their age. Dead particles are replaced by the last particle in the
+	block, so nothing is allocated after construction
+
+	Emitters are started from a free list and return to it once they have stopped spawning and
+	all their particles have died. The particles of an emitter can be written out as compact
+	instance data (position, size, packed colour), ready to draw all of them at once
+**************************************************************************************************/
+
+#ifndef GEN_C_PARTICLE_SYSTEM_H_INCLUDED
+#define GEN_C_PARTICLE_SYSTEM_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+#include "CJobSystem.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Emitter description / instance data
+---------------------------------------------------------------------------------------------*/
+
+// Everything needed to start an emitter
+struct SParticleEmitterDesc
+{
+	TFloat32 fPosX;             // Where particles are spawned
+	TFloat32 fPosY;
+	TFloat32 fPosZ;
+	TFloat32 fVelX;             // Average velocity of new particles, per second
+	TFloat32 fVelY;
+	TFloat32 fVelZ;
+	TFloat32 fVelSpread;        // Each velocity component of a new particle is randomised by +/- this
+	TFloat32 fGravity;          // Downwards acceleration, per second per second
+	TFloat32 fLifetime;         // Seconds each particle lives
+	TUInt32  iBurst;            // Particles spawned as soon as the emitter starts
+	TFloat32 fRate;             // Particles spawned per second after the burst...
+	TFloat32 fDuration;         // ...for this many seconds
+	TFloat32 afStartColour[4];  // RGBA, 0 to 1, going from start to end over each particle's life
+	TFloat32 afEndColour[4];
+	TFloat32 fStartSize;        // Half width of a particle, also over its life
+	TFloat32 fEndSize;
+};
+
+// A particle ready for drawing. The colour is packed with red in the low byte, the layout of
+// an R8G8B8A8 vertex element
+struct SParticleInstance
+{
+	TFloat32 fX;
+	TFloat32 fY;
+	TFloat32 fZ;
+	TFloat32 fSize;
+	TUInt32  iColour;
+};
+
+
+/*---------------------------------------------------------------------------------------------
+	CParticleSystem class
+---------------------------------------------------------------------------------------------*/
+
+class CParticleSystem
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Constructor takes the maximum number of emitters and the maximum number of particles of
+	// each emitter (rounded up to a multiple of four). All memory is reserved here
+	CParticleSystem( TUInt32 iMaxEmitters, TUInt32 iParticlesPerEmitter );
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CParticleSystem( const CParticleSystem& );
+	CParticleSystem& operator=( const CParticleSystem& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Value returned when an emitter cannot be started
+	static const TUInt32 kiNoEmitter = 0xffffffff;
+
+	// Start an emitter and spawn its burst, returns its number or kiNoEmitter if all are in use
+	TUInt32 StartEmitter( const SParticleEmitterDesc& desc );
+
+	// Stop an emitter spawning particles, it is freed once its particles have died
+	void StopEmitter( TUInt32 iEmitter );
+
+	// Move where an emitter spawns particles, existing particles are not moved
+	void MoveEmitter( TUInt32 iEmitter, TFloat32 fX, TFloat32 fY, TFloat32 fZ );
+
+	// Remove all emitters and particles
+	void Clear();
+
+	// Update all particles and spawn new ones, pass the time since the last update. If a job
+	// system is given the emitters are updated in parallel across its threads
+	void Update( TFloat32 fUpdateTime, CJobSystem* pJobs = 0 );
+
+
+	TUInt32 GetMaxEmitters() const
+	{
+		return m_kiMaxEmitters;
+	}
+
+	TUInt32 GetParticlesPerEmitter() const
+	{
+		return m_kiParticlesPerEmitter;
+	}
+
+	bool IsEmitterActive( TUInt32 iEmitter ) const
+	{
+		return m_aEmitters[iEmitter].bActive;
+	}
+
+	TUInt32 GetNumParticles( TUInt32 iEmitter ) const
+	{
+		return m_aEmitters[iEmitter].iNumParticles;
+	}
+
+	// Number of live particles over all emitters
+	TUInt32 GetTotalParticles() const;
+
+	// Write the instance data of an emitter's particles, GetNumParticles of them. Returns the
+	// number written
+	TUInt32 WriteInstances( TUInt32 iEmitter, SParticleInstance* pInstances ) const;
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	struct SEmitter
+	{
+		SParticleEmitterDesc desc;
+		bool     bActive;
+		bool     bEmitting;
+		TUInt32  iNumParticles;
+		TFloat32 fTimeLeft;   // Time left to spawn particles
+		TFloat32 fSpawnCarry; // Fraction of a particle not yet spawned
+		TUInt32  iRandom;     // Random number state, each emitter has its own for parallel updates
+	};
+
+	// Update the particles of one emitter, remove dead ones and spawn new ones. Only changes the
+	// emitter and its own block of particles
+	void UpdateEmitter( TUInt32 iEmitter, TFloat32 fUpdateTime );
+
+	// Spawn up to the given number of particles for an emitter, limited by its block size
+	void SpawnParticles( TUInt32 iEmitter, TUInt32 iCount );
+
+	// Move the last particle of an emitter into the given element
+	void MoveLast( TUInt32 iEmitter, TUInt32 iParticle );
+
+	// Random number from -1 to 1 using the given state
+	static TFloat32 RandomSigned( TUInt32& iState );
+
+	// Pack an RGBA colour from 0 to 1 into a 32 bit colour
+	static TUInt32 PackColour( const TFloat32* afColour );
+
+	const TUInt32    m_kiMaxEmitters;
+	const TUInt32    m_kiParticlesPerEmitter;
+
+	vector<SEmitter> m_aEmitters;
+	vector<TUInt32>  m_aiFreeEmitters; // Stack of unused emitters
+
+	// Particle properties, one block of m_kiParticlesPerEmitter for each emitter
+	vector<TFloat32> m_afPosX;
+	vector<TFloat32> m_afPosY;
+	vector<TFloat32> m_afPosZ;
+	vector<TFloat32> m_afVelX;
+	vector<TFloat32> m_afVelY;
+	vector<TFloat32> m_afVelZ;
+	vector<TFloat32> m_afLife;   // Seconds left to live
+	vector<TFloat32> m_afSize;
+	vector<TUInt32>  m_aiColour; // Packed as in SParticleInstance
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_PARTICLE_SYSTEM_H_INCLUDED
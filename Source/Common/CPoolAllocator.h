@@ -0,0 +1,117 @@
+/**************************************************************************************************
+	Module:       CPoolAllocator.h
+
+	Pool allocator for objects of a single type. Objects are allocated from an arena of their
+	own, so objects of the same type sit together in memory, are 16-byte aligned and take a
+	system allocation only once per block of objects. Freed objects go on a free list of the
+	pool's own, whatever the object size, and are reused by the next allocation. Reset releases
+	all objects at once
+**************************************************************************************************/
+
+#ifndef GEN_C_POOL_ALLOCATOR_H_INCLUDED
+#define GEN_C_POOL_ALLOCATOR_H_INCLUDED
+
+#include "Defines.h"
+#include "CArenaAllocator.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	CPoolAllocator class
+---------------------------------------------------------------------------------------------*/
+
+// The pool provides memory only, construct objects in it with placement new and call their
+// destructor before freeing them. Objects must not need more than 16-byte alignment
+template <class T>
+class CPoolAllocator
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Constructor takes the number of objects to allocate from the system at once
+	CPoolAllocator( const TUInt32 iObjectsPerBlock = 64 )
+		: m_Arena( iObjectsPerBlock * static_cast<TUInt32>(sizeof(T)) ), m_pFreeObjects( 0 ),
+		  m_iNumAllocations( 0 )
+	{
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CPoolAllocator( const CPoolAllocator& );
+	CPoolAllocator& operator=( const CPoolAllocator& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Allocate memory for an object, reusing a freed object if there is one
+	void* Allocate()
+	{
+		++m_iNumAllocations;
+		if (m_pFreeObjects)
+		{
+			SFreeObject* pObject = m_pFreeObjects;
+			m_pFreeObjects = pObject->pNext;
+			return pObject;
+		}
+		return m_Arena.Allocate( sizeof(T) );
+	}
+
+	// Free the memory of an object, its destructor must already have been called
+	void Free( void* pObject )
+	{
+		if (!pObject)
+		{
+			return;
+		}
+		--m_iNumAllocations;
+		SFreeObject* pFree = static_cast<SFreeObject*>(pObject);
+		pFree->pNext = m_pFreeObjects;
+		m_pFreeObjects = pFree;
+	}
+
+	// Free the memory of all objects at once, their destructors must already have been called
+	void Reset()
+	{
+		m_Arena.Reset();
+		m_pFreeObjects = 0;
+		m_iNumAllocations = 0;
+	}
+
+
+	// Number of system allocations made
+	TUInt32 GetNumBlocks() const
+	{
+		return m_Arena.GetNumBlocks();
+	}
+
+	// Number of objects currently allocated
+	TUInt32 GetNumAllocations() const
+	{
+		return m_iNumAllocations;
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// A freed object, stored in the object's own memory
+	struct SFreeObject
+	{
+		SFreeObject* pNext;
+	};
+
+	CArenaAllocator m_Arena;
+	SFreeObject*    m_pFreeObjects;
+	TUInt32         m_iNumAllocations;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_POOL_ALLOCATOR_H_INCLUDED
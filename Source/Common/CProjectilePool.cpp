@@ -0,0 +1,151 @@
+/**************************************************************************************************
+	Module:       CProjectilePool.cpp
+
+	A fixed capacity pool of projectiles moving in the XY plane
+
+	See header file for further notes
+**************************************************************************************************/
+
+#include "CProjectilePool.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+
+// Constructor takes the maximum number of projectiles, all memory is reserved here
+CProjectilePool::CProjectilePool( TUInt32 iCapacity )
+	: m_kiCapacity( iCapacity > 0 ? iCapacity : 1 )
+{
+	m_iNumProjectiles = 0;
+	m_afPosX.resize( m_kiCapacity );
+	m_afPosY.resize( m_kiCapacity );
+	m_afPosZ.resize( m_kiCapacity );
+	m_afVelX.resize( m_kiCapacity );
+	m_afVelY.resize( m_kiCapacity );
+	m_afHalfWidth.resize( m_kiCapacity );
+	m_afHalfHeight.resize( m_kiCapacity );
+	m_afLifetime.resize( m_kiCapacity );
+	m_aiOwner.resize( m_kiCapacity );
+	m_aiVisual.resize( m_kiCapacity );
+	m_aiDamage.resize( m_kiCapacity );
+	m_aiKnockback.resize( m_kiCapacity );
+	m_aiKnockUp.resize( m_kiCapacity );
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+
+// Add a projectile, returns false if the pool is full
+bool CProjectilePool::Spawn( const SProjectileDesc& desc )
+{
+	if (m_iNumProjectiles == m_kiCapacity)
+	{
+		return false;
+	}
+	TUInt32 i = m_iNumProjectiles++;
+	m_afPosX[i] = desc.fPosX;
+	m_afPosY[i] = desc.fPosY;
+	m_afPosZ[i] = desc.fPosZ;
+	m_afVelX[i] = desc.fVelX;
+	m_afVelY[i] = desc.fVelY;
+	m_afHalfWidth[i] = desc.fHalfWidth;
+	m_afHalfHeight[i] = desc.fHalfHeight;
+	m_afLifetime[i] = desc.fLifetime;
+	m_aiOwner[i] = desc.iOwner;
+	m_aiVisual[i] = desc.iVisual;
+	m_aiDamage[i] = desc.iDamage;
+	m_aiKnockback[i] = desc.iKnockback;
+	m_aiKnockUp[i] = desc.iKnockUp;
+	return true;
+}
+
+// Move all projectiles and count down their lifetimes, each in a loop over one or two arrays.
+// Expired projectiles are then removed from the back, so each moved projectile has been checked
+void CProjectilePool::Update( TFloat32 fUpdateTime )
+{
+	TUInt32 iNum = m_iNumProjectiles;
+	TFloat32* pPosX = &m_afPosX[0];
+	TFloat32* pPosY = &m_afPosY[0];
+	TFloat32* pLifetime = &m_afLifetime[0];
+	const TFloat32* pVelX = &m_afVelX[0];
+	const TFloat32* pVelY = &m_afVelY[0];
+	for (TUInt32 i = 0; i < iNum; ++i)
+	{
+		pPosX[i] += pVelX[i];
+	}
+	for (TUInt32 i = 0; i < iNum; ++i)
+	{
+		pPosY[i] += pVelY[i];
+	}
+	for (TUInt32 i = 0; i < iNum; ++i)
+	{
+		pLifetime[i] -= fUpdateTime;
+	}
+
+	for (TUInt32 i = iNum; i-- > 0;)
+	{
+		if (pLifetime[i] <= 0.0f)
+		{
+			MoveLast( i );
+		}
+	}
+}
+
+// Add the rectangle of each projectile to a box set, owned by the projectile's owner
+void CProjectilePool::AddBoxes( CBoxSet& boxes ) const
+{
+	for (TUInt32 i = 0; i < m_iNumProjectiles; ++i)
+	{
+		boxes.Add( m_aiOwner[i], m_afPosX[i] - m_afHalfWidth[i], m_afPosY[i] - m_afHalfHeight[i],
+		                         m_afPosX[i] + m_afHalfWidth[i], m_afPosY[i] + m_afHalfHeight[i] );
+	}
+}
+
+// Remove the given projectiles, in increasing order. Removing from the back means the last
+// projectile is never one still to be removed
+void CProjectilePool::Remove( const TUInt32* aiProjectiles, TUInt32 iNumProjectiles )
+{
+	for (TUInt32 i = iNumProjectiles; i-- > 0;)
+	{
+		if (aiProjectiles[i] < m_iNumProjectiles)
+		{
+			MoveLast( aiProjectiles[i] );
+		}
+	}
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+
+// Move the last projectile into the given element, removing the projectile that was there
+void CProjectilePool::MoveLast( TUInt32 iProjectile )
+{
+	TUInt32 iLast = --m_iNumProjectiles;
+	if (iProjectile == iLast)
+	{
+		return;
+	}
+	m_afPosX[iProjectile] = m_afPosX[iLast];
+	m_afPosY[iProjectile] = m_afPosY[iLast];
+	m_afPosZ[iProjectile] = m_afPosZ[iLast];
+	m_afVelX[iProjectile] = m_afVelX[iLast];
+	m_afVelY[iProjectile] = m_afVelY[iLast];
+	m_afHalfWidth[iProjectile] = m_afHalfWidth[iLast];
+	m_afHalfHeight[iProjectile] = m_afHalfHeight[iLast];
+	m_afLifetime[iProjectile] = m_afLifetime[iLast];
+	m_aiOwner[iProjectile] = m_aiOwner[iLast];
+	m_aiVisual[iProjectile] = m_aiVisual[iLast];
+	m_aiDamage[iProjectile] = m_aiDamage[iLast];
+	m_aiKnockback[iProjectile] = m_aiKnockback[iLast];
+	m_aiKnockUp[iProjectile] = m_aiKnockUp[iLast];
+}
+
+
+} // namespace gen
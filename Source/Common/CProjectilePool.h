@@ -0,0 +1,150 @@
+/**************************************************************************************************
+	Module:       CProjectilePool.h
+
+	A fixed capacity pool of projectiles moving in the XY plane, e.g. thrown knives
+
+	The projectiles are stored as an array for each property, with the live projectiles packed at
+	the start. Spawning writes the next element and removing a projectile moves the last one into
+	its place, so neither allocates memory. The arrays are updated in single loops, and each
+	projectile's rectangle can be added to a CBoxSet to test it against targets in one batch
+
+	The pool only holds data - what a projectile hits and how it is drawn is up to the caller,
+	using the owner and visual IDs given when it was spawned
+**************************************************************************************************/
+
+#ifndef GEN_C_PROJECTILE_POOL_H_INCLUDED
+#define GEN_C_PROJECTILE_POOL_H_INCLUDED
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+#include "CBoxSet.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Projectile description
+---------------------------------------------------------------------------------------------*/
+
+// Everything needed to spawn a projectile
+struct SProjectileDesc
+{
+	TUInt32  iOwner;      // Box owner, the projectile never hits boxes with the same owner
+	TUInt32  iVisual;     // Caller's ID for how to draw the projectile
+	TFloat32 fPosX;
+	TFloat32 fPosY;
+	TFloat32 fPosZ;       // Depth, only used for drawing
+	TFloat32 fVelX;       // Distance moved each update
+	TFloat32 fVelY;
+	TFloat32 fHalfWidth;  // Size of the projectile's rectangle
+	TFloat32 fHalfHeight;
+	TFloat32 fLifetime;   // Removed after this many seconds
+
+	// Payload delivered to what the projectile hits
+	TUInt32  iDamage;
+	TUInt32  iKnockback;
+	TUInt32  iKnockUp;
+};
+
+
+/*---------------------------------------------------------------------------------------------
+	CProjectilePool class
+---------------------------------------------------------------------------------------------*/
+
+class CProjectilePool
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	// Constructor takes the maximum number of projectiles, all memory is reserved here
+	CProjectilePool( TUInt32 iCapacity );
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CProjectilePool( const CProjectilePool& );
+	CProjectilePool& operator=( const CProjectilePool& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Add a projectile, returns false if the pool is full
+	bool Spawn( const SProjectileDesc& desc );
+
+	// Remove all projectiles
+	void Clear()
+	{
+		m_iNumProjectiles = 0;
+	}
+
+	// Move all projectiles by their velocity and remove those whose lifetime has run out, pass
+	// the time since the last update. Removing projectiles changes the order of the others
+	void Update( TFloat32 fUpdateTime );
+
+	// Add the rectangle of each projectile to a box set, owned by the projectile's owner. The
+	// box index of projectile n is the number of boxes in the set before the call plus n
+	void AddBoxes( CBoxSet& boxes ) const;
+
+	// Remove the given projectiles, whose indices must be in increasing order. Removing
+	// projectiles changes the order of the others
+	void Remove( const TUInt32* aiProjectiles, TUInt32 iNumProjectiles );
+
+
+	TUInt32 GetNumProjectiles() const
+	{
+		return m_iNumProjectiles;
+	}
+
+	TUInt32 GetCapacity() const
+	{
+		return m_kiCapacity;
+	}
+
+	// Property arrays, indexed by projectile number up to GetNumProjectiles
+	const TFloat32* GetPosX() const { return &m_afPosX[0]; }
+	const TFloat32* GetPosY() const { return &m_afPosY[0]; }
+	const TFloat32* GetPosZ() const { return &m_afPosZ[0]; }
+	const TFloat32* GetVelX() const { return &m_afVelX[0]; }
+	const TFloat32* GetVelY() const { return &m_afVelY[0]; }
+	const TUInt32*  GetOwner() const { return &m_aiOwner[0]; }
+	const TUInt32*  GetVisual() const { return &m_aiVisual[0]; }
+	const TUInt32*  GetDamage() const { return &m_aiDamage[0]; }
+	const TUInt32*  GetKnockback() const { return &m_aiKnockback[0]; }
+	const TUInt32*  GetKnockUp() const { return &m_aiKnockUp[0]; }
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// Move the last projectile into the given element
+	void MoveLast( TUInt32 iProjectile );
+
+	const TUInt32    m_kiCapacity;
+	TUInt32          m_iNumProjectiles;
+
+	// Properties, one element for each projectile in the pool
+	vector<TFloat32> m_afPosX;
+	vector<TFloat32> m_afPosY;
+	vector<TFloat32> m_afPosZ;
+	vector<TFloat32> m_afVelX;
+	vector<TFloat32> m_afVelY;
+	vector<TFloat32> m_afHalfWidth;
+	vector<TFloat32> m_afHalfHeight;
+	vector<TFloat32> m_afLifetime;
+	vector<TUInt32>  m_aiOwner;
+	vector<TUInt32>  m_aiVisual;
+	vector<TUInt32>  m_aiDamage;
+	vector<TUInt32>  m_aiKnockback;
+	vector<TUInt32>  m_aiKnockUp;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_PROJECTILE_POOL_H_INCLUDED
@@ -0,0 +1,130 @@
+/**************************************************************************************************
+	Module:       CRadixSort.cpp
+
+	Sorting of 32-bit keys, each with an index to the item it belongs to
+
+	See header file for further notes
+**************************************************************************************************/
+
+#include "CRadixSort.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+
+// Sort keys into ascending order, keys that are equal keep their order. The insertion sort is
+// only tried if few neighbouring keys are out of order, then it is allowed a couple of moves per
+// key, which covers keys where only a few items have changed place
+void CRadixSort::Sort( vector<SSortKey>& keys )
+{
+	TUInt32 iNumKeys = static_cast<TUInt32>(keys.size());
+	TUInt32 iMaxOutOfOrder = iNumKeys / 32 + 4;
+	TUInt32 iNumOutOfOrder = 0;
+	for (TUInt32 iKey = 1; iKey < iNumKeys && iNumOutOfOrder <= iMaxOutOfOrder; ++iKey)
+	{
+		iNumOutOfOrder += keys[iKey - 1].iKey > keys[iKey].iKey;
+	}
+
+	if (iNumOutOfOrder <= iMaxOutOfOrder && InsertionSort( keys, 2 * iNumKeys + 16 ))
+	{
+		++m_iNumInsertionSorts;
+		return;
+	}
+	RadixSort( keys );
+}
+
+// Sort keys with a radix sort only. The histograms for all four bytes are counted in one pass,
+// then each byte is sorted in turn from the lowest. A byte that is the same in every key would
+// leave the order unchanged, so its pass is skipped
+void CRadixSort::RadixSort( vector<SSortKey>& keys )
+{
+	++m_iNumRadixSorts;
+	TUInt32 iNumKeys = static_cast<TUInt32>(keys.size());
+	if (iNumKeys < 2)
+	{
+		return;
+	}
+	m_aScratch.resize( iNumKeys );
+
+	TUInt32 aiCounts[4][256];
+	memset( aiCounts, 0, sizeof(aiCounts) );
+	for (TUInt32 iKey = 0; iKey < iNumKeys; ++iKey)
+	{
+		TUInt32 iValue = keys[iKey].iKey;
+		++aiCounts[0][iValue & 0xff];
+		++aiCounts[1][(iValue >> 8) & 0xff];
+		++aiCounts[2][(iValue >> 16) & 0xff];
+		++aiCounts[3][iValue >> 24];
+	}
+
+	SSortKey* pFrom = &keys[0];
+	SSortKey* pTo = &m_aScratch[0];
+	for (TUInt32 iByte = 0; iByte < 4; ++iByte)
+	{
+		TUInt32* aiByteCounts = aiCounts[iByte];
+		TUInt32 iShift = iByte * 8;
+		if (aiByteCounts[(pFrom[0].iKey >> iShift) & 0xff] == iNumKeys)
+		{
+			continue;
+		}
+
+		// Turn the counts into the position of the first key with each byte value
+		TUInt32 iPosition = 0;
+		for (TUInt32 iValue = 0; iValue < 256; ++iValue)
+		{
+			TUInt32 iCount = aiByteCounts[iValue];
+			aiByteCounts[iValue] = iPosition;
+			iPosition += iCount;
+		}
+
+		for (TUInt32 iKey = 0; iKey < iNumKeys; ++iKey)
+		{
+			pTo[aiByteCounts[(pFrom[iKey].iKey >> iShift) & 0xff]++] = pFrom[iKey];
+		}
+		SSortKey* pSwap = pFrom;
+		pFrom = pTo;
+		pTo = pSwap;
+	}
+
+	// An odd number of passes leaves the result in the scratch space
+	if (pFrom != &keys[0])
+	{
+		memcpy( &keys[0], pFrom, iNumKeys * sizeof(SSortKey) );
+	}
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+
+// Insertion sort that stops after the given number of key moves. Returns false if it stopped
+bool CRadixSort::InsertionSort( vector<SSortKey>& keys, TUInt32 iMaxMoves )
+{
+	TUInt32 iNumKeys = static_cast<TUInt32>(keys.size());
+	TUInt32 iNumMoves = 0;
+	for (TUInt32 iKey = 1; iKey < iNumKeys; ++iKey)
+	{
+		SSortKey key = keys[iKey];
+		TUInt32 iPosition = iKey;
+		while (iPosition > 0 && keys[iPosition - 1].iKey > key.iKey)
+		{
+			keys[iPosition] = keys[iPosition - 1];
+			--iPosition;
+		}
+		keys[iPosition] = key;
+
+		iNumMoves += iKey - iPosition;
+		if (iNumMoves > iMaxMoves)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+} // namespace gen
@@ -0,0 +1,114 @@
+/**************************************************************************************************
+	Module:       CRadixSort.h
+
+	Sorting of 32-bit keys, each with an index to the item it belongs to. Keys are sorted with an
+	LSD radix sort - four passes over the keys, one per byte, each pass a counting sort that keeps
+	equal keys in order. The time is linear in the number of keys whatever their order
+
+	Keys sorted each frame (e.g. depths of sprites) are usually almost in the order they were last
+	frame. If the keys are given in last frame's order, an insertion sort is tried first, which
+	takes linear time on nearly sorted keys. It gives up when the keys need too many moves and the
+	radix sort is used instead
+**************************************************************************************************/
+
+#ifndef GEN_C_RADIX_SORT_H_INCLUDED
+#define GEN_C_RADIX_SORT_H_INCLUDED
+
+#include <string.h>
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+/*---------------------------------------------------------------------------------------------
+	Sort keys
+---------------------------------------------------------------------------------------------*/
+
+// A key to sort and the index of the item it belongs to
+struct SSortKey
+{
+	TUInt32 iKey;
+	TUInt32 iIndex;
+};
+
+// Convert a float to a key that sorts in the same order as the float. Positive floats already
+// sort correctly as integers once the sign bit is set, negative floats sort in reverse so all
+// their bits are flipped
+inline TUInt32 FloatToSortKey( TFloat32 f )
+{
+	TUInt32 iBits;
+	memcpy( &iBits, &f, sizeof(iBits) );
+	return (iBits & 0x80000000) ? ~iBits : iBits | 0x80000000;
+}
+
+
+/*---------------------------------------------------------------------------------------------
+	CRadixSort class
+---------------------------------------------------------------------------------------------*/
+
+// Sorts keys into ascending order. Holds the scratch space for the radix sort so sorting each
+// frame doesn't allocate memory
+class CRadixSort
+{
+
+/*---------------------------------------------------------------------------------------------
+	Constructors / Destructors
+---------------------------------------------------------------------------------------------*/
+public:
+	CRadixSort()
+	{
+		m_iNumInsertionSorts = 0;
+		m_iNumRadixSorts = 0;
+	}
+
+private:
+	// Disallow use of copy constructor and assignment operator (private and not defined)
+	CRadixSort( const CRadixSort& );
+	CRadixSort& operator=( const CRadixSort& );
+
+
+/*---------------------------------------------------------------------------------------------
+	Public interface
+---------------------------------------------------------------------------------------------*/
+public:
+	// Sort keys into ascending order, keys that are equal keep their order. Keys that are nearly
+	// sorted already are sorted with an insertion sort, others with a radix sort
+	void Sort( vector<SSortKey>& keys );
+
+	// Sort keys with a radix sort only
+	void RadixSort( vector<SSortKey>& keys );
+
+
+	// Number of sorts done with each method, to check how often the insertion sort succeeds
+	TUInt32 GetNumInsertionSorts() const
+	{
+		return m_iNumInsertionSorts;
+	}
+	TUInt32 GetNumRadixSorts() const
+	{
+		return m_iNumRadixSorts;
+	}
+
+
+/*---------------------------------------------------------------------------------------------
+	Private interface
+---------------------------------------------------------------------------------------------*/
+private:
+	// Insertion sort that stops after the given number of key moves. Returns false if it stopped,
+	// the keys are then in a different order but not sorted
+	static bool InsertionSort( vector<SSortKey>& keys, TUInt32 iMaxMoves );
+
+
+	vector<SSortKey> m_aScratch; // Radix sort passes go back and forth between this and the keys
+
+	TUInt32 m_iNumInsertionSorts;
+	TUInt32 m_iNumRadixSorts;
+};
+
+
+} // namespace gen
+
+#endif // GEN_C_RADIX_SORT_H_INCLUDED
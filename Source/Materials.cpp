@@ -21,6 +21,9 @@ using namespace std;
 #include "Materials.h"
 #include "FMODManager.h"
 #include "UIManager.h"
+#include "CFrameLoaderDX.h"
+#include "CSpriteAtlases.h"
+#include "CParticleRenderer.h"
 //#include "vld.h"
 namespace gen
 {
@@ -71,6 +74,9 @@ extern TUInt32 MouseY;
 // Messenger class for sending messages to and between entities
 extern CMessenger Messenger;
 
+// Folder for meshes/textures
+extern const string MediaFolder;
+
 
 //-----------------------------------------------------------------------------
 // Global game/scene variables
@@ -82,8 +88,15 @@ CAnimationManager AnimationManager;
 UIManager InterfaceManager;
 CParseLevel LevelParser( &EntityManager );
 
-CParseAnimation AnimParser(&AnimationManager);
 FMODManager SoundManager;
+
+// Animation frames are loaded through a cache shared by all entities and the interface. The
+// intro video streams hundreds of full screen frames, so it has a smaller cache of its own
+CFrameLoaderDX FrameLoader;
+CFrameCache FrameCache( &FrameLoader );
+CFrameCache VideoFrameCache( &FrameLoader, 64 * 1024 * 1024 );
+CSpriteAtlases SpriteAtlases;
+CParticleRenderer ParticleRenderer;
 bool isGameMode1VS1 = true;
 bool isPlayer1Taken = false;
 // Other scene elements
@@ -150,10 +163,33 @@ bool SceneSetup()
 	
 	//////////////////////////////////////////////
 	// Read templates and entities from XML file
-	//The animation parser is the most important part of the project as it reads and imports all the movements of sprites you will see
-	AnimParser.ParseFile("Animations.xml");
+	//The animation database is the most important part of the project as it holds all the movements of sprites you will see
+	//It is parsed from the XML once and cooked to a binary file, later runs map the cooked file directly
+	AnimationManager.LoadAnimations("Animations.xml", "Animations.bin");
+	//Movement, rescales and sounds on particular frames of the player animations
+	AnimationManager.LoadAnimEvents("AnimEvents.xml");
 	LevelParser.ParseFile( "Entities.xml" );
 
+	//Character frames are packed into sprite atlases. The atlas table and the atlas textures are built on the first run
+	//and saved to the media folder, both are rebuilt whenever a frame file is added, removed or changed
+	if (!SpriteAtlases.IsCreated())
+	{
+		bool atlasesRebuilt = false;
+		if (!AnimationManager.LoadAtlasTable(MediaFolder + "Atlases.bin"))
+		{
+			AnimationManager.BuildAtlasTable(MediaFolder + "Atlases.bin");
+			atlasesRebuilt = true;
+		}
+		SpriteAtlases.Create(AnimationManager.GetAtlasTable(), MediaFolder, atlasesRebuilt);
+	}
+
+	//Particles are drawn from one vertex buffer big enough for every emitter to be full
+	if (!ParticleRenderer.IsCreated())
+	{
+		const CParticleSystem& particles = EntityManager.GetParticles();
+		ParticleRenderer.Create(particles.GetMaxEmitters() * particles.GetParticlesPerEmitter());
+	}
+
 	
 
 	
@@ -180,6 +216,10 @@ void SceneShutdown()
 	// Destroy all entities
 	EntityManager.DestroyAllEntities();
 	EntityManager.DestroyAllTemplates();
+	FrameCache.Clear();
+	VideoFrameCache.Clear();
+	SpriteAtlases.Release();
+	ParticleRenderer.Release();
 }
 
 
@@ -212,6 +252,9 @@ void RenderScene( float updateTime )
 	ShadowViewCamera->SetAspect(static_cast<TFloat32>(ViewportWidth) / ViewportHeight);
 	ShadowViewCamera->CalculateMatrices();
 	SetCamera(ShadowViewCamera);
+
+	// Entity world matrices are calculated once here for all the render passes
+	EntityManager.UpdateAllMatrices();
 	EntityManager.ShadowRenderAllEntities();
 
 	vp.Width  = ViewportWidth;
@@ -247,6 +290,8 @@ void RenderScene( float updateTime )
 	
 		SetCamera(MainCamera);
 		EntityManager.BucketRenderAllEntities();
+		EntityManager.RenderProjectiles();
+		ParticleRenderer.Render(EntityManager.GetParticles());
 		EntityManager.CollisionCalculator();
 	
 	
@@ -329,6 +374,14 @@ void RenderSceneText( float updateTime )
 			outText << "Time From Launch: " << currentTime << "ms";
 			InterfaceManager.RenderText(outText.str(), 4, 40, 1.0f, 1.0f, 0.0f, OSDFont);
 			outText.str("");
+			outText << "Matrices: " << EntityManager.GetNumMatricesUpdated() << " updated, "
+			        << EntityManager.GetNumMatricesSkipped() << " skipped";
+			InterfaceManager.RenderText(outText.str(), 4, 60, 1.0f, 1.0f, 0.0f, OSDFont);
+			outText.str("");
+			outText << "Render buckets: " << EntityManager.GetNumRenderBucketEntries() << " entries, "
+			        << EntityManager.GetRenderBucketMemory() << " bytes";
+			InterfaceManager.RenderText(outText.str(), 4, 80, 1.0f, 1.0f, 0.0f, OSDFont);
+			outText.str("");
 		}
 
 		//No monsters in this version, PvP focused 
@@ -0,0 +1,177 @@
+/*******************************************
+	CFrameCache.cpp
+
+	Cache of decoded animation frames
+********************************************/
+
+#include <chrono>
+#include <fstream>
+#include "CFrameCache.h"
+
+namespace gen
+{
+
+/*-----------------------------------------------------------------------------------------
+	CPU frame loader
+-----------------------------------------------------------------------------------------*/
+
+bool CFrameLoaderCPU::LoadFrame( const string& fileName, SFrame* frame )
+{
+	ifstream file( fileName.c_str(), ios::in | ios::binary | ios::ate );
+	if (!file)
+	{
+		return false;
+	}
+
+	SFrameData* frameData = new SFrameData;
+	frameData->data.resize( static_cast<size_t>(file.tellg()) );
+	frameData->refCount = 1;
+	file.seekg( 0, ios::beg );
+	if (frameData->data.size() && !file.read( reinterpret_cast<char*>(&frameData->data[0]), frameData->data.size() ))
+	{
+		delete frameData;
+		return false;
+	}
+
+	frame->handle = frameData;
+	frame->sizeBytes = static_cast<TUInt32>(frameData->data.size());
+	return true;
+}
+
+void CFrameLoaderCPU::AddRefFrame( const SFrame& frame )
+{
+	++static_cast<SFrameData*>(frame.handle)->refCount;
+}
+
+void CFrameLoaderCPU::ReleaseFrame( const SFrame& frame )
+{
+	SFrameData* frameData = static_cast<SFrameData*>(frame.handle);
+	if (--frameData->refCount == 0)
+	{
+		delete frameData;
+	}
+}
+
+const vector<TUInt8>& CFrameLoaderCPU::FrameData( const SFrame& frame )
+{
+	return static_cast<SFrameData*>(frame.handle)->data;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	CFrameCache class
+-----------------------------------------------------------------------------------------*/
+
+CFrameCache::CFrameCache( IFrameLoader* loader, TUInt32 budgetBytes /*= kDefaultBudget*/ )
+{
+	m_Loader = loader;
+	m_Budget = budgetBytes;
+	ResetStats();
+	m_Stats.residentFrames = 0;
+	m_Stats.residentBytes = 0;
+}
+
+CFrameCache::~CFrameCache()
+{
+	Clear();
+}
+
+
+// Get the frame for the given file, loading it if it is not resident. The returned frame
+// carries a reference owned by the caller
+bool CFrameCache::AcquireFrame( const string& fileName, SFrame* frame )
+{
+	TEntryMapIter found = m_EntryMap.find( fileName );
+	if (found != m_EntryMap.end())
+	{
+		// Resident - move to front of the use list
+		++m_Stats.hits;
+		m_Entries.splice( m_Entries.begin(), m_Entries, found->second );
+	}
+	else
+	{
+		// Not resident - decode the frame and time how long the loader takes
+		++m_Stats.misses;
+		SCacheEntry newEntry;
+		newEntry.fileName = fileName;
+
+		chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+		bool loaded = m_Loader->LoadFrame( fileName, &newEntry.frame );
+		m_Stats.decodeSeconds +=
+			chrono::duration<TFloat64>( chrono::high_resolution_clock::now() - start ).count();
+
+		if (!loaded)
+		{
+			++m_Stats.failedLoads;
+			return false;
+		}
+
+		m_Entries.push_front( newEntry );
+		m_EntryMap[fileName] = m_Entries.begin();
+		++m_Stats.residentFrames;
+		m_Stats.residentBytes += newEntry.frame.sizeBytes;
+
+		EvictToBudget();
+	}
+
+	// Add the caller's reference
+	*frame = m_Entries.front().frame;
+	m_Loader->AddRefFrame( *frame );
+	return true;
+}
+
+// Give back a reference obtained from AcquireFrame
+void CFrameCache::ReleaseFrame( const SFrame& frame )
+{
+	m_Loader->ReleaseFrame( frame );
+}
+
+
+// Change the memory budget, evicting frames immediately if over the new budget
+void CFrameCache::SetBudget( TUInt32 budgetBytes )
+{
+	m_Budget = budgetBytes;
+	EvictToBudget();
+}
+
+// Release every resident frame
+void CFrameCache::Clear()
+{
+	while (m_Entries.size())
+	{
+		m_Loader->ReleaseFrame( m_Entries.back().frame );
+		m_Entries.pop_back();
+	}
+	m_EntryMap.clear();
+	m_Stats.residentFrames = 0;
+	m_Stats.residentBytes = 0;
+}
+
+void CFrameCache::ResetStats()
+{
+	m_Stats.hits = 0;
+	m_Stats.misses = 0;
+	m_Stats.evictions = 0;
+	m_Stats.failedLoads = 0;
+	m_Stats.decodeSeconds = 0.0;
+}
+
+
+// Drop least recently used frames until within budget, the most recent frame is never dropped
+void CFrameCache::EvictToBudget()
+{
+	while (m_Stats.residentBytes > m_Budget && m_Entries.size() > 1)
+	{
+		SCacheEntry& oldest = m_Entries.back();
+		m_Stats.residentBytes -= oldest.frame.sizeBytes;
+		--m_Stats.residentFrames;
+		++m_Stats.evictions;
+
+		m_Loader->ReleaseFrame( oldest.frame );
+		m_EntryMap.erase( oldest.fileName );
+		m_Entries.pop_back();
+	}
+}
+
+
+} // namespace gen
@@ -0,0 +1,170 @@
+/*******************************************
+	CFrameCache.h
+
+	Cache of decoded animation frames, shared
+	between entities and the interface
+********************************************/
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+/////////////////////////////////////
+//	Public types
+
+// A decoded frame as handed out by a frame loader. The handle is owned by the loader backend -
+// for DirectX it is a shader resource view, for the CPU backend a block of file data
+struct SFrame
+{
+	void*   handle;
+	TUInt32 sizeBytes; // Approximate memory held by the frame while resident
+};
+
+// Counters kept by the cache, so the hit rate and decode cost can be checked
+struct SFrameCacheStats
+{
+	TUInt32  hits;
+	TUInt32  misses;
+	TUInt32  evictions;
+	TUInt32  failedLoads;
+	TUInt32  residentFrames;
+	TUInt32  residentBytes;
+	TFloat64 decodeSeconds; // Total time spent inside the loader
+};
+
+
+/*-----------------------------------------------------------------------------------------
+	Frame loader interface
+-----------------------------------------------------------------------------------------*/
+
+// A frame loader decodes a frame file into a backend object. Frames are reference counted by
+// the backend: the cache holds one reference for as long as the frame is resident, and every
+// user of a frame holds another, so evicting a frame that is still on screen is safe
+class IFrameLoader
+{
+public:
+	virtual ~IFrameLoader() {}
+
+	// Decode the given file into a frame with a single reference. Returns false on failure
+	virtual bool LoadFrame( const string& fileName, SFrame* frame ) = 0;
+
+	// Add / release a reference to a frame previously returned by LoadFrame
+	virtual void AddRefFrame( const SFrame& frame ) = 0;
+	virtual void ReleaseFrame( const SFrame& frame ) = 0;
+};
+
+
+// CPU-only loader, reads the frame file into memory without touching the GPU. Used to measure
+// cache behaviour and load times without a device
+class CFrameLoaderCPU : public IFrameLoader
+{
+public:
+	bool LoadFrame( const string& fileName, SFrame* frame );
+	void AddRefFrame( const SFrame& frame );
+	void ReleaseFrame( const SFrame& frame );
+
+	// Access the raw bytes of a frame loaded by this loader
+	static const vector<TUInt8>& FrameData( const SFrame& frame );
+
+private:
+	struct SFrameData
+	{
+		vector<TUInt8> data;
+		TUInt32        refCount;
+	};
+};
+
+
+/*-----------------------------------------------------------------------------------------
+	CFrameCache class
+-----------------------------------------------------------------------------------------*/
+
+// Frames are keyed by their file name (as found in Animations.xml, with the media folder). Each
+// frame is decoded once and kept resident until the memory budget is exceeded, at which point
+// the least recently used frames are dropped
+class CFrameCache
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	static const TUInt32 kDefaultBudget = 256 * 1024 * 1024;
+
+	// Constructor takes the loader to decode frames with and the memory budget in bytes
+	CFrameCache( IFrameLoader* loader, TUInt32 budgetBytes = kDefaultBudget );
+
+	// Destructor releases all resident frames
+	~CFrameCache();
+
+private:
+	// Prevent use of copy constructor and assignment operator (private and not defined)
+	CFrameCache( const CFrameCache& );
+	CFrameCache& operator=( const CFrameCache& );
+
+
+/////////////////////////////////////
+//	Public interface
+public:
+
+	// Get the frame for the given file, loading it if it is not resident. The returned frame
+	// carries a reference owned by the caller, which must be given back with ReleaseFrame
+	// Returns false if the frame could not be loaded
+	bool AcquireFrame( const string& fileName, SFrame* frame );
+
+	// Give back a reference obtained from AcquireFrame
+	void ReleaseFrame( const SFrame& frame );
+
+	// Change the memory budget, evicting frames immediately if over the new budget
+	void SetBudget( TUInt32 budgetBytes );
+	TUInt32 GetBudget()
+	{
+		return m_Budget;
+	}
+
+	// Release every resident frame (frames still held by users stay alive until released)
+	void Clear();
+
+	// Statistics since construction or the last ResetStats
+	const SFrameCacheStats& GetStats()
+	{
+		return m_Stats;
+	}
+	void ResetStats();
+
+
+/////////////////////////////////////
+//	Private interface
+private:
+
+	// Resident frames are held in a list in order of use, most recent at the front. The map
+	// finds a frame's list entry from its file name
+	struct SCacheEntry
+	{
+		string fileName;
+		SFrame frame;
+	};
+	typedef list<SCacheEntry>                 TEntryList;
+	typedef TEntryList::iterator              TEntryIter;
+	typedef map<string, TEntryIter>           TEntryMap;
+	typedef TEntryMap::iterator               TEntryMapIter;
+
+	// Drop least recently used frames until within budget, the most recent frame is never dropped
+	void EvictToBudget();
+
+	IFrameLoader*    m_Loader;
+	TUInt32          m_Budget;
+	TEntryList       m_Entries;
+	TEntryMap        m_EntryMap;
+	SFrameCacheStats m_Stats;
+};
+
+
+} // namespace gen
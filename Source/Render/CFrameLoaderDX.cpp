@@ -0,0 +1,130 @@
+/*******************************************
+	CFrameLoaderDX.cpp
+
+	DirectX frame loader for the frame cache
+********************************************/
+
+#include <d3dx10.h>
+#include "CFrameLoaderDX.h"
+#include "CSpriteAtlases.h"
+#include "AnimationManager.h"
+
+namespace gen
+{
+
+// Get reference to global DirectX variables from another source file
+extern ID3D10Device* g_pd3dDevice;
+
+// Global frame cache, sprite atlases and the animation manager holding the atlas table
+extern CFrameCache FrameCache;
+extern CSpriteAtlases SpriteAtlases;
+extern CAnimationManager AnimationManager;
+
+
+bool CFrameLoaderDX::LoadFrame( const string& fileName, SFrame* frame )
+{
+	ID3D10ShaderResourceView* view;
+	if (FAILED(D3DX10CreateShaderResourceViewFromFile( g_pd3dDevice, fileName.c_str(), NULL, NULL, &view, NULL )))
+	{
+		return false;
+	}
+
+	// Estimate memory use from the texture dimensions - 32-bit texels plus a third for mip-maps
+	frame->handle = view;
+	frame->sizeBytes = 0;
+	ID3D10Resource* resource;
+	view->GetResource( &resource );
+	ID3D10Texture2D* texture;
+	if (SUCCEEDED(resource->QueryInterface( __uuidof(ID3D10Texture2D), reinterpret_cast<void**>(&texture) )))
+	{
+		D3D10_TEXTURE2D_DESC desc;
+		texture->GetDesc( &desc );
+		frame->sizeBytes = desc.Width * desc.Height * 4 * 4 / 3;
+		texture->Release();
+	}
+	resource->Release();
+	return true;
+}
+
+void CFrameLoaderDX::AddRefFrame( const SFrame& frame )
+{
+	static_cast<ID3D10ShaderResourceView*>(frame.handle)->AddRef();
+}
+
+void CFrameLoaderDX::ReleaseFrame( const SFrame& frame )
+{
+	static_cast<ID3D10ShaderResourceView*>(frame.handle)->Release();
+}
+
+
+// Set a texture slot to the frame with the given file name, taken from the global frame cache
+bool SetTextureFrame( ID3D10ShaderResourceView** texture, const string& fileName )
+{
+	return SetTextureFrame( texture, fileName, FrameCache );
+}
+
+// Set a texture slot to the frame with the given file name, taken from the given frame cache.
+// The new frame is acquired before the old one is released so a repeated frame is never reloaded
+bool SetTextureFrame( ID3D10ShaderResourceView** texture, const string& fileName, CFrameCache& cache )
+{
+	SFrame frame;
+	if (!cache.AcquireFrame( fileName, &frame ))
+	{
+		return false;
+	}
+	if (*texture)
+	{
+		(*texture)->Release();
+	}
+	*texture = static_cast<ID3D10ShaderResourceView*>(frame.handle);
+	return true;
+}
+
+// Set the first texture of a material to the frame with the given file name, using the sprite
+// atlases where possible and the global frame cache otherwise
+bool SetMaterialFrame( SMeshMaterialDX* material, const string& fileName )
+{
+	return SetMaterialFrame( material, fileName, FrameCache );
+}
+
+// Set the first texture of a material to the frame with the given file name, using the sprite
+// atlases where possible and the given frame cache otherwise
+bool SetMaterialFrame( SMeshMaterialDX* material, const string& fileName, CFrameCache& cache )
+{
+	SAtlasFrame atlasFrame;
+	ID3D10ShaderResourceView* atlas = NULL;
+	if (AnimationManager.GetFrameUV( fileName, &atlasFrame ))
+	{
+		atlas = SpriteAtlases.GetView( atlasFrame.atlas );
+	}
+
+	if (atlas)
+	{
+		// Consecutive frames are usually in the same atlas, then only the UV rect changes
+		if (material->textures[0] != atlas)
+		{
+			atlas->AddRef();
+			if (material->textures[0])
+			{
+				material->textures[0]->Release();
+			}
+			material->textures[0] = atlas;
+		}
+		for (int i = 0; i < 4; ++i)
+		{
+			material->uvRect[i] = atlasFrame.uvRect[i];
+		}
+		return true;
+	}
+
+	if (!SetTextureFrame( &material->textures[0], fileName, cache ))
+	{
+		return false;
+	}
+	material->uvRect[0] = material->uvRect[1] = 0.0f;
+	material->uvRect[2] = material->uvRect[3] = 1.0f;
+	return true;
+}
+
+
+} // namespace gen
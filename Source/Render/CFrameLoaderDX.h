@@ -0,0 +1,48 @@
+/*******************************************
+	CFrameLoaderDX.h
+
+	DirectX frame loader for the frame cache
+	and helper to swap an animation frame
+********************************************/
+
+#pragma once
+
+#include <string>
+using namespace std;
+
+#include <d3d10.h>
+#include "Defines.h"
+#include "CFrameCache.h"
+#include "MeshData.h"
+
+namespace gen
+{
+
+// Loads frames into shader resource views. The view's own COM reference count is used as the
+// frame's reference count, so a view handed out by the cache can be released like any other
+class CFrameLoaderDX : public IFrameLoader
+{
+public:
+	bool LoadFrame( const string& fileName, SFrame* frame );
+	void AddRefFrame( const SFrame& frame );
+	void ReleaseFrame( const SFrame& frame );
+};
+
+
+// Set a texture slot to the frame with the given file name, taken from the global frame cache.
+// The previous texture in the slot (if any) is released. On failure the slot is left unchanged
+// and false is returned
+bool SetTextureFrame( ID3D10ShaderResourceView** texture, const string& fileName );
+
+// Set the first texture of a material to the frame with the given file name. If the frame is in a
+// sprite atlas the atlas is bound and only the material's UV rect changes, otherwise the frame is
+// taken from the frame cache as above
+bool SetMaterialFrame( SMeshMaterialDX* material, const string& fileName );
+
+// As above, but taking frames from the given cache rather than the global one. Streamed frames
+// such as the intro video use a cache of their own so they cannot evict character frames
+bool SetTextureFrame( ID3D10ShaderResourceView** texture, const string& fileName, CFrameCache& cache );
+bool SetMaterialFrame( SMeshMaterialDX* material, const string& fileName, CFrameCache& cache );
+
+
+} // namespace gen
@@ -0,0 +1,126 @@
+/*******************************************
+	CParticleRenderer.cpp
+
+	Draws the particles of a particle system
+	as camera facing quads
+********************************************/
+
+#include <d3dx10.h>
+#include "CParticleRenderer.h"
+
+namespace gen
+{
+
+// Get reference to global DirectX variables from another source file
+extern ID3D10Device* g_pd3dDevice;
+extern ID3D10Effect* Effect;
+
+
+// Create the vertex buffer and the vertex layout matching SParticleInstance
+bool CParticleRenderer::Create( TUInt32 maxInstances )
+{
+	Release();
+
+	m_Technique = Effect->GetTechniqueByName( "Particles" );
+	if (!m_Technique->IsValid())
+	{
+		SystemMessageBox( "Error selecting technique Particles", "Particle Error" );
+		m_Technique = NULL;
+		return false;
+	}
+
+	D3D10_INPUT_ELEMENT_DESC elements[] =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0,  D3D10_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R32_FLOAT,       0, 12, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+		{ "COLOR",    0, DXGI_FORMAT_R8G8B8A8_UNORM,  0, 16, D3D10_INPUT_PER_VERTEX_DATA, 0 },
+	};
+	D3D10_PASS_DESC passDesc;
+	m_Technique->GetPassByIndex( 0 )->GetDesc( &passDesc );
+	if (FAILED(g_pd3dDevice->CreateInputLayout( elements, 3, passDesc.pIAInputSignature,
+	                                            passDesc.IAInputSignatureSize, &m_VertexLayout )))
+	{
+		m_VertexLayout = NULL;
+		return false;
+	}
+
+	D3D10_BUFFER_DESC bufferDesc;
+	bufferDesc.ByteWidth = maxInstances * sizeof(SParticleInstance);
+	bufferDesc.Usage = D3D10_USAGE_DYNAMIC;
+	bufferDesc.BindFlags = D3D10_BIND_VERTEX_BUFFER;
+	bufferDesc.CPUAccessFlags = D3D10_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = 0;
+	if (FAILED(g_pd3dDevice->CreateBuffer( &bufferDesc, NULL, &m_VertexBuffer )))
+	{
+		m_VertexBuffer = NULL;
+		Release();
+		return false;
+	}
+	m_MaxInstances = maxInstances;
+	return true;
+}
+
+void CParticleRenderer::Release()
+{
+	if (m_VertexBuffer) m_VertexBuffer->Release();
+	if (m_VertexLayout) m_VertexLayout->Release();
+	m_VertexBuffer = NULL;
+	m_VertexLayout = NULL;
+	m_Technique = NULL;
+	m_MaxInstances = 0;
+}
+
+// Write every active emitter's particles into the vertex buffer, then draw each emitter's range
+void CParticleRenderer::Render( const CParticleSystem& particles )
+{
+	if (!m_VertexBuffer)
+	{
+		return;
+	}
+
+	m_EmitterStarts.clear();
+	m_EmitterCounts.clear();
+	SParticleInstance* instances;
+	if (FAILED(m_VertexBuffer->Map( D3D10_MAP_WRITE_DISCARD, 0, reinterpret_cast<void**>(&instances) )))
+	{
+		return;
+	}
+	TUInt32 numInstances = 0;
+	for (TUInt32 emitter = 0; emitter < particles.GetMaxEmitters(); ++emitter)
+	{
+		TUInt32 count = particles.GetNumParticles( emitter );
+		if (!particles.IsEmitterActive( emitter ) || count == 0 || numInstances + count > m_MaxInstances)
+		{
+			continue;
+		}
+		particles.WriteInstances( emitter, instances + numInstances );
+		m_EmitterStarts.push_back( numInstances );
+		m_EmitterCounts.push_back( count );
+		numInstances += count;
+	}
+	m_VertexBuffer->Unmap();
+	if (numInstances == 0)
+	{
+		return;
+	}
+
+	UINT stride = sizeof(SParticleInstance);
+	UINT offset = 0;
+	g_pd3dDevice->IASetVertexBuffers( 0, 1, &m_VertexBuffer, &stride, &offset );
+	g_pd3dDevice->IASetInputLayout( m_VertexLayout );
+	g_pd3dDevice->IASetPrimitiveTopology( D3D10_PRIMITIVE_TOPOLOGY_POINTLIST );
+
+	D3D10_TECHNIQUE_DESC techDesc;
+	m_Technique->GetDesc( &techDesc );
+	for (UINT p = 0; p < techDesc.Passes; ++p)
+	{
+		m_Technique->GetPassByIndex( p )->Apply( 0 );
+		for (TUInt32 draw = 0; draw < m_EmitterStarts.size(); ++draw)
+		{
+			g_pd3dDevice->Draw( m_EmitterCounts[draw], m_EmitterStarts[draw] );
+		}
+	}
+}
+
+
+} // namespace gen
@@ -0,0 +1,76 @@
+/*******************************************
+	CParticleRenderer.h
+
+	Draws the particles of a particle system
+	as camera facing quads
+********************************************/
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include <d3d10.h>
+#include "Defines.h"
+#include "CParticleSystem.h"
+
+namespace gen
+{
+
+// Each frame the instance data of every active emitter is written into one dynamic vertex
+// buffer, then each emitter is drawn with a single draw call as a list of points. The Particles
+// technique in Materials.fx expands each point into a quad facing the camera
+class CParticleRenderer
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	CParticleRenderer()
+		: m_VertexBuffer( NULL ), m_VertexLayout( NULL ), m_Technique( NULL ), m_MaxInstances( 0 ) {}
+	~CParticleRenderer()
+	{
+		Release();
+	}
+
+private:
+	// Prevent use of copy constructor and assignment operator (private and not defined)
+	CParticleRenderer( const CParticleRenderer& );
+	CParticleRenderer& operator=( const CParticleRenderer& );
+
+
+/////////////////////////////////////
+//	Public interface
+public:
+
+	// Create the vertex buffer for the given number of particles and the vertex layout for the
+	// technique, the effect must have been loaded. Returns false on failure
+	bool Create( TUInt32 maxInstances );
+
+	void Release();
+
+	bool IsCreated()
+	{
+		return m_VertexBuffer != NULL;
+	}
+
+	// Draw the particles of all active emitters, one draw per emitter. The camera must have been
+	// set. Particles past the size of the vertex buffer are not drawn
+	void Render( const CParticleSystem& particles );
+
+
+/////////////////////////////////////
+//	Private interface
+private:
+
+	ID3D10Buffer*          m_VertexBuffer;
+	ID3D10InputLayout*     m_VertexLayout;
+	ID3D10EffectTechnique* m_Technique;
+	TUInt32                m_MaxInstances;
+
+	// Start and count in the vertex buffer of each emitter drawn this frame
+	vector<TUInt32> m_EmitterStarts;
+	vector<TUInt32> m_EmitterCounts;
+};
+
+
+} // namespace gen
@@ -0,0 +1,122 @@
+/*******************************************
+	CSpriteAtlases.cpp
+
+	Atlas textures for the frames listed in
+	an atlas table
+********************************************/
+
+#include <d3dx10.h>
+#include "CSpriteAtlases.h"
+
+namespace gen
+{
+
+// Get reference to global DirectX variables from another source file
+extern ID3D10Device* g_pd3dDevice;
+
+
+// Create the atlas textures for the given table, returns the number created
+TUInt32 CSpriteAtlases::Create( const CAtlasTable& table, const string& folder, bool recompose /*= false*/ )
+{
+	Release();
+
+	TUInt32 numCreated = 0;
+	m_Views.resize( table.GetNumAtlases(), NULL );
+	for (TUInt32 atlas = 0; atlas < table.GetNumAtlases(); ++atlas)
+	{
+		string ddsFileName = folder + table.GetAtlas( atlas ).name + ".dds";
+		if (recompose ||
+		    FAILED(D3DX10CreateShaderResourceViewFromFile( g_pd3dDevice, ddsFileName.c_str(), NULL, NULL, &m_Views[atlas], NULL )))
+		{
+			m_Views[atlas] = Compose( table, atlas, ddsFileName );
+		}
+		if (m_Views[atlas])
+		{
+			++numCreated;
+		}
+	}
+	return numCreated;
+}
+
+// Release all atlas textures
+void CSpriteAtlases::Release()
+{
+	for (TUInt32 atlas = 0; atlas < m_Views.size(); ++atlas)
+	{
+		if (m_Views[atlas]) m_Views[atlas]->Release();
+	}
+	m_Views.clear();
+}
+
+
+// Build an atlas texture by copying each of its frames in, then save it as DDS
+ID3D10ShaderResourceView* CSpriteAtlases::Compose( const CAtlasTable& table, TUInt32 atlas, const string& ddsFileName )
+{
+	const SAtlasInfo& atlasInfo = table.GetAtlas( atlas );
+
+	// Single mip-map only - mip-maps of an atlas would blend neighbouring frames together
+	D3D10_TEXTURE2D_DESC atlasDesc;
+	atlasDesc.Width = atlasInfo.width;
+	atlasDesc.Height = atlasInfo.height;
+	atlasDesc.MipLevels = 1;
+	atlasDesc.ArraySize = 1;
+	atlasDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	atlasDesc.SampleDesc.Count = 1;
+	atlasDesc.SampleDesc.Quality = 0;
+	atlasDesc.Usage = D3D10_USAGE_DEFAULT;
+	atlasDesc.BindFlags = D3D10_BIND_SHADER_RESOURCE;
+	atlasDesc.CPUAccessFlags = 0;
+	atlasDesc.MiscFlags = 0;
+	ID3D10Texture2D* atlasTexture;
+	if (FAILED(g_pd3dDevice->CreateTexture2D( &atlasDesc, NULL, &atlasTexture )))
+	{
+		return NULL;
+	}
+
+	// Load each frame at its original size in the same format as the atlas, then copy it in
+	D3DX10_IMAGE_LOAD_INFO loadInfo;
+	loadInfo.Width = D3DX10_FROM_FILE;
+	loadInfo.Height = D3DX10_FROM_FILE;
+	loadInfo.Depth = D3DX10_FROM_FILE;
+	loadInfo.FirstMipLevel = 0;
+	loadInfo.MipLevels = 1;
+	loadInfo.Usage = D3D10_USAGE_DEFAULT;
+	loadInfo.BindFlags = D3D10_BIND_SHADER_RESOURCE;
+	loadInfo.CpuAccessFlags = 0;
+	loadInfo.MiscFlags = 0;
+	loadInfo.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	loadInfo.Filter = D3DX10_FILTER_NONE;
+	loadInfo.MipFilter = D3DX10_FILTER_NONE;
+	loadInfo.pSrcInfo = NULL;
+	for (TUInt32 frame = 0; frame < table.GetNumFrames(); ++frame)
+	{
+		const SAtlasFrame& atlasFrame = table.GetFrame( frame );
+		if (atlasFrame.atlas != atlas)
+		{
+			continue;
+		}
+
+		ID3D10Resource* frameTexture;
+		if (FAILED(D3DX10CreateTextureFromFile( g_pd3dDevice, table.GetFrameName( frame ).c_str(), &loadInfo, NULL, &frameTexture, NULL )))
+		{
+			atlasTexture->Release();
+			return NULL;
+		}
+		g_pd3dDevice->CopySubresourceRegion( atlasTexture, 0, atlasFrame.x, atlasFrame.y, 0, frameTexture, 0, NULL );
+		frameTexture->Release();
+	}
+
+	// Save so the atlas can be loaded directly next time, failure to save is not an error
+	D3DX10SaveTextureToFile( atlasTexture, D3DX10_IFF_DDS, ddsFileName.c_str() );
+
+	ID3D10ShaderResourceView* view;
+	if (FAILED(g_pd3dDevice->CreateShaderResourceView( atlasTexture, NULL, &view )))
+	{
+		view = NULL;
+	}
+	atlasTexture->Release();
+	return view;
+}
+
+
+} // namespace gen
@@ -0,0 +1,76 @@
+/*******************************************
+	CSpriteAtlases.h
+
+	Atlas textures for the frames listed in
+	an atlas table
+********************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include <d3d10.h>
+#include "Defines.h"
+#include "CAtlasTable.h"
+
+namespace gen
+{
+
+// Holds one shader resource view per atlas in an atlas table. Each atlas is loaded from a DDS file
+// in the given folder, or if that is missing it is composed from the individual frame files and
+// then saved as DDS so later runs only need to load it
+class CSpriteAtlases
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	CSpriteAtlases() {}
+	~CSpriteAtlases()
+	{
+		Release();
+	}
+
+private:
+	// Prevent use of copy constructor and assignment operator (private and not defined)
+	CSpriteAtlases( const CSpriteAtlases& );
+	CSpriteAtlases& operator=( const CSpriteAtlases& );
+
+
+/////////////////////////////////////
+//	Public interface
+public:
+
+	// Create the atlas textures for the given table. Atlases saved by an earlier run are loaded
+	// unless recompose is set (the table has just been rebuilt). Atlases that cannot be created
+	// are left empty (frames in them fall back to individual textures). Returns the number created
+	TUInt32 Create( const CAtlasTable& table, const string& folder, bool recompose = false );
+
+	// Release all atlas textures
+	void Release();
+
+	bool IsCreated()
+	{
+		return !m_Views.empty();
+	}
+
+	// Get the view of the given atlas, NULL if it could not be created
+	ID3D10ShaderResourceView* GetView( TUInt32 atlas )
+	{
+		return atlas < m_Views.size() ? m_Views[atlas] : NULL;
+	}
+
+
+/////////////////////////////////////
+//	Private interface
+private:
+
+	// Build an atlas texture by copying each of its frames in, then save it as DDS
+	ID3D10ShaderResourceView* Compose( const CAtlasTable& table, TUInt32 atlas, const string& ddsFileName );
+
+	vector<ID3D10ShaderResourceView*> m_Views;
+};
+
+
+} // namespace gen
@@ -53,6 +53,9 @@ Texture2D GodrayOcclusionMap;
 float GodrayStart;
 float GodrayWidth;
 int FlipHorizontal;
+
+// Area of the diffuse map to use as offset (u,v) and scale - selects a frame from a sprite atlas
+float4 UVRect = float4(0.0f, 0.0f, 1.0f, 1.0f);
 static const int NUM_SAMPLES = 100;
 // Samplers to use with the above texture maps. Specifies texture filtering and addressing mode to use when accessing texture pixels
 SamplerState TrilinearWrap
@@ -181,6 +184,21 @@ struct PS_PARTICLE_OUTPUT
     float Depth : SV_Depth;
 };
 
+// A particle from the CPU particle system, a point with a size that is expanded into a quad
+struct VS_PARTICLE_INPUT
+{
+    float3 Pos : POSITION;
+    float Size : TEXCOORD0;
+    float4 Colour : COLOR0;
+};
+
+struct PS_PARTICLE_COLOUR_INPUT
+{
+    float4 ProjPos : SV_Position;
+    float2 Corner : TEXCOORD0; // -1 to 1 across the quad
+    float4 Colour : COLOR0;
+};
+
 //--------------------------------------------------------------------------------------
 // Vertex Shaders
 //--------------------------------------------------------------------------------------
@@ -211,7 +229,7 @@ VS_FOG_BASIC_OUTPUT VSFogVertexShader(VS_INPUT vIn)
 	vOut.ProjPos = mul(viewPos, ProjMatrix);
 
 	// Pass texture coordinates (UVs) on to the pixel shader
-	vOut.UV = vIn.UV;
+	vOut.UV = UVRect.xy + vIn.UV * UVRect.zw;
 	float4 cameraPosition;
 	cameraPosition = mul(float4(vIn.Pos, 1.0f), WorldMatrix);
 	cameraPosition = mul(cameraPosition, ViewMatrix);
@@ -232,7 +250,7 @@ VS_TEX_OUTPUT VSBasicTransform(VS_INPUT vIn)
 	vOut.ProjPos = mul(viewPos, ProjMatrix);
 
 	// Pass texture coordinates (UVs) on to the pixel shader
-	vOut.UV = vIn.UV;
+	vOut.UV = UVRect.xy + vIn.UV * UVRect.zw;
 
 	return vOut;
 }
@@ -247,7 +265,7 @@ VS_TEX_OUTPUT VSShadowTransform(VS_INPUT vIn)
 	vOut.ProjPos = mul(viewPos, ProjMatrix);
 
 	// Pass texture coordinates (UVs) on to the pixel shader
-	vOut.UV = vIn.UV;
+	vOut.UV = UVRect.xy + vIn.UV * UVRect.zw;
 
 	vOut.UV.y -= vOut.UV.y;
 	return vOut;
@@ -266,7 +284,7 @@ VS_TEX_OUTPUT VSTransformTex( VS_INPUT vIn )
 	vOut.ProjPos    = mul( viewPos,  ProjMatrix );
 	
 	// Pass texture coordinates (UVs) on to the pixel shader
-	vOut.UV = vIn.UV;
+	vOut.UV = UVRect.xy + vIn.UV * UVRect.zw;
 	float4 cameraPosition;
 	cameraPosition = mul(float4(vIn.Pos, 1.0f), WorldMatrix);
 	cameraPosition = mul(cameraPosition, ViewMatrix);
@@ -355,7 +373,7 @@ VS_LIGHTINGTEX_OUTPUT VSPixelLitTex( VS_INPUT vIn )
 	vOut.ProjPos    = mul( viewPos,  ProjMatrix );
 
 	// Pass texture coordinates (UVs) on to the pixel shader, the vertex shader doesn't need them
-	vOut.UV = vIn.UV;
+	vOut.UV = UVRect.xy + vIn.UV * UVRect.zw;
 
 	float4 cameraPosition;
 	cameraPosition = mul(float4(vIn.Pos, 1.0f), WorldMatrix);
@@ -407,6 +425,36 @@ VS_GODRAYS_OUTPUT VSGodrays(VS_INPUT vIn)
 	return vOut;
 }
 
+// Particles are already in world space, so are passed straight to the geometry shader
+VS_PARTICLE_INPUT VSParticle(VS_PARTICLE_INPUT vIn)
+{
+	return vIn;
+}
+
+//--------------------------------------------------------------------------------------
+// Geometry Shaders
+//--------------------------------------------------------------------------------------
+
+// Expand a particle point into a quad facing the camera, by offsetting the corners in view space
+[maxvertexcount(4)]
+void GSParticle(point VS_PARTICLE_INPUT inParticle[1], inout TriangleStream<PS_PARTICLE_COLOUR_INPUT> outStrip)
+{
+	const float2 corners[4] = { float2(-1.0f, 1.0f), float2(1.0f, 1.0f), float2(-1.0f, -1.0f), float2(1.0f, -1.0f) };
+	float4 viewPos = mul(float4(inParticle[0].Pos, 1.0f), ViewMatrix);
+
+	PS_PARTICLE_COLOUR_INPUT vOut;
+	vOut.Colour = inParticle[0].Colour;
+	for (int i = 0; i < 4; i++)
+	{
+		float4 cornerPos = viewPos;
+		cornerPos.xy += corners[i] * inParticle[0].Size;
+		vOut.ProjPos = mul(cornerPos, ProjMatrix);
+		vOut.Corner = corners[i];
+		outStrip.Append(vOut);
+	}
+	outStrip.RestartStrip();
+}
+
 //--------------------------------------------------------------------------------------
 // Pixel Shaders
 //--------------------------------------------------------------------------------------
@@ -445,7 +493,7 @@ float4 PSTexColour( VS_TEX_OUTPUT vOut ) : SV_Target
 }
 float4 PSTexColour_FlipHorizontal(VS_TEX_OUTPUT vOut) : SV_Target
 {
-    vOut.UV *= float2(-1.0, 1.0);
+    vOut.UV.x = 2.0f * UVRect.x + UVRect.z - vOut.UV.x; // Mirror within the frame's area of the texture
     float4 diffuseMapColour = DiffuseMap.Sample(TrilinearWrap, vOut.UV);
     return float4(DiffuseColour.xyz * diffuseMapColour.xyz, diffuseMapColour.a); // Only tint the RGB, get alpha from texture directly
 }
@@ -903,6 +951,13 @@ PS_PARTICLE_OUTPUT PS_SoftParticle(PS_PARTICLE_INPUT pIn)
     pOut.Depth = pIn.ProjPos.z;
     return pOut;
 }
+
+// Particle colour, fading out towards the edge of the quad to give a round particle
+float4 PSParticle(PS_PARTICLE_COLOUR_INPUT pIn) : SV_Target
+{
+    float fade = saturate(1.0f - dot(pIn.Corner, pIn.Corner));
+    return float4(pIn.Colour.rgb, pIn.Colour.a * fade);
+}
 //--------------------------------------------------------------------------------------
 // States
 //--------------------------------------------------------------------------------------
@@ -1143,4 +1198,20 @@ technique10 ParallaxMapping
 	}
 }
 
+// CPU particles, drawn as a point list with a quad made for each point
+technique10 Particles
+{
+	pass P0
+	{
+		SetVertexShader(CompileShader(vs_4_0, VSParticle()));
+		SetGeometryShader(CompileShader(gs_4_0, GSParticle()));
+		SetPixelShader(CompileShader(ps_4_0, PSParticle()));
+
+		// Blended particles don't hide each other
+		SetBlendState(AlphaBlending, float4(0.0f, 0.0f, 0.0f, 0.0f), 0xFFFFFFFF);
+		SetRasterizerState(CullNone);
+		SetDepthStencilState(DepthWritesOff, 0);
+	}
+}
+
 
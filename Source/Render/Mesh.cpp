@@ -504,6 +504,10 @@ bool CMesh::CreateMaterialDX
 	materialDX->specularColour = D3DXCOLOR( material.specularColour.r, material.specularColour.g, 
 	                                        material.specularColour.b, material.specularColour.a );
 	materialDX->specularPower = material.specularPower;
+	materialDX->uvRect[0] = 0.0f;
+	materialDX->uvRect[1] = 0.0f;
+	materialDX->uvRect[2] = 1.0f;
+	materialDX->uvRect[3] = 1.0f;
 
 	// Load material textures
 	materialDX->numTextures = material.numTextures;
@@ -610,39 +614,6 @@ bool CMesh::PreProcess()
 //-----------------------------------------------------------------------------
 
 // Render the model using the given matrix list as a hierarchy (must be one matrix per node)
-
-
-
-void CMesh::PreRender(CMatrix4x4* matrices) {
-
-	if (!m_HasGeometry) return;
-
-	for (TUInt32 subMesh = 0; subMesh < m_NumSubMeshes; ++subMesh)
-	{
-		// Get a reference to the submesh and its material to reduce code clutter
-
-		SSubMeshDX& subMeshDX = m_SubMeshesDX[subMesh];
-		SMeshMaterialDX& material = m_Materials[subMeshDX.material];
-
-		SMeshBucketRenderData s_RenderData;
-		s_RenderData.subMeshDX = subMeshDX;
-		
-		s_RenderData.material = material;
-		s_RenderData.matrix = matrices;
-		s_RenderData.m_HasGeometry = m_HasGeometry;
-
-		s_RenderData.technique = GetRenderMethodTechnique(s_RenderData.material.renderMethod);
-		SMeshBucketRenderData& s_byRefRenderData = s_RenderData;
-		
-		// Set up render method passing material colours & textures and the sub-mesh's world matrix, also get back the fx file technique to use
-		
-		submeshRenderData.push_back(s_byRefRenderData);
-		
-		
-
-	}
-}
-
 void CMesh::Render(CMatrix4x4* matrices)
 {
 	if (!m_HasGeometry) return;
@@ -654,6 +625,7 @@ void CMesh::Render(CMatrix4x4* matrices)
 		SMeshMaterialDX& material = m_Materials[subMeshDX.material];
 
 		// Set up render method passing material colours & textures and the sub-mesh's world matrix, also get back the fx file technique to use
+		SetTextureRect(material.uvRect);
 		SetRenderMethod(material.renderMethod, &material.diffuseColour, &material.specularColour, material.specularPower, material.textures, &matrices[subMeshDX.node]);
 		ID3D10EffectTechnique* technique = GetRenderMethodTechnique(material.renderMethod);
 
@@ -689,6 +661,7 @@ void CMesh::ShadowMapRender(CMatrix4x4* matrices)
 		SMeshMaterialDX& material = m_Materials[subMeshDX.material];
 
 		// Set up render method passing material colours & textures and the sub-mesh's world matrix, also get back the fx file technique to use
+		SetTextureRect(material.uvRect);
 		SetRenderMethod(DepthOnly , &material.diffuseColour, &material.specularColour, material.specularPower, material.textures, &matrices[subMeshDX.node]);
 		ID3D10EffectTechnique* technique = GetRenderMethodTechnique(DepthOnly);
 		// Select vertex and index buffer for sub-mesh - assuming all geometry data is triangle lists
@@ -729,6 +702,7 @@ void CMesh::BucketRender(CMatrix4x4* matrices, ERenderMethod method, TUInt32 sub
 	
 		
 		// Set up render method passing material colours & textures and the sub-mesh's world matrix, also get back the fx file technique to use
+		SetTextureRect(material.uvRect);
 		SetRenderMethod(method,&material.diffuseColour, &material.specularColour, material.specularPower, material.textures, &matrices[subMeshDX.node]);
 
 
@@ -119,7 +119,6 @@ public:
 
 	// Render the model using the given matrix list as a hierarchy (must be one matrix per node)
 	void Render( CMatrix4x4* matrices );
-	void PreRender(CMatrix4x4* matrices );
 	virtual void BucketRender(CMatrix4x4* matrices, ERenderMethod method, TUInt32 submesh);
 	void ShadowMapRender(CMatrix4x4* matrices);
 /*-----------------------------------------------------------------------------------------
@@ -141,14 +140,15 @@ private:
 	
 	
 	public:
-		SMeshBucketRenderData GetSubMesh(int num)
-		{
-			return submeshRenderData[num];
-		}
 		TUInt32  GetSubMeshCount()
 		{
 			return m_NumSubMeshes;
 		}
+		// Render method of the material used by a sub-mesh
+		ERenderMethod GetSubMeshRenderMethod( TUInt32 subMesh )
+		{
+			return m_Materials[m_SubMeshesDX[subMesh].material].renderMethod;
+		}
 		
 	/////////////////////////////////////
 	// Support functions
@@ -176,7 +176,6 @@ private:
 
 	bool HasMaterialChosen(ERenderMethod material, TUInt32 submesh);
 
-	meshRenderData submeshRenderData;
 	/*---------------------------------------------------------------------------------------------
 		Data
 	---------------------------------------------------------------------------------------------*/
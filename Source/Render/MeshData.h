@@ -107,20 +107,12 @@ struct SMeshMaterialDX
 
 	TUInt32       numTextures;
 	ID3D10ShaderResourceView* textures[kiMaxTextures];
-};
 
-struct SMeshBucketRenderData
-{
-	SSubMeshDX subMeshDX;
-	SMeshMaterialDX material;
-	CMatrix4x4* matrix;
-	bool m_HasGeometry;
-	ID3D10EffectTechnique* technique;
+	// Area of the first texture to use as offset (u,v) and scale - (0,0,1,1) for the whole
+	// texture, otherwise a single frame within a sprite atlas
+	TFloat32      uvRect[4];
 };
 
-
-typedef vector<SMeshBucketRenderData> meshRenderData;
-
 } // namespace gen
 
 #endif // GEN_MESH_H_INCLUDED
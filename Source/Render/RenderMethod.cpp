@@ -229,6 +229,8 @@ ID3D10EffectScalarVariable* FogEndVar = NULL;
 ID3D10EffectScalarVariable* FogEnableVar = NULL;
 //Flipped
 ID3D10EffectScalarVariable* FlipHorizontalVar = NULL;
+// Sprite atlas frame
+ID3D10EffectVectorVariable* UVRectVar = NULL;
 
 //-----------------------------------------------------------------------------
 // Method initialisation
@@ -263,6 +265,7 @@ bool InitialiseMethods()
 	ShadowViewMatrixVar = Effect->GetVariableByName("ShadowViewMatrix")->AsMatrix();
 	ShadowProjMatrixVar = Effect->GetVariableByName("ShadowProjMatrix")->AsMatrix();
 	FlipHorizontalVar = Effect->GetVariableByName("FlipHorizontal")->AsScalar();
+	UVRectVar = Effect->GetVariableByName("UVRect")->AsVector();
 	// Access lighting shader variables
 	Light1PosVar     = Effect->GetVariableByName( "Light1Pos"     )->AsVector();
 	Light1ColourVar  = Effect->GetVariableByName( "Light1Colour"  )->AsVector();
@@ -359,6 +362,12 @@ void SetCamera( CCamera* camera )
 	CameraPosVar->SetRawValue( &camera->Position(), 0, 12 );
 }
 
+// Set the area of the diffuse map to use, as offset (u,v) and scale
+void SetTextureRect( const TFloat32* uvRect )
+{
+	UVRectVar->SetRawValue( const_cast<TFloat32*>(uvRect), 0, 16 );
+}
+
 
 //-----------------------------------------------------------------------------
 // Specific render method setup functions
@@ -126,6 +126,10 @@ void SetLights( CLight** lights );
 // Set the camera to use for all methods
 void SetCamera( CCamera* camera );
 
+// Set the area of the diffuse map to use, as offset (u,v) and scale. Used to select a frame from
+// a sprite atlas, pass (0,0,1,1) for the whole texture
+void SetTextureRect( const TFloat32* uvRect );
+
 
 
 
@@ -0,0 +1,162 @@
+/*******************************************
+	CEntityComponents.cpp
+
+	Physics and gameplay state of all entities,
+	stored as one array per value
+********************************************/
+
+#include "CEntityComponents.h"
+
+namespace gen
+{
+
+namespace
+{
+	// Move the last element of an array into the given index and remove the last element
+	template <class T> void RemoveSwap( vector<T>& values, TUInt32 index )
+	{
+		values[index] = values.back();
+		values.pop_back();
+	}
+}
+
+
+// Add an entry with default values to the end of the arrays, returns its index
+TUInt32 CEntityComponents::Add()
+{
+	posX.push_back( 0.0f );
+	posY.push_back( 0.0f );
+	groundLevel.push_back( 10.0f );
+	gravity.push_back( 2.5f );
+	gravityScale.push_back( 2.0f );
+	upwardVel.push_back( 0.0f );
+	horizontalVel.push_back( 0.0f );
+	flags.push_back( 0 );
+	animChangeTimer.push_back( 0.0f );
+	return Size() - 1;
+}
+
+// Remove an entry, the last entry is moved into its place
+void CEntityComponents::Remove( TUInt32 index )
+{
+	RemoveSwap( posX, index );
+	RemoveSwap( posY, index );
+	RemoveSwap( groundLevel, index );
+	RemoveSwap( gravity, index );
+	RemoveSwap( gravityScale, index );
+	RemoveSwap( upwardVel, index );
+	RemoveSwap( horizontalVel, index );
+	RemoveSwap( flags, index );
+	RemoveSwap( animChangeTimer, index );
+}
+
+// Copy an entry over another
+void CEntityComponents::Move( TUInt32 from, TUInt32 to )
+{
+	posX[to] = posX[from];
+	posY[to] = posY[from];
+	groundLevel[to] = groundLevel[from];
+	gravity[to] = gravity[from];
+	gravityScale[to] = gravityScale[from];
+	upwardVel[to] = upwardVel[from];
+	horizontalVel[to] = horizontalVel[from];
+	flags[to] = flags[from];
+	animChangeTimer[to] = animChangeTimer[from];
+}
+
+// Remove all entries from the given index onwards
+void CEntityComponents::Truncate( TUInt32 size )
+{
+	posX.resize( size );
+	posY.resize( size );
+	groundLevel.resize( size );
+	gravity.resize( size );
+	gravityScale.resize( size );
+	upwardVel.resize( size );
+	horizontalVel.resize( size );
+	flags.resize( size );
+	animChangeTimer.resize( size );
+}
+
+// Remove all entries
+void CEntityComponents::Clear()
+{
+	posX.clear();
+	posY.clear();
+	groundLevel.clear();
+	gravity.clear();
+	gravityScale.clear();
+	upwardVel.clear();
+	horizontalVel.clear();
+	flags.clear();
+	animChangeTimer.clear();
+}
+
+// Reserve space for the given number of entries
+void CEntityComponents::Reserve( TUInt32 size )
+{
+	posX.reserve( size );
+	posY.reserve( size );
+	groundLevel.reserve( size );
+	gravity.reserve( size );
+	gravityScale.reserve( size );
+	upwardVel.reserve( size );
+	horizontalVel.reserve( size );
+	flags.reserve( size );
+	animChangeTimer.reserve( size );
+}
+
+
+/////////////////////////////////////
+// Systems
+
+// Apply impulses in the order given
+void CEntityComponents::ApplyImpulses( const SKinematicImpulse* impulses, TUInt32 numImpulses )
+{
+	for (TUInt32 impulse = 0; impulse < numImpulses; ++impulse)
+	{
+		TUInt32 i = impulses[impulse].index;
+		upwardVel[i] = impulses[impulse].upwardVel;
+		horizontalVel[i] = impulses[impulse].horizontalVel;
+		flags[i] = (flags[i] | Kinematic_Simulated | Kinematic_InAir) & ~Kinematic_Landed;
+	}
+}
+
+// Move simulated entities by their velocities then apply gravity to those in the air. Works the
+// same way as the player's gravity did. The loop selects values rather than branching so the
+// compiler can vectorise it
+void CEntityComponents::UpdateKinematics( TFloat32 step, TFloat32 timeStopScale )
+{
+	TUInt32 size = Size();
+	if (size == 0)
+	{
+		return;
+	}
+
+	TFloat32* x = &posX[0];
+	TFloat32* y = &posY[0];
+	TFloat32* ground = &groundLevel[0];
+	TFloat32* g = &gravity[0];
+	TFloat32* gScale = &gravityScale[0];
+	TFloat32* upVel = &upwardVel[0];
+	TFloat32* horzVel = &horizontalVel[0];
+	TUInt32*  kinematics = &flags[0];
+	for (TUInt32 i = 0; i < size; ++i)
+	{
+		TFloat32 simulated = (kinematics[i] & Kinematic_Simulated) ? 1.0f : 0.0f;
+		TFloat32 inAir = (kinematics[i] & Kinematic_InAir) ? simulated : 0.0f;
+		TFloat32 timeScale = (kinematics[i] & Kinematic_TimeUnaffected) ? 1.0f : timeStopScale;
+
+		x[i] += horzVel[i] * simulated;
+		y[i] += upVel[i] * simulated;
+		upVel[i] -= g[i] * gScale[i] * timeScale * step * inAir;
+
+		bool landed = inAir != 0.0f && y[i] < ground[i];
+		y[i] = landed ? ground[i] : y[i];
+		upVel[i] = landed ? 0.0f : upVel[i];
+		kinematics[i] = landed ? (kinematics[i] & ~Kinematic_InAir) | Kinematic_Landed : kinematics[i];
+	}
+}
+
+
+} // namespace gen
@@ -0,0 +1,124 @@
+/*******************************************
+	CEntityComponents.h
+
+	Physics and gameplay state of all entities,
+	stored as one array per value
+********************************************/
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+/////////////////////////////////////
+//	Public types
+
+// Flags describing the kinematics of an entity
+enum EKinematicFlags
+{
+	Kinematic_Simulated      = 1, // Position is moved by UpdateKinematics
+	Kinematic_InAir          = 2, // Falling under gravity
+	Kinematic_Held           = 4, // Only simulated in the update this is set, the owner sets it
+	                              // again each update the entity should keep moving
+	Kinematic_Landed         = 8, // Landed on the ground, cleared by the owner or an impulse
+	Kinematic_TimeUnaffected = 16, // Gravity is not changed while time is stopped
+};
+
+// A change of velocity for an entity, e.g. from being hit. Sets the velocities and puts the
+// entity in the air
+struct SKinematicImpulse
+{
+	TUInt32  index;
+	TFloat32 upwardVel;
+	TFloat32 horizontalVel;
+};
+
+
+/////////////////////////////////////
+//	CEntityComponents class
+
+// Physics and gameplay state of the entities, as a structure of arrays. Entry i belongs to the
+// entity at index i in the entity manager's list and entries are removed in the same way (the
+// last entry moves into the gap) so the arrays stay packed. The update functions step through
+// whole arrays without branching on entity type, only touching the values they use
+class CEntityComponents
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	CEntityComponents() {}
+
+private:
+	// Prevent use of copy constructor and assignment operator (private and not defined)
+	CEntityComponents( const CEntityComponents& );
+	CEntityComponents& operator=( const CEntityComponents& );
+
+
+/////////////////////////////////////
+//	Public interface
+public:
+
+	// Add an entry with default values to the end of the arrays, returns its index
+	TUInt32 Add();
+
+	// Remove an entry, the last entry is moved into its place
+	void Remove( TUInt32 index );
+
+	// Copy an entry over another, used with Truncate to remove several entries in one pass
+	void Move( TUInt32 from, TUInt32 to );
+
+	// Remove all entries from the given index onwards
+	void Truncate( TUInt32 size );
+
+	// Remove all entries
+	void Clear();
+
+	// Reserve space for the given number of entries
+	void Reserve( TUInt32 size );
+
+	TUInt32 Size() const
+	{
+		return static_cast<TUInt32>(flags.size());
+	}
+
+
+	/////////////////////////////////////
+	// Systems
+
+	// Apply impulses in the order given, a later impulse for the same entity replaces an earlier
+	// one. The entities become simulated and in the air
+	void ApplyImpulses( const SKinematicImpulse* impulses, TUInt32 numImpulses );
+
+	// Move simulated entities by their velocities then apply gravity to those in the air, scaled
+	// by each entity's gravity scale and, unless unaffected, by timeStopScale. Entities that fall
+	// below their ground level land on it, leave the air and are marked as landed. Always called
+	// with the same fixed step, so velocities are movement per step
+	void UpdateKinematics( TFloat32 step, TFloat32 timeStopScale );
+
+
+	/////////////////////////////////////
+	// Data
+
+	// Transform - root node position of simulated entities
+	vector<TFloat32> posX;
+	vector<TFloat32> posY;
+
+	// Kinematics, velocities are movement per physics step
+	vector<TFloat32> groundLevel;
+	vector<TFloat32> gravity;
+	vector<TFloat32> gravityScale;
+	vector<TFloat32> upwardVel;
+	vector<TFloat32> horizontalVel;
+	vector<TUInt32>  flags; // EKinematicFlags, 32-bit so stores cannot alias the float arrays
+
+	// Animation
+	vector<TFloat32> animChangeTimer;
+};
+
+
+} // namespace gen
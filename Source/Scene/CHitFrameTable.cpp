@@ -0,0 +1,252 @@
+/*******************************************
+	CHitFrameTable.cpp
+
+	Which frames of each attack sequence deal
+	a hit, as one bitmask per sequence
+********************************************/
+
+#include "CHitFrameTable.h"
+#include "AnimationManager.h"
+
+namespace gen
+{
+
+namespace
+{
+	// Number of set bits in a 64-bit value
+	TUInt32 CountBits( TUInt64 bits )
+	{
+		bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+		bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+		bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0full;
+		return static_cast<TUInt32>((bits * 0x0101010101010101ull) >> 56);
+	}
+}
+
+
+CHitFrameTable::CHitFrameTable( TUInt32 numSequences )
+{
+	m_Sequences.resize( numSequences );
+	Clear();
+}
+
+
+// Make a frame of a sequence a hit frame
+void CHitFrameTable::AddHitFrame( TUInt32 sequence, TUInt32 frame, TUInt32 flags )
+{
+	if (sequence >= m_Sequences.size() || frame >= MaxHitFrames)
+	{
+		return;
+	}
+
+	SSequence& seq = m_Sequences[sequence];
+	TUInt32 index = HitIndex( seq, frame );
+	if (IsHitFrame( sequence, frame ))
+	{
+		seq.hits[index].flags = flags;
+		return;
+	}
+
+	SHitFrame hit;
+	hit.frame = frame;
+	hit.flags = flags;
+	seq.hits.insert( seq.hits.begin() + index, hit );
+	seq.mask[frame / 64] |= 1ull << (frame % 64);
+}
+
+// Remove all hit frames
+void CHitFrameTable::Clear()
+{
+	for (TUInt32 sequence = 0; sequence < m_Sequences.size(); ++sequence)
+	{
+		for (TUInt32 word = 0; word < kMaskWords; ++word)
+		{
+			m_Sequences[sequence].mask[word] = 0;
+		}
+		m_Sequences[sequence].hits.clear();
+	}
+}
+
+
+// Get the data of a hit frame, NULL if the frame does not deal a hit
+const SHitFrame* CHitFrameTable::GetHitFrame( TUInt32 sequence, TUInt32 frame ) const
+{
+	if (!IsHitFrame( sequence, frame ))
+	{
+		return 0;
+	}
+	const SSequence& seq = m_Sequences[sequence];
+	return &seq.hits[HitIndex( seq, frame )];
+}
+
+// Index of a hit frame in its sequence's hits - the number of hit frames before it
+TUInt32 CHitFrameTable::HitIndex( const SSequence& sequence, TUInt32 frame ) const
+{
+	TUInt32 index = 0;
+	for (TUInt32 word = 0; word < frame / 64; ++word)
+	{
+		index += CountBits( sequence.mask[word] );
+	}
+	TUInt64 below = (1ull << (frame % 64)) - 1;
+	return index + CountBits( sequence.mask[frame / 64] & below );
+}
+
+
+
+/////////////////////////////////////
+//	Player hit frames
+
+// Hit frames of a player's attack sequences. Jotaro's attacks end at his stand's ultimate, Dio's go on
+// to his own ultimate. Dio's stand rush hits on every third frame, so needs the length of its sequence
+void SetPlayerHitFrames( CHitFrameTable* table, bool isPlayerJotaro, TUInt32 numOraFrames )
+{
+	TInt32 lastSequence = isPlayerJotaro ? AttackAnimsPlayerFinish : Ult_Num_1;
+	table->Clear();
+	if (isPlayerJotaro)
+	{
+		for (int i = AttackAnimsPlayerStart; i <= lastSequence; i++)
+		{
+			switch (i)
+			{
+			case Light_Leg_Att:
+				table->AddHitFrame(i, 2);
+				break;
+			case Light_Crouch_Att:
+				table->AddHitFrame(i, 6);
+				break;
+			case Medium_Att:
+				table->AddHitFrame(i, 4);
+				break;
+			case Medium_Walk_Att:
+				table->AddHitFrame(i, 4);
+				break;
+			case Medium_Crouch_Att:
+				table->AddHitFrame(i, 3);
+				break;
+			case Medium_Air_Att:
+				table->AddHitFrame(i, 2);
+				break;
+			case Heavy_Att:
+				table->AddHitFrame(i, 4);
+				break;
+			case Heavy_Walk_Att:
+				table->AddHitFrame(i, 6);
+				break;
+			case Heavy_Crouch_Att:
+				table->AddHitFrame(i, 5);
+				break;
+			case Heavy_Crouch_Fr_Att:
+				table->AddHitFrame(i, 6);
+				break;
+			case Heavy_Air_Att:
+				table->AddHitFrame(i, 4);
+				break;
+			case Throw:
+				table->AddHitFrame(i, 6);
+				table->AddHitFrame(i, 16, HitFrame_Finisher);
+				break;
+			case Stando_OraOraOra:
+				table->AddHitFrame(i, 3);
+				table->AddHitFrame(i, 6);
+				table->AddHitFrame(i, 9);
+				table->AddHitFrame(i, 12);
+				table->AddHitFrame(i, 15);
+				break;
+			case Stando_Sp_2:
+				table->AddHitFrame(i, 8);
+				break;
+			case Stando_Sp_3:
+				table->AddHitFrame(i, 4);
+				table->AddHitFrame(i, 8);
+				break;
+			case Stando_Sp_4:
+				table->AddHitFrame(i, 12);
+				break;
+			case Stando_Ult_1:
+				for (int ult = 5; ult < 105; ult +=2)
+				{
+					if(ult < 105)
+					table->AddHitFrame(i, ult);
+				}
+			default:
+				break;
+			}
+		}
+	}
+	else if (!isPlayerJotaro)
+	{
+		for (int i = AttackAnimsPlayerStart; i <= lastSequence; i++)
+		{
+			switch (i)
+			{
+			case Light_Leg_Att:
+				table->AddHitFrame(i, 1);
+				break;
+			case Light_Crouch_Att:
+				table->AddHitFrame(i, 1);
+				break;
+			case Medium_Att:
+				table->AddHitFrame(i, 3);
+				table->AddHitFrame(i, 6);
+				break;
+			case Medium_Walk_Att:
+				table->AddHitFrame(i, 3);
+				table->AddHitFrame(i, 6);
+				break;
+			case Medium_Crouch_Att:
+				table->AddHitFrame(i, 4);
+				break;
+			case Medium_Air_Att:
+				table->AddHitFrame(i, 2);
+				break;
+			case Heavy_Att:
+				table->AddHitFrame(i, 2);
+				break;
+			case Heavy_Walk_Att:
+				table->AddHitFrame(i, 3);
+				break;
+			case Heavy_Crouch_Att:
+				table->AddHitFrame(i, 4);
+				break;
+			case Heavy_Air_Att:
+				table->AddHitFrame(i, 4);
+				break;
+			case Throw:
+				table->AddHitFrame(i, 6);
+				table->AddHitFrame(i, 14, HitFrame_Finisher);
+				break;
+			case Stando_OraOraOra:
+				for (TUInt32 frame = 1; frame < numOraFrames; frame += 3)
+				{
+					table->AddHitFrame(i, frame);
+				}
+				break;
+			case Special_Num_4:
+				table->AddHitFrame(i, 14);
+				table->AddHitFrame(i, 16);
+				table->AddHitFrame(i, 20);
+				table->AddHitFrame(i, 30);
+				break;
+			case Stando_Sp_3:
+				table->AddHitFrame(i, 4);
+				table->AddHitFrame(i, 8);
+				break;
+			case Stando_Sp_4:
+				table->AddHitFrame(i, 12);
+				break;
+			case Ult_Num_1:
+				table->AddHitFrame(i, 1, HitFrame_Launcher);
+				table->AddHitFrame(i, 2, HitFrame_Launcher);
+				for (int ult = 12; ult < 130; ult += 5)
+				{
+					table->AddHitFrame(i, ult);
+				}
+			default:
+				break;
+			}
+		}
+	}
+}
+
+
+} // namespace gen
@@ -0,0 +1,108 @@
+/*******************************************
+	CHitFrameTable.h
+
+	Which frames of each attack sequence deal
+	a hit, as one bitmask per sequence
+********************************************/
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+#include "Defines.h"
+
+namespace gen
+{
+
+/////////////////////////////////////
+//	Public types
+
+// Longest sequence that can have hit frames, frames past this are never hit frames
+static const TUInt32 MaxHitFrames = 256;
+
+// Flags describing a particular hit
+enum EHitFrameFlags
+{
+	HitFrame_Finisher = 1, // Last hit of a throw - full damage and knockback
+	HitFrame_Launcher = 2, // Opening hit of an ultimate that launches the opponent
+};
+
+// Data carried by each hit frame. Damage and knockback stay per sequence in the player's
+// HitMessageComposer, which also composes the stand's hits from the player's sequence
+struct SHitFrame
+{
+	TUInt32 frame;
+	TUInt32 flags; // EHitFrameFlags
+};
+
+
+/////////////////////////////////////
+//	CHitFrameTable class
+
+// Hit frames of every sequence of a character. Each sequence has a bitmask with a bit per frame, so
+// testing whether a frame deals a hit is a single bit test. The data of the hit frames is stored
+// in frame order and found by counting the mask bits below the frame
+class CHitFrameTable
+{
+/////////////////////////////////////
+//	Constructors/Destructors
+public:
+	CHitFrameTable( TUInt32 numSequences );
+
+/////////////////////////////////////
+//	Public interface
+public:
+
+	// Make a frame of a sequence a hit frame. Setting the same frame again replaces its flags
+	void AddHitFrame( TUInt32 sequence, TUInt32 frame, TUInt32 flags = 0 );
+
+	// Remove all hit frames
+	void Clear();
+
+	// Whether the frame of a sequence deals a hit - out of range sequences and frames never do
+	bool IsHitFrame( TUInt32 sequence, TUInt32 frame ) const
+	{
+		if (sequence >= m_Sequences.size() || frame >= MaxHitFrames)
+		{
+			return false;
+		}
+		return ((m_Sequences[sequence].mask[frame / 64] >> (frame % 64)) & 1) != 0;
+	}
+
+	// Get the data of a hit frame, NULL if the frame does not deal a hit
+	const SHitFrame* GetHitFrame( TUInt32 sequence, TUInt32 frame ) const;
+
+	TUInt32 GetNumHitFrames( TUInt32 sequence ) const
+	{
+		return sequence < m_Sequences.size() ? static_cast<TUInt32>(m_Sequences[sequence].hits.size()) : 0;
+	}
+
+
+/////////////////////////////////////
+//	Private interface
+private:
+	static const TUInt32 kMaskWords = MaxHitFrames / 64;
+
+	struct SSequence
+	{
+		TUInt64           mask[kMaskWords];
+		vector<SHitFrame> hits; // One per set bit, in frame order
+	};
+
+	// Index of a hit frame in its sequence's hits - the number of hit frames before it
+	TUInt32 HitIndex( const SSequence& sequence, TUInt32 frame ) const;
+
+	vector<SSequence> m_Sequences;
+};
+
+
+/////////////////////////////////////
+//	Player hit frames
+
+// Fill a table with the hit frames of Jotaro's or Dio's attack sequences. numOraFrames is the length
+// of the Stando_OraOraOra sequence
+void SetPlayerHitFrames( CHitFrameTable* table, bool isPlayerJotaro, TUInt32 numOraFrames );
+
+
+} // namespace gen
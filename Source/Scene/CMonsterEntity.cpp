@@ -14,8 +14,8 @@ namespace gen {
 
 		for (int i = 0; i < MonsterAnimTypeCount; i++)
 		{
-			MonsterAnimsRight[i].swap(AnimationManager.GetMonsterAnimSequence(Zombie,i,true));
-			MonsterAnimsLeft[i].swap(AnimationManager.GetMonsterAnimSequence(Zombie, i, false));
+			MonsterAnimsRight[i] = AnimationManager.GetMonsterAnimSequence(Zombie,i,true);
+			MonsterAnimsLeft[i] = AnimationManager.GetMonsterAnimSequence(Zombie, i, false);
 		}
 		
 
@@ -33,15 +33,7 @@ namespace gen {
 	}
 	bool CMonsterEntity::RenderAnim()
 	{
-		string fullFileName;
-		if (isFacingRight)
-		{
-			fullFileName = MediaFolder + MonsterAnimsRight[Walk][10].second;
-		}
-		else if (!isFacingRight)
-		{
-			fullFileName = MediaFolder + MonsterAnimsLeft[Walk][10].second;
-		}
+		const string& fullFileName = isFacingRight ? MonsterAnimsRight[Walk].GetFullPath(10) : MonsterAnimsLeft[Walk].GetFullPath(10);
 		if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &MeshAnimFrame, NULL)))
 		{
 			string errorMsg = "Error loading texture " + fullFileName;
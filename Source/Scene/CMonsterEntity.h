@@ -17,8 +17,8 @@ namespace gen {
 	bool RenderAnim();
 		 ID3D10ShaderResourceView* MeshAnimFrame = NULL;
 		 CMatrix4x4 MeshMatrix ; 
-		 AnimationSequence MonsterAnimsRight[LastMonsterAnims];
-		 AnimationSequence MonsterAnimsLeft[LastMonsterAnims];
+		 CAnimSequenceView MonsterAnimsRight[LastMonsterAnims];
+		 CAnimSequenceView MonsterAnimsLeft[LastMonsterAnims];
 		 // Relative and absolute world matrices for each node in the template's mesh
 	private: 
 		 bool isFacingRight = false;
@@ -10,6 +10,7 @@
 #include "UIManager.h"
 #include "Messenger.h"
 #include "EntityManager.h"
+#include "CFrameLoaderDX.h"
 
 namespace gen
 {
@@ -44,13 +45,19 @@ namespace gen
 		m_Template = entityTemplate;
 		m_UID = UID;
 		m_Name = name;
+		m_ComponentIndex = EntityManager.GetEntityIndex( UID ); // Component entry is already added
+		m_IsBaseEntity = false;
 		monsterComponent = NULL;
 
 
-		// Allocate space for matrices
+		// Allocate space for matrices, relative and world matrices in a single array
 		TUInt32 numNodes = m_Template->Mesh()->GetNumNodes();
-		m_RelMatrices = new CMatrix4x4[numNodes];
-		m_Matrices = new CMatrix4x4[numNodes];
+		m_NumNodes = numNodes;
+		Mesh = m_Template->Mesh();
+		i_subMeshCount = Mesh->GetSubMeshCount();
+		m_RelMatrices = EntityManager.AllocateMatrices( 2 * numNodes );
+		m_Matrices = m_RelMatrices + numNodes;
+		m_DirtyNodes = ~0u; // No world matrices calculated yet
 		isTexFlippedHorizontal = false;
 		// Set initial matrices from mesh defaults
 		for (TUInt32 node = 0; node < numNodes; ++node)
@@ -64,39 +71,66 @@ namespace gen
 
 		AssembleMonster();
 
+		//Everything that is not a player or a tree, is a house, since we care only for the name string
+		isFloatingClutter = m_Name.find("House") != std::string::npos;
+
 		if (m_UID > 30)
 		{
 			int i = 0;
 		}
 	}
 
-	void CEntity::PreRender()
+	// Calculate absolute matrices from relative node matrices & node heirarchy, only for nodes that
+	// have changed and their children. Nodes are in depth-first order so parents come first and a
+	// node is dirty if its parent is. Incorporating bone<->mesh offsets isn't needed (only for
+	// skinning)
+	void CEntity::UpdateMatrices(TUInt32& numUpdated, TUInt32& numSkipped)
 	{
-		Mesh = m_Template->Mesh();
-		// Calculate absolute matrices from relative node matrices & node heirarchy
-		m_Matrices[0] = m_RelMatrices[0];
-		TUInt32 numNodes = Mesh->GetNumNodes();
-		for (TUInt32 node = 1; node < numNodes; ++node)
+		if (m_DirtyNodes == 0)
 		{
-			m_Matrices[node] = m_RelMatrices[node] * m_Matrices[Mesh->GetNode(node).parent];
+			numSkipped += m_NumNodes;
+			return;
 		}
-		// Incorporate any bone<->mesh offsets (only relevant for skinning)
-		// Don't need this step for this exercise
 
-		// Render with absolute matrices
-		Mesh->PreRender(m_Matrices);
-		i_subMeshCount = Mesh->GetSubMeshCount();
-		for (int i = 0; i < Mesh->GetSubMeshCount(); i++)
+		CMesh* Mesh = m_Template->Mesh();
+		if (m_DirtyNodes & NodeBit(0))
 		{
-			SMeshBucketRenderData& buf = Mesh->GetSubMesh(i);
-			buf.matrix = m_Matrices;
-			renderdata.push_back(buf);
-			renderMethods.push_back(buf.material.renderMethod);
-			submeshToRender.push_back(buf.material.renderMethod);
+			m_Matrices[0] = m_RelMatrices[0];
+			++numUpdated;
 		}
+		else
+		{
+			++numSkipped;
+		}
+		for (TUInt32 node = 1; node < m_NumNodes; ++node)
+		{
+			TUInt32 parent = Mesh->GetNode(node).parent;
+			if (m_DirtyNodes & (NodeBit(node) | NodeBit(parent)))
+			{
+				m_DirtyNodes |= NodeBit(node);
+				m_Matrices[node] = m_RelMatrices[node] * m_Matrices[parent];
+				++numUpdated;
+			}
+			else
+			{
+				++numSkipped;
+			}
+		}
+		m_DirtyNodes = 0;
+	}
 
-		renderMethodSize = renderMethods.size();
+	// Destructor returns the matrices to the entity manager
+	CEntity::~CEntity()
+	{
+		EntityManager.FreeMatrices( m_RelMatrices, 2 * m_NumNodes );
+	}
 
+	// The entity manager puts the entity in its render buckets when it is created, so this only
+	// needs to make sure the absolute matrices are ready. PreRender is called before the first update
+	void CEntity::PreRender()
+	{
+		TUInt32 numUpdated = 0, numSkipped = 0;
+		UpdateMatrices(numUpdated, numSkipped);
 	}
 	// Render the model
 	void CEntity::Render()
@@ -104,34 +138,27 @@ namespace gen
 		// Get pointer to mesh to simplify code
 		CMesh* Mesh = m_Template->Mesh();
 
-		// Calculate absolute matrices from relative node matrices & node heirarchy
-		m_Matrices[0] = m_RelMatrices[0];
-		TUInt32 numNodes = Mesh->GetNumNodes();
-		for (TUInt32 node = 1; node < numNodes; ++node)
-		{
-			m_Matrices[node] = m_RelMatrices[node] * m_Matrices[Mesh->GetNode(node).parent];
-		}
-		// Incorporate any bone<->mesh offsets (only relevant for skinning)
-		// Don't need this step for this exercise
-
 		// Render with absolute matrices
 		Mesh->Render(m_Matrices);
 	}
 
-	void CEntity::ShadowRender()
+	// Render the model with its root node at the given matrix, the other nodes are placed relative
+	// to it in the same way as in UpdateMatrices
+	void CEntity::RenderAt(const CMatrix4x4& rootMatrix, CMatrix4x4* matrices)
 	{
-		// Get pointer to mesh to simplify code
 		CMesh* Mesh = m_Template->Mesh();
-
-		// Calculate absolute matrices from relative node matrices & node heirarchy
-		m_Matrices[0] = m_RelMatrices[0];
-		TUInt32 numNodes = Mesh->GetNumNodes();
-		for (TUInt32 node = 1; node < numNodes; ++node)
+		matrices[0] = rootMatrix;
+		for (TUInt32 node = 1; node < m_NumNodes; ++node)
 		{
-			m_Matrices[node] = m_RelMatrices[node] * m_Matrices[Mesh->GetNode(node).parent];
+			matrices[node] = m_RelMatrices[node] * matrices[Mesh->GetNode(node).parent];
 		}
-		// Incorporate any bone<->mesh offsets (only relevant for skinning)
-		// Don't need this step for this exercise
+		Mesh->Render(matrices);
+	}
+
+	void CEntity::ShadowRender()
+	{
+		// Get pointer to mesh to simplify code
+		CMesh* Mesh = m_Template->Mesh();
 
 		// Render with absolute matrices
 		if (m_Name != "Floor" || m_Name != "Sun")
@@ -140,17 +167,7 @@ namespace gen
 
 	void CEntity::BucketRender(ERenderMethod method)
 	{
-		// Get pointer to mesh to simplify code
-
-		// Calculate absolute matrices from relative node matrices & node heirarchy
-		m_Matrices[0] = m_RelMatrices[0];
-		TUInt32 numNodes = Mesh->GetNumNodes();
-
-		for (TUInt32 node = 1; node < numNodes; ++node)
-		{
-			m_Matrices[node] = m_RelMatrices[node] * m_Matrices[Mesh->GetNode(node).parent];
-		}
-
+		// Absolute matrices were calculated in UpdateMatrices
 
 
 		// Render with material buckets
@@ -163,26 +180,18 @@ namespace gen
 		}
 
 	}
+
 	//Animate function for the monsters, which is not used now
 	bool CEntity::Animate(TFloat32 updateTime)
 	{
 
-		string fullFileName;
-		if (isFacingRight)
-		{
-			fullFileName = MediaFolder + MonsterAnimsRight[thisMonsterType][currentAnim].second;
-		}
-		else if (!isFacingRight)
-		{
-			fullFileName = MediaFolder + MonsterAnimsLeft[thisMonsterType][currentAnim].second;
-
-		}
+		const string& fullFileName = isFacingRight ? MonsterAnimsRight[thisMonsterType].GetFullPath(currentAnim)
+		                                           : MonsterAnimsLeft[thisMonsterType].GetFullPath(currentAnim);
 		
-		if (animChangeTimer >= animCycleDelay)
+		if (AnimChangeTimer() >= animCycleDelay)
 		{
-			animChangeTimer = 0.0f;
-			Mesh->m_Materials->textures[0]->Release();
-			if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &Mesh->m_Materials->textures[0], NULL)))
+			AnimChangeTimer() = 0.0f;
+			if (!SetMaterialFrame(Mesh->m_Materials, fullFileName))
 			{
 				string errorMsg = "Error loading texture " + fullFileName;
 				SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -194,8 +203,7 @@ namespace gen
 		{
 			currentAnim = 0;
 		}
-		dmgImmunityTimer -= updateTime * AnimMultSlow;
-		animChangeTimer += updateTime * AnimMultNormal;
+		AnimChangeTimer() += updateTime * AnimMultNormal;
 		return true;
 
 
@@ -226,27 +234,73 @@ namespace gen
 		}
 	}
 	bool CEntity::Update(TFloat32 updateTime)
+	{
+		if (UpdateIndependent(updateTime))
+		{
+			return ResolveUpdate();
+		}
+		return true;
+	}
+
+	// Part of the update that only changes this entity
+	bool CEntity::UpdateIndependent(TFloat32 updateTime)
 	{
 		if (isDeleted)
 		{
-			return true;
+			return false;
 		}
-		//Everything that is not a player or a tree, is a house, since we care only for the name string
 		//Clutter falling on the background is moved here
-		if (m_Name.find("House") != std::string::npos)
+		if (isFloatingClutter)
 		{
 			
 				FloatingCounter += updateTime * 100;
 			//We do not move clutter when Dio stops time
 				if(!EntityManager.zaWarudoEnabled)
 			this->Matrix().MoveY(sin(FloatingCounter));
-			if (this->Matrix().GetY() < -500)
-			{
-				this->Matrix().SetY(300 + Random(0, 1000));
-			}
+			//Clutter that fell out of view goes back to the top, which uses the shared random numbers
+			return this->Matrix().GetY() < -500;
 		}
+		return false;
+	}
+
+	// Part of the update run on the main thread, base entities only need it to put fallen clutter
+	// back at the top
+	bool CEntity::ResolveUpdate()
+	{
+		this->Matrix().SetY(300 + Random(0, 1000));
 		return true;
 	}
+
+	// Physics and gameplay state, at the entity's index in the entity manager's component arrays
+	TFloat32& CEntity::GroundLevel()
+	{
+		return EntityManager.Components().groundLevel[m_ComponentIndex];
+	}
+	TFloat32& CEntity::Gravity()
+	{
+		return EntityManager.Components().gravity[m_ComponentIndex];
+	}
+	TFloat32& CEntity::GravityScale()
+	{
+		return EntityManager.Components().gravityScale[m_ComponentIndex];
+	}
+	TFloat32& CEntity::UpwardVel()
+	{
+		return EntityManager.Components().upwardVel[m_ComponentIndex];
+	}
+	TFloat32& CEntity::HorizontalVel()
+	{
+		return EntityManager.Components().horizontalVel[m_ComponentIndex];
+	}
+	TUInt32& CEntity::KinematicFlags()
+	{
+		return EntityManager.Components().flags[m_ComponentIndex];
+	}
+	TFloat32& CEntity::AnimChangeTimer()
+	{
+		return EntityManager.Components().animChangeTimer[m_ComponentIndex];
+	}
+
 	//It renders hp bar above any enemy, not used
 	bool CEntity::RenderEntityUI(TFloat32 updateTime)
 	{
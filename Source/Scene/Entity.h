@@ -136,11 +136,7 @@ public:
 	);
 
 	// Destructor - base class destructors should always be virtual
-	virtual ~CEntity()
-	{
-		delete[] m_Matrices;
-		delete[] m_RelMatrices;
-	}
+	virtual ~CEntity();
 
 private:
 	// Prevent use of copy constructor and assignment operator (private and not defined)
@@ -170,29 +166,48 @@ public:
 		return m_Name;
 	}
 
-	SMeshBucketRenderData getSubmeshData(int num)
-	{
-		return renderdata[num];
-	}
-	int getSubmeshCount()
-	{
-		return renderdata.size();
-
-	}
+	/////////////////////////////////////
+	// Physics and gameplay state
+
+	// The entity manager holds this state in arrays, see CEntityComponents
+	TFloat32& GroundLevel();
+	TFloat32& Gravity();
+	TFloat32& GravityScale();
+	TFloat32& UpwardVel();
+	TFloat32& HorizontalVel();
+	TUInt32& KinematicFlags(); // EKinematicFlags
+	TFloat32& AnimChangeTimer();
 	
 	/////////////////////////////////////
 	// Matrix access
 
-	// Direct access to position and matrix
+	// Direct access to position and matrix. The access may change the node, so its world matrix
+	// (and those of its children) are recalculated in the next UpdateMatrices
 	CVector3& Position( TUInt32 node = 0 )
 	{
+		m_DirtyNodes |= NodeBit( node );
 		return m_RelMatrices[node].Position();
 	}
 	virtual CMatrix4x4& Matrix( TUInt32 node = 0 )
 	{
+		m_DirtyNodes |= NodeBit( node );
 		return m_RelMatrices[node];
 	}
 
+	// Read-only access to position and matrix, which leaves the node's world matrix as it is
+	const CVector3& GetPosition( TUInt32 node = 0 ) const
+	{
+		return m_RelMatrices[node].Position();
+	}
+	const CMatrix4x4& GetMatrix( TUInt32 node = 0 ) const
+	{
+		return m_RelMatrices[node];
+	}
+
+	// Calculate the world matrices of nodes that have changed since the last call, and of their
+	// children. Adds the number of node matrices calculated and skipped to the given counts
+	void UpdateMatrices( TUInt32& numUpdated, TUInt32& numSkipped );
+
 	int GetSubMeshCount()
 	{
 		return i_subMeshCount;
@@ -206,40 +221,45 @@ public:
 	// Virtual function, base version does nothing
 	virtual bool Update(TFloat32 updateTime);
 
+	// The entity manager updates independent entities in two parts rather than calling Update.
+	// UpdateIndependent runs in parallel with other entities' updates so must only change this
+	// entity, it returns true if ResolveUpdate is needed. ResolveUpdate runs on the main thread in
+	// entity order and returns false if the entity is to be destroyed. Only entities created as
+	// base class entities are independent by default - a derived class is updated through its
+	// Update one at a time unless it overrides IsIndependent along with the two parts
+	virtual bool IsIndependent() { return m_IsBaseEntity; }
+	virtual bool UpdateIndependent(TFloat32 updateTime);
+	virtual bool ResolveUpdate();
+
 	virtual bool Animate(TFloat32 updateTime, bool isFacingRight, int AnimationType) { return true; }
 	 virtual bool RenderEntityUI(TFloat32 updateTime);
 
-	// Render the entity
+	// Render the entity, using the world matrices from the last UpdateMatrices
 	void PreRender();
 	void Render();
 	void BucketRender(ERenderMethod method);
 	void ShadowRender();
-	vector<ERenderMethod> renderMethods;
-	vector<int> submeshToRender;
 
-	int renderMethodSize;
+	// Render the model with its root at the given world matrix rather than its own, for instances
+	// such as projectiles sharing this entity's mesh. The node world matrices are calculated into
+	// the given array of GetNumNodes() matrices, so the entity's own matrices are left as they are
+	void RenderAt( const CMatrix4x4& rootMatrix, CMatrix4x4* matrices );
+	TUInt32 GetNumNodes() const
+	{
+		return m_NumNodes;
+	}
+
 	bool isTexFlippedHorizontal;
 	bool doNotTouch = false;
 	bool isDepthSorted = false;
-	float depthFromCamera;
 	CMesh* Mesh;
-	float animChangeTimer = 0.0f;
 	float animCycleDelay = 10.5;
-	float dmgImmunityTimer = 0.0f;
 	TInt32 AnimMultNormal = 250;
 	TInt32 AnimMultSlow = 75;
 	TInt32 AnimMultFast = 350;
 	TInt32 AnimMultSplitSec = 500;
-	float FloatingCounter;
-	TFloat32 m_GroundLevel = 10.0f;
-	TFloat32 m_Gravity = 2.5f;
-	TFloat32 m_UpdwardVel = 0.0f;
-	bool isInAir = false;
-	TFloat32 m_HorizontalVel = 0.0f;
-	bool isInKnockback = false;
-	bool isKnockbackRight = true;
-
-	TFloat32 deathTimer = 0.0f;
+	float FloatingCounter = 0.0f;
+	bool isFloatingClutter; // Houses float around the background
 	bool isDeleted = false;
 	int currentAnim = 0;
 	bool isAMonster = false;
@@ -268,17 +288,34 @@ private:
 	TEntityUID  m_UID;
 	string      m_Name;
 
+	// Index of the entity's physics and gameplay state in the entity manager's component arrays,
+	// the same as its index in the manager's entity list. The manager updates it when it moves
+	// the entity in the list
+	friend class CEntityManager;
+	TUInt32     m_ComponentIndex;
+
+	// Set by the entity manager when it creates the entity as a base class entity
+	bool        m_IsBaseEntity;
+
 	// Relative and absolute world matrices for each node in the template's mesh
-	CMatrix4x4* m_RelMatrices; // Dynamically allocated arrays
+	CMatrix4x4* m_RelMatrices; // Both in one array from the entity manager's matrix arena
 	CMatrix4x4* m_Matrices;
+	TUInt32     m_NumNodes;
+
+	// Nodes whose world matrices need recalculating, bit n for node n. Nodes from 31 onwards
+	// share the top bit
+	TUInt32     m_DirtyNodes;
+	static TUInt32 NodeBit( TUInt32 node )
+	{
+		return 1u << (node < 31 ? node : 31);
+	}
 
 	int i_subMeshCount;
-	meshRenderData renderdata;
 
 	bool Animate(TFloat32 updateTime);
 
-	AnimationSequence MonsterAnimsRight[LastMonsterAnims];
-	AnimationSequence MonsterAnimsLeft[LastMonsterAnims];
+	CAnimSequenceView MonsterAnimsRight[LastMonsterAnims];
+	CAnimSequenceView MonsterAnimsLeft[LastMonsterAnims];
 	// Relative and absolute world matrices for each node in the template's mesh
 	private:
 		bool isFacingRight = false;
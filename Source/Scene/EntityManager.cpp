@@ -10,8 +10,10 @@
 #include "Mesh.h"
 #include "MathDX.h"
 #include <algorithm>
+#include <new>
 #include "FMODManager.h"
 #include "UIManager.h"
+#include "AnimationManager.h"
 namespace gen
 {
 	extern ID3D10Device* g_pd3dDevice;
@@ -20,21 +22,28 @@ namespace gen
 	extern CMessenger Messenger;
 	extern FMODManager SoundManager;
 	extern UIManager InterfaceManager;
+	extern CAnimationManager AnimationManager;
 /////////////////////////////////////
 // Constructors/Destructors
 
-// Constructor reserves space for entities and UID hash map, also sets first UID
+// Constructor reserves space for entities, UID slots and the name index
 CEntityManager::CEntityManager()
+	: m_EntityUIDs( 1024 ), m_EntityNameIndex( 256, 1024 ),
+	  m_CollisionGrid( 64.0f ), m_Projectiles( kMaxProjectiles ),
+	  m_Particles( kMaxParticleEmitters, kParticlesPerEmitter )
 {
-	// Initialise list of entities and UID hash map
+	// Initialise list of entities, UID slots and name index
 	m_Entities.reserve( 1024 );
-	m_EntityUIDMap = new CHashTable<TEntityUID, TUInt32>( 2048, JOneAtATimeHash ); 
-
-	// Set first entity UID that will be used
-	m_NextUID = 0;
+	m_Components.Reserve( 1024 );
 
 
 	m_IsEnumerating = false;
+	m_IsUpdating = false;
+	m_NumDestroysQueued = 0;
+	m_JobSystem = 0;
+	m_PhysicsTime = 0.0f;
+	m_NumMatricesUpdated = 0;
+	m_NumMatricesSkipped = 0;
 	MonsterTypeStrings[0] = "Zombie";
 }
 
@@ -42,6 +51,7 @@ CEntityManager::CEntityManager()
 CEntityManager::~CEntityManager()
 {
 	DestroyAllEntities();
+	delete m_JobSystem;
 }
 
 
@@ -103,7 +113,8 @@ void CEntityManager::DestroyAllTemplates()
 // Entity creation / destruction
 
 // Create a base class entity - requires a template name, may supply entity name and position
-// Returns the UID of the new entity
+// Returns the UID of the new entity. During UpdateAllEntities the entity is created after the
+// update instead, see QueueCreateEntity
 TEntityUID CEntityManager::CreateEntity
 (
 	const string&    templateName,
@@ -112,6 +123,76 @@ TEntityUID CEntityManager::CreateEntity
 	const CVector3&  rotation /*= CVector3( 0.0f, 0.0f, 0.0f )*/,
 	const CVector3&  scale /*= CVector3( 1.0f, 1.0f, 1.0f )*/
 )
+{
+	if (m_IsUpdating)
+	{
+		return QueueCreate( false, templateName, name, position, rotation, scale );
+	}
+
+	// Get vector index for new entity and a UID pointing at it
+	TUInt32 entityIndex = static_cast<TUInt32>(m_Entities.size());
+	TEntityUID UID = NewUID( entityIndex );
+	AddEntity( UID, false, templateName, name, position, rotation, scale );
+
+	// Return UID of new entity
+	return UID;
+}
+
+// Create a base class entity after the current update (or immediately if not updating). Returns
+// the UID the entity will have, GetEntity returns 0 for it until the entity is created
+TEntityUID CEntityManager::QueueCreateEntity
+(
+	const string&    templateName,
+	const string&    name /*= ""*/,
+	const CVector3&  position /*= CVector3::kOrigin*/, 
+	const CVector3&  rotation /*= CVector3( 0.0f, 0.0f, 0.0f )*/,
+	const CVector3&  scale /*= CVector3( 1.0f, 1.0f, 1.0f )*/
+)
+{
+	return CreateEntity( templateName, name, position, rotation, scale );
+}
+
+// Queue the creation of a base class or player entity for the end of the update. Returns the
+// UID the entity will have
+TEntityUID CEntityManager::QueueCreate
+(
+	bool             isPlayer,
+	const string&    templateName,
+	const string&    name,
+	const CVector3&  position,
+	const CVector3&  rotation,
+	const CVector3&  scale
+)
+{
+	// Reserve a UID, but leave it invalid until the entity is created
+	TEntityUID UID = m_EntityUIDs.Reserve();
+	m_EntityUIDs.Data( UID ).destroyQueued = false;
+
+	SCreateCommand command;
+	command.UID = UID;
+	command.isPlayer = isPlayer;
+	command.templateName = templateName;
+	command.name = name;
+	command.position = position;
+	command.rotation = rotation;
+	command.scale = scale;
+	command.cancelled = false;
+	m_CreateCommands.push_back( command );
+	return UID;
+}
+
+// Construct a base class or player entity with the given UID, whose slot must already point at
+// the end of the entity list, and add it to the list, name index and entity lists
+void CEntityManager::AddEntity
+(
+	TEntityUID       UID,
+	bool             isPlayer,
+	const string&    templateName,
+	const string&    name,
+	const CVector3&  position,
+	const CVector3&  rotation,
+	const CVector3&  scale
+)
 {
 	// Get template associated with the template name
 	CEntityTemplate* entityTemplate = GetTemplate( templateName );
@@ -119,25 +200,31 @@ TEntityUID CEntityManager::CreateEntity
 	{
 		LevelMonsters.push_back(name);
 	}
-	// Create new entity with next UID
-	CEntity* newEntity = new CEntity( entityTemplate, m_NextUID, name, position, rotation, scale );
+	m_Components.Add(); // Before the entity is created, it may use its state in its constructor
 
-	// Get vector index for new entity and add it to vector
-	TUInt32 entityIndex = static_cast<TUInt32>(m_Entities.size());
+	// Create new entity and add it to vector
+	m_EntityUIDs.Data( UID ).isPlayer = isPlayer;
+	CEntity* newEntity;
+	if (isPlayer)
+	{
+		newEntity = new (m_PlayerPool.Allocate())
+			CPlayerEntity( entityTemplate, UID, name, position, rotation, scale );
+	}
+	else
+	{
+		newEntity = new (m_EntityPool.Allocate())
+			CEntity( entityTemplate, UID, name, position, rotation, scale );
+		newEntity->m_IsBaseEntity = true;
+	}
 	m_Entities.push_back( newEntity );
-
-	// Add mapping from UID to entity index into hash map
-	m_EntityUIDMap->SetKeyValue( m_NextUID, entityIndex );
-	
-	m_IsEnumerating = false; // Cancel any entity enumeration (entity list has changed)
-
-	// Return UID of new entity then increase it ready for next entity
-	return m_NextUID++;
+	m_EntityNameIndex.Add( UID, name );
+	AddToEntityLists( UID, entityTemplate );
+	AddToRenderBuckets( UID, entityTemplate );
 }
 
-// Create a planet, requires a planet template name, may supply entity name and position
-// Returns the UID of the new entity
-
+// Create a player entity, requires a template name, may supply entity name and position
+// Returns the UID of the new entity. During UpdateAllEntities the entity is created after the
+// update instead
 TEntityUID CEntityManager::CreatePlayer
 (
 	const string&   templateName,
@@ -147,85 +234,611 @@ TEntityUID CEntityManager::CreatePlayer
 	const CVector3& scale /*= CVector3( 1.0f, 1.0f, 1.0f )*/
 )
 {
-	// Get planet template associated with the template name
-	CEntityTemplate* playerTemplate = GetTemplate(templateName);
-
-	// Create new planet entity with next UID
-	CPlayerEntity* newEntity =
-		new CPlayerEntity(playerTemplate, m_NextUID, name, position, rotation, scale);
-
-	// Get vector index for new entity and add it to vector
-	TUInt32 entityIndex = static_cast<int>(m_Entities.size());
-	m_Entities.push_back(newEntity);
-
-	// Add mapping from UID to entity index into hash map
-	m_EntityUIDMap->SetKeyValue(999, entityIndex);
+	if (m_IsUpdating)
+	{
+		return QueueCreate( true, templateName, name, position, rotation, scale );
+	}
 
-	m_IsEnumerating = false; // Cancel any entity enumeration (entity list has changed)
+	// Get vector index for new entity and a UID pointing at it
+	TUInt32 entityIndex = static_cast<TUInt32>(m_Entities.size());
+	TEntityUID UID = NewUID(entityIndex);
+	AddEntity( UID, true, templateName, name, position, rotation, scale );
 
-							 // Return UID of new entity then increase it ready for next entity
-	return m_NextUID++;
+	// Return UID of new entity
+	return UID;
 }
-// Destroy the given entity - returns true if the entity existed and was destroyed
+// Destroy the given entity - returns true if the entity existed and was destroyed. During
+// UpdateAllEntities the entity is destroyed after the update instead, see QueueDestroyEntity
 bool CEntityManager::DestroyEntity( TEntityUID UID )
 {
-	// Find the vector index of the given UID
-	TUInt32 entityIndex;
-	if (!m_EntityUIDMap->LookUpKey( UID, &entityIndex ))
+	if (m_IsUpdating)
+	{
+		return QueueDestroyEntity( UID );
+	}
+
+	// Quit if the UID doesn't refer to an entity
+	if (!GetEntity( UID ))
 	{
-		// Quit if not found
 		return false;
 	}
 
-	// Delete the given entity and remove from UID map
-	delete m_Entities[entityIndex];
-	m_EntityUIDMap->RemoveKey( UID );
+	// Delete the given entity, remove it from the name index, entity lists and render buckets and
+	// free its UID slot
+	TUInt32 entityIndex = m_EntityUIDs.GetIndex( UID );
+	m_EntityNameIndex.Remove( UID, m_Entities[entityIndex]->GetName() );
+	RemoveFromEntityLists( UID );
+	RemoveFromRenderBuckets( UID );
+	DeleteEntity( m_Entities[entityIndex], m_EntityUIDs.Data( UID ).isPlayer );
+	m_EntityUIDs.Free( UID );
+
+	// The component arrays are kept in the same order as the entities
+	m_Components.Remove( entityIndex );
 
 	// If not removing last entity...
 	if (entityIndex != m_Entities.size() - 1)
 	{
-		// ...put the last entity into the empty entity slot and update UID map
+		// ...put the last entity into the empty entity slot and update its UID slot
 		m_Entities[entityIndex] = m_Entities.back();
-		m_EntityUIDMap->SetKeyValue( m_Entities.back()->GetUID(), entityIndex );
+		m_Entities[entityIndex]->m_ComponentIndex = entityIndex;
+		m_EntityUIDs.SetIndex( m_Entities.back()->GetUID(), entityIndex );
 	}
 	m_Entities.pop_back(); // Remove last entity
 
-	m_IsEnumerating = false; // Cancel any entity enumeration (entity list has changed)
+	// Don't let lists fill up with destroyed entities if there is no update for a while
+	FlushEntityListRemovals( true );
+
 	return true;
 }
 
+// Destroy the given entity after the current update, it stays valid until then. Returns false
+// if the UID doesn't refer to an entity (or one queued for creation). Queueing the same entity
+// twice is harmless
+bool CEntityManager::QueueDestroyEntity( TEntityUID UID )
+{
+	if (GetEntity( UID ))
+	{
+		SEntitySlot& slot = m_EntityUIDs.Data( UID );
+		if (!slot.destroyQueued)
+		{
+			slot.destroyQueued = true;
+			++m_NumDestroysQueued;
+		}
+		return true;
+	}
+
+	// An entity queued for creation this update is simply never created
+	for (TUInt32 command = 0; command < m_CreateCommands.size(); ++command)
+	{
+		if (m_CreateCommands[command].UID == UID && !m_CreateCommands[command].cancelled)
+		{
+			m_CreateCommands[command].cancelled = true;
+			m_EntityUIDs.Free( UID );
+			return true;
+		}
+	}
+	return false;
+}
+
+// Carry out the creations and destructions queued during the update. Queued destructions are
+// done in a single pass over the entity list, which moves the remaining entities down to fill
+// the gaps and keeps them in order
+void CEntityManager::ApplyEntityCommands()
+{
+	for (TUInt32 command = 0; command < m_CreateCommands.size(); ++command)
+	{
+		const SCreateCommand& create = m_CreateCommands[command];
+		if (!create.cancelled)
+		{
+			m_EntityUIDs.Activate( create.UID, static_cast<TUInt32>(m_Entities.size()) );
+			AddEntity( create.UID, create.isPlayer, create.templateName, create.name,
+			           create.position, create.rotation, create.scale );
+		}
+	}
+	m_CreateCommands.clear();
+
+	if (m_NumDestroysQueued == 0)
+	{
+		return;
+	}
+
+	TUInt32 numKept = 0;
+	for (TUInt32 entity = 0; entity < m_Entities.size(); ++entity)
+	{
+		CEntity* thisEntity = m_Entities[entity];
+		TEntityUID UID = thisEntity->GetUID();
+		SEntitySlot& slot = m_EntityUIDs.Data( UID );
+		if (slot.destroyQueued)
+		{
+			m_EntityNameIndex.Remove( UID, thisEntity->GetName() );
+			RemoveFromEntityLists( UID );
+			RemoveFromRenderBuckets( UID );
+			DeleteEntity( thisEntity, slot.isPlayer );
+			m_EntityUIDs.Free( UID );
+		}
+		else
+		{
+			if (numKept != entity)
+			{
+				m_Entities[numKept] = thisEntity;
+				thisEntity->m_ComponentIndex = numKept;
+				m_Components.Move( entity, numKept );
+				m_EntityUIDs.SetIndex( UID, numKept );
+			}
+			++numKept;
+		}
+	}
+	m_Entities.resize( numKept );
+	m_Components.Truncate( numKept );
+	m_NumDestroysQueued = 0;
+	FlushEntityListRemovals( true );
+}
+
 
 // Destroy all entities held by the manager
 void CEntityManager::DestroyAllEntities()
 {
-	m_EntityUIDMap->RemoveAllKeys();
+	m_EnumRange = CEntityRange();
+	m_EntityNameIndex.RemoveAll();
+	for (TEntityLists::iterator list = m_TemplateLists.begin(); list != m_TemplateLists.end(); ++list)
+	{
+		list->second.Clear();
+	}
+	for (TEntityLists::iterator list = m_TypeLists.begin(); list != m_TypeLists.end(); ++list)
+	{
+		list->second.Clear();
+	}
+	for (TUInt32 method = 0; method < NumRenderMethods; ++method)
+	{
+		m_RenderBuckets[method].Clear();
+	}
+	m_ListsWithRemovals.clear();
+	m_Projectiles.Clear();
+	m_Particles.Clear();
+
+	// Queued creations will never happen, free their UIDs. Queued destructions happen below
+	for (TUInt32 command = 0; command < m_CreateCommands.size(); ++command)
+	{
+		if (!m_CreateCommands[command].cancelled)
+		{
+			m_EntityUIDs.Free( m_CreateCommands[command].UID );
+		}
+	}
+	m_CreateCommands.clear();
+	m_NumDestroysQueued = 0;
+
+	// Entity destructors are still called, but their memory and matrices are released all at once
 	while (m_Entities.size())
 	{
-		delete m_Entities.back();
+		m_EntityUIDs.Free( m_Entities.back()->GetUID() );
+		m_Entities.back()->~CEntity();
 		m_Entities.pop_back();
 	}
+	m_EntityPool.Reset();
+	m_PlayerPool.Reset();
+	m_MatrixArena.Reset();
+	m_Components.Clear();
+	m_QueuedLaunches.clear();
+	m_PhysicsTime = 0.0f;
 
 	m_IsEnumerating = false; // Cancel any entity enumeration (entity list has changed)
 }
 
 
+// Call the destructor of an entity and return its memory to its pool
+void CEntityManager::DeleteEntity( CEntity* entity, bool isPlayer )
+{
+	entity->~CEntity(); // Virtual, calls the destructor of the actual entity class
+	if (isPlayer)
+	{
+		m_PlayerPool.Free( entity );
+	}
+	else
+	{
+		m_EntityPool.Free( entity );
+	}
+}
+
+
+// Allocate an array of matrices for the nodes of an entity, 16-byte aligned. Matrices have no
+// constructor to call
+CMatrix4x4* CEntityManager::AllocateMatrices( TUInt32 numMatrices )
+{
+	return static_cast<CMatrix4x4*>(m_MatrixArena.Allocate( numMatrices * sizeof(CMatrix4x4) ));
+}
+
+// Free an array of matrices from AllocateMatrices
+void CEntityManager::FreeMatrices( CMatrix4x4* matrices, TUInt32 numMatrices )
+{
+	m_MatrixArena.Free( matrices, numMatrices * sizeof(CMatrix4x4) );
+}
+
+
+/////////////////////////////////////
+// Entity UIDs
+
+// Get a UID for a new entity with the given index in m_Entities. Slot data is not cleared when a
+// slot is reused, the entity's slot data is set up as it is added to the indexes and lists
+TEntityUID CEntityManager::NewUID( TUInt32 entityIndex )
+{
+	TEntityUID UID = m_EntityUIDs.New( entityIndex );
+	m_EntityUIDs.Data( UID ).destroyQueued = false;
+	return UID;
+}
+
+
+
+/////////////////////////////////////
+// Entity queries
+
+// Add an entity to the end of the lists for its template name and type
+void CEntityManager::AddToEntityLists( TEntityUID UID, CEntityTemplate* entityTemplate )
+{
+	SEntitySlot& slot = m_EntityUIDs.Data( UID );
+	if (!entityTemplate)
+	{
+		slot.templateList = 0;
+		slot.typeList = 0;
+		return;
+	}
+
+	// Creates the lists the first time a template or type is used
+	slot.templateList = &m_TemplateLists[entityTemplate->GetName()];
+	slot.typeList = &m_TypeLists[entityTemplate->GetType()];
+	slot.templateList->Add( UID );
+	slot.typeList->Add( UID );
+}
+
+// Note a destroyed entity in the lists holding it. The entity stays in the lists (and is skipped
+// by queries) until FlushEntityListRemovals
+void CEntityManager::RemoveFromEntityLists( TEntityUID UID )
+{
+	SEntitySlot& slot = m_EntityUIDs.Data( UID );
+	CHandleList* lists[2] = { slot.templateList, slot.typeList };
+	for (TUInt32 list = 0; list < 2; ++list)
+	{
+		if (lists[list] && lists[list]->NoteRemoval())
+		{
+			m_ListsWithRemovals.push_back( lists[list] );
+		}
+	}
+}
+
+// Take destroyed entities out of the entity lists and render buckets, keeping the remaining
+// entities in order. Only lists that had entities destroyed are visited. Lists being stepped
+// through by a range, or that are not yet mostly destroyed entities if requested, are kept for
+// next time
+void CEntityManager::FlushEntityListRemovals( bool onlyMostlyRemoved /*= false*/ )
+{
+	TUInt32 numLeft = 0;
+	for (TUInt32 list = 0; list < m_ListsWithRemovals.size(); ++list)
+	{
+		CHandleList* UIDs = m_ListsWithRemovals[list];
+		if ((onlyMostlyRemoved && !UIDs->IsMostlyRemoved()) || !UIDs->Compact( m_EntityUIDs ))
+		{
+			m_ListsWithRemovals[numLeft++] = UIDs;
+		}
+	}
+	m_ListsWithRemovals.resize( numLeft );
+}
+
+
+
+/////////////////////////////////////
+// Render buckets
+
+// Add an entity to the end of the bucket for each render method used by its mesh's materials
+void CEntityManager::AddToRenderBuckets( TEntityUID UID, CEntityTemplate* entityTemplate )
+{
+	SEntitySlot& slot = m_EntityUIDs.Data( UID );
+	slot.renderMethods = 0;
+	if (!entityTemplate)
+	{
+		return;
+	}
+
+	CMesh* mesh = entityTemplate->Mesh();
+	for (TUInt32 subMesh = 0; subMesh < mesh->GetSubMeshCount(); ++subMesh)
+	{
+		slot.renderMethods |= 1 << mesh->GetSubMeshRenderMethod( subMesh );
+	}
+	for (TUInt32 method = 0; method < NumRenderMethods; ++method)
+	{
+		if (slot.renderMethods & (1 << method))
+		{
+			m_RenderBuckets[method].Add( UID );
+		}
+	}
+}
+
+// Mark the buckets holding an entity as having a destroyed entity. The entity stays in the buckets
+// (and is skipped when rendering) until FlushEntityListRemovals
+void CEntityManager::RemoveFromRenderBuckets( TEntityUID UID )
+{
+	SEntitySlot& slot = m_EntityUIDs.Data( UID );
+	for (TUInt32 method = 0; method < NumRenderMethods; ++method)
+	{
+		CHandleList& bucket = m_RenderBuckets[method];
+		if ((slot.renderMethods & (1 << method)) && bucket.NoteRemoval())
+		{
+			m_ListsWithRemovals.push_back( &bucket );
+		}
+	}
+	slot.renderMethods = 0;
+}
+
+// Number of entries in the render buckets, including destroyed entities not yet flushed
+TUInt32 CEntityManager::GetNumRenderBucketEntries()
+{
+	TUInt32 numEntries = 0;
+	for (TUInt32 method = 0; method < NumRenderMethods; ++method)
+	{
+		numEntries += m_RenderBuckets[method].GetSize();
+	}
+	return numEntries;
+}
+
+// Memory reserved for the render buckets in bytes
+TUInt32 CEntityManager::GetRenderBucketMemory()
+{
+	TUInt32 memory = sizeof(m_RenderBuckets);
+	for (TUInt32 method = 0; method < NumRenderMethods; ++method)
+	{
+		memory += m_RenderBuckets[method].GetMemory();
+	}
+	return memory;
+}
+
+
+// Return the entities using the given template, in creation order
+CEntityManager::CEntityRange CEntityManager::GetEntitiesOfTemplate( const string& templateName )
+{
+	TEntityLists::iterator list = m_TemplateLists.find( templateName );
+	if (list == m_TemplateLists.end())
+	{
+		return CEntityRange();
+	}
+	return CEntityRange( this, &list->second );
+}
+
+// Return the entities whose template has the given type, in creation order
+CEntityManager::CEntityRange CEntityManager::GetEntitiesOfType( const string& templateType )
+{
+	TEntityLists::iterator list = m_TypeLists.find( templateType );
+	if (list == m_TypeLists.end())
+	{
+		return CEntityRange();
+	}
+	return CEntityRange( this, &list->second );
+}
+
+
+// Begin an enumeration of entities matching given name, template name and type. Steps through the
+// name chain, template list or type list, whichever is most selective. The name chain can change
+// when entities are destroyed, so it is copied first
+void CEntityManager::BeginEnumEntities( const string& name, const string& templateName,
+                                        const string& templateType /*= ""*/ )
+{
+	m_EnumRange = CEntityRange(); // Done with the last enumeration's list
+	m_IsEnumerating = true;
+	m_EnumName = name;
+	m_EnumTemplateName = templateName;
+	m_EnumTemplateType = templateType;
+
+	if (name.length() > 0)
+	{
+		m_EnumUIDs.Clear();
+		for (TEntityUID UID = m_EntityNameIndex.GetFirst( name ); UID != SystemUID;
+		     UID = m_EntityNameIndex.GetNext( UID ))
+		{
+			m_EnumUIDs.Add( UID );
+		}
+		m_EnumRange = CEntityRange( this, &m_EnumUIDs );
+	}
+	else if (templateName.length() > 0)
+	{
+		m_EnumRange = GetEntitiesOfTemplate( templateName );
+	}
+	else if (templateType.length() > 0)
+	{
+		m_EnumRange = GetEntitiesOfType( templateType );
+	}
+	else
+	{
+		// Matching anything, copy all the UIDs
+		m_EnumUIDs.Clear();
+		for (TUInt32 entity = 0; entity < m_Entities.size(); ++entity)
+		{
+			m_EnumUIDs.Add( m_Entities[entity]->GetUID() );
+		}
+		m_EnumRange = CEntityRange( this, &m_EnumUIDs );
+	}
+}
+
+// Return next entity matching parameters passed to a previous call to BeginEnumEntities
+// Returns 0 if BeginEnumEntities not called or no more matching entities
+CEntity* CEntityManager::EnumEntity()
+{
+	if (!m_IsEnumerating)
+	{
+		return 0;
+	}
+
+	CEntity* entity = m_EnumRange.Next();
+	while (entity)
+	{
+		if ((m_EnumName.length() == 0 || entity->GetName() == m_EnumName) &&
+			(m_EnumTemplateName.length() == 0 || entity->Template()->GetName() == m_EnumTemplateName) &&
+			(m_EnumTemplateType.length() == 0 || entity->Template()->GetType() == m_EnumTemplateType))
+		{
+			return entity;
+		}
+		entity = m_EnumRange.Next();
+	}
+
+	EndEnumEntities();
+	return 0;
+}
+
+
+/////////////////////////////////////
+// Entity components
+
+// 60 physics steps a second
+const TFloat32 CEntityManager::kPhysicsStep = 1.0f / 60.0f;
+
+// Queue a launch of an entity with the kinematics update, applied at the start of the next update
+void CEntityManager::LaunchEntity( TEntityUID UID, TFloat32 upwardVel, TFloat32 horizontalVel )
+{
+	SQueuedLaunch launch = { UID, upwardVel, horizontalVel };
+	m_QueuedLaunches.push_back( launch );
+}
+
+// Run the component updates over all entities at once. Queued launches are applied together,
+// then the simulated entities are moved in whole physics steps: their matrix positions are
+// copied into the component arrays, stepped and copied back. An entity held by its owner is
+// only moved in the update it asked for, others stop being moved once they have landed. Time
+// stop makes gravity stronger for all entities not marked as unaffected, as for the players
+void CEntityManager::UpdateComponents( TFloat32 updateTime )
+{
+	// Launches of entities destroyed since they were queued are dropped
+	m_Impulses.clear();
+	for (TUInt32 launch = 0; launch < m_QueuedLaunches.size(); ++launch)
+	{
+		if (GetEntity( m_QueuedLaunches[launch].UID ))
+		{
+			SKinematicImpulse impulse = { GetEntityIndex( m_QueuedLaunches[launch].UID ),
+			                              m_QueuedLaunches[launch].upwardVel,
+			                              m_QueuedLaunches[launch].horizontalVel };
+			m_Impulses.push_back( impulse );
+		}
+	}
+	m_QueuedLaunches.clear();
+	if (!m_Impulses.empty())
+	{
+		m_Components.ApplyImpulses( &m_Impulses[0], static_cast<TUInt32>(m_Impulses.size()) );
+	}
+
+	m_PhysicsTime += updateTime;
+	TUInt32 numSteps = static_cast<TUInt32>(m_PhysicsTime / kPhysicsStep);
+	if (numSteps > kMaxPhysicsSteps)
+	{
+		numSteps = kMaxPhysicsSteps;
+		m_PhysicsTime = 0.0f;
+	}
+	else
+	{
+		m_PhysicsTime -= numSteps * kPhysicsStep;
+	}
+
+	TUInt32 numEntities = m_Components.Size();
+	if (numSteps > 0)
+	{
+		for (TUInt32 entity = 0; entity < numEntities; ++entity)
+		{
+			if (m_Components.flags[entity] & Kinematic_Simulated)
+			{
+				const CVector3& position = m_Entities[entity]->GetPosition();
+				m_Components.posX[entity] = position.x;
+				m_Components.posY[entity] = position.y;
+			}
+		}
+		// A player slowed by time stop used to have its update time divided by 8 and its gravity
+		// scaled by 15 rather than 2, so it falls with 15/16 of its normal gravity per step
+		TFloat32 timeStopScale = zaWarudoEnabled ? 15.0f / 16.0f : 1.0f;
+		for (TUInt32 step = 0; step < numSteps; ++step)
+		{
+			m_Components.UpdateKinematics( kPhysicsStep, timeStopScale );
+		}
+	}
+
+	for (TUInt32 entity = 0; entity < numEntities; ++entity)
+	{
+		TUInt32& flags = m_Components.flags[entity];
+		if (flags & Kinematic_Simulated)
+		{
+			if (numSteps > 0)
+			{
+				m_Entities[entity]->Matrix().SetX( m_Components.posX[entity] );
+				m_Entities[entity]->Matrix().SetY( m_Components.posY[entity] );
+			}
+			if (flags & Kinematic_Held)
+			{
+				flags &= ~(Kinematic_Simulated | Kinematic_Held);
+			}
+			else if (!(flags & Kinematic_InAir))
+			{
+				flags &= ~Kinematic_Simulated;
+			}
+		}
+	}
+}
+
+
 /////////////////////////////////////
 // Update / Rendering
 
 // Call all entity update functions. Pass the time since last update
 void CEntityManager::UpdateAllEntities(float updateTime)
 {
-	TUInt32 entity = 0;
-	for (int i = 0; i < m_Entities.size(); i++)
+	// Entities destroyed since the last update can now be taken out of the entity lists
+	FlushEntityListRemovals();
+
+	UpdateComponents( updateTime );
+
+	// Entities are not created or destroyed during the update, so the entity list does not
+	// change while it is stepped through. Creations and destructions are queued and carried out
+	// at the end
+	m_IsUpdating = true;
+
+	// Gather - sort the entities into those that can be updated in parallel and the rest
+	m_IndependentEntities.clear();
+	m_SerialEntities.clear();
+	for (TUInt32 entity = 0; entity < m_Entities.size(); ++entity)
 	{
-		// Update entity, if it returns false, then destroy it
-		if (!m_Entities[entity]->Update(updateTime))
+		if (m_Entities[entity]->IsIndependent())
 		{
-			DestroyEntity(m_Entities[entity]->GetUID());
+			m_IndependentEntities.push_back(entity);
 		}
 		else
 		{
-			++entity;
+			m_SerialEntities.push_back(entity);
+		}
+	}
+
+	// Independent update across all threads. Each entity only changes itself, so the results do
+	// not depend on the number of threads or the order the jobs run in
+	if (!m_JobSystem)
+	{
+		m_JobSystem = new CJobSystem();
+	}
+	m_NeedsResolve.resize(m_IndependentEntities.size());
+	m_JobSystem->ParallelFor(static_cast<TUInt32>(m_IndependentEntities.size()), 256,
+		[this, updateTime](TUInt32 begin, TUInt32 end)
+		{
+			for (TUInt32 i = begin; i < end; ++i)
+			{
+				bool resolve = m_Entities[m_IndependentEntities[i]]->UpdateIndependent(updateTime);
+				m_NeedsResolve[i] = resolve ? 1 : 0;
+			}
+		});
+
+	// Resolve - finish the independent updates that need it on this thread in entity order, then
+	// update the other entities one at a time. If an update returns false, then destroy the entity
+	// after the update
+	for (TUInt32 i = 0; i < m_IndependentEntities.size(); ++i)
+	{
+		CEntity* entity = m_Entities[m_IndependentEntities[i]];
+		if (m_NeedsResolve[i] && !entity->ResolveUpdate())
+		{
+			QueueDestroyEntity(entity->GetUID());
+		}
+	}
+	for (TUInt32 i = 0; i < m_SerialEntities.size(); ++i)
+	{
+		CEntity* entity = m_Entities[m_SerialEntities[i]];
+		if (!entity->Update(updateTime))
+		{
+			QueueDestroyEntity(entity->GetUID());
 		}
 	}
 	if (!DoubleUltCollisionSoundPlayed && DoubleUltCollisionEvent)
@@ -240,45 +853,31 @@ void CEntityManager::UpdateAllEntities(float updateTime)
 	}
 	
 	UpdateParticles(updateTime);
-	
-}
-// Pre render all entities
 
-void CEntityManager::PreRenderAllEntities()
+	m_IsUpdating = false;
+	ApplyEntityCommands();
+}
+// Calculate the world matrices of all entities in one pass, the render passes then use them as
+// they are
+void CEntityManager::UpdateAllMatrices()
 {
-	i_Vectorsize = m_Entities.size();
-	i_numRenderMethod = GetNumRenderMethods();
-
-	bool hasMethod[NumRenderMethods];
-
-	for (int i = 0; i < NumRenderMethods; i++)
+	m_NumMatricesUpdated = 0;
+	m_NumMatricesSkipped = 0;
+	for (TUInt32 entity = 0; entity < m_Entities.size(); ++entity)
 	{
-		hasMethod[i] = false;
+		m_Entities[entity]->UpdateMatrices( m_NumMatricesUpdated, m_NumMatricesSkipped );
 	}
+}
+
+// Pre render all entities. The render buckets are kept up to date as entities are created and
+// destroyed, so this can be called any number of times
 
-	for (TUInt32 i = 0; i < i_Vectorsize; ++i)
+void CEntityManager::PreRenderAllEntities()
+{
+	for (TUInt32 i = 0; i < m_Entities.size(); ++i)
 	{
 		m_Entities[i]->PreRender();
-		
-
-		for (int j = 0; j < m_Entities[i]->getSubmeshCount(); j++)
-		{
-			SMeshBucketRenderData renderdata = m_Entities[i]->getSubmeshData(j);
-			SSubmesh submesh;
-
-			submesh.bucketRenderData = renderdata;
-			submesh.UID = m_Entities[i]->GetUID();
-		    
-			hasMethod[submesh.bucketRenderData.material.renderMethod] = true;
-				}
 
-		for (int j = 0; j < NumRenderMethods; j++)
-		{
-			if (hasMethod[j] == true)
-			{
-				m_EntityBuckets[j].push_back(m_Entities[i]);
-			}
-		}
 		// for shadow stuff
 
 		if (m_Entities[i]->GetName() == "ShadowDropPoint1")
@@ -313,21 +912,14 @@ void CEntityManager::RenderAllEntities()
 void CEntityManager::ShadowRenderAllEntities()
 {
 	
-	bool render = false;
+	// Entities that only have alpha blended sub-meshes cast no shadow
 	for (int i = 0; i < m_Entities.size(); i++)
 	{
-		for (int j = 0; j < m_Entities[i]->renderMethods.size(); j++)
-		{
-			if (m_Entities[i]->renderMethods[j] != AlphaBlend)
-			{
-				render = true;
-			}
-		}
-		if (render)
+		TUInt32 renderMethods = m_EntityUIDs.Data( m_Entities[i]->GetUID() ).renderMethods;
+		if (renderMethods & ~(1 << AlphaBlend))
 		{
 			m_Entities[i]->ShadowRender();
 		}
-		render = false;
 	}
 
 	
@@ -368,17 +960,7 @@ void CEntityManager::BucketRenderAllEntities()
 			break;
 		case AlphaBlend:
 			method = AlphaBlend;
-			for (int j = 0; j  < m_EntityBuckets[i].size(); j++)
-			{
-				//Do not Touch is created because of a PlayerEntity not having Mesh and Render info of it`s own, which causes errors
-				//So we skip them
-				if (m_EntityBuckets[i][j]->doNotTouch)
-				{
-					continue;
-			    }
-					CVector3 distToCamera = m_EntityBuckets[i][j]->Matrix().GetPosition() - MainCamera->Matrix().GetPosition();
-					m_EntityBuckets[i][j]->depthFromCamera = distToCamera.Length();
-			}
+			SortEntitiesByDepth(AlphaBlend);
 			break;
 		case Atmosphere:
 			method = Atmosphere;
@@ -400,10 +982,15 @@ void CEntityManager::BucketRenderAllEntities()
 		{
 			currentTechnique->GetDesc(&currentTechDesc);
 		}
-		QuicksortEntitiesByDepth(AlphaBlend);
-		for (int j = 0; j < m_EntityBuckets[i].size(); j++)
+		// Destroyed entities stay in the buckets until the next update
+		const vector<TEntityUID>& bucket = m_RenderBuckets[i].Handles();
+		for (int j = 0; j < bucket.size(); j++)
 		{
-			m_EntityBuckets[i][j]->BucketRender(method);
+			CEntity* entity = GetEntity(bucket[j]);
+			if (entity)
+			{
+				entity->BucketRender(method);
+			}
 		}
 
 		
@@ -454,64 +1041,143 @@ void CEntityManager::BucketRenderByMaterial(int material)
 	
 }
 
-//The quicksort function, that determines which sprites render last and which first
-void CEntityManager::QuicksortEntitiesByDepth(int method)
+// Sort a render bucket from back to front, which determines which sprites render last and which
+// first. Keys are made from the squared distance to the camera, which sorts the same as the
+// distance. The bucket keeps its order between frames, so the keys are nearly sorted already
+// unless the camera or many sprites have moved a long way. Destroyed entities still in the bucket
+// are sorted to the end
+void CEntityManager::SortEntitiesByDepth(int method)
 {
-	int counter = 0;
-	int which = 0;
-	float max = 0.0;
-	do {
-		for (int i = 0; i < m_EntityBuckets[method].size() - counter ; i++)
+	vector<TEntityUID>& bucket = m_RenderBuckets[method].Handles();
+	CVector3 cameraPosition = MainCamera->Matrix().GetPosition();
+
+	m_DepthKeys.resize(bucket.size());
+	for (TUInt32 i = 0; i < bucket.size(); i++)
+	{
+		m_DepthKeys[i].iIndex = i;
+		CEntity* entity = GetEntity(bucket[i]);
+		if (!entity)
 		{
-			if (m_EntityBuckets[method][i]->depthFromCamera > max)
-			{
-				max = m_EntityBuckets[method][i]->depthFromCamera;
-				which = i;
-			}
+			m_DepthKeys[i].iKey = 0xffffffff;
+		}
+		//Do not Touch is created because of a PlayerEntity not having Mesh and Render info of it`s own, which causes errors
+		//So they are treated as being at the camera
+		else if (entity->doNotTouch)
+		{
+			m_DepthKeys[i].iKey = ~FloatToSortKey(0.0f);
+		}
+		else
+		{
+			CVector3 distToCamera = entity->GetPosition() - cameraPosition;
+			m_DepthKeys[i].iKey = ~FloatToSortKey(distToCamera.LengthSquared()); // Furthest first
 		}
-		m_EntityBuckets[method].push_back(m_EntityBuckets[method][which]);
-		m_EntityBuckets[method].erase(m_EntityBuckets[method].begin() + which);
-		counter++;
-		max = 0;
-	} while (counter != m_EntityBuckets[method].size());
+	}
+
+	m_DepthSort.Sort(m_DepthKeys);
+
+	m_SortedUIDs.resize(bucket.size());
+	for (TUInt32 i = 0; i < bucket.size(); i++)
+	{
+		m_SortedUIDs[i] = bucket[m_DepthKeys[i].iIndex];
+	}
+	bucket.swap(m_SortedUIDs);
 }
 void CEntityManager::CollisionCalculator()
 {
 	//Collision calculator for player vs monsters, currently not used
-	for (int i = 0; i < m_Entities.size(); i++)
+	CEntity* player = GetEntity("Player");
+	CEntity* stando = GetEntity("Stando");
+	float adjustor = 0;
+	if (RoddaRolla)
 	{
-		if (m_Entities[i]->isAMonster)
+		adjustor = 20.0f;
+	}
+
+	// Put the player, stand and monsters in the broadphase grid, by index in the entity list.
+	// Monsters are as large as the furthest they can collide from. The monsters are the entities
+	// using a monster template, so only those are visited rather than every entity
+	m_CollisionGrid.Clear();
+	CEntityRange monsters = GetEntitiesOfTemplate(MonsterTypeStrings[Zombie]);
+	for (CEntity* monster = monsters.Next(); monster; monster = monsters.Next())
+	{
+		monster->isCollidingWithPlayer = false;
+		monster->isCollidingWithPlayerToDamage = false;
+		const CVector3& monsterpos = monster->GetPosition();
+		m_CollisionGrid.Add(GetEntityIndex(monster->GetUID()), monsterpos.x, monsterpos.y,
+		                    monster->distFromCenter + adjustor, CollisionGroup_Monster, 0);
+	}
+	if (player)
+	{
+		const CVector3& pos = player->GetPosition();
+		m_CollisionGrid.Add(GetEntityIndex(player->GetUID()), pos.x, pos.y, 0.0f,
+		                    CollisionGroup_Player, CollisionGroup_Monster);
+	}
+	if (stando)
+	{
+		const CVector3& pos = stando->GetPosition();
+		m_CollisionGrid.Add(GetEntityIndex(stando->GetUID()), pos.x, pos.y, 0.0f,
+		                    CollisionGroup_Stand, CollisionGroup_Monster);
+	}
+	m_CollisionGrid.Build();
+
+	// Exact tests on the nearby pairs only, comparing squared distances
+	TUInt32 numPairs;
+	do
+	{
+		numPairs = m_CollisionGrid.GetPairs(m_CollisionPairs, kCollisionBatchSize);
+		for (TUInt32 pair = 0; pair < numPairs; pair++)
 		{
-			m_Entities[i]->isCollidingWithPlayer = false;
-			m_Entities[i]->isCollidingWithPlayerToDamage = false;
-			CVector3 playerpos = GetEntity("Player")->Matrix().Position();
-			CVector3 monsterpos = m_Entities[i]->Matrix().Position();
-			float adjustor = 0;
-			if (RoddaRolla)
+			CEntity* monster = m_Entities[m_CollisionPairs[pair].iA];
+			CEntity* other = m_Entities[m_CollisionPairs[pair].iB];
+			if (!monster->isAMonster)
 			{
-				adjustor = 20.0f;
+				swap(monster, other);
 			}
-			if (Distance(playerpos,monsterpos ) < m_Entities[i]->distFromCenter + adjustor)
+			const CVector3& monsterpos = monster->GetPosition();
+			float distSquared = LengthSquared(other->GetPosition() - monsterpos);
+			if (other == player)
 			{
-				m_Entities[i]->isCollidingWithPlayer = true;
+				float reach = monster->distFromCenter + adjustor;
+				if (distSquared < reach * reach)
+				{
+					monster->isCollidingWithPlayer = true;
+				}
+				float damageReach = monster->distFromCenter / 4;
+				if (distSquared < damageReach * damageReach)
+				{
+					monster->isCollidingWithPlayerToDamage = true;
+				}
 			}
-			if (Distance(playerpos, monsterpos) < m_Entities[i]->distFromCenter / 4)
+			else if (distSquared < monster->distFromCenter * monster->distFromCenter)
 			{
-				m_Entities[i]->isCollidingWithPlayerToDamage = true;
+				monster->isCollidingWithPlayer = true;
 			}
-				CVector3 standopos = GetEntity("Stando")->Matrix().Position();
-				if (Distance(standopos, monsterpos) < m_Entities[i]->distFromCenter)
-				{
-					m_Entities[i]->isCollidingWithPlayer = true;
-				}
 		}
-	}
+	} while (numPairs == kCollisionBatchSize);
 }
 void CEntityManager::UpdateParticles(TFloat32 updatetime)
 {
 	if (isGameMode1VS1)
 	{
-		if (abs(Distance(player1Pos, player2Pos)) < 30.0f || abs(Distance(standoPlayer1Pos, player2Pos)) < 50.0f)
+		// A player hits the other if a hitbox of their frame overlaps a hurtbox of the other's frame.
+		// Frames without boxes in AnimEvents.xml, and the stands, use the distance between them
+		// instead. Only a handful of fixed pairs here, so they are tested directly without the
+		// broadphase
+		TUInt32 numHitBoxes[2], numHurtBoxes[2];
+		m_HitBoxSet.Clear();
+		m_HurtBoxSet.Clear();
+		AddPlayerBoxes(0, player1Pos, player1Frame, &numHitBoxes[0], &numHurtBoxes[0]);
+		AddPlayerBoxes(1, player2Pos, player2Frame, &numHitBoxes[1], &numHurtBoxes[1]);
+
+		bool boxHits[2] = { false, false };
+		TUInt32 numOverlaps = m_HitBoxSet.FindOverlaps(m_HurtBoxSet, m_BoxOverlaps, kMaxBoxOverlaps);
+		for (TUInt32 overlap = 0; overlap < numOverlaps; overlap++)
+		{
+			boxHits[m_HitBoxSet.GetOwner(m_BoxOverlaps[overlap].iBox)] = true;
+		}
+
+		bool player1Hits = (numHitBoxes[0] > 0 && numHurtBoxes[1] > 0) ? boxHits[0] : LengthSquared(player1Pos - player2Pos) < 30.0f * 30.0f;
+		if (player1Hits || LengthSquared(standoPlayer1Pos - player2Pos) < 50.0f * 50.0f)
 		{
 			player1CanHitplayer2 = true;
 		}
@@ -520,7 +1186,8 @@ void CEntityManager::UpdateParticles(TFloat32 updatetime)
 			player1CanHitplayer2 = false;
 		}
 
-		if (abs(Distance(player2Pos, player1Pos)) < 30.0f || abs(Distance(standoPlayer2Pos, player1Pos)) < 50.0f)
+		bool player2Hits = (numHitBoxes[1] > 0 && numHurtBoxes[0] > 0) ? boxHits[1] : LengthSquared(player2Pos - player1Pos) < 30.0f * 30.0f;
+		if (player2Hits || LengthSquared(standoPlayer2Pos - player1Pos) < 50.0f * 50.0f)
 		{
 			player2CanHitplayer1 = true;
 		}
@@ -533,56 +1200,197 @@ void CEntityManager::UpdateParticles(TFloat32 updatetime)
 		{
 			int i = 0;
 		}
-		if (knivesCreated && !zaWarudoEnabled)
+
+		// Projectiles hit the hurtboxes too. A player whose frame has none is given a square the
+		// size of the distance check
+		const CVector3* playerPos[2] = { &player1Pos, &player2Pos };
+		for (TUInt32 player = 0; player < 2; player++)
 		{
-			if (knivesFlyRight)
+			if (numHurtBoxes[player] == 0)
 			{
-				GetEntity("KnivesRight")->Matrix().MoveX(5.0f);
+				m_HurtBoxSet.Add(player, playerPos[player]->x - 30.0f, playerPos[player]->y - 30.0f,
+				                         playerPos[player]->x + 30.0f, playerPos[player]->y + 30.0f);
 			}
-			else
-				GetEntity("KnivesLeft")->Matrix().MoveX(-5.0f);
+		}
+		if (!zaWarudoEnabled)
+		{
+			UpdateProjectiles(updatetime);
+		}
+	}
+
+	// Stopped time freezes the particles too
+	if (!zaWarudoEnabled)
+	{
+		bool isParallel = m_JobSystem && m_Particles.GetTotalParticles() >= kMinParallelParticles;
+		m_Particles.Update(updatetime, isParallel ? m_JobSystem : 0);
+	}
+}
 
-			if (knivesOwnerPlayer1)
+// Move the projectiles, then test them all against the hurtboxes in one batch. Each projectile
+// that hits adds its payload to the totals for the player it hit, and each player hit gets one
+// damage message with the totals once all the hits are found
+void CEntityManager::UpdateProjectiles( TFloat32 updateTime )
+{
+	m_Projectiles.Update(updateTime);
+	if (m_Projectiles.GetNumProjectiles() == 0)
+	{
+		return;
+	}
+
+	m_ProjectileBoxSet.Clear();
+	m_Projectiles.AddBoxes(m_ProjectileBoxSet);
+	TUInt32 numOverlaps = m_ProjectileBoxSet.FindOverlaps(m_HurtBoxSet, m_ProjectileOverlaps, kMaxProjectileOverlaps);
+
+	// The overlaps are in projectile order, a projectile overlapping several hurtboxes only hits once
+	const TUInt32* damage = m_Projectiles.GetDamage();
+	const TUInt32* knockback = m_Projectiles.GetKnockback();
+	const TUInt32* knockUp = m_Projectiles.GetKnockUp();
+	const TFloat32* velX = m_Projectiles.GetVelX();
+	SMessage hits[2];
+	bool isHit[2] = { false, false };
+	TUInt32 numHit = 0;
+	for (TUInt32 overlap = 0; overlap < numOverlaps; overlap++)
+	{
+		TUInt32 projectile = m_ProjectileOverlaps[overlap].iBox;
+		if (numHit > 0 && m_HitProjectiles[numHit - 1] == projectile)
+		{
+			continue;
+		}
+		m_HitProjectiles[numHit++] = projectile;
+
+		TUInt32 player = m_HurtBoxSet.GetOwner(m_ProjectileOverlaps[overlap].iOtherBox);
+		SMessage& msg = hits[player];
+		if (!isHit[player])
+		{
+			isHit[player] = true;
+			msg.type = Msg_Dmg;
+			msg.from = SystemUID;
+			msg.dmg = 0;
+			msg.effect = 0;
+			msg.knockbackVel = 0;
+			msg.knockUpVel = 0;
+			msg.isStoppingTime = false;
+			msg.isTheWorld = false;
+		}
+		msg.dmg += damage[projectile];
+		msg.knockbackVel = max(msg.knockbackVel, knockback[projectile]);
+		msg.knockUpVel = max(msg.knockUpVel, knockUp[projectile]);
+		msg.isKnockbackedRight = velX[projectile] > 0.0f;
+	}
+	m_Projectiles.Remove(m_HitProjectiles, numHit);
+
+	const TEntityUID playerUIDs[2] = { PlayerUID, Player2UID };
+	for (TUInt32 player = 0; player < 2; player++)
+	{
+		if (isHit[player])
+		{
+			Messenger.SendMessage(playerUIDs[player], hits[player]);
+			SoundManager.PlayPlayerSound(BloodSplatterSound, false, player == 0);
+		}
+	}
+}
+
+// Start a particle emitter, returns its number or CParticleSystem::kiNoEmitter if all are in use
+TUInt32 CEntityManager::StartParticleEmitter( const SParticleEmitterDesc& desc )
+{
+	return m_Particles.StartEmitter(desc);
+}
+
+// Start a burst of blood where a player was hit, thrown upwards and falling back under gravity.
+// The number of particles goes up with the damage
+void CEntityManager::SpawnHitParticles( const CVector3& position, TUInt32 damage )
+{
+	SParticleEmitterDesc blood;
+	blood.fPosX = position.x;
+	blood.fPosY = position.y + 10.0f;
+	blood.fPosZ = position.z - 1.0f;
+	blood.fVelX = 0.0f;
+	blood.fVelY = 60.0f;
+	blood.fVelZ = 0.0f;
+	blood.fVelSpread = 60.0f;
+	blood.fGravity = 200.0f;
+	blood.fLifetime = 0.6f;
+	blood.iBurst = 16 + 2 * min(damage, 100u);
+	blood.fRate = 0.0f;
+	blood.fDuration = 0.0f;
+	const TFloat32 startColour[4] = { 0.8f, 0.0f, 0.0f, 1.0f };
+	const TFloat32 endColour[4]   = { 0.3f, 0.0f, 0.0f, 0.0f };
+	for (int c = 0; c < 4; c++)
+	{
+		blood.afStartColour[c] = startColour[c];
+		blood.afEndColour[c] = endColour[c];
+	}
+	blood.fStartSize = 1.5f;
+	blood.fEndSize = 0.5f;
+	m_Particles.StartEmitter(blood);
+}
+
+// Add a projectile to the pool, returns false if there are too many projectiles
+bool CEntityManager::SpawnProjectile( const SProjectileDesc& desc )
+{
+	return m_Projectiles.Spawn(desc);
+}
+
+// Draw each projectile with the mesh of its visual entity, using the entity's root matrix moved to
+// the projectile's position. The visual entity itself is not moved
+void CEntityManager::RenderProjectiles()
+{
+	TUInt32 numProjectiles = m_Projectiles.GetNumProjectiles();
+	const TFloat32* posX = m_Projectiles.GetPosX();
+	const TFloat32* posY = m_Projectiles.GetPosY();
+	const TFloat32* posZ = m_Projectiles.GetPosZ();
+	const TUInt32* visual = m_Projectiles.GetVisual();
+	for (TUInt32 projectile = 0; projectile < numProjectiles; projectile++)
+	{
+		CEntity* entity = GetEntity(visual[projectile]);
+		if (!entity)
+		{
+			continue;
+		}
+		if (m_ProjectileMatrices.size() < entity->GetNumNodes())
+		{
+			m_ProjectileMatrices.resize(entity->GetNumNodes());
+		}
+		CMatrix4x4 rootMatrix = entity->GetMatrix();
+		rootMatrix.Position() = CVector3(posX[projectile], posY[projectile], posZ[projectile]);
+		entity->RenderAt(rootMatrix, &m_ProjectileMatrices[0]);
+	}
+}
+// Add the hitboxes and hurtboxes of a player's frame to the box sets, owned by the player number.
+// The boxes are for a player facing right, so are mirrored about the player's position for a
+// player facing left
+void CEntityManager::AddPlayerBoxes( TUInt32 player, const CVector3& position, const SPlayerFrame& shownFrame,
+                                     TUInt32* numHitBoxes, TUInt32* numHurtBoxes )
+{
+	const CFrameBoxTable* tables[2] = { &AnimationManager.GetHitBoxes(), &AnimationManager.GetHurtBoxes() };
+	CBoxSet* sets[2] = { &m_HitBoxSet, &m_HurtBoxSet };
+	TUInt32* counts[2] = { numHitBoxes, numHurtBoxes };
+	for (int table = 0; table < 2; table++)
+	{
+		TUInt32 firstBox = 0;
+		TUInt32 numBoxes = tables[table]->GetFrameBoxes(shownFrame.isJotaro ? 0 : 1, shownFrame.sequence,
+		                                                shownFrame.frame, &firstBox);
+		const TFloat32* minX = tables[table]->GetMinX() + firstBox;
+		const TFloat32* minY = tables[table]->GetMinY() + firstBox;
+		const TFloat32* maxX = tables[table]->GetMaxX() + firstBox;
+		const TFloat32* maxY = tables[table]->GetMaxY() + firstBox;
+		for (TUInt32 box = 0; box < numBoxes; box++)
+		{
+			if (shownFrame.facingRight)
 			{
-				if (abs(Distance(GetEntity("KnivesLeft")->Matrix().Position(), player2Pos)) < 30.0f || abs(Distance(GetEntity("KnivesRight")->Matrix().Position(), player2Pos)) < 30.0f)
-				{
-					SMessage msg;
-					msg.dmg = 65;
-					msg.from = SystemUID;
-					msg.type = Msg_Dmg;
-					msg.knockbackVel = 0.1;
-					msg.knockUpVel  = 0.1;
-					Messenger.SendMessage(Player2UID, msg);
-					GetEntity("KnivesLeft")->Matrix().SetPosition(CVector3(-10000, -1000, -1000));
-					GetEntity("KnivesRight")->Matrix().SetPosition(CVector3(-10000, -1000, -1000));
-					knivesCreated = false;
-					SoundManager.PlayPlayerSound(BloodSplatterSound, false, false);
-				}
+				sets[table]->Add(player, position.x + minX[box], position.y + minY[box],
+				                         position.x + maxX[box], position.y + maxY[box]);
 			}
 			else
 			{
-				if (abs(Distance(GetEntity("KnivesLeft")->Matrix().Position(), player1Pos)) < 30.0f || abs(Distance(GetEntity("KnivesRight")->Matrix().Position(), player1Pos)) < 30.0f)
-				{
-					SMessage msg;
-					msg.dmg = 65;
-					msg.from = SystemUID;
-					msg.type = Msg_Dmg;
-					msg.knockbackVel = 0.1;
-					msg.knockUpVel = 0.1;
-					Messenger.SendMessage(PlayerUID, msg);
-					GetEntity("KnivesLeft")->Matrix().SetPosition(CVector3(-10000, -1000, -1000));
-					GetEntity("KnivesRight")->Matrix().SetPosition(CVector3(-10000, -1000, -1000));
-					knivesCreated = false;
-					SoundManager.PlayPlayerSound(BloodSplatterSound, false, true);
-				}
+				sets[table]->Add(player, position.x - maxX[box], position.y + minY[box],
+				                         position.x - minX[box], position.y + maxY[box]);
 			}
-
-
 		}
-
-
+		*counts[table] = numBoxes;
 	}
 }
+
 void CEntityManager::f_DoubleUltCollisionEvent(float updateTime)
 {
 	DoubleUltCollisionTimer += updateTime;
@@ -10,7 +10,17 @@
 #include <map>
 using namespace std;
 
-#include "CHashTable.h"
+#include "CHandleTable.h"
+#include "CHandleList.h"
+#include "CNameIndex.h"
+#include "CPoolAllocator.h"
+#include "CJobSystem.h"
+#include "CRadixSort.h"
+#include "CBroadphaseGrid.h"
+#include "CBoxSet.h"
+#include "CProjectilePool.h"
+#include "CParticleSystem.h"
+#include "CEntityComponents.h"
 #include "Entity.h"
 #include "PlayerEntity.h"
 #include "MeshData.h"
@@ -19,8 +29,11 @@ using namespace std;
 namespace gen
 {
 
+// Set to collect look-up statistics for the entity name index, reported by GetNameMapStats
+const bool kEntityNameMapStats = false;
+
 // The entity manager is responsible for creation, update, rendering and deletion of
-// entities. It also manages UIDs for entities using a hash table
+// entities. It also manages UIDs for entities, which are handles into a table of slots
 class CEntityManager
 {
 /////////////////////////////////////
@@ -68,7 +81,8 @@ public:
 	// Entity creation / destruction
 
 	// Create a base class entity - requires a template name, may supply entity name and position
-	// Returns the UID of the new entity
+	// Returns the UID of the new entity. If called during UpdateAllEntities the entity is created
+	// at the end of the update instead, the UID is not valid until then
 	TEntityUID CreateEntity
 	(
 		const string&    templateName,
@@ -89,6 +103,7 @@ public:
 		const CVector3& rotation = CVector3( 0.0f, 0.0f, 0.0f ),
 		const CVector3& scale = CVector3( 1.0f, 1.0f, 1.0f )
 	);
+	// Create a player entity, as CreateEntity
 	TEntityUID CreatePlayer
 	(
 		const string&   templateName,
@@ -117,19 +132,36 @@ public:
 		ID3D10Buffer*            indexBuffer;
 		TUInt32                  numIndices;
 	};
-	struct SSubmesh
-	{
-		SMeshBucketRenderData bucketRenderData;
-		TEntityUID UID;
-	};
+	// Create a base class entity after the current UpdateAllEntities, or immediately if not
+	// updating - the same as CreateEntity, which queues when called during the update. Returns
+	// the UID the entity will have - it is not valid until the entity exists
+	TEntityUID QueueCreateEntity
+	(
+		const string&    templateName,
+		const string&    name = "",
+		const CVector3&  position = CVector3::kOrigin, 
+		const CVector3&  rotation = CVector3( 0.0f, 0.0f, 0.0f ),
+		const CVector3&  scale = CVector3( 1.0f, 1.0f, 1.0f )
+	);
 
-	// Destroy the given entity - returns true if the entity existed and was destroyed
+	// Destroy the given entity - returns true if the entity existed and was destroyed. If called
+	// during UpdateAllEntities the entity is destroyed at the end of the update instead
 	bool DestroyEntity( TEntityUID UID );
 
+	// Destroy the given entity at the end of the current UpdateAllEntities, it is still valid until
+	// then. Returns true if the entity existed
+	bool QueueDestroyEntity( TEntityUID UID );
+
 	// Destroy all entities held by the manager
 	void DestroyAllEntities();
 
 
+	// Allocate / free an array of matrices for the nodes of an entity, 16-byte aligned. Uses an
+	// arena that is released in one go when all entities are destroyed
+	CMatrix4x4* AllocateMatrices( TUInt32 numMatrices );
+	void FreeMatrices( CMatrix4x4* matrices, TUInt32 numMatrices );
+
+
 	/////////////////////////////////////
 	// Template / Entity access
 
@@ -160,84 +192,180 @@ public:
 		return m_Entities[index];
 	}
 
-	// Return the entity with the given UID
+	// Return the index in the entity list (and in the component arrays) of the entity with the
+	// given UID, which must be valid
+	TUInt32 GetEntityIndex( TEntityUID UID )
+	{
+		return m_EntityUIDs.GetIndex( UID );
+	}
+
+	// Physics and gameplay state of all entities, in the same order as the entity list
+	CEntityComponents& Components()
+	{
+		return m_Components;
+	}
+
+	// Start moving an entity with the kinematics update - it leaves the ground with the given
+	// velocities (distance per physics step) and is moved each step until it lands. The launch is
+	// queued and applied at the start of the next update, in the order launches were queued, so a
+	// later launch of the same entity replaces an earlier one. Must not be called from independent
+	// entity updates
+	void LaunchEntity( TEntityUID UID, TFloat32 upwardVel, TFloat32 horizontalVel );
+
+	// Return the entity with the given UID, or 0 if there is no such entity (including UIDs of
+	// destroyed entities, even if their slot has been reused)
 	CEntity* GetEntity( TEntityUID UID )
 	{
-		// Find the entity UID in the entity hash map
-		TUInt32 entityIndex;
-		if (!m_EntityUIDMap->LookUpKey( UID, &entityIndex ))
+		if (!m_EntityUIDs.IsValid( UID ))
 		{
 			return 0;
 		}
-		return m_Entities[entityIndex];
+		return m_Entities[m_EntityUIDs.GetIndex( UID )];
+	}
+
+	// Fill in a report on the name index, to tune its initial size. Look-up counters are only
+	// collected if kEntityNameMapStats is set
+	void GetNameMapStats( SHashTableStats* pStats ) const
+	{
+		m_EntityNameIndex.GetStats( pStats );
 	}
 
 	// Return the entity with the given name & optionally the given template name & type
+	// If several entities match, the one created first is returned
 	CEntity* GetEntity( const string& name, const string& templateName = "",
 	                    const string& templateType = "" )
 	{
-		TEntityIter entity = m_Entities.begin();
-		while (entity != m_Entities.end())
+		return GetEntity( ResolveEntity( name, templateName, templateType ) );
+	}
+
+	// Return the UID of the entity with the given name & optionally the given template name &
+	// type, or SystemUID if there is none. Resolve names once and keep the UID to look entities
+	// up by UID later on. Uses the name index, so only entities with this name are checked
+	TEntityUID ResolveEntity( const string& name, const string& templateName = "",
+	                          const string& templateType = "" )
+	{
+		for (TEntityUID UID = m_EntityNameIndex.GetFirst( name ); UID != SystemUID;
+		     UID = m_EntityNameIndex.GetNext( UID ))
 		{
-			if ((*entity)->GetName() == name && 
-				(templateName.length() == 0 || (*entity)->Template()->GetName() == templateName) &&
-				(templateType.length() == 0 || (*entity)->Template()->GetType() == templateType))
+			CEntityTemplate* entityTemplate = m_Entities[m_EntityUIDs.GetIndex( UID )]->Template();
+			if ((templateName.length() == 0 || entityTemplate->GetName() == templateName) &&
+				(templateType.length() == 0 || entityTemplate->GetType() == templateType))
 			{
-				return (*entity);
+				return UID;
 			}
-			++entity;
 		}
-		return 0;
+		return SystemUID;
 	}
 
 
-	// Begin an enumeration of entities matching given name, template name and type
-	// An empty string indicates to match anything in this field (would be nice to support
-	// wildcards, e.g. match name of "Ship*")
-	void BeginEnumEntities( const string& name, const string& templateName,
-	                        const string& templateType = "" )
-	{
-		m_IsEnumerating = true;
-		m_EnumEntity = m_Entities.begin();
-		m_EnumName = name;
-		m_EnumTemplateName = templateName;
-		m_EnumTemplateType = templateType;
-	}
 
-	// Finish enumerating entities (see above)
-	void EndEnumEntities()
-	{
-		m_IsEnumerating = false;
-	}
+	/////////////////////////////////////
+	// Entity queries
 
-	// Return next entity matching parameters passed to a previous call to BeginEnumEntities
-	// Returns 0 if BeginEnumEntities not called or no more matching entities
-	CEntity* EnumEntity()
+	// Entities returned by a query, step through them with Next. Entities destroyed while stepping
+	// through a range are skipped, entities created may or may not be returned. The list a range
+	// steps through is not compacted while the range exists, so keep ranges short-lived. Ranges
+	// must not outlive DestroyAllEntities
+	class CEntityRange
 	{
-		if (!m_IsEnumerating)
+	public:
+		// Empty range
+		CEntityRange() : m_Manager( 0 ), m_UIDs( 0 ), m_Pos( 0 ) {}
+
+		// Copies step through the same list independently
+		CEntityRange( const CEntityRange& range )
+			: m_Manager( range.m_Manager ), m_UIDs( range.m_UIDs ), m_Pos( range.m_Pos )
+		{
+			OpenReader();
+		}
+		CEntityRange& operator=( const CEntityRange& range )
 		{
+			if (this != &range)
+			{
+				CloseReader();
+				m_Manager = range.m_Manager;
+				m_UIDs = range.m_UIDs;
+				m_Pos = range.m_Pos;
+				OpenReader();
+			}
+			return *this;
+		}
+
+		~CEntityRange()
+		{
+			CloseReader();
+		}
+
+		// Return the next entity in the range, or 0 if there are no more
+		CEntity* Next()
+		{
+			while (m_UIDs && m_Pos < m_UIDs->GetSize())
+			{
+				CEntity* entity = m_Manager->GetEntity( (*m_UIDs)[m_Pos++] );
+				if (entity)
+				{
+					return entity;
+				}
+			}
 			return 0;
 		}
 
-		while (m_EnumEntity != m_Entities.end())
+	private:
+		friend class CEntityManager;
+		CEntityRange( CEntityManager* manager, CHandleList* UIDs )
+			: m_Manager( manager ), m_UIDs( UIDs ), m_Pos( 0 )
+		{
+			OpenReader();
+		}
+
+		void OpenReader()
+		{
+			if (m_UIDs)
+			{
+				m_UIDs->OpenReader();
+			}
+		}
+		void CloseReader()
 		{
-			if ((m_EnumName.length() == 0 || (*m_EnumEntity)->GetName() == m_EnumName) && 
-				(m_EnumTemplateName.length() == 0 ||
-				 (*m_EnumEntity)->Template()->GetName() == m_EnumTemplateName) &&
-				(m_EnumTemplateType.length() == 0 ||
-				 (*m_EnumEntity)->Template()->GetType() == m_EnumTemplateType))
+			if (m_UIDs)
 			{
-				CEntity* foundEntity = *m_EnumEntity;
-				++m_EnumEntity;
-				return foundEntity;
+				m_UIDs->CloseReader();
 			}
-			++m_EnumEntity;
 		}
-		
+
+		CEntityManager* m_Manager;
+		CHandleList*    m_UIDs; // UIDs of the entities, may include destroyed ones
+		TUInt32         m_Pos;  // Next UID to return
+	};
+
+	// Return the entities using the given template, in creation order. The manager keeps a list
+	// of entities for each template, so this costs time for the entities returned only
+	CEntityRange GetEntitiesOfTemplate( const string& templateName );
+
+	// Return the entities whose template has the given type, in creation order. Also uses a list
+	// kept by the manager
+	CEntityRange GetEntitiesOfType( const string& templateType );
+
+
+	// Begin an enumeration of entities matching given name, template name and type
+	// An empty string indicates to match anything in this field (would be nice to support
+	// wildcards, e.g. match name of "Ship*"). Only the entities with the given name, template or
+	// type (in that order of preference) are checked. Creating or destroying entities does not
+	// end the enumeration, destroyed entities are skipped
+	void BeginEnumEntities( const string& name, const string& templateName,
+	                        const string& templateType = "" );
+
+	// Finish enumerating entities (see above)
+	void EndEnumEntities()
+	{
 		m_IsEnumerating = false;
-		return 0;
+		m_EnumRange = CEntityRange(); // Lets its list be compacted
 	}
 
+	// Return next entity matching parameters passed to a previous call to BeginEnumEntities
+	// Returns 0 if BeginEnumEntities not called or no more matching entities
+	CEntity* EnumEntity();
+
 	//static bool compareSubmeshes( const CSubmesh* a,  const  CSubmesh* b);
 	/////////////////////////////////////
 	// Update / Rendering
@@ -247,12 +375,41 @@ public:
 	// Pass the time since last update
 	void UpdateAllEntities( float updateTime );
 	void UpdateParticles(float updateTime);
+	// Calculate the world matrices of all entities in one pass, once a frame before rendering.
+	// Only the nodes that have changed (and their children) are calculated
+	void UpdateAllMatrices();
+	// Number of node matrices calculated / skipped as unchanged in the last UpdateAllMatrices
+	TUInt32 GetNumMatricesUpdated() { return m_NumMatricesUpdated; }
+	TUInt32 GetNumMatricesSkipped() { return m_NumMatricesSkipped; }
 	// Render all entities - not the ideal method, OK for this example
 	void PreRenderAllEntities();
 	void RenderAllEntities();
 	void BucketRenderAllEntities();
 	void ShadowRenderAllEntities();
 	void BucketRenderByMaterial(int material);
+
+	// Projectiles move and hit the players in UpdateParticles. A projectile's owner is the number
+	// of the player that fired it (0 or 1) and its visual is the UID of an entity whose mesh is
+	// drawn at the projectile's position. Returns false if there are too many projectiles
+	bool SpawnProjectile( const SProjectileDesc& desc );
+	void RenderProjectiles();
+	TUInt32 GetNumProjectiles() { return m_Projectiles.GetNumProjectiles(); }
+
+	// Particles are updated in UpdateParticles and drawn from the particle system after the
+	// entities. Start an emitter, returns its number or CParticleSystem::kiNoEmitter if all the
+	// emitters are in use
+	TUInt32 StartParticleEmitter( const SParticleEmitterDesc& desc );
+	// Start a burst of blood where a player was hit, larger for more damage
+	void SpawnHitParticles( const CVector3& position, TUInt32 damage );
+	const CParticleSystem& GetParticles() { return m_Particles; }
+
+	// Entities are put in a render bucket for each render method used by their mesh when they are
+	// created. Material render methods are fixed when meshes are loaded, so the buckets only
+	// change when entities are created or destroyed
+
+	// Number of entries in the render buckets and the memory reserved for them in bytes
+	TUInt32 GetNumRenderBucketEntries();
+	TUInt32 GetRenderBucketMemory();
 	void f_DoubleUltCollisionEvent(float updateTime);
 	bool RoddaRolla = false;
 	bool player1IntroFinished = false;
@@ -278,12 +435,19 @@ public:
 	CVector3 standoPlayer2Pos;
 	bool player1CanHitplayer2;
 	bool player2CanHitplayer1;
+	// Animation frame shown by each player, for the hitboxes and hurtboxes of the frame
+	struct SPlayerFrame
+	{
+		int  sequence = 0;
+		int  frame = 0;
+		bool isJotaro = true;
+		bool facingRight = true;
+	};
+	SPlayerFrame player1Frame;
+	SPlayerFrame player2Frame;
 	int player1LifeLeft = 3;
 	int player2LifeLeft = 3;
 	bool zaWarudoEnabled = false;
-	bool knivesCreated = false;
-	bool knivesFlyRight = true;
-	bool knivesOwnerPlayer1 = false;
 
 	ID3D10EffectTechnique* currentTechnique;
 	D3D10_TECHNIQUE_DESC currentTechDesc;
@@ -321,34 +485,215 @@ private:
 	// fill its space
 	public:
 	TEntities m_Entities;
-	private:
-	TEntities m_EntityBuckets[NumRenderMethods];
 	
 	public:
 		void CollisionCalculator();
 	/*TSubmeshes m_Submeshes[NumRenderMethods];*/
 	private:
 	bool hasmethods[materialCount] = {false,false,false,false,false,false,false};
-	void QuicksortEntitiesByDepth( int method);
+	void SortEntitiesByDepth( int method);
+
+	// Broadphase for CollisionCalculator, rebuilt each frame. Monsters only collide with the
+	// player and stand, and their pairs are read a batch at a time
+	enum ECollisionGroup
+	{
+		CollisionGroup_Player  = 1,
+		CollisionGroup_Stand   = 2,
+		CollisionGroup_Monster = 4,
+	};
+	static const TUInt32 kCollisionBatchSize = 256;
+	CBroadphaseGrid m_CollisionGrid;
+	SBroadphasePair m_CollisionPairs[kCollisionBatchSize];
+
+	// World space hitboxes and hurtboxes of the players' frames, owned by player number (0 or 1),
+	// and the overlaps found between them
+	static const TUInt32 kMaxBoxOverlaps = 64;
+	CBoxSet     m_HitBoxSet;
+	CBoxSet     m_HurtBoxSet;
+	SBoxOverlap m_BoxOverlaps[kMaxBoxOverlaps];
+
+	// Add the boxes of a player's frame to the box sets, returns the numbers of each added
+	void AddPlayerBoxes( TUInt32 player, const CVector3& position, const SPlayerFrame& shownFrame,
+	                     TUInt32* numHitBoxes, TUInt32* numHurtBoxes );
+
+	// Projectiles, their boxes, the overlaps of those with the players' hurtboxes and the
+	// projectiles that hit this update. Overlaps past the maximum are found in the next update
+	static const TUInt32 kMaxProjectiles = 512;
+	static const TUInt32 kMaxProjectileOverlaps = 256;
+	CProjectilePool m_Projectiles;
+	CBoxSet         m_ProjectileBoxSet;
+	SBoxOverlap     m_ProjectileOverlaps[kMaxProjectileOverlaps];
+	TUInt32         m_HitProjectiles[kMaxProjectileOverlaps];
+
+	// Node world matrices of the projectile being rendered, its visual entity's are left alone
+	vector<CMatrix4x4> m_ProjectileMatrices;
+
+	// Move the projectiles and send damage to the players they hit, uses the hurtboxes
+	void UpdateProjectiles( TFloat32 updateTime );
+
+	// Particle emitters and their particles. The emitters are updated in parallel on the job
+	// system when there are enough particles to be worth it
+	static const TUInt32 kMaxParticleEmitters = 64;
+	static const TUInt32 kParticlesPerEmitter = 256;
+	static const TUInt32 kMinParallelParticles = 4096;
+	CParticleSystem m_Particles;
+
+	// Depth sort of the alpha blended bucket, a key for each entity and the sorted UIDs
+	CRadixSort         m_DepthSort;
+	vector<SSortKey>   m_DepthKeys;
+	vector<TEntityUID> m_SortedUIDs;
+
+	// Lists of the entities with a given template or template type, in creation order
+	typedef map<string, CHandleList> TEntityLists;
+
+	// Entity UIDs are handles into a table of slots, each slot holding the index of its entity in
+	// the entity list along with the data below. UIDs of destroyed entities never match again,
+	// even when their slot is reused. The first entities created get UIDs 0, 1, 2... and SystemUID
+	// (kiNoHandle) is never an entity UID
+	struct SEntitySlot
+	{
+		CHandleList* templateList; // Lists holding the entity, 0 if it has no template
+		CHandleList* typeList;
+		TUInt32      renderMethods; // Bit per render bucket holding the entity
+		bool         isPlayer;      // Which pool the entity was allocated from
+		bool         destroyQueued; // Entity will be destroyed at the end of the update
+	};
+	CHandleTable<SEntitySlot> m_EntityUIDs;
+
+	// Get a UID for a new entity with the given index in m_Entities
+	TEntityUID NewUID( TUInt32 entityIndex );
+
+	// Name index - maps each entity name to the UID of the first entity created with that name,
+	// other entities with the name are chained after it in creation order
+	CNameIndex<kEntityNameMapStats> m_EntityNameIndex;
+
+	// Entity lists for each template name and each template type. List entries are never erased
+	// from the maps so ranges over the lists stay valid
+	TEntityLists m_TemplateLists;
+	TEntityLists m_TypeLists;
+
+	// Lists (and render buckets) with destroyed entities still in them. Destroyed entities are
+	// taken out at the start of each update, and also straight after a destruction outside the
+	// update if that leaves a list at least half destroyed entities. Lists being stepped through
+	// by a range are left until later
+	vector<CHandleList*> m_ListsWithRemovals;
+
+	// Add an entity to the lists for its template / note a destroyed entity in its lists
+	void AddToEntityLists( TEntityUID UID, CEntityTemplate* entityTemplate );
+	void RemoveFromEntityLists( TEntityUID UID );
+
+	// Take destroyed entities out of the entity lists and render buckets, or only out of the
+	// lists that are at least half destroyed entities
+	void FlushEntityListRemovals( bool onlyMostlyRemoved = false );
+
+	// Render buckets - the entities with a sub-mesh using each render method, in creation order
+	// apart from the alpha blended bucket, which is sorted by depth. Destroyed entities are taken
+	// out along with the entity lists and skipped until then
+	CHandleList m_RenderBuckets[NumRenderMethods];
+
+	// Add an entity to the buckets for its mesh's render methods / mark its buckets as holding a
+	// destroyed entity
+	void AddToRenderBuckets( TEntityUID UID, CEntityTemplate* entityTemplate );
+	void RemoveFromRenderBuckets( TEntityUID UID );
+
+	// Entity objects are allocated from a pool for each entity class, and their node matrices from
+	// an arena. All are reset together when all entities are destroyed
+	CPoolAllocator<CEntity>       m_EntityPool;
+	CPoolAllocator<CPlayerEntity> m_PlayerPool;
+	CArenaAllocator               m_MatrixArena;
+
+	// Call the destructor of an entity and return its memory to its pool
+	void DeleteEntity( CEntity* entity, bool isPlayer );
+
+	// Construct a base class or player entity and add it to the entity list, name index and entity
+	// lists. Its UID slot must already point at the end of the entity list
+	void AddEntity
+	(
+		TEntityUID       UID,
+		bool             isPlayer,
+		const string&    templateName,
+		const string&    name,
+		const CVector3&  position,
+		const CVector3&  rotation,
+		const CVector3&  scale
+	);
+
+	// Creations and destructions requested during UpdateAllEntities are held here and carried out
+	// at the end of the update. Destructions are flagged in the entities' UID slots
+	struct SCreateCommand
+	{
+		TEntityUID UID; // Reserved UID, its slot is not valid until creation
+		bool       isPlayer;
+		string     templateName;
+		string     name;
+		CVector3   position;
+		CVector3   rotation;
+		CVector3   scale;
+		bool       cancelled; // Destroyed before it was created
+	};
+	vector<SCreateCommand> m_CreateCommands;
+	TUInt32                m_NumDestroysQueued;
+	bool                   m_IsUpdating;
 
-	// A mapping from UIDs to indexes into the above array
-	CHashTable<TEntityUID, TUInt32>* m_EntityUIDMap;
+	// Queue the creation of an entity for the end of the update, returns its reserved UID
+	TEntityUID QueueCreate
+	(
+		bool             isPlayer,
+		const string&    templateName,
+		const string&    name,
+		const CVector3&  position,
+		const CVector3&  rotation,
+		const CVector3&  scale
+	);
+
+	// Carry out the queued creations and destructions
+	void ApplyEntityCommands();
 
-	// Entity IDs are provided using a single increasing integer
-	TEntityUID m_NextUID;
+	// Independent entity updates are spread across the job system's threads. The job system is
+	// created on the first update
+	CJobSystem*     m_JobSystem;
+
+	// Counts from the last UpdateAllMatrices
+	TUInt32 m_NumMatricesUpdated;
+	TUInt32 m_NumMatricesSkipped;
+	vector<TUInt32> m_IndependentEntities; // Indexes of entities, gathered each update
+	vector<TUInt32> m_SerialEntities;
+	vector<TUInt8>  m_NeedsResolve;        // One per independent entity
+
+	// Physics and gameplay state, entry i is for m_Entities[i]
+	CEntityComponents m_Components;
+
+	// Kinematics run in fixed steps so movement does not depend on the frame rate. Time not yet
+	// simulated carries over to the next update. After a long frame at most kMaxPhysicsSteps are
+	// run and the rest of the time is dropped
+	static const TFloat32 kPhysicsStep;
+	static const TUInt32  kMaxPhysicsSteps = 8;
+	TFloat32 m_PhysicsTime;
+
+	// Launches queued since the last update, by UID as entity indexes change until then
+	struct SQueuedLaunch
+	{
+		TEntityUID UID;
+		TFloat32   upwardVel;
+		TFloat32   horizontalVel;
+	};
+	vector<SQueuedLaunch>     m_QueuedLaunches;
+	vector<SKinematicImpulse> m_Impulses;
+
+	// Run the component updates and the physics steps, copying the positions of moving entities
+	// between their matrices and the component arrays
+	void UpdateComponents( TFloat32 updateTime );
 
 
 	/////////////////////////////////////
 	// Data for Entity Enumeration
 
-	bool        m_IsEnumerating;
-	TEntityIter m_EnumEntity;
-	string      m_EnumName;
-	string      m_EnumTemplateName;
-	string      m_EnumTemplateType;
-	
-	TUInt32 i_Vectorsize;
-	TUInt32 i_numRenderMethod;
+	bool               m_IsEnumerating;
+	CHandleList        m_EnumUIDs;    // Entities to check when not using an entity list
+	CEntityRange       m_EnumRange;   // Entities still to check
+	string             m_EnumName;
+	string             m_EnumTemplateName;
+	string             m_EnumTemplateType;
 };
 
 } // namespace gen
@@ -18,6 +18,7 @@ Handles:
 #include "EntityManager.h"
 #include "FMODManager.h"
 #include "UIManager.h"
+#include "CFrameLoaderDX.h"
 namespace gen
 {
 	extern ID3D10Device* g_pd3dDevice;
@@ -51,7 +52,7 @@ namespace gen
 		const CVector3&  position /*= CVector3::kOrigin*/,
 		const CVector3&  rotation /*= CVector3( 0.0f, 0.0f, 0.0f )*/,
 		const CVector3&  scale /*= CVector3( 1.0f, 1.0f, 1.0f )*/
-	) : CEntity(PlayerTemplate, UID, name, position, rotation, scale)
+	) : CEntity(PlayerTemplate, UID, name, position, rotation, scale), hitFrames(PlayerAnimationTypes)
 	{
 		//The first player will always be occupied by Jotaro
 		if (!EntityManager.isPlayer1Taken)
@@ -179,6 +180,13 @@ namespace gen
 			Animate_StandoDio(updateTime, faceDirectionRight, currentStandoAnimSequence);
 		}
 	
+		//The frame shown is published too, for the hitboxes and hurtboxes of the frame
+		CEntityManager::SPlayerFrame& shownFrame = isPlayer1 ? EntityManager.player1Frame : EntityManager.player2Frame;
+		shownFrame.sequence = currentAnimSequence;
+		shownFrame.frame = currentAnim;
+		shownFrame.isJotaro = isPlayerJotaro;
+		shownFrame.facingRight = faceDirectionRight;
+
 	    //If the stand was not previously initialized, we do it here
 		if (isPlayer1)
 		{
@@ -210,11 +218,11 @@ namespace gen
 	{
 		if (!isPlayerJotaro && isPlayer1&& playerStats.hp >= 200)
 		{
-			InterfaceManager.ChangeUIAnimFrame("PlayerFaceLeft", AnimationManager.GetPlayerUITexturePath(FaceAnim, 0, isPlayerJotaro, isPlayer1));
+			InterfaceManager.ChangeUIAnimFrame("PlayerFaceLeft", AnimationManager.GetPlayerUITextureFullPath(FaceAnim, 0, isPlayerJotaro, isPlayer1));
 		}
 		if (!isPlayerJotaro && !isPlayer1&& playerStats.hp >= 200)
 		{
-			InterfaceManager.ChangeUIAnimFrame("PlayerFaceRight", AnimationManager.GetPlayerUITexturePath(FaceAnim, 0, isPlayerJotaro, isPlayer1));
+			InterfaceManager.ChangeUIAnimFrame("PlayerFaceRight", AnimationManager.GetPlayerUITextureFullPath(FaceAnim, 0, isPlayerJotaro, isPlayer1));
 		}
 	
 		if (isStandoSummoned )
@@ -223,43 +231,33 @@ namespace gen
 		}
 		
 		DamageAccumulator(updateTime, isFacingRight);
-		string fullFileName;
+		//Paths are pre-resolved by the animation manager, so choosing a frame never builds a string
+		const string* fullFileName;
 		if (isFacingRight)
 		{
-			fullFileName = MediaFolder + animsRight[AnimationType][currentAnim].second;
+			fullFileName = &animsRight[AnimationType].GetFullPath(currentAnim);
 		}
-		else if (!isFacingRight)
+		else
 		{
-			fullFileName = MediaFolder + animsLeft[AnimationType][currentAnim].second;
+			fullFileName = &animsLeft[AnimationType].GetFullPath(currentAnim);
 		}
 		if(isDamaged && isTransparent)
 		{
-			fullFileName = AnimationManager.GetBlankTexturePath();
+			fullFileName = &AnimationManager.GetBlankTexturePath();
 		}
 		if (this->isPlayerJotaro == true)
 		{
-			SwitchAnimStateJotaro(updateTime, isFacingRight, AnimationType, fullFileName);
+			SwitchAnimStateJotaro(updateTime, isFacingRight, AnimationType, *fullFileName);
 		}
 		else  if(this->isPlayerJotaro == false)
 		{
-			SwitchAnimStateDio(updateTime, isFacingRight, AnimationType, fullFileName);
+			SwitchAnimStateDio(updateTime, isFacingRight, AnimationType, *fullFileName);
 		}
 		
-		if (isAttacking)
+		//Only attack sequences have hit frames, so this is a single bit test
+		if (isAttacking && hitFrames.IsHitFrame(currentAnimSequence, currentAnim))
 		{
-			for (int i = 0; i <= (playerAttackAnimsMax - AttackAnimsPlayerStart); i++)
-			{
-				if (i == currentAnimSequence - AttackAnimsPlayerStart)
-				{
-					for (int j = 0; j < hitFrames[i].second.size(); j++)
-					{
-						if (hitFrames[i].second[j] == currentAnim)
-						{
-							HitMessageComposer();
-						}
-					}
-				}
-			}
+			HitMessageComposer();
 		}
 		return true;
 	}
@@ -267,20 +265,12 @@ namespace gen
 	bool CPlayerEntity::Animate_Stando(TFloat32 updateTime, bool isFacingRight, int AnimationType)
 	{
 		f_Create_Stando();
-		string fullFileName;
-		if (isFacingRight)
-		{
-			fullFileName = MediaFolder + animsRight[AnimationType][currentStandoAnim].second;
-		}
-		else if (!isFacingRight)
-		{
-			fullFileName = MediaFolder + animsLeft[AnimationType][currentStandoAnim].second;
-		}
+		const string& fullFileName = isFacingRight ? animsRight[AnimationType].GetFullPath(currentStandoAnim)
+		                                           : animsLeft[AnimationType].GetFullPath(currentStandoAnim);
 		//////////////////////////////////////////////
 		//This function is used everywhere as it is because I was familiarising myself with rendering texture to file with no memory leaks 
 		//////////////////////////////////////////////
-		stando->Mesh->m_Materials->textures[0]->Release();
-		if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &stando->Mesh->m_Materials->textures[0], NULL)))
+		if (!SetMaterialFrame(stando->Mesh->m_Materials, fullFileName))
 		{
 			string errorMsg = "Error loading texture " + fullFileName;
 			SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -407,21 +397,12 @@ namespace gen
 			break;
 		}
 		//Here we check for the hit frames according to previously set, and after that we create a hit message to be sent to opposing player
-		for (int i = 0; i <= (AttackAnimsPlayerFinish  - AttackAnimsPlayerStart); i++)
+		if (currentStandoAnimSequence <= AttackAnimsPlayerFinish && hitFrames.IsHitFrame(currentStandoAnimSequence, currentStandoAnim))
 		{
-			if (i == currentStandoAnimSequence - AttackAnimsPlayerStart)
+			HitMessageComposer();
+			if (currentStandoAnimSequence == Stando_OraOraOra)
 			{
-				for (int j = 0; j < hitFrames[i].second.size(); j++)
-				{
-					if (hitFrames[i].second[j] == currentStandoAnim)
-					{
-						HitMessageComposer();
-						if (currentStandoAnimSequence == Stando_OraOraOra)
-						{
-							SoundManager.PlayPlayerSound(PlayerBasicAttackSound, false,isPlayer1);
-						}
-					}
-				}
+				SoundManager.PlayPlayerSound(PlayerBasicAttackSound, false,isPlayer1);
 			}
 		}
 
@@ -433,9 +414,7 @@ namespace gen
 		
 		if (isKnockedUp)
 		{
-			f_physGravity(updateTime / 2 );
-			player->Matrix().MoveY(m_UpdwardVel * 0.33);
-			
+			f_physGravity();
 		}
 		if (!animationLock && !this->buttonPressed) {
 
@@ -801,9 +780,9 @@ namespace gen
 
 					ultPointsAvailable--;
 					if(isPlayer1)
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 					else
-						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 					break;
 				case Special_Num_2: case Special_Num_4:
 					if (ultPointsAvailable < 2)
@@ -811,9 +790,9 @@ namespace gen
 
 					ultPointsAvailable -= 2;
 					if (isPlayer1)
-						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 					else
-						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 					break;
 				case Ult_Num_1:
 					if (ultPointsAvailable != ultPointsMax)
@@ -821,9 +800,9 @@ namespace gen
 
 					ultPointsAvailable = 0;
 					if (isPlayer1)
-						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 					else
-						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 					break;
 				}
 			}
@@ -851,7 +830,7 @@ namespace gen
 				break;
 			case Jump:
 				isInAir = true;
-				m_UpwardVelocity = 2.0f;
+				f_physLaunch(2.0f);
 				SoundManager.PlayPlayerSound(PlayerJumpSound, false, isPlayer1);
 				break;
 			case Light_Crouch_Att: case Light_Leg_Att: case Medium_Att:  case Medium_Walk_Att:
@@ -967,9 +946,9 @@ namespace gen
 
 				ultPointsAvailable -= 2;
 				if (isPlayer1)
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 				else
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 				break;
 			case Special_Num_2:
 				if (ultPointsAvailable < 1)
@@ -977,9 +956,9 @@ namespace gen
 
 				ultPointsAvailable--;
 				if (isPlayer1)
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 				else
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 				break;
 			case Special_Num_3:
 				if (ultPointsAvailable < 3)
@@ -987,9 +966,9 @@ namespace gen
 
 				ultPointsAvailable-=3;
 				if (isPlayer1)
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 				else
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 				break;
 			case Ult_Num_1:
 				if (ultPointsAvailable != ultPointsMax)
@@ -999,12 +978,12 @@ namespace gen
 				
 				if (isPlayer1)
 				{
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 					InterfaceManager.ultEnergyDrainMeterPlayer1 = 0;
 				}	
 				else
 				{
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 					InterfaceManager.ultEnergyDrainMeterPlayer2 = 0;
 				}
 					
@@ -1034,9 +1013,9 @@ namespace gen
 		case Jump:
 			isInAir = true;
 			if (EntityManager.zaWarudoEnabled && !thisUnaffected)
-				m_UpwardVelocity = 0.4;
+				f_physLaunch(0.4f);
 			else
-			m_UpwardVelocity = 2.0f;
+				f_physLaunch(2.0f);
 	
 			SoundManager.PlayPlayerSound(PlayerJumpSound, false, isPlayer1);
 			break;
@@ -1168,6 +1147,43 @@ namespace gen
 		}
 
 	}
+	//Frame events are read from AnimEvents.xml into flat tables by the animation manager, so each tick is one lookup
+	//and a short list of simple effects. Anything that depends on game state stays in SwitchAnimStateJotaro/Dio
+	void CPlayerEntity::RunFrameEvents(int AnimationType)
+	{
+		const SAnimEvent* events;
+		TUInt32 numEvents = AnimationManager.GetFrameEvents(AnimationType, isPlayerJotaro, currentAnim, &events);
+		for (TUInt32 i = 0; i < numEvents; i++)
+		{
+			switch (events[i].type)
+			{
+			case AnimEvent_Move:
+				f_attackMoveDisplacer(events[i].value);
+				break;
+			case AnimEvent_Enlarge:
+				f_Rescale(true, player);
+				break;
+			case AnimEvent_Shrink:
+				f_Rescale(false, player);
+				break;
+			case AnimEvent_Enlarge2x:
+				f_Rescalex2(true, player);
+				break;
+			case AnimEvent_Sound:
+				SoundManager.PlayPlayerSound(events[i].sound, false, events[i].channel < 0 ? isPlayer1 : events[i].channel != 0);
+				break;
+			case AnimEvent_Scale:
+				player->Matrix().SetScale(CVector3(events[i].value, events[i].value, events[i].value));
+				break;
+			case AnimEvent_Height:
+				player->Matrix().SetY(events[i].value);
+				break;
+			case AnimEvent_Ground:
+				player->Matrix().SetY(GroundLevel());
+				break;
+			}
+		}
+	}
 	void CPlayerEntity::f_Rescalex2(bool Enlarge, CEntity* entity)
 	{
 		if (Enlarge && entity->Matrix().GetScaleX() < 2.5f)
@@ -1250,23 +1266,31 @@ namespace gen
 				stando->Matrix().SetPosition(CVector3(player->Matrix().GetX() - (7 + m_Stando_Ult_Displacement), player->Matrix().GetY() + 3, player->Matrix().GetZ() + 15));
 		}
 	}
-	void CPlayerEntity::f_physGravity(TFloat32 updateTime)
+	//The player sprite is moved by the entity manager's fixed physics steps, which land it on the ground and mark it as landed.
+	//The request only lasts for this update, so it is made again every update the player is in the air
+	void CPlayerEntity::f_physGravity()
 	{
-		int scaling = 2;
-		if (EntityManager.zaWarudoEnabled && !thisUnaffected)
-		{
-			scaling = 15;
-		}
-		player->Matrix().MoveY(m_UpwardVelocity);
-		m_UpwardVelocity -= m_Gravity * updateTime * scaling;
-		if (player->Matrix().GetY() < m_GroundLevel)
+		TUInt32& flags = player->KinematicFlags();
+		if (flags & Kinematic_Landed)
 		{
-			m_UpwardVelocity = 0.0f;
-			player->Matrix().SetY(m_GroundLevel);
+			flags &= ~Kinematic_Landed;
 			isInAir = false;
 			isKnockedUp = false;
+			return;
 		}
-
+		flags |= Kinematic_Simulated | Kinematic_Held | Kinematic_InAir;
+		if (thisUnaffected)
+			flags |= Kinematic_TimeUnaffected;
+		else
+			flags &= ~Kinematic_TimeUnaffected;
+		//A knocked up player used to fall under gravity both here and in the hit sequence, 3 times gravity moving it twice each update,
+		//so it falls with 6 times gravity from the launch
+		player->GravityScale() = isKnockedUp ? 6.0f : 2.0f;
+	}
+	void CPlayerEntity::f_physLaunch(TFloat32 upwardVel)
+	{
+		player->UpwardVel() = upwardVel;
+		player->KinematicFlags() = (player->KinematicFlags() | Kinematic_InAir) & ~Kinematic_Landed;
 	}
 	//Message component for recieving messages, only 2 types for now: Damage and Victory
 	void CPlayerEntity::MessageComponent()
@@ -1305,169 +1329,11 @@ namespace gen
 			}
 		}
 	}
-	//Setting hit frames for each sequence, is a vector of vectors of pairs, but I felt like it was easier to manage, and it proved to be worth the effort
+	//Setting hit frames for each sequence of the attack range. The frames themselves are listed in SetPlayerHitFrames, so the
+	//hit frame tests can replay them without a player
 	void CPlayerEntity::setHitFrames(bool isPlayerJotaro)
 	{
-		if (isPlayerJotaro)
-		{
-			playerAttackAnimsMax = AttackAnimsPlayerFinish;
-		}
-		else if (!isPlayerJotaro)
-		{
-			playerAttackAnimsMax = Ult_Num_1;
-		}
-		HitFrames hitframes;
-		int countFromStart = 0;
-		if (isPlayerJotaro)
-		{
-			for (int i = AttackAnimsPlayerStart; i <= playerAttackAnimsMax; i++)
-			{
-				hitframes.first = i;
-				hitFrames.push_back(hitframes);
-				switch (i)
-				{
-				case Light_Leg_Att:
-					hitFrames[countFromStart].second.push_back(2);
-					break;
-				case Light_Crouch_Att:
-					hitFrames[countFromStart].second.push_back(6);
-					break;
-				case Medium_Att:
-					hitFrames[countFromStart].second.push_back(4);
-					break;
-				case Medium_Walk_Att:
-					hitFrames[countFromStart].second.push_back(4);
-					break;
-				case Medium_Crouch_Att:
-					hitFrames[countFromStart].second.push_back(3);
-					break;
-				case Medium_Air_Att:
-					hitFrames[countFromStart].second.push_back(2);
-					break;
-				case Heavy_Att:
-					hitFrames[countFromStart].second.push_back(4);
-					break;
-				case Heavy_Walk_Att:
-					hitFrames[countFromStart].second.push_back(6);
-					break;
-				case Heavy_Crouch_Att:
-					hitFrames[countFromStart].second.push_back(5);
-					break;
-				case Heavy_Crouch_Fr_Att:
-					hitFrames[countFromStart].second.push_back(6);
-					break;
-				case Heavy_Air_Att:
-					hitFrames[countFromStart].second.push_back(4);
-					break;
-				case Throw:
-					hitFrames[countFromStart].second.push_back(6);
-					hitFrames[countFromStart].second.push_back(16);
-					break;
-				case Stando_OraOraOra:
-					hitFrames[countFromStart].second.push_back(3);
-					hitFrames[countFromStart].second.push_back(6);
-					hitFrames[countFromStart].second.push_back(9);
-					hitFrames[countFromStart].second.push_back(12);
-					hitFrames[countFromStart].second.push_back(15);
-					break;
-				case Stando_Sp_2:
-					hitFrames[countFromStart].second.push_back(8);
-					break;
-				case Stando_Sp_3:
-					hitFrames[countFromStart].second.push_back(4);
-					hitFrames[countFromStart].second.push_back(8);
-					break;
-				case Stando_Sp_4:
-					hitFrames[countFromStart].second.push_back(12);
-					break;
-				case Stando_Ult_1:
-					for (int ult = 5; ult < 105; ult +=2)
-					{
-						if(ult < 105)
-						hitFrames[countFromStart].second.push_back(ult);
-					}
-				default:
-					break;
-				}
-				countFromStart++;
-			}
-		}
-		else if (!isPlayerJotaro)
-		{
-			for (int i = AttackAnimsPlayerStart; i <= playerAttackAnimsMax; i++)
-			{
-				hitframes.first = i;
-				hitFrames.push_back(hitframes);
-				switch (i)
-				{
-				case Light_Leg_Att:
-					hitFrames[countFromStart].second.push_back(1);
-					break;
-				case Light_Crouch_Att:
-					hitFrames[countFromStart].second.push_back(1);
-					break;
-				case Medium_Att:
-					hitFrames[countFromStart].second.push_back(3);
-					hitFrames[countFromStart].second.push_back(6);
-					break;
-				case Medium_Walk_Att:
-					hitFrames[countFromStart].second.push_back(3);
-					hitFrames[countFromStart].second.push_back(6);
-					break;
-				case Medium_Crouch_Att:
-					hitFrames[countFromStart].second.push_back(4);
-					break;
-				case Medium_Air_Att:
-					hitFrames[countFromStart].second.push_back(2);
-					break;
-				case Heavy_Att:
-					hitFrames[countFromStart].second.push_back(2);
-					break;
-				case Heavy_Walk_Att:
-					hitFrames[countFromStart].second.push_back(3);
-					break;
-				case Heavy_Crouch_Att:
-					hitFrames[countFromStart].second.push_back(4);
-					break;
-				case Heavy_Air_Att:
-					hitFrames[countFromStart].second.push_back(4);
-					break;
-				case Throw:
-					hitFrames[countFromStart].second.push_back(6);
-					hitFrames[countFromStart].second.push_back(14);
-					break;
-				case Stando_OraOraOra:
-					for (int i = 1; i < animsRight[Stando_OraOraOra].size(); i += 3)
-					{
-						hitFrames[countFromStart].second.push_back(i);
-					}
-					break;
-				case Special_Num_4:
-					hitFrames[countFromStart].second.push_back(14);
-					hitFrames[countFromStart].second.push_back(16);
-					hitFrames[countFromStart].second.push_back(20);
-					hitFrames[countFromStart].second.push_back(30);
-					break;
-				case Stando_Sp_3:
-					hitFrames[countFromStart].second.push_back(4);
-					hitFrames[countFromStart].second.push_back(8);
-					break;
-				case Stando_Sp_4:
-					hitFrames[countFromStart].second.push_back(12);
-					break;
-				case Ult_Num_1:
-					hitFrames[countFromStart].second.push_back(1);
-					hitFrames[countFromStart].second.push_back(2);
-					for (int ult = 12; ult < 130; ult += 5)
-					{
-						hitFrames[countFromStart].second.push_back(ult);
-					}
-				default:
-					break;
-				}
-				countFromStart++;
-			}
-		}
+		SetPlayerHitFrames(&hitFrames, isPlayerJotaro, animsRight[Stando_OraOraOra].size());
 	}
 	//Here we assemble the hit message depending on the attack type, and if we hit the enemy, we send it to him
 	void CPlayerEntity::HitMessageComposer()
@@ -1483,6 +1349,8 @@ namespace gen
 		msg.knockUpVel = 0.1;
 		msg.isStoppingTime = true;
 
+		//Data of the player's current frame, for hits that differ within a sequence
+		const SHitFrame* hit = hitFrames.GetHitFrame(currentAnimSequence, currentAnim);
 		if (isPlayerJotaro)
 		{
 			switch (currentAnimSequence)
@@ -1515,7 +1383,7 @@ namespace gen
 				msg.isThrow = true;
 				msg.dmg = 5;
 				msg.knockbackVel = -2.0f;
-				if (currentAnim == 16)
+				if (hit && (hit->flags & HitFrame_Finisher))
 				{
 					msg.dmg = 30;
 					msg.knockbackVel = 20.0f;
@@ -1575,7 +1443,7 @@ namespace gen
 				msg.isThrow = true;
 				msg.dmg = 5;
 				msg.knockbackVel = -2.0f;
-				if (currentAnim == 14)
+				if (hit && (hit->flags & HitFrame_Finisher))
 				{
 					msg.dmg = 30;
 					msg.knockbackVel = 20.0f;
@@ -1589,7 +1457,7 @@ namespace gen
 				msg.dmg = 10;
 				break;
 			case Ult_Num_1:
-				if (currentAnim == 1 || currentAnim == 2)
+				if (hit && (hit->flags & HitFrame_Launcher))
 				{
 					msg.dmg = 20;
 					if (faceDirectionRight)
@@ -1618,7 +1486,7 @@ namespace gen
 		{
 			for (int i = 0; i < EntityManager.m_Entities.size(); i++)
 			{
-				if (EntityManager.m_Entities[i]->isAMonster && (EntityManager.m_Entities[i]->isCollidingWithPlayer || EntityManager.m_Entities[i]->isCollidingWithPlayerStando) && EntityManager.m_Entities[i]->dmgImmunityTimer <= 0.0f)
+				if (EntityManager.m_Entities[i]->isAMonster && (EntityManager.m_Entities[i]->isCollidingWithPlayer || EntityManager.m_Entities[i]->isCollidingWithPlayerStando))
 				{
 					if (player->Matrix().GetX() > EntityManager.m_Entities[i]->Matrix().GetX())
 					{
@@ -1758,7 +1626,7 @@ namespace gen
 
 			InterfaceManager.player1MaxHp = playerStats.hp_max;
 			InterfaceManager.player1Hp = playerStats.hp;
-			InterfaceManager.ChangeUIAnimFrame("PlayerHpBarLeft", AnimationManager.GetPlayerUITexturePath(HealthBarAnim, blockAvailable, isPlayerJotaro, isPlayer1));
+			InterfaceManager.ChangeUIAnimFrame("PlayerHpBarLeft", AnimationManager.GetPlayerUITextureFullPath(HealthBarAnim, blockAvailable, isPlayerJotaro, isPlayer1));
 			if (ultPointsAvailable == ultPointsMax && InterfaceManager.ultEnergyDrainMeterPlayer1 >= 1000)
 				InterfaceManager.CycleUltMeterReady(updateTime, isPlayerJotaro, isPlayer1);
 		}
@@ -1766,7 +1634,7 @@ namespace gen
 		{
 			InterfaceManager.player2MaxHp = playerStats.hp_max;
 			InterfaceManager.player2Hp = playerStats.hp;
-			InterfaceManager.ChangeUIAnimFrame("PlayerHpBarRight", AnimationManager.GetPlayerUITexturePath(HealthBarAnim, blockAvailable, isPlayerJotaro, isPlayer1));
+			InterfaceManager.ChangeUIAnimFrame("PlayerHpBarRight", AnimationManager.GetPlayerUITextureFullPath(HealthBarAnim, blockAvailable, isPlayerJotaro, isPlayer1));
 			if (ultPointsAvailable == ultPointsMax && InterfaceManager.ultEnergyDrainMeterPlayer2 >= 1000)
 				InterfaceManager.CycleUltMeterReady(updateTime, isPlayerJotaro, isPlayer1);
 		}
@@ -1813,36 +1681,37 @@ namespace gen
 			}
 			else
 				playerStats.hp = playerStats.hp - msg.dmg;
+			EntityManager.SpawnHitParticles(player->Matrix().Position(), msg.dmg);
 
 			//Here we tailor the face shown on HP Bar to the current state of player HP
 			if (isPlayer1)
 			{
 				if (playerStats.hp < 160 && playerStats.hp > 110)
 				{
-					InterfaceManager.ChangeUIAnimFrame("PlayerFaceLeft", AnimationManager.GetPlayerUITexturePath(FaceAnim, 1, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerFaceLeft", AnimationManager.GetPlayerUITextureFullPath(FaceAnim, 1, isPlayerJotaro, isPlayer1));
 				}
 				if (playerStats.hp < 110 && playerStats.hp > 50)
 				{
-					InterfaceManager.ChangeUIAnimFrame("PlayerFaceLeft", AnimationManager.GetPlayerUITexturePath(FaceAnim, 2, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerFaceLeft", AnimationManager.GetPlayerUITextureFullPath(FaceAnim, 2, isPlayerJotaro, isPlayer1));
 				}
 				if (playerStats.hp < 50)
 				{
-					InterfaceManager.ChangeUIAnimFrame("PlayerFaceLeft", AnimationManager.GetPlayerUITexturePath(FaceAnim, 3, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerFaceLeft", AnimationManager.GetPlayerUITextureFullPath(FaceAnim, 3, isPlayerJotaro, isPlayer1));
 				}
 			}
 			else
 			{
 				if (playerStats.hp < 160 && playerStats.hp > 110)
 				{
-					InterfaceManager.ChangeUIAnimFrame("PlayerFaceRight", AnimationManager.GetPlayerUITexturePath(FaceAnim, 1, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerFaceRight", AnimationManager.GetPlayerUITextureFullPath(FaceAnim, 1, isPlayerJotaro, isPlayer1));
 				}
 				if (playerStats.hp < 110 && playerStats.hp > 50)
 				{
-					InterfaceManager.ChangeUIAnimFrame("PlayerFaceRight", AnimationManager.GetPlayerUITexturePath(FaceAnim, 2, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerFaceRight", AnimationManager.GetPlayerUITextureFullPath(FaceAnim, 2, isPlayerJotaro, isPlayer1));
 				}
 				if (playerStats.hp < 50)
 				{
-					InterfaceManager.ChangeUIAnimFrame("PlayerFaceRight", AnimationManager.GetPlayerUITexturePath(FaceAnim, 3, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerFaceRight", AnimationManager.GetPlayerUITextureFullPath(FaceAnim, 3, isPlayerJotaro, isPlayer1));
 				}
 			}
 			if (playerStats.hp <= 0)
@@ -1895,7 +1764,7 @@ namespace gen
 			if (msg.knockUpVel > 1.0f)
 			{
 				isKnockedUp = true;
-				m_UpdwardVel = msg.knockUpVel;
+				EntityManager.LaunchEntity(player->GetUID(), msg.knockUpVel * 0.33f, 0.0f);
 				isInAir = true;
 			}
 			if (isInAir)
@@ -1970,8 +1839,8 @@ namespace gen
 				{
 					ultPointsAvailable++;
 					
-						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
-						/*InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));*/
+						InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+						/*InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));*/
 				}
 		    }
 			
@@ -2003,8 +1872,8 @@ namespace gen
 				{
 					ultPointsAvailable++;
 
-					/*InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));*/
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					/*InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));*/
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 				}
 			}
 		}
@@ -2022,9 +1891,9 @@ namespace gen
 				InterfaceManager.ultEnergyDrainMeterPlayer1 = 1000.0f;
 				ultPointsAvailable--;
 				if (isPlayer1)
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 				else
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 
 			}
 			if (ultPointsAvailable == 0 && !isAttacking && InterfaceManager.ultEnergyDrainMeterPlayer1 < 0)
@@ -2041,9 +1910,9 @@ namespace gen
 				InterfaceManager.ultEnergyDrainMeterPlayer2 = 1000.0f;
 				ultPointsAvailable--;
 				if (isPlayer1)
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterLeft", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 				else
-					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITexturePath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
+					InterfaceManager.ChangeUIAnimFrame("PlayerUltMeterRight", AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Anim, ultPointsAvailable, isPlayerJotaro, isPlayer1));
 
 			}
 			if (ultPointsAvailable == 0 && !isAttacking && InterfaceManager.ultEnergyDrainMeterPlayer2 < 0)
@@ -2119,7 +1988,7 @@ namespace gen
 	//Animation controller for Jotaro.
 	//Every animation has effect on certain frames, while continuing or when in end
 	//Also sets the playback speed for certain animations
-	bool CPlayerEntity::SwitchAnimStateJotaro(TFloat32 updateTime, bool isFacingRight, int AnimationType, string fullFileName)
+	bool CPlayerEntity::SwitchAnimStateJotaro(TFloat32 updateTime, bool isFacingRight, int AnimationType, const string& fullFileName)
 	{
 		switch (AnimationType)
 		{
@@ -2133,11 +2002,6 @@ namespace gen
 			{
 				currentAnim = 1;
 			}
-		case Walking:
-			if (currentAnim == 0 || currentAnim == 7)
-			{
-				SoundManager.PlayPlayerSound(PlayerFootstepSound, false, isPlayer1);
-			}
 			break;
 		case Block:
 			if (currentAnim == 2 && buttonPressed)
@@ -2162,117 +2026,6 @@ namespace gen
 
 			break;
 
-		case Dash: 
-			if (currentAnim > 1 && currentAnim < 5)
-			{		
-				f_attackMoveDisplacer(15.0f);
-			}
-			break;
-		case Dash_Back:
-			if (currentAnim > 1 && currentAnim < 5)
-			{
-				f_attackMoveDisplacer(-15.0f);
-			}
-			break;
-
-		case Light_Leg_Att:
-			if (currentAnim > 1 && currentAnim < 5)
-			{
-				f_attackMoveDisplacer(2.5f);
-			}
-			break;
-		case Medium_Att:
-			if (currentAnim > 1 && currentAnim < 6)
-			{
-				f_attackMoveDisplacer(3.0f);
-			}
-			break;
-		case Medium_Walk_Att:
-			if (currentAnim == 5)
-			{
-				f_attackMoveDisplacer(15.0f);
-			}
-			break;
-		case Medium_Crouch_Att:
-			if (currentAnim == 1)
-			{
-				f_Rescale(true, player);
-			}
-			else if (currentAnim == 14)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Medium_Air_Att:
-			if (currentAnim == 1)
-			{
-				f_attackMoveDisplacer(5.0f);
-			}
-			break;
-		case Heavy_Att:
-			if (currentAnim == 2)
-			{
-				f_Rescale(true, player);
-			}
-			else if (currentAnim == 23)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Heavy_Walk_Att:
-			if (currentAnim == 4)
-			{
-				f_Rescale(true, player);
-			}
-			else if (currentAnim == 5)
-			{
-				f_attackMoveDisplacer(10.0f);
-			}
-			else if (currentAnim == 17)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Heavy_Crouch_Att:
-			if (currentAnim == 3)
-			{
-				f_Rescale(true, player);
-			}
-			else if (currentAnim == 12)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Heavy_Crouch_Fr_Att:
-			if (currentAnim == 4)
-			{
-				f_Rescale(true, player);
-			}
-			else if (currentAnim == 10)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Throw:
-			if (currentAnim == 1)
-			{
-				f_Rescale(true, player);
-			}
-			else if (currentAnim == 3)
-			{
-				f_attackMoveDisplacer(5.0f);
-			}
-			else if (currentAnim == 26)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Heavy_Air_Att:
-			if (currentAnim == 3)
-			{
-				f_attackMoveDisplacer(10.0f);
-			}
-			break;
 		case Special_OraOraOra:
 			if (currentAnim == 8 && currentStandoAnimSequence == Stando_OraOraOra)
 			{
@@ -2310,7 +2063,7 @@ namespace gen
 		case Jump:
 			if (isInAir)
 			{
-				f_physGravity(updateTime);
+				f_physGravity();
 			}
 			break;
 		case Is_Hit_Air:
@@ -2319,17 +2072,21 @@ namespace gen
 				if (currentAnim >= 4)
 					currentAnim == 4;
 
-				f_physGravity(updateTime);
+				f_physGravity();
 			}
-		case Is_Killed:
-			f_attackMoveDisplacer(-1.0f);
+			break;
+		//Sequences whose frame effects are all in the event table. These don't fall while in the air
+		case Walking: case Dash: case Dash_Back: case Light_Leg_Att: case Medium_Att: case Medium_Walk_Att: case Medium_Crouch_Att:
+		case Medium_Air_Att: case Heavy_Att: case Heavy_Walk_Att: case Heavy_Crouch_Att: case Heavy_Crouch_Fr_Att: case Throw:
+		case Heavy_Air_Att: case Is_Killed:
 			break;
 		default:
 			if (isInAir)
-				f_physGravity(updateTime);
+				f_physGravity();
 			break;
 		}
-		if (animChangeTimer >= animCycleDelay )
+		RunFrameEvents(AnimationType);
+		if (AnimChangeTimer() >= animCycleDelay )
 		{
 			if (currentAnimSequence != Summon && currentAnimSequence != Summon_Air && currentStandoAnimSequence == Stando_Idle && currentAnimSequence != Summon_Air && !isAttacking)
 			{
@@ -2339,8 +2096,7 @@ namespace gen
 					Enlarged = false;
 				}
 			}
-			this->player->Mesh->m_Materials->textures[0]->Release();
-			if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &this->player->Mesh->m_Materials->textures[0], NULL)))
+			if (!SetMaterialFrame(this->player->Mesh->m_Materials, fullFileName))
 			{
 				string errorMsg = "Error loading texture " + fullFileName;
 				SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -2376,7 +2132,7 @@ namespace gen
 					if (isInAir)
 					{
 						currentAnimSequence = Jump;
-						m_UpwardVelocity = 0.0f;
+						player->UpwardVel() = 0.0f;
 						currentAnim = animsRight[AnimationType].size() - 1;
 					}
 					else
@@ -2475,7 +2231,7 @@ namespace gen
 						f_Create_Stando();
 						if (isInAir)
 						{
-							m_UpwardVelocity = 0.0f;
+							player->UpwardVel() = 0.0f;
 							currentAnimSequence = Jump;
 							currentAnim = animsRight[AnimationType].size() - 1;
 							return true;
@@ -2504,37 +2260,37 @@ namespace gen
 					break;
 				}
 			}
-			animChangeTimer = 0.0f;
+			AnimChangeTimer() = 0.0f;
 
 		}
 		switch (currentAnimSequence)
 		{
 		case Intro:
-			animChangeTimer += updateTime * AnimMultSlow * 0.5;
+			AnimChangeTimer() += updateTime * AnimMultSlow * 0.5;
 			break;
 		case Idle: case Crouch_Turn:  case Special_Num_2:   case Is_Killed: case Victory: case Ult_Num_1: 
-			animChangeTimer += updateTime * AnimMultSlow;
+			AnimChangeTimer() += updateTime * AnimMultSlow;
 			break;
 		case Walking: case Crouch: case Dash: case Dash_Back: case Summon: case Light_Crouch_Att: case Heavy_Air_Att: case Medium_Air_Att: case Throw:  case Victory_2: case Medium_Crouch_Att: 
-			animChangeTimer += updateTime * AnimMultNormal;
+			AnimChangeTimer() += updateTime * AnimMultNormal;
 			break;
 		case Turning: case Stand_Up: case Jump: case Summon_Air: case Light_Leg_Att: case Medium_Walk_Att:  case Special_Num_3: case Special_OraOraOra: case Block:
-			animChangeTimer += updateTime * AnimMultFast;
+			AnimChangeTimer() += updateTime * AnimMultFast;
 			break;
 		case Heavy_Att: case Heavy_Walk_Att: case Heavy_Crouch_Att: case Heavy_Crouch_Fr_Att:
 			if(currentAnimSequence == Heavy_Att && EntityManager.DoubleUltCollisionEvent)
 				{
-				animChangeTimer += updateTime * AnimMultSlow * 0.1;
+				AnimChangeTimer() += updateTime * AnimMultSlow * 0.1;
 				}
 			else
-			animChangeTimer += updateTime * AnimMultSplitSec;
+			AnimChangeTimer() += updateTime * AnimMultSplitSec;
 		default:
-			animChangeTimer += updateTime * AnimMultNormal;
+			AnimChangeTimer() += updateTime * AnimMultNormal;
 			break;
 		}
     }
 	//Same function type as above but now for Dio
-	bool CPlayerEntity::SwitchAnimStateDio(TFloat32 updateTime, bool isFacingRight, int AnimationType, string fullFileName)
+	bool CPlayerEntity::SwitchAnimStateDio(TFloat32 updateTime, bool isFacingRight, int AnimationType, const string& fullFileName)
 	{
 		if (EntityManager.zaWarudoEnabled)
 		{
@@ -2561,17 +2317,7 @@ namespace gen
 					currentAnim = 1;
 				}
 				else MainCamera->Matrix().SetX(player->Matrix().GetX());
-				if (currentAnim == 2)
-				{
-					SoundManager.PlayPlayerSound(DioIntroSound, false, false);
-				}
 				break;
-		case Walking:
-			if (currentAnim == 0 || currentAnim == 7 )
-			{
-				SoundManager.PlayPlayerSound(PlayerFootstepSound, false, isPlayer1);
-			}
-			break;
 		case Block:
 			if (currentAnim == 11 && buttonPressed)
 			{
@@ -2600,162 +2346,6 @@ namespace gen
 
 			break;
 
-		case Dash:
-			if (currentAnim > 1 && currentAnim < 5)
-			{
-				f_attackMoveDisplacer(10.0f);
-			}
-			if (currentAnim == 1)
-			{
-				f_Rescale(true, player);
-			}
-			 if (currentAnim == 2)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Dash_Back:
-
-			
-			
-			if (currentAnim == 1)
-			{
-				
-				f_Rescale(true, player);
-			}
-			 if (currentAnim >=3 && currentAnim <=4 )
-			{
-				f_attackMoveDisplacer(-12.5f);
-			}
-			else  if (currentAnim == 6)
-			 {
-				f_Rescale(false, player);
-				
-			 }
-			
-			break;
-		
-		case Summon_Air: case Summon: 
-			if (currentAnim == 2)
-			{
-				f_Rescale(true, player);
-			}
-			break;
-		case Light_Leg_Att:
-			if (currentAnim > 1 && currentAnim < 3)
-			{
-				f_attackMoveDisplacer(1.5f);
-			}
-			if (currentAnim == 1)
-			{
-				f_Rescale(true, player);
-			}
-			if (currentAnim == 3)
-			{
-				f_Rescale(false, player);
-			}
-			
-			break;
-		case Light_Crouch_Att:
-			if (currentAnim == 1)
-			{
-				f_Rescale(true, player);
-			}
-			 
-			break;
-		case Medium_Att: case Medium_Walk_Att:
-			
-				if (currentAnim == 3 || currentAnim == 8)
-				{
-					f_attackMoveDisplacer(-5.5f);
-					f_Rescale(true, player);
-				}
-				 if (currentAnim == 6 || currentAnim == 10)
-				{
-					f_Rescale(false, player);
-				}
-			break;
-		case Medium_Crouch_Att:
-			if (currentAnim == 1)
-			{
-				f_Rescale(true, player);
-			}
-			if (currentAnim == 5)
-			{
-				f_attackMoveDisplacer(7.5f);
-			}
-			break;
-		case Medium_Air_Att:
-			if (currentAnim == 2)
-			{
-				f_Rescalex2(true, player);
-
-				f_attackMoveDisplacer(5.0f);
-			}
-			break;
-		case Heavy_Att:
-			if (currentAnim == 0)
-			{
-				f_Rescale(true, player);
-			}
-			
-			 if (currentAnim == 7)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Heavy_Walk_Att:
-			if (currentAnim == 4)
-			{
-				f_Rescale(true, player);
-			}
-			if (currentAnim > 2 && currentAnim < 6)
-			{
-				f_attackMoveDisplacer(4.0f);
-			}
-			 if (currentAnim == 6)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Heavy_Crouch_Att:
-			if (currentAnim == 4)
-			{
-				f_attackMoveDisplacer(17.5f);
-				f_Rescale(true, player);
-			}
-			 if (currentAnim == 14)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Heavy_Crouch_Fr_Att:
-			if (currentAnim == 4)
-			{
-				f_Rescale(true, player);
-			}
-			 if (currentAnim == 10)
-			{
-				f_Rescale(false, player);
-			}
-			break;
-		case Throw:
-			if (currentAnim == 5)
-			{
-				f_Rescale(true, player);
-			}
-			break;
-		case Heavy_Air_Att:
-			if (currentAnim == 1)
-			{
-				f_Rescale(true, player);
-			}
-			
-			if (currentAnim == 3)
-			{
-				f_attackMoveDisplacer(10.0f);
-			}
-			break;
 		case Special_OraOraOra:
 			if (currentAnim == 7 && currentStandoAnimSequence == Stando_OraOraOra)
 			{
@@ -2763,35 +2353,41 @@ namespace gen
 			}
 			break;
 		case Special_Num_2:
-			if (currentAnim == 5)
+			//One throw per pass through the sequence, however many updates frame 14 is shown for
+			if (currentAnim != 14)
 			{
-				f_Rescale(true, player);
+				knivesThrown = false;
 			}
-			if (currentAnim == 14)
+			else if (!knivesThrown)
 			{
+				knivesThrown = true;
 				SoundManager.PlayPlayerSound(KnivesFlySound, false,isPlayer1);
-				EntityManager.knivesFlyRight = isFacingRight;
-				EntityManager.knivesOwnerPlayer1 = isPlayer1;
-				if (isFacingRight)
-				{
-					EntityManager.GetEntity("KnivesRight")->Matrix().SetPosition(CVector3(player->Matrix().GetX() + 10, player->Matrix().GetY() + 5, player->Matrix().GetZ()));
-				}
-				else
-					EntityManager.GetEntity("KnivesLeft")->Matrix().SetPosition(CVector3(player->Matrix().GetX() - 10, player->Matrix().GetY() + 5, player->Matrix().GetZ()));
-				EntityManager.knivesCreated = true;
-			}
-			
-			 if (currentAnim == 19)
-			{
-				f_Rescale(false, player);
+				//The knives are a projectile drawn with the knives entity for their direction. They hit when their box
+				//overlaps a hurtbox, rather than within 30 units of the player, and expire after 4 seconds, so a throw
+				//made while the last knives are still flying no longer moves them back
+				SProjectileDesc knives;
+				knives.iOwner = isPlayer1 ? 0 : 1;
+				if (knivesRightUID == SystemUID)
+				{
+					knivesRightUID = EntityManager.ResolveEntity("KnivesRight");
+					knivesLeftUID = EntityManager.ResolveEntity("KnivesLeft");
+				}
+				knives.iVisual = isFacingRight ? knivesRightUID : knivesLeftUID;
+				knives.fPosX = player->Matrix().GetX() + (isFacingRight ? 10.0f : -10.0f);
+				knives.fPosY = player->Matrix().GetY() + 5.0f;
+				knives.fPosZ = player->Matrix().GetZ();
+				knives.fVelX = isFacingRight ? 5.0f : -5.0f;
+				knives.fVelY = 0.0f;
+				knives.fHalfWidth = 8.0f;
+				knives.fHalfHeight = 3.0f;
+				knives.fLifetime = 4.0f;
+				knives.iDamage = 65;
+				knives.iKnockback = 0;
+				knives.iKnockUp = 0;
+				EntityManager.SpawnProjectile(knives);
 			}
 			 break;
 		case Special_Num_3:
-			if (currentAnim == 0) {
-				player->Matrix().SetScale(CVector3(1.85, 1.85, 1.85));
-				player->Matrix().SetY(15.0f);
-				
-			}
 			if (currentAnim == 15)
 			{
 				EntityManager.GetEntity("ZaWarudoSphere")->Matrix().SetPosition(CVector3(MainCamera->Matrix().GetX(), MainCamera->Matrix().GetY(), MainCamera->Matrix().GetZ() + 20));
@@ -2804,44 +2400,11 @@ namespace gen
 				EntityManager.GetEntity("ZaWarudoSphere")->Matrix().ScaleX(1.05);
 				EntityManager.GetEntity("ZaWarudoSphere")->Matrix().ScaleY(1.05);
 			}
-			if (currentAnim == 25)
-			{
-				player->Matrix().SetScale(CVector3(1.5, 1.5, 1.5));
-				player->Matrix().SetY(m_GroundLevel);
-			}
-		
-			
-			break;
-		case Special_Num_4:
-			if (currentAnim == 2)
-			{
-				player->Matrix().SetScale(CVector3(1.75, 1.75, 1.75));
-				player->Matrix().SetY(15.0f);
-			}
-			if (currentAnim >= 13 && currentAnim < 19)
-			{
-				f_attackMoveDisplacer(6.0f);
-			}
-			if (currentAnim == 19)
-			{
-				player->Matrix().SetScale(CVector3(1.5, 1.5, 1.5));
-				player->Matrix().SetY(m_GroundLevel);
-			}
-			if (currentAnim == 27)
-			{
-				player->Matrix().SetScale(CVector3(1.75, 1.75, 1.75));
-				player->Matrix().SetY(15.0f);
-			}
-			if (currentAnim == 43)
-			{
-				player->Matrix().SetScale(CVector3(1.5, 1.5, 1.5));
-				player->Matrix().SetY(m_GroundLevel);
-			}
 			break;
 		case Ult_Num_1:
 			
 			
-				if (currentAnim >= 1 && player->Matrix().GetY() > m_GroundLevel + 15 && !EntityManager.DoubleUltCollisionEvent)
+				if (currentAnim >= 1 && player->Matrix().GetY() > GroundLevel() + 15 && !EntityManager.DoubleUltCollisionEvent)
 				{
 					if (isGameMode1VS1)
 					{
@@ -2854,7 +2417,7 @@ namespace gen
 					}
 					player->Matrix().MoveY(-10);
 					currentAnim = 1;
-					if (player->Matrix().GetY() < m_GroundLevel + 15)
+					if (player->Matrix().GetY() < GroundLevel() + 15)
 					{
 						isInAir = false;
 						player->Matrix().SetY(15);
@@ -2876,30 +2439,14 @@ namespace gen
 			}
 			break;
 		case Jump:
-			if (currentAnim == 0)
-			{
-				f_Rescale(true, player);
-			}
-			 if (currentAnim == 8)
-			{
-				f_Rescale(false, player);
-			}
+			//The rescale frames are checked before the landing hold turns frame 9 back into 8
+			RunFrameEvents(AnimationType);
 			 if (currentAnim == 9 && isInAir) {
 				currentAnim = 8;
 			}
 			if (isInAir)
 			{
-				f_physGravity(updateTime);
-			}
-			break;
-		case Is_Hit_Hard_2:
-			if (currentAnim == 1)
-			{
-				f_Rescale(true, player);
-			}
-			 if (currentAnim == 6)
-			{
-				f_Rescale(false, player);
+				f_physGravity();
 			}
 			break;
 		case Is_Hit_Air:
@@ -2908,30 +2455,17 @@ namespace gen
 				if (currentAnim >= 6)
 					currentAnim = 6;
 
-				f_physGravity(updateTime);
-			}
-			if (currentAnim == 0 || currentAnim == 7 || currentAnim == 11)
-			{
-				f_Rescale(true, player);
-			}
-			 if (currentAnim == 4 || currentAnim == 8 || currentAnim == 17)
-			{
-				f_Rescale(false, player);
+				f_physGravity();
 			}
 			break;
-		case Is_Killed:
-			if (currentAnim == 0)
-			{
-				f_Rescale(true, player);
-			}
-			f_attackMoveDisplacer(-1.0f);
-			break;
 		default:
 			break;
 		}
+		if (AnimationType != Jump)
+			RunFrameEvents(AnimationType);
 		if (isInAir && isBlocking)
-			f_physGravity(updateTime);
-		if (animChangeTimer >= animCycleDelay )
+			f_physGravity();
+		if (AnimChangeTimer() >= animCycleDelay )
 		{
 			if (currentAnimSequence != Summon && currentAnimSequence != Summon_Air  && currentAnimSequence != Summon_Air && !isAttacking && currentAnimSequence != Special_Num_3 && currentAnimSequence != Special_Num_4 && currentAnimSequence != Ult_Num_1)
 			{
@@ -2941,8 +2475,7 @@ namespace gen
 					Enlarged = false;
 				}
 			}
-			this->player->Mesh->m_Materials->textures[0]->Release();
-			if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &this->player->Mesh->m_Materials->textures[0], NULL)))
+			if (!SetMaterialFrame(this->player->Mesh->m_Materials, fullFileName))
 			{
 				string errorMsg = "Error loading texture " + fullFileName;
 				SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -2973,7 +2506,7 @@ namespace gen
 							f_Rescale(false, player);
 
 						currentAnimSequence = Jump;
-						m_UpwardVelocity = 0.0f;
+						player->UpwardVel() = 0.0f;
 						currentAnim = animsRight[currentAnimSequence].size() - 1;
 					}
 					else
@@ -3033,12 +2566,12 @@ namespace gen
 					if (currentAnimSequence == Special_Num_3)
 					{
 						player->Matrix().SetScale(CVector3(1.5, 1.5, 1.5));
-						player->Matrix().SetY(m_GroundLevel);
+						player->Matrix().SetY(GroundLevel());
 					}
 					if (currentAnimSequence == Ult_Num_1)
 					{
 						player->Matrix().SetScale(CVector3(1.1, 1.1, 1.1));
-						player->Matrix().SetY(m_GroundLevel);
+						player->Matrix().SetY(GroundLevel());
 						player->Matrix().MoveZ(-10);
 						EntityManager.RoddaRolla = false;
 					}
@@ -3051,7 +2584,7 @@ namespace gen
 						f_Create_Stando();
 						if (isInAir)
 						{
-							m_UpwardVelocity = 0.0f;
+							player->UpwardVel() = 0.0f;
 							currentAnimSequence = Jump;
 							currentAnim = animsRight[currentAnimSequence].size() - 1;
 							return true;
@@ -3108,37 +2641,37 @@ namespace gen
 					break;
 				}
 			}
-			animChangeTimer = 0.0f;
+			AnimChangeTimer() = 0.0f;
 
 		}
 		switch (currentAnimSequence)
 		{
 		case Is_Killed: case Victory:   case Intro_2:
-			animChangeTimer += updateTime * AnimMultSlow;
+			AnimChangeTimer() += updateTime * AnimMultSlow;
 			break;
 		case Special_Num_3:  case Light_Leg_Att:
-			animChangeTimer += updateTime * AnimMultSlow * 1.25;
+			AnimChangeTimer() += updateTime * AnimMultSlow * 1.25;
 			break;
 		case Medium_Att: case Medium_Walk_Att:  case Special_Num_2: case Dash_Back: case Crouch_Turn: case Heavy_Walk_Att:
-			animChangeTimer += updateTime * AnimMultSlow * 2.5;
+			AnimChangeTimer() += updateTime * AnimMultSlow * 2.5;
 			break;
 		 case Idle: case Walking: case Crouch: case Dash:   case Light_Crouch_Att: case Heavy_Air_Att: case Medium_Air_Att: case Throw:  case Victory_2: case Medium_Crouch_Att:  case Special_Num_4: 
-			animChangeTimer += updateTime * AnimMultNormal;
+			AnimChangeTimer() += updateTime * AnimMultNormal;
 			break;
 		case Turning: case Stand_Up: case Jump:   case Special_OraOraOra: 
-			animChangeTimer += updateTime * AnimMultFast;
+			AnimChangeTimer() += updateTime * AnimMultFast;
 			break;
 		case Heavy_Att:  case Heavy_Crouch_Att: case Heavy_Crouch_Fr_Att: case Summon: case Block: case Crouch_Block:  case Summon_Air: case Block_Air:
-			animChangeTimer += updateTime * AnimMultSplitSec;
+			AnimChangeTimer() += updateTime * AnimMultSplitSec;
 			break;
 		case Ult_Num_1:
 			if(currentAnim < 10)
-				animChangeTimer += updateTime * AnimMultSlow * 0.4;
+				AnimChangeTimer() += updateTime * AnimMultSlow * 0.4;
 			else
-			animChangeTimer += updateTime * AnimMultSplitSec * 0.8 ;
+			AnimChangeTimer() += updateTime * AnimMultSplitSec * 0.8 ;
 			break;
 		default:
-			animChangeTimer += updateTime * AnimMultNormal;
+			AnimChangeTimer() += updateTime * AnimMultNormal;
 			break;
 		}
 		return true;
@@ -3148,17 +2681,9 @@ namespace gen
 	bool CPlayerEntity::Animate_StandoDio(TFloat32 updateTime, bool isFacingRight, int AnimationType)
 	{
 		f_Create_Stando();
-		string fullFileName;
-		if (isFacingRight)
-		{
-			fullFileName = MediaFolder + animsRight[AnimationType][currentStandoAnim].second;
-		}
-		else if (!isFacingRight)
-		{
-			fullFileName = MediaFolder + animsLeft[AnimationType][currentStandoAnim].second;
-		}
-		stando->Mesh->m_Materials->textures[0]->Release();
-		if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &stando->Mesh->m_Materials->textures[0], NULL)))
+		const string& fullFileName = isFacingRight ? animsRight[AnimationType].GetFullPath(currentStandoAnim)
+		                                           : animsLeft[AnimationType].GetFullPath(currentStandoAnim);
+		if (!SetMaterialFrame(stando->Mesh->m_Materials, fullFileName))
 		{
 			string errorMsg = "Error loading texture " + fullFileName;
 			SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -3220,19 +2745,10 @@ namespace gen
 			break;
 		}
 
-		for (int i = 0; i <= (AttackAnimsPlayerFinish - AttackAnimsPlayerStart); i++)
+		if (currentStandoAnimSequence <= AttackAnimsPlayerFinish && hitFrames.IsHitFrame(currentStandoAnimSequence, currentStandoAnim))
 		{
-			if (i == currentStandoAnimSequence - AttackAnimsPlayerStart)
-			{
-				for (int j = 0; j < hitFrames[i].second.size(); j++)
-				{
-					if (hitFrames[i].second[j] == currentStandoAnim)
-					{
-						HitMessageComposer();
-						SoundManager.PlayPlayerSound(PlayerBasicAttackSound, false, isPlayer1);
-					}
-				}
-			}
+			HitMessageComposer();
+			SoundManager.PlayPlayerSound(PlayerBasicAttackSound, false, isPlayer1);
 		}
 
 		return true;
@@ -13,6 +13,7 @@ using namespace std;
 #include "Entity.h"
 #include "AnimationManager.h"
 #include "Messenger.h"
+#include "CHitFrameTable.h"
 namespace gen
 {
 
@@ -55,7 +56,7 @@ namespace gen
 
 		virtual CMatrix4x4& Matrix(TUInt32 node = 0)
 		{
-			return m_RelMatrices[node];
+			return CEntity::Matrix(node);
 		}
 
 		/////////////////////////////////////
@@ -76,6 +77,7 @@ namespace gen
 		// Return false if the entity is to be destroyed
 		// Keep as a virtual function in case of further derivation
 		virtual bool Update(TFloat32 updateTime);
+
 		virtual bool Animate(TFloat32 updateTime, bool isFacingRight, int AnimationType);
 		bool Animate_Stando(TFloat32 updateTime, bool isFacingRight, int AnimationType);
 		bool Animate_StandoDio(TFloat32 updateTime, bool isFacingRight, int AnimationType);
@@ -111,13 +113,12 @@ namespace gen
 		string      m_Name;
 		EntityStats playerStats;
 		bool isPlayer1;
-		TFloat32 m_UpwardVelocity = 0.0f;
 		TFloat32 m_HorizontalMoveSpeed = 0.5f;
 		int currentAnimSequence = 0;
 		int prevAnimSequence = 0;
-		AnimationSequence animsRight[PlayerAnimationTypes];
-		AnimationSequence animsLeft[PlayerAnimationTypes];
-		HitDetectorInfo hitFrames;
+		CAnimSequenceView animsRight[PlayerAnimationTypes];
+		CAnimSequenceView animsLeft[PlayerAnimationTypes];
+		CHitFrameTable hitFrames;
 		TUInt32 playerMaxHp = 200;
 		bool isAnimating = true;
 		bool animationLock = false;
@@ -141,7 +142,6 @@ namespace gen
 		bool moveShieldOnce = false;
 		bool Enlarged = false;
 		bool isDamaged = false;
-		TFloat32 playerAttackAnimsMax;
 		TFloat32 damagedTimer = 0.0f;
 		TFloat32 damageTransparencyTimer = 0.0f;
 		TFloat32 setHpTo = 0.0f;
@@ -178,10 +178,15 @@ namespace gen
 		void f_RescaleY(bool Enlarge, CEntity* entity, TFloat32 amount);
 		void f_attackMoveDisplacer( float displacementX);
 		void f_Stando_Displacement();
-		void f_physGravity(TFloat32 updateTime);
+		//Ask the entity manager to move the player with gravity this update, half gravity while knocked up. Once landed it clears isInAir and isKnockedUp
+		void f_physGravity();
+		//Leave the ground with the given upward velocity, per physics step
+		void f_physLaunch(TFloat32 upwardVel);
 		void SwitchPlayerHpState(SMessage msg);
-		bool SwitchAnimStateJotaro(TFloat32 updateTime, bool isFacingRight, int animSequence, string fullFileName);
-		bool SwitchAnimStateDio(TFloat32 updateTime, bool isFacingRight, int animSequence, string fullFileName);
+		bool SwitchAnimStateJotaro(TFloat32 updateTime, bool isFacingRight, int animSequence, const string& fullFileName);
+		bool SwitchAnimStateDio(TFloat32 updateTime, bool isFacingRight, int animSequence, const string& fullFileName);
+		//Apply the events from the event table on the current frame of a sequence
+		void RunFrameEvents(int animSequence);
 		void SetupControls(bool isPlayer1);
 		void UltPointsAccumulator(int dmg);
 		// Relative and absolute world matrices for each node in the template's mesh
@@ -190,6 +195,11 @@ namespace gen
 		// Entity status
 		CEntity* player ;  // 
 		CEntity* stando;
+		//Entities drawn for Dio's thrown knives, found by name on the first throw
+		TEntityUID knivesRightUID = SystemUID;
+		TEntityUID knivesLeftUID = SystemUID;
+		//Set once the knives of this pass through the throw are spawned, the throwing frame stays up for several updates
+		bool knivesThrown = false;
 		bool isPlayerJotaro;
 		
 		float standoAnimChangeTimer = 0.0f;
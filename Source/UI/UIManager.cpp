@@ -6,6 +6,7 @@
 #include <thread>
 #include <future>
 #include "FMODManager.h"
+#include "CFrameLoaderDX.h"
 using namespace std;
 
 /********************************************************************
@@ -22,6 +23,7 @@ namespace gen {
 	extern CAnimationManager AnimationManager;
 	extern const string MediaFolder;
 	extern FMODManager SoundManager;
+	extern CFrameCache VideoFrameCache;
 	UIManager::UIManager()
 	{
 		 ultEnergyDrainMeterPlayer1 = 0.0f;
@@ -117,11 +119,9 @@ namespace gen {
 			EntityManager.GetEntity("PlayerUltMeterRight")->Matrix().SetPosition(CVector3(-10000, -10000, -1000));
 		}
 	}
-	bool UIManager::ChangeUIAnimFrame(const string& s_name, string fullfilename)
+	bool UIManager::ChangeUIAnimFrame(const string& s_name, const string& fullFileName)
 	{
-		string fullFileName = MediaFolder + fullfilename;
-		EntityManager.GetEntity(s_name)->Mesh->m_Materials->textures[0]->Release();
-		if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &EntityManager.GetEntity(s_name)->Mesh->m_Materials->textures[0], NULL)))
+		if (!SetMaterialFrame(EntityManager.GetEntity(s_name)->Mesh->m_Materials, fullFileName))
 		{
 			string errorMsg = "Error loading texture " + fullFileName;
 			SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -149,9 +149,8 @@ namespace gen {
 			{
 				sName = "PlayerUltMeterRight";
 			}
-			string fullFileName = MediaFolder + AnimationManager.GetPlayerUITexturePath(Ult_Meter_Ready_Anim, currentUltMaxFrame, isPlayerJotaro, isRight);
-			EntityManager.GetEntity(sName)->Mesh->m_Materials->textures[0]->Release();
-			if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &EntityManager.GetEntity(sName)->Mesh->m_Materials->textures[0], NULL)))
+			const string& fullFileName = AnimationManager.GetPlayerUITextureFullPath(Ult_Meter_Ready_Anim, currentUltMaxFrame, isPlayerJotaro, isRight);
+			if (!SetMaterialFrame(EntityManager.GetEntity(sName)->Mesh->m_Materials, fullFileName))
 			{
 				string errorMsg = "Error loading texture " + fullFileName;
 				SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -174,9 +173,8 @@ namespace gen {
 			//INTRO VIDEO
 			//Is not actually a video, but many many separate video frames rendered to texture, which is positioned to fully cover the camera view
 			//Unfortunately DirectX 10 is not capable of many things, and video API is one of them
-			string fullFileName = MediaFolder + AnimationManager.GetMenuUIAnimFrame(currentIntroFrame, IntroAnim);
-			EntityManager.GetEntity("IntroVideo")->Mesh->m_Materials->textures[0]->Release();
-			if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &EntityManager.GetEntity("IntroVideo")->Mesh->m_Materials->textures[0], NULL)))
+			const string& fullFileName = AnimationManager.GetMenuUIAnimFullPath(currentIntroFrame, IntroAnim);
+			if (!SetMaterialFrame(EntityManager.GetEntity("IntroVideo")->Mesh->m_Materials, fullFileName, VideoFrameCache))
 			{
 				string errorMsg = "Error loading texture " + fullFileName;
 				SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -186,9 +184,8 @@ namespace gen {
 			if (currentIntroFrame >=386 || IntroSkipped)
 			{
 				currentIntroFrame = 320;
-				string fullFileName = MediaFolder + AnimationManager.GetMenuUIAnimFrame(currentIntroFrame, IntroAnim);
-				EntityManager.GetEntity("IntroVideo")->Mesh->m_Materials->textures[0]->Release();
-				if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &EntityManager.GetEntity("IntroVideo")->Mesh->m_Materials->textures[0], NULL)))
+				const string& fullFileName = AnimationManager.GetMenuUIAnimFullPath(currentIntroFrame, IntroAnim);
+				if (!SetMaterialFrame(EntityManager.GetEntity("IntroVideo")->Mesh->m_Materials, fullFileName, VideoFrameCache))
 				{
 					string errorMsg = "Error loading texture " + fullFileName;
 					SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -258,9 +255,8 @@ namespace gen {
 		modeSelectTimer += updateTime;
 		if (modeSelectTimer >= 0.25)
 		{
-			string fullFileName = MediaFolder + AnimationManager.GetMenuUIAnimFrame(currentModeSelectFrame, ModeSelectAnim);
-			EntityManager.GetEntity("ModeSelect")->Mesh->m_Materials->textures[0]->Release();
-			if (FAILED(D3DX10CreateShaderResourceViewFromFile(g_pd3dDevice, fullFileName.c_str(), NULL, NULL, &EntityManager.GetEntity("ModeSelect")->Mesh->m_Materials->textures[0], NULL)))
+			const string& fullFileName = AnimationManager.GetMenuUIAnimFullPath(currentModeSelectFrame, ModeSelectAnim);
+			if (!SetMaterialFrame(EntityManager.GetEntity("ModeSelect")->Mesh->m_Materials, fullFileName))
 			{
 				string errorMsg = "Error loading texture " + fullFileName;
 				SystemMessageBox(errorMsg.c_str(), "Mesh Error");
@@ -87,7 +87,8 @@ namespace gen {
 		bool RenderPlayerSelectMenu = false;
 		
 		void RenderText(const string& text, int X, int Y, float r, float g, float b,ID3DX10Font* font, bool centre = false);
-		bool ChangeUIAnimFrame(const string& s_name,string fullfilename);
+		//Set a UI entity to the frame with the given full path (as returned by GetPlayerUITextureFullPath)
+		bool ChangeUIAnimFrame(const string& s_name, const string& fullFileName);
 		bool CycleUltMeterReady(TFloat32 updateTime, bool isPlayerJotaro, bool isFacingRight);
 		
 	};
@@ -0,0 +1,197 @@
+/*******************************************
+	BenchAnimEvents.cpp
+
+	Per-tick cost of the player frame events:
+	the compiled event table against checking
+	every event of the sequence in turn, as the
+	"if (currentAnim == N)" chains did
+********************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include "AnimationManager.h"
+#include "TestCheck.h"
+
+namespace gen
+{
+	extern const string MediaFolder = "Media\\";
+}
+
+using namespace gen;
+
+namespace
+{
+
+const char* const kXMLFile = "../../Animations.xml";
+const char* const kCookedFile = "Animations.bin";
+const char* const kEventsFile = "../../AnimEvents.xml";
+const int kNumTicks = 1 << 20;
+const int kRuns = 9;
+
+// Frame shown on one player tick
+struct STick
+{
+	TUInt32 character;
+	TUInt32 sequence;
+	TUInt32 frame;
+};
+
+// An event with the frame it is on, for the per-sequence chains
+struct SFrameEvent
+{
+	TUInt32    frame;
+	SAnimEvent event;
+};
+
+// Stand-in for what the events do to a player, so the work cannot be optimised away
+struct SPlayerState
+{
+	TFloat32 moved;
+	TUInt32  effects;
+};
+
+inline void ApplyEvent( const SAnimEvent& event, SPlayerState& state )
+{
+	if (event.type == AnimEvent_Move)
+	{
+		state.moved += event.value;
+	}
+	state.effects += event.type + 1 + event.sound;
+}
+
+// Two players playing random sequences from start to end, the way the game steps them
+void MakeTicks( const TUInt32* frameCounts, vector<STick>* ticks )
+{
+	mt19937 random( 1234 );
+	STick players[2] = {};
+	while (ticks->size() < kNumTicks)
+	{
+		for (TUInt32 character = 0; character < 2; ++character)
+		{
+			STick& player = players[character];
+			player.character = character;
+			if (++player.frame >= frameCounts[character * PlayerAnimationTypes + player.sequence])
+			{
+				do
+				{
+					player.sequence = random() % PlayerAnimationTypes;
+				} while (!frameCounts[character * PlayerAnimationTypes + player.sequence]);
+				player.frame = 0;
+			}
+			ticks->push_back( player );
+		}
+	}
+}
+
+// Unpack the compiled table into one event list per sequence
+void MakeChains( CAnimationManager& manager, const TUInt32* frameCounts,
+                 vector<SFrameEvent>* chains )
+{
+	for (TUInt32 character = 0; character < 2; ++character)
+	{
+		for (TUInt32 sequence = 0; sequence < PlayerAnimationTypes; ++sequence)
+		{
+			vector<SFrameEvent>& chain = chains[character * PlayerAnimationTypes + sequence];
+			for (TUInt32 frame = 0; frame < frameCounts[character * PlayerAnimationTypes + sequence]; ++frame)
+			{
+				const SAnimEvent* events;
+				TUInt32 numEvents = manager.GetFrameEvents( sequence, character == 0, frame, &events );
+				for (TUInt32 event = 0; event < numEvents; ++event)
+				{
+					SFrameEvent frameEvent = { frame, events[event] };
+					chain.push_back( frameEvent );
+				}
+			}
+		}
+	}
+}
+
+template <typename TTick>
+TFloat64 TimeTicks( const vector<STick>& ticks, SPlayerState& state, TTick tick )
+{
+	state = SPlayerState();
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (size_t i = 0; i < ticks.size(); ++i)
+	{
+		tick( ticks[i], state );
+	}
+	chrono::duration<TFloat64> seconds = chrono::steady_clock::now() - start;
+	return seconds.count() * 1e9 / ticks.size();
+}
+
+TFloat64 Median( vector<TFloat64>& times )
+{
+	sort( times.begin(), times.end() );
+	return times[times.size() / 2];
+}
+
+} // namespace
+
+
+int main()
+{
+	CAnimationManager manager;
+	TEST_CHECK( manager.LoadAnimations( kXMLFile, kCookedFile ) );
+	TEST_CHECK( manager.LoadAnimEvents( kEventsFile ) );
+
+	TUInt32 frameCounts[2 * PlayerAnimationTypes];
+	for (TUInt32 character = 0; character < 2; ++character)
+	{
+		for (TUInt32 sequence = 0; sequence < PlayerAnimationTypes; ++sequence)
+		{
+			frameCounts[character * PlayerAnimationTypes + sequence] =
+				manager.GetAnimSequence( sequence, character == 0, true ).size();
+		}
+	}
+
+	vector<STick> ticks;
+	MakeTicks( frameCounts, &ticks );
+	vector<SFrameEvent> chains[2 * PlayerAnimationTypes];
+	MakeChains( manager, frameCounts, chains );
+
+	// Compiled table - one lookup, then the frame's events
+	auto tableTick = [&manager]( const STick& tick, SPlayerState& state )
+	{
+		const SAnimEvent* events;
+		TUInt32 numEvents = manager.GetFrameEvents( tick.sequence, tick.character == 0, tick.frame, &events );
+		for (TUInt32 event = 0; event < numEvents; ++event)
+		{
+			ApplyEvent( events[event], state );
+		}
+	};
+
+	// Chains - every event of the sequence compared against the current frame
+	auto chainTick = [&chains]( const STick& tick, SPlayerState& state )
+	{
+		const vector<SFrameEvent>& chain = chains[tick.character * PlayerAnimationTypes + tick.sequence];
+		for (size_t event = 0; event < chain.size(); ++event)
+		{
+			if (chain[event].frame == tick.frame)
+			{
+				ApplyEvent( chain[event].event, state );
+			}
+		}
+	};
+
+	vector<TFloat64> tableTimes, chainTimes;
+	SPlayerState tableState, chainState;
+	for (int run = 0; run < kRuns; ++run)
+	{
+		tableTimes.push_back( TimeTicks( ticks, tableState, tableTick ) );
+		chainTimes.push_back( TimeTicks( ticks, chainState, chainTick ) );
+	}
+	TEST_CHECK( tableState.effects == chainState.effects && tableState.moved == chainState.moved );
+	TEST_CHECK( tableState.effects > 0 );
+
+	size_t numEvents = 0;
+	for (TUInt32 sequence = 0; sequence < 2 * PlayerAnimationTypes; ++sequence)
+	{
+		numEvents += chains[sequence].size();
+	}
+	printf( "  %u frame events, %d player ticks, median of %d runs\n", static_cast<TUInt32>(numEvents), kNumTicks, kRuns );
+	printf( "  %-26s %6.2f ns/tick\n", "Compiled event table", Median( tableTimes ) );
+	printf( "  %-26s %6.2f ns/tick\n", "Per-sequence checks", Median( chainTimes ) );
+	return TestResult( "BenchAnimEvents" );
+}
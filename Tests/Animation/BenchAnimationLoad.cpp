@@ -0,0 +1,136 @@
+/*******************************************
+	BenchAnimationLoad.cpp
+
+	Startup benchmark of the animation database:
+	parsing Animations.xml against mapping the
+	cooked Animations.bin
+********************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "AnimationManager.h"
+#include "TestCheck.h"
+
+namespace gen
+{
+	extern const string MediaFolder = "Media\\";
+}
+
+using namespace gen;
+
+namespace
+{
+
+const char* const kXMLFile = "../../Animations.xml";
+const char* const kCookedFile = "Animations.bin";
+const int kRuns = 20;
+
+// Load a fresh manager, returning the load time in milliseconds
+TFloat64 TimeLoad( bool cooked )
+{
+	if (!cooked)
+	{
+		remove( kCookedFile );
+	}
+	CAnimationManager manager;
+	TEST_CHECK( manager.LoadAnimations( kXMLFile, kCookedFile ) );
+	TEST_CHECK( manager.WasLoadedFromCooked() == cooked );
+	return manager.GetLoadSeconds() * 1000.0;
+}
+
+bool SameSequence( const CAnimSequenceView& sequence1, const CAnimSequenceView& sequence2 )
+{
+	if (sequence1.size() != sequence2.size())
+	{
+		return false;
+	}
+	for (TUInt32 frame = 0; frame < sequence1.size(); ++frame)
+	{
+		if (sequence1.GetFrameId( frame ) != sequence2.GetFrameId( frame ) ||
+		    strcmp( sequence1.GetPath( frame ), sequence2.GetPath( frame ) ) ||
+		    sequence1.GetFullPath( frame ) != sequence2.GetFullPath( frame ))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// The cooked database must serve exactly what the XML does
+void CheckCookedMatchesXML()
+{
+	remove( kCookedFile );
+	CAnimationManager parsed, cooked;
+	TEST_CHECK( parsed.LoadAnimations( kXMLFile, kCookedFile ) && !parsed.WasLoadedFromCooked() );
+	TEST_CHECK( cooked.LoadAnimations( kXMLFile, kCookedFile ) && cooked.WasLoadedFromCooked() );
+
+	TUInt32 numFrames = 0;
+	for (int character = 0; character < 2; ++character)
+	{
+		for (int facing = 0; facing < 2; ++facing)
+		{
+			for (int type = 0; type < PlayerAnimationTypes; ++type)
+			{
+				CAnimSequenceView sequence = parsed.GetAnimSequence( type, character == 0, facing == 0 );
+				TEST_CHECK( SameSequence( sequence, cooked.GetAnimSequence( type, character == 0, facing == 0 ) ) );
+				numFrames += sequence.size();
+			}
+		}
+	}
+	for (int facing = 0; facing < 2; ++facing)
+	{
+		for (int monster = 0; monster < MonsterTypeCount; ++monster)
+		{
+			for (int type = 0; type < MonsterAnimTypeCount; ++type)
+			{
+				TEST_CHECK( SameSequence( parsed.GetMonsterAnimSequence( monster, type, facing == 0 ),
+				                          cooked.GetMonsterAnimSequence( monster, type, facing == 0 ) ) );
+			}
+		}
+	}
+	for (int type = 0; type < MenuUIAnimationTypeCount; ++type)
+	{
+		for (int frame = 0; frame < 400; ++frame)
+		{
+			TEST_CHECK( parsed.GetMenuUIAnimFullPath( frame, type ) == cooked.GetMenuUIAnimFullPath( frame, type ) );
+		}
+	}
+	TEST_CHECK( numFrames > 1000 );
+	printf( "  %u player frames, cooked database matches the XML\n", numFrames );
+}
+
+void Report( const char* name, vector<TFloat64>& times )
+{
+	sort( times.begin(), times.end() );
+	TFloat64 total = 0.0;
+	for (size_t run = 0; run < times.size(); ++run)
+	{
+		total += times[run];
+	}
+	printf( "  %-26s min %8.3f ms  median %8.3f ms  mean %8.3f ms\n", name,
+	        times.front(), times[times.size() / 2], total / times.size() );
+}
+
+} // namespace
+
+
+int main()
+{
+	CheckCookedMatchesXML();
+
+	vector<TFloat64> xmlTimes, cookedTimes;
+	for (int run = 0; run < kRuns; ++run)
+	{
+		xmlTimes.push_back( TimeLoad( false ) );
+	}
+	for (int run = 0; run < kRuns; ++run)
+	{
+		cookedTimes.push_back( TimeLoad( true ) );
+	}
+	printf( "  LoadAnimations, %d runs each (cooked runs include resolving full paths)\n", kRuns );
+	Report( "Animations.xml (expat)", xmlTimes );
+	Report( "Animations.bin (mapped)", cookedTimes );
+	return TestResult( "BenchAnimationLoad" );
+}
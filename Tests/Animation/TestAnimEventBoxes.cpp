@@ -0,0 +1,117 @@
+/*******************************************
+	TestAnimEventBoxes.cpp
+
+	Tests of the hitboxes and hurtboxes shipped
+	in AnimEvents.xml, as loaded by the
+	animation manager
+********************************************/
+
+#include "AnimationManager.h"
+#include "TestCheck.h"
+
+namespace gen
+{
+	extern const string MediaFolder = "Media\\";
+}
+
+using namespace gen;
+
+namespace
+{
+
+const char* const kXMLFile = "../../Animations.xml";
+const char* const kCookedFile = "Animations.bin";
+const char* const kEventsFile = "../../AnimEvents.xml";
+
+const TUInt32 kJotaro = 0, kDio = 1;
+
+CAnimationManager* Manager;
+
+TUInt32 NumFrames( TUInt32 character, TUInt32 sequence )
+{
+	return static_cast<TUInt32>(Manager->GetAnimSequence( sequence, character == kJotaro, true ).size());
+}
+
+// Stand sequences are not played by the players themselves
+bool IsPlayerSequence( TUInt32 sequence )
+{
+	return sequence < Stando_OraOraOra || sequence > Stando_Idle;
+}
+
+bool IsAttack( TUInt32 sequence )
+{
+	return sequence >= Light_Leg_Att && sequence <= Throw;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Tests
+-----------------------------------------------------------------------------------------*/
+
+// Jotaro has a hurtbox on every frame the player shows and a hitbox on every frame of his attacks
+void JotaroBoxes()
+{
+	TUInt32 numSequences = 0, numWrong = 0;
+	for (TUInt32 sequence = 0; sequence < PlayerAnimationTypes; ++sequence)
+	{
+		TUInt32 numFrames = NumFrames( kJotaro, sequence );
+		if (!IsPlayerSequence( sequence ) || numFrames == 0)
+		{
+			continue;
+		}
+		++numSequences;
+		for (TUInt32 frame = 0; frame < numFrames; ++frame)
+		{
+			TUInt32 firstBox;
+			numWrong += Manager->GetHurtBoxes().GetFrameBoxes( kJotaro, sequence, frame, &firstBox ) != 1;
+			numWrong += Manager->GetHitBoxes().GetFrameBoxes( kJotaro, sequence, frame, &firstBox ) !=
+			            (IsAttack( sequence ) ? 1u : 0u);
+		}
+	}
+	TEST_CHECK( numSequences > 0 && numWrong == 0 );
+}
+
+// Dio has no boxes yet, so his hits still use the distance check
+void DioHasNoBoxes()
+{
+	TUInt32 numBoxes = 0;
+	for (TUInt32 sequence = 0; sequence < PlayerAnimationTypes; ++sequence)
+	{
+		for (TUInt32 frame = 0; frame < NumFrames( kDio, sequence ); ++frame)
+		{
+			TUInt32 firstBox;
+			numBoxes += Manager->GetHurtBoxes().GetFrameBoxes( kDio, sequence, frame, &firstBox );
+			numBoxes += Manager->GetHitBoxes().GetFrameBoxes( kDio, sequence, frame, &firstBox );
+		}
+	}
+	TEST_CHECK( numBoxes == 0 );
+}
+
+// An attack reaches as far in front as the old 30 unit distance check, whichever way the player
+// hit is facing, and not behind the attacker
+void AttackReach()
+{
+	TUInt32 hitBox, hurtBox;
+	TEST_CHECK( Manager->GetHitBoxes().GetFrameBoxes( kJotaro, Medium_Att, 0, &hitBox ) == 1 );
+	TEST_CHECK( Manager->GetHurtBoxes().GetFrameBoxes( kJotaro, Idle, 0, &hurtBox ) == 1 );
+	const CFrameBoxTable& hits = Manager->GetHitBoxes();
+	const CFrameBoxTable& hurts = Manager->GetHurtBoxes();
+	TEST_CHECK( hurts.GetMinX()[hurtBox] == -hurts.GetMaxX()[hurtBox] );
+	TEST_CHECK( hits.GetMaxX()[hitBox] + hurts.GetMaxX()[hurtBox] == 30.0f );
+	TEST_CHECK( hits.GetMinX()[hitBox] >= 0.0f );
+}
+
+} // namespace
+
+
+int main()
+{
+	CAnimationManager manager;
+	Manager = &manager;
+	TEST_CHECK( manager.LoadAnimations( kXMLFile, kCookedFile ) );
+	TEST_CHECK( manager.LoadAnimEvents( kEventsFile ) );
+	TEST_RUN( JotaroBoxes );
+	TEST_RUN( DioHasNoBoxes );
+	TEST_RUN( AttackReach );
+	return TestResult( "TestAnimEventBoxes" );
+}
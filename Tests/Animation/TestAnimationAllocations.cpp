@@ -0,0 +1,199 @@
+/*******************************************
+	TestAnimationAllocations.cpp
+
+	Counts heap allocations on the per-frame
+	animation path: sequence views, full paths,
+	atlas lookup and frame cache hits
+********************************************/
+
+#include <cstdlib>
+#include <new>
+#include "AnimationManager.h"
+#include "CAtlasPacker.h"
+#include "CFrameCache.h"
+#include "TestCheck.h"
+
+namespace gen
+{
+	extern const string MediaFolder = "Media\\";
+}
+
+using namespace gen;
+
+/////////////////////////////////////
+// Allocation counting - every global new in the program goes through here
+
+namespace
+{
+	TUInt32 NumAllocations = 0;
+}
+
+void* operator new( size_t size )
+{
+	++NumAllocations;
+	void* memory = malloc( size ? size : 1 );
+	if (!memory)
+	{
+		throw bad_alloc();
+	}
+	return memory;
+}
+void* operator new[]( size_t size )
+{
+	return operator new( size );
+}
+void operator delete( void* memory ) noexcept
+{
+	free( memory );
+}
+void operator delete[]( void* memory ) noexcept
+{
+	free( memory );
+}
+void operator delete( void* memory, size_t ) noexcept
+{
+	free( memory );
+}
+void operator delete[]( void* memory, size_t ) noexcept
+{
+	free( memory );
+}
+
+
+namespace
+{
+
+const char* const kXMLFile = "../../Animations.xml";
+const char* const kCookedFile = "Animations.bin";
+
+// Loader that decodes nothing, every frame is a fixed size block with no data
+class CNullLoader : public IFrameLoader
+{
+public:
+	bool LoadFrame( const string& fileName, SFrame* frame )
+	{
+		frame->handle = this;
+		frame->sizeBytes = 1024;
+		return true;
+	}
+	void AddRefFrame( const SFrame& frame ) {}
+	void ReleaseFrame( const SFrame& frame ) {}
+};
+
+// What the animation code does each time a frame changes: take the frame from the sequence view,
+// look it up in the atlases and, if not there, in the frame cache
+TUInt32 ShowFrame( const CAnimSequenceView& sequence, TUInt32 frame, const CAtlasTable& atlases,
+                   CFrameCache& frameCache )
+{
+	const string& fullPath = sequence.GetFullPath( frame );
+	SAtlasFrame atlasFrame;
+	if (atlases.FindFrame( fullPath, &atlasFrame ))
+	{
+		return atlasFrame.atlas;
+	}
+	SFrame cached;
+	if (frameCache.AcquireFrame( fullPath, &cached ))
+	{
+		frameCache.ReleaseFrame( cached );
+	}
+	return sequence.GetFrameId( frame );
+}
+
+// Show every frame of every player sequence, both characters and facings. Returns a checksum so
+// the work is not optimised away
+TUInt32 ShowAllPlayerFrames( CAnimationManager& manager, const CAtlasTable& atlases, CFrameCache& frameCache )
+{
+	TUInt32 checksum = 0;
+	for (int character = 0; character < 2; ++character)
+	{
+		for (int facing = 0; facing < 2; ++facing)
+		{
+			for (int type = 0; type < PlayerAnimationTypes; ++type)
+			{
+				CAnimSequenceView sequence = manager.GetAnimSequence( type, character == 0, facing == 0 );
+				for (TUInt32 frame = 0; frame < sequence.size(); ++frame)
+				{
+					checksum += ShowFrame( sequence, frame, atlases, frameCache );
+				}
+			}
+		}
+	}
+	for (int type = 0; type < PlayerUIAnimsCount; ++type)
+	{
+		checksum += static_cast<TUInt32>(manager.GetPlayerUITextureFullPath( type, 0, true, true ).size());
+	}
+	for (int frame = 0; frame < 400; ++frame)
+	{
+		checksum += static_cast<TUInt32>(manager.GetMenuUIAnimFullPath( frame, IntroAnim ).size());
+	}
+	return checksum;
+}
+
+
+// Once the database is loaded and the caches are warm, showing frames must not allocate
+void TestNoAllocationsPerFrame( bool cooked )
+{
+	if (!cooked)
+	{
+		remove( kCookedFile );
+	}
+	TUInt32 allocationsBeforeLoad = NumAllocations;
+	CAnimationManager manager;
+	TEST_CHECK( manager.LoadAnimations( kXMLFile, kCookedFile ) );
+	TEST_CHECK( manager.WasLoadedFromCooked() == cooked );
+	TEST_CHECK( NumAllocations > allocationsBeforeLoad ); // The counter is live
+
+	// Half the Jotaro frames go in an atlas, the rest through the frame cache
+	CAtlasPacker packer;
+	packer.BeginGroup( "Jotaro" );
+	for (int type = 0; type < PlayerAnimationTypes; type += 2)
+	{
+		CAnimSequenceView sequence = manager.GetAnimSequence( type, true, true );
+		for (TUInt32 frame = 0; frame < sequence.size(); ++frame)
+		{
+			packer.AddFrame( sequence.GetFullPath( frame ), 64, 64 );
+		}
+	}
+	CAtlasTable atlases;
+	TEST_CHECK( packer.Pack( &atlases ) > 0 );
+
+	CNullLoader loader;
+	CFrameCache frameCache( &loader );
+	TUInt32 warmChecksum = ShowAllPlayerFrames( manager, atlases, frameCache );
+	TEST_CHECK( frameCache.GetStats().misses > 0 );
+
+	frameCache.ResetStats();
+	TUInt32 allocationsBefore = NumAllocations;
+	TUInt32 checksum = 0;
+	for (int pass = 0; pass < 10; ++pass)
+	{
+		checksum += ShowAllPlayerFrames( manager, atlases, frameCache );
+	}
+	TUInt32 allocations = NumAllocations - allocationsBefore;
+
+	printf( "  %s database: %u allocations over 10 passes, %u frame cache hits\n",
+	        cooked ? "cooked" : "parsed", allocations, frameCache.GetStats().hits );
+	TEST_CHECK( allocations == 0 );
+	TEST_CHECK( frameCache.GetStats().misses == 0 );
+	TEST_CHECK( checksum == warmChecksum * 10 );
+}
+
+void TestParsedDatabase()
+{
+	TestNoAllocationsPerFrame( false );
+}
+
+void TestCookedDatabase()
+{
+	TestNoAllocationsPerFrame( true );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( TestParsedDatabase );
+	TEST_RUN( TestCookedDatabase );
+	return TestResult( "TestAnimationAllocations" );
+}
@@ -0,0 +1,146 @@
+/*******************************************
+	TestAtlasPacker.cpp
+
+	Tests of the sprite atlas packer: every
+	frame placed once, inside its atlas, with
+	no overlap and groups kept apart
+********************************************/
+
+#include <fstream>
+#include <sstream>
+#include "CAtlasPacker.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32 kMaxAtlasSize = 1024;
+const TUInt32 kPadding = 2;
+
+string FrameName( const string& group, TUInt32 frame )
+{
+	ostringstream name;
+	name << group << frame;
+	return name.str();
+}
+
+// Write just the start of a PNG file - the signature and the IHDR chunk holding the size
+void WritePNGHeader( const string& fileName, TUInt32 width, TUInt32 height )
+{
+	const TUInt8 header[24] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n', 0, 0, 0, 13, 'I', 'H', 'D', 'R',
+		static_cast<TUInt8>(width >> 24), static_cast<TUInt8>(width >> 16),
+		static_cast<TUInt8>(width >> 8), static_cast<TUInt8>(width),
+		static_cast<TUInt8>(height >> 24), static_cast<TUInt8>(height >> 16),
+		static_cast<TUInt8>(height >> 8), static_cast<TUInt8>(height) };
+	ofstream file( fileName.c_str(), ios::binary );
+	file.write( reinterpret_cast<const char*>(header), sizeof(header) );
+}
+
+// Check every frame in the table lies inside its atlas, clear of the edges and of other frames
+// by the padding
+void CheckPlacements( const CAtlasTable& table )
+{
+	for (TUInt32 i = 0; i < table.GetNumFrames(); ++i)
+	{
+		const SAtlasFrame& frame = table.GetFrame( i );
+		const SAtlasInfo& atlas = table.GetAtlas( frame.atlas );
+		TEST_CHECK( frame.x >= kPadding && frame.y >= kPadding );
+		TEST_CHECK( frame.x + frame.width + kPadding <= atlas.width );
+		TEST_CHECK( frame.y + frame.height + kPadding <= atlas.height );
+		TEST_CHECK( atlas.width <= kMaxAtlasSize && atlas.height <= kMaxAtlasSize );
+		TEST_CHECK( atlas.width % 4 == 0 && atlas.height % 4 == 0 );
+
+		for (TUInt32 j = i + 1; j < table.GetNumFrames(); ++j)
+		{
+			const SAtlasFrame& other = table.GetFrame( j );
+			bool apart = frame.atlas != other.atlas ||
+			             frame.x + frame.width + kPadding <= other.x || other.x + other.width + kPadding <= frame.x ||
+			             frame.y + frame.height + kPadding <= other.y || other.y + other.height + kPadding <= frame.y;
+			TEST_CHECK( apart );
+		}
+	}
+}
+
+
+void TestPackedFramesDoNotOverlap()
+{
+	CAtlasPacker packer( kMaxAtlasSize, kPadding );
+	packer.BeginGroup( "Jotaro" );
+	for (TUInt32 frame = 0; frame < 60; ++frame)
+	{
+		packer.AddFrame( FrameName( "jotaro", frame ), 150 + frame % 9 * 11, 120 + frame % 7 * 13 );
+	}
+
+	CAtlasTable table;
+	TEST_CHECK( packer.Pack( &table ) == 60 );
+	TEST_CHECK( table.GetNumFrames() == 60 );
+	TEST_CHECK( table.GetNumAtlases() > 1 ); // 60 frames of this size need more than one atlas
+	CheckPlacements( table );
+
+	// UV rect is the pixel rect scaled to the atlas
+	SAtlasFrame frame;
+	TEST_CHECK( table.FindFrame( FrameName( "jotaro", 5 ), &frame ) );
+	const SAtlasInfo& atlas = table.GetAtlas( frame.atlas );
+	TEST_CHECK( frame.uvRect[0] == frame.x / static_cast<TFloat32>(atlas.width) );
+	TEST_CHECK( frame.uvRect[3] == frame.height / static_cast<TFloat32>(atlas.height) );
+	TEST_CHECK( !table.FindFrame( "missing", &frame ) );
+}
+
+void TestGroupsAreSeparate()
+{
+	CAtlasPacker packer( kMaxAtlasSize, kPadding );
+	packer.BeginGroup( "Jotaro" );
+	packer.AddFrame( "jotaro0", 100, 100 );
+	packer.AddFrame( "shared", 100, 100 );
+	packer.BeginGroup( "Dio" );
+	packer.AddFrame( "dio0", 100, 100 );
+	packer.AddFrame( "shared", 100, 100 ); // Already in a group, ignored
+	packer.AddFrame( "tooLarge", kMaxAtlasSize, 10 );
+
+	CAtlasTable table;
+	TEST_CHECK( packer.Pack( &table ) == 3 );
+	TEST_CHECK( table.GetNumAtlases() == 2 );
+	TEST_CHECK( table.GetAtlas( 0 ).name == "Jotaro_0" && table.GetAtlas( 1 ).name == "Dio_0" );
+
+	SAtlasFrame jotaro, dio, shared;
+	TEST_CHECK( table.FindFrame( "jotaro0", &jotaro ) );
+	TEST_CHECK( table.FindFrame( "dio0", &dio ) );
+	TEST_CHECK( table.FindFrame( "shared", &shared ) );
+	TEST_CHECK( jotaro.atlas == 0 && shared.atlas == 0 && dio.atlas == 1 );
+	TEST_CHECK( !table.FindFrame( "tooLarge", &shared ) );
+	CheckPlacements( table );
+}
+
+void TestReadPNGSize()
+{
+	WritePNGHeader( "frame.png", 321, 4000 );
+	TUInt32 width = 0, height = 0;
+	TEST_CHECK( CAtlasPacker::ReadPNGSize( "frame.png", &width, &height ) );
+	TEST_CHECK( width == 321 && height == 4000 );
+
+	ofstream( "notPNG.png" ) << "this is not a PNG file at all";
+	TEST_CHECK( !CAtlasPacker::ReadPNGSize( "notPNG.png", &width, &height ) );
+	TEST_CHECK( !CAtlasPacker::ReadPNGSize( "missing.png", &width, &height ) );
+
+	CAtlasPacker packer( kMaxAtlasSize, kPadding );
+	packer.BeginGroup( "UI" );
+	TEST_CHECK( !packer.AddFrame( "missing.png" ) );
+	WritePNGHeader( "small.png", 64, 32 );
+	TEST_CHECK( packer.AddFrame( "small.png" ) );
+	CAtlasTable table;
+	TEST_CHECK( packer.Pack( &table ) == 1 );
+	TEST_CHECK( table.GetFrame( 0 ).width == 64 && table.GetFrame( 0 ).height == 32 );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( TestPackedFramesDoNotOverlap );
+	TEST_RUN( TestGroupsAreSeparate );
+	TEST_RUN( TestReadPNGSize );
+	return TestResult( "TestAtlasPacker" );
+}
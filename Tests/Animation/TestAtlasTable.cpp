@@ -0,0 +1,135 @@
+/*******************************************
+	TestAtlasTable.cpp
+
+	Tests of the atlas table file and of the
+	source key that marks it out of date
+********************************************/
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include "CAtlasTable.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+void WriteFile( const string& fileName, const string& contents )
+{
+	ofstream file( fileName.c_str(), ios::binary | ios::trunc );
+	file << contents;
+}
+
+CAtlasTable MakeTable()
+{
+	CAtlasTable table;
+	table.AddAtlas( "Jotaro_0", 512, 256 );
+	table.AddAtlas( "Dio_0", 128, 128 );
+	table.AddFrame( "jotaro0.png", 0, 2, 2, 100, 50 );
+	table.AddFrame( "jotaro1.png", 0, 104, 2, 100, 50 );
+	table.AddFrame( "dio0.png", 1, 2, 2, 64, 64 );
+	return table;
+}
+
+
+void TestSaveAndLoad()
+{
+	CAtlasTable table = MakeTable();
+	table.SetSourceKey( 0x123456789abcdefull );
+	TEST_CHECK( table.Save( "table.bin" ) );
+
+	CAtlasTable loaded;
+	TEST_CHECK( loaded.Load( "table.bin" ) );
+	TEST_CHECK( loaded.GetSourceKey() == 0x123456789abcdefull );
+	TEST_CHECK( loaded.GetNumAtlases() == 2 && loaded.GetNumFrames() == 3 );
+	TEST_CHECK( loaded.GetAtlas( 1 ).name == "Dio_0" && loaded.GetAtlas( 0 ).width == 512 );
+
+	SAtlasFrame saved, frame;
+	TEST_CHECK( table.FindFrame( "jotaro1.png", &saved ) );
+	TEST_CHECK( loaded.FindFrame( "jotaro1.png", &frame ) );
+	TEST_CHECK( frame.atlas == 0 && frame.x == 104 && frame.y == 2 );
+	for (int i = 0; i < 4; ++i)
+	{
+		TEST_CHECK( frame.uvRect[i] == saved.uvRect[i] );
+	}
+
+	// The key given to Load must match the one saved
+	TEST_CHECK( loaded.Load( "table.bin", 0x123456789abcdefull ) );
+	TEST_CHECK( !loaded.Load( "table.bin", 1 ) );
+	TEST_CHECK( loaded.GetNumFrames() == 0 ); // A rejected table is left empty
+}
+
+void TestRejectsBadFiles()
+{
+	CAtlasTable table;
+	TEST_CHECK( !table.Load( "missing.bin" ) );
+
+	WriteFile( "short.bin", "ATLS" );
+	TEST_CHECK( !table.Load( "short.bin" ) );
+
+	// Right magic, wrong version
+	TUInt32 header[8] = { 0x534c5441, 1, 0, 0, 0, 0, 0, 0 };
+	WriteFile( "oldVersion.bin", string( reinterpret_cast<const char*>(header), sizeof(header) ) );
+	TEST_CHECK( !table.Load( "oldVersion.bin" ) );
+
+	// Truncated frame records
+	MakeTable().Save( "table.bin" );
+	ifstream full( "table.bin", ios::binary );
+	string contents( (istreambuf_iterator<char>( full )), istreambuf_iterator<char>() );
+	WriteFile( "truncated.bin", contents.substr( 0, contents.size() / 2 ) );
+	TEST_CHECK( !table.Load( "truncated.bin" ) );
+}
+
+// The key changes when any source file is added, removed, resized or rewritten, and not otherwise
+void TestSourceKey()
+{
+	WriteFile( "source0.png", "frame zero" );
+	WriteFile( "source1.png", "frame one" );
+	filesystem::remove( "source2.png" );
+	vector<string> files;
+	files.push_back( "source0.png" );
+	files.push_back( "source1.png" );
+
+	TUInt64 key = CAtlasTable::MakeSourceKey( files );
+	TEST_CHECK( CAtlasTable::MakeSourceKey( files ) == key );
+
+	// Resized
+	WriteFile( "source1.png", "frame one, longer" );
+	TUInt64 resizedKey = CAtlasTable::MakeSourceKey( files );
+	TEST_CHECK( resizedKey != key );
+
+	// Same size, newer write time
+	filesystem::file_time_type writeTime = filesystem::last_write_time( "source0.png" );
+	WriteFile( "source0.png", "frame 0000" );
+	filesystem::last_write_time( "source0.png", writeTime + chrono::seconds( 10 ) );
+	TUInt64 rewrittenKey = CAtlasTable::MakeSourceKey( files );
+	TEST_CHECK( rewrittenKey != resizedKey );
+
+	// A listed file that is missing, then appears
+	files.push_back( "source2.png" );
+	TUInt64 missingKey = CAtlasTable::MakeSourceKey( files );
+	TEST_CHECK( missingKey != rewrittenKey );
+	WriteFile( "source2.png", "frame two" );
+	TEST_CHECK( CAtlasTable::MakeSourceKey( files ) != missingKey );
+
+	// A table saved with the key loads until a source changes
+	CAtlasTable table = MakeTable();
+	table.SetSourceKey( CAtlasTable::MakeSourceKey( files ) );
+	table.Save( "keyed.bin" );
+	TEST_CHECK( table.Load( "keyed.bin", CAtlasTable::MakeSourceKey( files ) ) );
+	WriteFile( "source2.png", "frame two changed" );
+	TEST_CHECK( !table.Load( "keyed.bin", CAtlasTable::MakeSourceKey( files ) ) );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( TestSaveAndLoad );
+	TEST_RUN( TestRejectsBadFiles );
+	TEST_RUN( TestSourceKey );
+	return TestResult( "TestAtlasTable" );
+}
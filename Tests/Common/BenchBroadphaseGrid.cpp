@@ -0,0 +1,159 @@
+/*******************************************
+	BenchBroadphaseGrid.cpp
+
+	Collision tests of monsters against other
+	objects: the broadphase grid against testing
+	every pair, and that both find the same
+	collisions
+********************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include "CBroadphaseGrid.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32 kNumFrames = 20;
+const TUInt32 kBatchSize = 256;
+
+// Collision groups, as CEntityManager uses them
+const TUInt32 kPlayer = 1, kStand = 2, kMonster = 4, kProjectile = 8;
+
+struct SObject
+{
+	TFloat32 x, y, radius;
+	TUInt32  group;
+};
+
+typedef pair<TUInt32, TUInt32> TCollision;
+
+// Monsters collide with anything else within both radiuses
+bool Collide( const SObject& a, const SObject& b )
+{
+	if ((a.group == kMonster) == (b.group == kMonster))
+	{
+		return false;
+	}
+	TFloat32 dx = a.x - b.x, dy = a.y - b.y, reach = a.radius + b.radius;
+	return dx * dx + dy * dy < reach * reach;
+}
+
+TCollision Ordered( TUInt32 a, TUInt32 b )
+{
+	return a < b ? TCollision( a, b ) : TCollision( b, a );
+}
+
+TFloat64 MicrosecondsSince( chrono::steady_clock::time_point start )
+{
+	chrono::duration<TFloat64, micro> microseconds = chrono::steady_clock::now() - start;
+	return microseconds.count();
+}
+
+// Test every monster against every other object
+TFloat64 BruteForce( const vector<SObject>& objects, vector<TCollision>& collisions )
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 i = 0; i < objects.size(); ++i)
+	{
+		if (objects[i].group != kMonster)
+		{
+			continue;
+		}
+		for (TUInt32 j = 0; j < objects.size(); ++j)
+		{
+			if (Collide( objects[i], objects[j] ))
+			{
+				collisions.push_back( Ordered( i, j ) );
+			}
+		}
+	}
+	return MicrosecondsSince( start );
+}
+
+// Rebuild the grid and test the pairs it returns, as CEntityManager::CollisionCalculator does
+TFloat64 Grid( CBroadphaseGrid& grid, const vector<SObject>& objects, vector<TCollision>& collisions,
+               TUInt32* numCandidates )
+{
+	SBroadphasePair pairs[kBatchSize];
+	*numCandidates = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	grid.Clear();
+	for (TUInt32 i = 0; i < objects.size(); ++i)
+	{
+		grid.Add( i, objects[i].x, objects[i].y, objects[i].radius, objects[i].group,
+		          objects[i].group == kMonster ? 0 : kMonster );
+	}
+	grid.Build();
+	TUInt32 numPairs;
+	do
+	{
+		numPairs = grid.GetPairs( pairs, kBatchSize );
+		*numCandidates += numPairs;
+		for (TUInt32 pair = 0; pair < numPairs; ++pair)
+		{
+			if (Collide( objects[pairs[pair].iA], objects[pairs[pair].iB] ))
+			{
+				collisions.push_back( Ordered( pairs[pair].iA, pairs[pair].iB ) );
+			}
+		}
+	} while (numPairs == kBatchSize);
+	return MicrosecondsSince( start );
+}
+
+// Half monsters and half projectiles spread along the stage at the same density for each size,
+// with one player and one stand
+void RunSize( TUInt32 numObjects )
+{
+	mt19937 random( 2 );
+	TFloat32 stageWidth = 2.0f * numObjects;
+	uniform_real_distribution<TFloat32> x( -stageWidth, stageWidth ), y( 0.0f, 600.0f );
+	vector<SObject> objects;
+	SObject player = { 0.0f, 10.0f, 0.0f, kPlayer }, stand = { 20.0f, 30.0f, 0.0f, kStand };
+	objects.push_back( player );
+	objects.push_back( stand );
+	for (TUInt32 i = 0; i < numObjects / 2; ++i)
+	{
+		SObject monster = { x( random ), y( random ), 45.0f, kMonster };
+		SObject projectile = { x( random ), y( random ), 15.0f, kProjectile };
+		objects.push_back( monster );
+		objects.push_back( projectile );
+	}
+
+	vector<TCollision> bruteCollisions, gridCollisions;
+	TFloat64 bruteTime = BruteForce( objects, bruteCollisions );
+
+	CBroadphaseGrid grid( 64.0f );
+	TFloat64 gridTime = 0.0;
+	TUInt32 numCandidates = 0;
+	for (TUInt32 frame = 0; frame < kNumFrames; ++frame)
+	{
+		gridCollisions.clear();
+		gridTime += Grid( grid, objects, gridCollisions, &numCandidates );
+	}
+
+	// Same collisions, none found twice
+	sort( bruteCollisions.begin(), bruteCollisions.end() );
+	sort( gridCollisions.begin(), gridCollisions.end() );
+	TEST_CHECK( adjacent_find( gridCollisions.begin(), gridCollisions.end() ) == gridCollisions.end() );
+	TEST_CHECK( gridCollisions == bruteCollisions );
+
+	printf( "  %6u objects  every pair %9.0f us  grid %7.0f us  (%u collisions, %u candidate pairs, %u cells)\n",
+	        static_cast<TUInt32>(objects.size()), bruteTime, gridTime / kNumFrames,
+	        static_cast<TUInt32>(gridCollisions.size()), numCandidates, grid.GetNumCells() );
+}
+
+} // namespace
+
+
+int main()
+{
+	RunSize( 2000 );
+	RunSize( 8000 );
+	RunSize( 32000 );
+	return TestResult( "BenchBroadphaseGrid" );
+}
@@ -0,0 +1,206 @@
+/*******************************************
+	BenchHandleLookUp.cpp
+
+	Entity look-up by UID: the handle table
+	against a CFlatHashTable from UID to index,
+	as entity UIDs were before, with 10k, 100k
+	and 1M entities created and destroyed
+********************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include "CHandleTable.h"
+#include "CFlatHashTable.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32 kNumRounds = 8;
+const TUInt32 kLookUpsPerEntity = 4;
+
+// Stand-in for an entity, knowing its own UID
+struct SEntity
+{
+	TUInt32 UID;
+	TUInt32 data;
+};
+
+// Entities kept packed as the entity manager keeps them, with the UID to index mapping done by a
+// handle table
+class CHandleEntities
+{
+public:
+	CHandleEntities() : m_UIDs( 1024 ) {}
+
+	TUInt32 Create()
+	{
+		TUInt32 UID = m_UIDs.New( static_cast<TUInt32>(m_Entities.size()) );
+		SEntity entity = { UID, UID };
+		m_Entities.push_back( entity );
+		return UID;
+	}
+
+	void Destroy( TUInt32 UID )
+	{
+		TUInt32 index = m_UIDs.GetIndex( UID );
+		m_UIDs.Free( UID );
+		if (index != m_Entities.size() - 1)
+		{
+			m_Entities[index] = m_Entities.back();
+			m_UIDs.SetIndex( m_Entities[index].UID, index );
+		}
+		m_Entities.pop_back();
+	}
+
+	const SEntity* Get( TUInt32 UID )
+	{
+		return m_UIDs.IsValid( UID ) ? &m_Entities[m_UIDs.GetIndex( UID )] : 0;
+	}
+
+private:
+	CHandleTable<bool> m_UIDs;
+	vector<SEntity>    m_Entities;
+};
+
+// The same with a hash table from UID to index, and UIDs from a counter
+class CHashedEntities
+{
+public:
+	CHashedEntities() : m_UIDs( 1024 ), m_NextUID( 0 ) {}
+
+	TUInt32 Create()
+	{
+		TUInt32 UID = m_NextUID++;
+		m_UIDs.SetKeyValue( UID, static_cast<TUInt32>(m_Entities.size()) );
+		SEntity entity = { UID, UID };
+		m_Entities.push_back( entity );
+		return UID;
+	}
+
+	void Destroy( TUInt32 UID )
+	{
+		TUInt32 index = 0;
+		m_UIDs.LookUpKey( UID, &index );
+		m_UIDs.RemoveKey( UID );
+		if (index != m_Entities.size() - 1)
+		{
+			m_Entities[index] = m_Entities.back();
+			m_UIDs.SetKeyValue( m_Entities[index].UID, index );
+		}
+		m_Entities.pop_back();
+	}
+
+	const SEntity* Get( TUInt32 UID )
+	{
+		TUInt32 index;
+		return m_UIDs.LookUpKey( UID, &index ) ? &m_Entities[index] : 0;
+	}
+
+private:
+	CFlatHashTable<TUInt32, TUInt32> m_UIDs;
+	vector<SEntity>                  m_Entities;
+	TUInt32                          m_NextUID;
+};
+
+// Times in nanoseconds per operation
+struct STimes
+{
+	TFloat64 churn;  // Destroy one entity and create another
+	TFloat64 lookUp; // Look up a live entity
+	TFloat64 stale;  // Look up a destroyed entity
+};
+
+TFloat64 NanosecondsSince( chrono::steady_clock::time_point start, size_t numOperations )
+{
+	chrono::duration<TFloat64> seconds = chrono::steady_clock::now() - start;
+	return seconds.count() * 1e9 / numOperations;
+}
+
+// Create the entities, then each round replace a tenth of them and look up random live entities
+// and entities destroyed in that round
+template <class TEntities>
+STimes TimeEntities( TUInt32 numEntities )
+{
+	STimes times = { 0.0, 0.0, 0.0 };
+	TEntities entities;
+	vector<TUInt32> live( numEntities ), stale;
+	for (TUInt32 entity = 0; entity < numEntities; ++entity)
+	{
+		live[entity] = entities.Create();
+	}
+
+	mt19937 random( numEntities );
+	vector<TUInt32> replaced( numEntities / 10 ), lookUps( numEntities * kLookUpsPerEntity );
+	TUInt32 sum = 0, numFound = 0, numStaleFound = 0;
+	for (TUInt32 round = 0; round < kNumRounds; ++round)
+	{
+		for (size_t i = 0; i < replaced.size(); ++i)
+		{
+			replaced[i] = random() % numEntities;
+		}
+		for (size_t i = 0; i < lookUps.size(); ++i)
+		{
+			lookUps[i] = random() % numEntities;
+		}
+
+		stale.clear();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (size_t i = 0; i < replaced.size(); ++i)
+		{
+			stale.push_back( live[replaced[i]] );
+			entities.Destroy( live[replaced[i]] );
+			live[replaced[i]] = entities.Create();
+		}
+		times.churn += NanosecondsSince( start, replaced.size() );
+
+		start = chrono::steady_clock::now();
+		for (size_t i = 0; i < lookUps.size(); ++i)
+		{
+			const SEntity* entity = entities.Get( live[lookUps[i]] );
+			numFound += entity != 0;
+			sum += entity->data;
+		}
+		times.lookUp += NanosecondsSince( start, lookUps.size() );
+
+		start = chrono::steady_clock::now();
+		for (size_t i = 0; i < lookUps.size(); ++i)
+		{
+			numStaleFound += entities.Get( stale[lookUps[i] % stale.size()] ) != 0;
+		}
+		times.stale += NanosecondsSince( start, lookUps.size() );
+	}
+	TEST_CHECK( numFound == kNumRounds * lookUps.size() && numStaleFound == 0 );
+	TEST_CHECK( sum != 1 ); // Keep the look-ups
+
+	times.churn /= kNumRounds;
+	times.lookUp /= kNumRounds;
+	times.stale /= kNumRounds;
+	return times;
+}
+
+void Report( const char* name, const STimes& times )
+{
+	printf( "    %-16s churn %7.1f ns  look-up %7.1f ns  stale %7.1f ns\n", name, times.churn, times.lookUp, times.stale );
+}
+
+void RunSize( TUInt32 numEntities )
+{
+	printf( "  %u entities, a tenth replaced each of %u rounds\n", numEntities, kNumRounds );
+	Report( "CHandleTable", TimeEntities<CHandleEntities>( numEntities ) );
+	Report( "CFlatHashTable", TimeEntities<CHashedEntities>( numEntities ) );
+}
+
+} // namespace
+
+
+int main()
+{
+	RunSize( 10000 );
+	RunSize( 100000 );
+	RunSize( 1000000 );
+	return TestResult( "BenchHandleLookUp" );
+}
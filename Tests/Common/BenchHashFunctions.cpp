@@ -0,0 +1,123 @@
+/*******************************************
+	BenchHashFunctions.cpp
+
+	Look-up throughput with the hash traits
+	against hashing keys byte by byte through
+	JOneAtATimeHash, and the block hash against
+	it on long keys
+********************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include "CFlatHashTable.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32 kNumLookUps = 1 << 22;
+
+typedef CByteHashTraits<TUInt32, JOneAtATimeHash> TByteTraits;
+
+TFloat64 NanosecondsSince( chrono::steady_clock::time_point start, TUInt32 numOperations )
+{
+	chrono::duration<TFloat64> seconds = chrono::steady_clock::now() - start;
+	return seconds.count() * 1e9 / numOperations;
+}
+
+// Look up keys that are all present, in the order given. Keys are consecutive like entity UIDs
+template <class TTable>
+TFloat64 TimeLookUps( TUInt32 numKeys, const vector<TUInt32>& order )
+{
+	TTable table( 1024 );
+	for (TUInt32 key = 0; key < numKeys; ++key)
+	{
+		table.SetKeyValue( key, key );
+	}
+
+	TUInt32 sum = 0, value = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (size_t i = 0; i < order.size(); ++i)
+	{
+		table.LookUpKey( order[i], &value );
+		sum += value;
+	}
+	TFloat64 time = NanosecondsSince( start, static_cast<TUInt32>(order.size()) );
+	TEST_CHECK( sum != 1 ); // Keep the look-ups
+	return time;
+}
+
+void UIDLookUps( TUInt32 numKeys )
+{
+	mt19937 random( numKeys );
+	vector<TUInt32> sequential( kNumLookUps ), shuffled( kNumLookUps );
+	for (TUInt32 i = 0; i < kNumLookUps; ++i)
+	{
+		sequential[i] = i % numKeys;
+		shuffled[i] = random() % numKeys;
+	}
+
+	printf( "  %u UID keys, %u look-ups (ns per look-up, sequential / random order)\n", numKeys, kNumLookUps );
+	printf( "    %-16s JOneAtATimeHash %6.1f / %6.1f   MixHash %6.1f / %6.1f\n", "CHashTable",
+	        TimeLookUps< CHashTable<TUInt32, TUInt32, TByteTraits> >( numKeys, sequential ),
+	        TimeLookUps< CHashTable<TUInt32, TUInt32, TByteTraits> >( numKeys, shuffled ),
+	        TimeLookUps< CHashTable<TUInt32, TUInt32> >( numKeys, sequential ),
+	        TimeLookUps< CHashTable<TUInt32, TUInt32> >( numKeys, shuffled ) );
+	printf( "    %-16s JOneAtATimeHash %6.1f / %6.1f   MixHash %6.1f / %6.1f\n", "CFlatHashTable",
+	        TimeLookUps< CFlatHashTable<TUInt32, TUInt32, TByteTraits> >( numKeys, sequential ),
+	        TimeLookUps< CFlatHashTable<TUInt32, TUInt32, TByteTraits> >( numKeys, shuffled ),
+	        TimeLookUps< CFlatHashTable<TUInt32, TUInt32> >( numKeys, sequential ),
+	        TimeLookUps< CFlatHashTable<TUInt32, TUInt32> >( numKeys, shuffled ) );
+}
+
+// Bytes hashed per nanosecond for keys of the given length
+TFloat64 HashThroughput( THashFunction pfHash, const vector<TUInt8>& data, TUInt32 keyLength )
+{
+	TUInt32 numKeys = static_cast<TUInt32>(data.size()) / keyLength;
+	TUInt32 sum = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 pass = 0; pass < 8; ++pass)
+	{
+		for (TUInt32 key = 0; key < numKeys; ++key)
+		{
+			sum += pfHash( &data[key * keyLength], keyLength );
+		}
+	}
+	TFloat64 nanoseconds = NanosecondsSince( start, 1 );
+	TEST_CHECK( sum != 1 );
+	return 8.0 * numKeys * keyLength / nanoseconds;
+}
+
+void LongKeys()
+{
+	vector<TUInt8> data( 1 << 20 );
+	mt19937 random( 1 );
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		data[i] = static_cast<TUInt8>(random());
+	}
+
+	printf( "  Long keys (bytes hashed per ns)\n" );
+	const TUInt32 keyLengths[] = { 16, 32, 64, 256, 4096 };
+	for (TUInt32 i = 0; i < sizeof(keyLengths) / sizeof(keyLengths[0]); ++i)
+	{
+		printf( "    %4u bytes      JOneAtATimeHash %6.2f          BlockHash %6.2f\n", keyLengths[i],
+		        HashThroughput( JOneAtATimeHash, data, keyLengths[i] ),
+		        HashThroughput( BlockHash, data, keyLengths[i] ) );
+	}
+}
+
+} // namespace
+
+
+int main()
+{
+	UIDLookUps( 1000 );
+	UIDLookUps( 100000 );
+	UIDLookUps( 1000000 );
+	LongKeys();
+	return TestResult( "BenchHashFunctions" );
+}
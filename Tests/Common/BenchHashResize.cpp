@@ -0,0 +1,64 @@
+/*******************************************
+	BenchHashResize.cpp
+
+	Insert latency distribution of the hash
+	tables, resizing in one go against resizing
+	incrementally
+********************************************/
+
+#include <algorithm>
+#include <chrono>
+#include "CFlatHashTable.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32 kNumKeys = 4 << 20;
+
+// Time below which the given fraction of the sorted times fall
+TFloat32 Percentile( const vector<TFloat32>& times, TFloat64 fraction )
+{
+	return times[static_cast<size_t>(fraction * (times.size() - 1))];
+}
+
+// Time every insert of kNumKeys keys into a table that starts small, and report the distribution
+template <class TTable>
+void InsertLatency( const char* name, TUInt32 resizeStep )
+{
+	TTable table( 16, 0.7f, resizeStep );
+	vector<TFloat32> times( kNumKeys );
+	for (TUInt32 key = 0; key < kNumKeys; ++key)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		table.SetKeyValue( key * 2654435761u, key );
+		chrono::duration<TFloat32, nano> nanoseconds = chrono::steady_clock::now() - start;
+		times[key] = nanoseconds.count();
+	}
+
+	TFloat64 total = 0.0;
+	for (TUInt32 key = 0; key < kNumKeys; ++key)
+	{
+		total += times[key];
+	}
+	sort( times.begin(), times.end() );
+	printf( "    %-16s step %u  mean %6.0f  p99 %6.0f  p99.9 %7.0f  p99.99 %9.0f  max %10.0f ns  max moves %u\n",
+	        name, resizeStep, total / kNumKeys, Percentile( times, 0.99 ), Percentile( times, 0.999 ),
+	        Percentile( times, 0.9999 ), times.back(), table.GetMaxResizeMoves() );
+	TEST_CHECK( resizeStep == 0 || table.GetMaxResizeMoves() <= 64 );
+}
+
+} // namespace
+
+
+int main()
+{
+	printf( "  Inserting %u keys\n", kNumKeys );
+	InsertLatency< CHashTable<TUInt32, TUInt32> >( "CHashTable", 0 );
+	InsertLatency< CHashTable<TUInt32, TUInt32> >( "CHashTable", 8 );
+	InsertLatency< CFlatHashTable<TUInt32, TUInt32> >( "CFlatHashTable", 0 );
+	InsertLatency< CFlatHashTable<TUInt32, TUInt32> >( "CFlatHashTable", 8 );
+	return TestResult( "BenchHashResize" );
+}
@@ -0,0 +1,111 @@
+/*******************************************
+	BenchHashTables.cpp
+
+	The list bucket CHashTable against the open
+	addressing CFlatHashTable, inserting and
+	looking up 1k, 100k and 10M keys
+********************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include "CFlatHashTable.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32 kNumLookUps = 1 << 22;
+
+// Times in nanoseconds per operation
+struct STimes
+{
+	TFloat64 insert;
+	TFloat64 hit;
+	TFloat64 miss;
+};
+
+TFloat64 NanosecondsSince( chrono::steady_clock::time_point start, TUInt32 numOperations )
+{
+	chrono::duration<TFloat64> seconds = chrono::steady_clock::now() - start;
+	return seconds.count() * 1e9 / numOperations;
+}
+
+// Insert the keys into a table that starts small, as the entity map does, then look up present keys
+// and absent keys in random order
+template <class TTable>
+STimes TimeTable( const vector<TUInt32>& keys, const vector<TUInt32>& hitOrder,
+                  const vector<TUInt32>& missOrder )
+{
+	STimes times;
+	TTable table( 1024 );
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (size_t key = 0; key < keys.size(); ++key)
+	{
+		table.SetKeyValue( keys[key], static_cast<TUInt32>(key) );
+	}
+	times.insert = NanosecondsSince( start, static_cast<TUInt32>(keys.size()) );
+
+	TUInt32 sum = 0, value = 0, numFound = 0;
+	start = chrono::steady_clock::now();
+	for (size_t i = 0; i < hitOrder.size(); ++i)
+	{
+		numFound += table.LookUpKey( keys[hitOrder[i]], &value );
+		sum += value;
+	}
+	times.hit = NanosecondsSince( start, static_cast<TUInt32>(hitOrder.size()) );
+	TEST_CHECK( numFound == hitOrder.size() );
+
+	numFound = 0;
+	start = chrono::steady_clock::now();
+	for (size_t i = 0; i < missOrder.size(); ++i)
+	{
+		numFound += table.LookUpKey( missOrder[i], &value );
+	}
+	times.miss = NanosecondsSince( start, static_cast<TUInt32>(missOrder.size()) );
+	TEST_CHECK( numFound == 0 );
+	TEST_CHECK( sum != 1 ); // Keep the look-ups
+	return times;
+}
+
+void Report( const char* name, const STimes& times )
+{
+	printf( "    %-16s insert %7.1f ns  hit %7.1f ns  miss %7.1f ns\n", name, times.insert, times.hit, times.miss );
+}
+
+void RunSize( TUInt32 numKeys )
+{
+	// Distinct random keys - even keys are inserted, odd keys are the misses
+	mt19937 random( numKeys );
+	vector<TUInt32> keys( numKeys );
+	for (TUInt32 key = 0; key < numKeys; ++key)
+	{
+		keys[key] = key * 2;
+	}
+	shuffle( keys.begin(), keys.end(), random );
+
+	vector<TUInt32> hitOrder( kNumLookUps ), missOrder( kNumLookUps );
+	for (TUInt32 i = 0; i < kNumLookUps; ++i)
+	{
+		hitOrder[i] = random() % numKeys;
+		missOrder[i] = (random() % numKeys) * 2 + 1;
+	}
+
+	printf( "  %u keys, %u look-ups each\n", numKeys, kNumLookUps );
+	Report( "CHashTable", TimeTable< CHashTable<TUInt32, TUInt32> >( keys, hitOrder, missOrder ) );
+	Report( "CFlatHashTable", TimeTable< CFlatHashTable<TUInt32, TUInt32> >( keys, hitOrder, missOrder ) );
+}
+
+} // namespace
+
+
+int main()
+{
+	RunSize( 1000 );
+	RunSize( 100000 );
+	RunSize( 10000000 );
+	return TestResult( "BenchHashTables" );
+}
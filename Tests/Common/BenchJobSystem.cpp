@@ -0,0 +1,106 @@
+/*******************************************
+	BenchJobSystem.cpp
+
+	Independent entity updates spread across
+	1 to 16 threads, in jobs of 256 entities as
+	the entity manager runs them. Results must
+	be the same for every thread count
+********************************************/
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include "CJobSystem.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32  kNumEntities = 100000;
+const TUInt32  kNumUpdates = 30;
+const TUInt32  kGrainSize = 256;
+const TFloat32 kUpdateTime = 1.0f / 60.0f;
+
+// Stand-in for an entity with floating clutter movement, the work CEntity::UpdateIndependent does
+struct SEntity
+{
+	TFloat32 matrix[16];
+	TFloat32 floatingCounter;
+	char     otherState[900];
+};
+
+vector<SEntity*> Entities;
+vector<TUInt8>   NeedsResolve;
+
+void UpdateEntities( TUInt32 begin, TUInt32 end )
+{
+	for (TUInt32 i = begin; i < end; ++i)
+	{
+		SEntity& entity = *Entities[i];
+		entity.floatingCounter += kUpdateTime * 100;
+		entity.matrix[13] += sin( entity.floatingCounter );
+		NeedsResolve[i] = entity.matrix[13] < -500.0f;
+	}
+}
+
+// Time per update with the given number of threads, and the sum of the positions after it
+TFloat64 MicrosecondsPerUpdate( TUInt32 numThreads, TFloat32* positionSum )
+{
+	for (TUInt32 i = 0; i < kNumEntities; ++i)
+	{
+		Entities[i]->floatingCounter = i * 0.01f;
+		Entities[i]->matrix[13] = 0.0f;
+	}
+
+	CJobSystem jobs( numThreads );
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 update = 0; update < kNumUpdates; ++update)
+	{
+		jobs.ParallelFor( kNumEntities, kGrainSize, UpdateEntities );
+	}
+	chrono::duration<TFloat64, micro> microseconds = chrono::steady_clock::now() - start;
+
+	*positionSum = 0.0f;
+	for (TUInt32 i = 0; i < kNumEntities; ++i)
+	{
+		*positionSum += Entities[i]->matrix[13];
+	}
+	return microseconds.count() / kNumUpdates;
+}
+
+} // namespace
+
+
+int main()
+{
+	for (TUInt32 i = 0; i < kNumEntities; ++i)
+	{
+		Entities.push_back( new SEntity() );
+	}
+	NeedsResolve.resize( kNumEntities );
+
+	printf( "  %u entities, %u hardware threads\n", kNumEntities, thread::hardware_concurrency() );
+	const TUInt32 threadCounts[] = { 1, 2, 4, 8, 16 };
+	TFloat64 oneThreadTime = 0.0;
+	TFloat32 oneThreadSum = 0.0f;
+	for (TUInt32 i = 0; i < 5; ++i)
+	{
+		TFloat32 sum;
+		TFloat64 time = MicrosecondsPerUpdate( threadCounts[i], &sum );
+		if (i == 0)
+		{
+			oneThreadTime = time;
+			oneThreadSum = sum;
+		}
+		TEST_CHECK( sum == oneThreadSum );
+		printf( "    %2u threads %8.0f us/update  speed-up %.2fx\n", threadCounts[i], time, oneThreadTime / time );
+	}
+
+	for (TUInt32 i = 0; i < kNumEntities; ++i)
+	{
+		delete Entities[i];
+	}
+	return TestResult( "BenchJobSystem" );
+}
@@ -0,0 +1,125 @@
+/*******************************************
+	BenchParticleSystem.cpp
+
+	A million particles updated serially and
+	across 1 to 4 job threads, and their
+	instance data written for drawing. The
+	particles must end up the same for every
+	thread count
+********************************************/
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include "CParticleSystem.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32  kNumEmitters = 256;
+const TUInt32  kParticlesPerEmitter = 4096;
+const TUInt32  kNumUpdates = 50;
+const TFloat32 kUpdateTime = 1.0f / 60.0f;
+
+// Every emitter bursts to its full particle count and the particles outlive the benchmark
+SParticleEmitterDesc LongLivedBurst()
+{
+	SParticleEmitterDesc desc;
+	memset( &desc, 0, sizeof(desc) );
+	desc.fVelY = 100.0f;
+	desc.fVelSpread = 50.0f;
+	desc.fGravity = 200.0f;
+	desc.fLifetime = 1000.0f;
+	desc.iBurst = kParticlesPerEmitter;
+	const TFloat32 startColour[4] = { 1.0f, 0.0f, 0.0f, 1.0f }, endColour[4] = { 0.5f, 0.0f, 0.0f, 0.0f };
+	memcpy( desc.afStartColour, startColour, sizeof(startColour) );
+	memcpy( desc.afEndColour, endColour, sizeof(endColour) );
+	desc.fStartSize = 2.0f;
+	desc.fEndSize = 6.0f;
+	return desc;
+}
+
+vector<SParticleInstance> Instances( kParticlesPerEmitter );
+
+// Sum of the particle heights, written as instances
+TFloat64 HeightSum( const CParticleSystem& particles )
+{
+	TFloat64 sum = 0.0;
+	for (TUInt32 emitter = 0; emitter < kNumEmitters; ++emitter)
+	{
+		TUInt32 numParticles = particles.WriteInstances( emitter, &Instances[0] );
+		for (TUInt32 i = 0; i < numParticles; ++i)
+		{
+			sum += Instances[i].fY;
+		}
+	}
+	return sum;
+}
+
+// Time per update with the given number of job threads, or with no job system for 0
+TFloat64 MillisecondsPerUpdate( TUInt32 numThreads, TFloat64* heightSum )
+{
+	CParticleSystem particles( kNumEmitters, kParticlesPerEmitter );
+	for (TUInt32 emitter = 0; emitter < kNumEmitters; ++emitter)
+	{
+		particles.StartEmitter( LongLivedBurst() );
+	}
+	TEST_CHECK( particles.GetTotalParticles() == kNumEmitters * kParticlesPerEmitter );
+
+	CJobSystem* jobs = numThreads > 0 ? new CJobSystem( numThreads ) : 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 update = 0; update < kNumUpdates; ++update)
+	{
+		particles.Update( kUpdateTime, jobs );
+	}
+	chrono::duration<TFloat64, milli> milliseconds = chrono::steady_clock::now() - start;
+	delete jobs;
+
+	*heightSum = HeightSum( particles );
+	return milliseconds.count() / kNumUpdates;
+}
+
+// Time to write the instance data of every emitter, as the particle renderer does each frame
+TFloat64 MillisecondsPerWrite()
+{
+	CParticleSystem particles( kNumEmitters, kParticlesPerEmitter );
+	for (TUInt32 emitter = 0; emitter < kNumEmitters; ++emitter)
+	{
+		particles.StartEmitter( LongLivedBurst() );
+	}
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 update = 0; update < kNumUpdates; ++update)
+	{
+		for (TUInt32 emitter = 0; emitter < kNumEmitters; ++emitter)
+		{
+			particles.WriteInstances( emitter, &Instances[0] );
+		}
+	}
+	chrono::duration<TFloat64, milli> milliseconds = chrono::steady_clock::now() - start;
+	return milliseconds.count() / kNumUpdates;
+}
+
+} // namespace
+
+
+int main()
+{
+	printf( "  %u particles, %u hardware threads\n", kNumEmitters * kParticlesPerEmitter,
+	        thread::hardware_concurrency() );
+	TFloat64 serialSum;
+	TFloat64 serialTime = MillisecondsPerUpdate( 0, &serialSum );
+	printf( "    serial     %6.2f ms/update\n", serialTime );
+	const TUInt32 threadCounts[] = { 1, 2, 4 };
+	for (TUInt32 i = 0; i < 3; ++i)
+	{
+		TFloat64 sum;
+		TFloat64 time = MillisecondsPerUpdate( threadCounts[i], &sum );
+		TEST_CHECK( sum == serialSum );
+		printf( "    %u threads  %6.2f ms/update  speed-up %.2fx\n", threadCounts[i], time, serialTime / time );
+	}
+	printf( "    write instances %6.2f ms/frame\n", MillisecondsPerWrite() );
+	return TestResult( "BenchParticleSystem" );
+}
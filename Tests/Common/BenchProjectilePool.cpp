@@ -0,0 +1,125 @@
+/*******************************************
+	BenchProjectilePool.cpp
+
+	A projectile update as the entity manager
+	runs it - respawn, move, test the boxes
+	against the players' hurtboxes and remove
+	the projectiles that hit - for numbers of
+	projectiles in flight
+********************************************/
+
+#include <chrono>
+#include <random>
+#include "CProjectilePool.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32  kNumTicks = 20000;
+const TUInt32  kMaxProjectiles = 512;
+const TUInt32  kMaxOverlaps = 256;
+const TFloat32 kUpdateTime = 1.0f / 60.0f;
+
+const TFloat32 kKnifeHalfWidth = 8.0f, kKnifeHalfHeight = 3.0f;
+
+// Players stand 300 units apart with the 60 unit square used for a frame without hurtboxes
+struct SHurtBox
+{
+	TUInt32  owner;
+	TFloat32 minX, minY, maxX, maxY;
+};
+const SHurtBox kHurtBoxes[2] = { { 0, -30.0f, -30.0f, 30.0f, 30.0f }, { 1, 270.0f, -30.0f, 330.0f, 30.0f } };
+
+// Number of projectiles overlapping or touching a hurtbox of the other player, by testing every pair
+TUInt32 NumHitting( const CProjectilePool& pool )
+{
+	const TFloat32* posX = pool.GetPosX();
+	const TFloat32* posY = pool.GetPosY();
+	const TUInt32* owner = pool.GetOwner();
+	TUInt32 numHitting = 0;
+	for (TUInt32 projectile = 0; projectile < pool.GetNumProjectiles(); ++projectile)
+	{
+		for (TUInt32 hurtBox = 0; hurtBox < 2; ++hurtBox)
+		{
+			const SHurtBox& box = kHurtBoxes[hurtBox];
+			if (owner[projectile] != box.owner &&
+			    posX[projectile] - kKnifeHalfWidth <= box.maxX && posX[projectile] + kKnifeHalfWidth >= box.minX &&
+			    posY[projectile] - kKnifeHalfHeight <= box.maxY && posY[projectile] + kKnifeHalfHeight >= box.minY)
+			{
+				++numHitting;
+				break;
+			}
+		}
+	}
+	return numHitting;
+}
+
+// Knives thrown from across the stage in both directions, topped up to the given number each tick
+void RunSize( TUInt32 numProjectiles )
+{
+	mt19937 random( 3 );
+	uniform_real_distribution<TFloat32> x( -1000.0f, 1000.0f ), y( -100.0f, 100.0f );
+	CProjectilePool pool( kMaxProjectiles );
+	CBoxSet projectileBoxes, hurtBoxes;
+	SBoxOverlap overlaps[kMaxOverlaps];
+	TUInt32 hitProjectiles[kMaxOverlaps];
+
+	TUInt32 numHits = 0, numWrong = 0;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 tick = 0; tick < kNumTicks; ++tick)
+	{
+		while (pool.GetNumProjectiles() < numProjectiles)
+		{
+			bool isRight = (random() & 1) != 0;
+			SProjectileDesc knife = { static_cast<TUInt32>(random() & 1), 0, x( random ), y( random ), 0.0f, isRight ? 5.0f : -5.0f, 0.0f,
+			                          kKnifeHalfWidth, kKnifeHalfHeight, 4.0f, 65, 0, 0 };
+			pool.Spawn( knife );
+		}
+		pool.Update( kUpdateTime );
+
+		hurtBoxes.Clear();
+		for (TUInt32 hurtBox = 0; hurtBox < 2; ++hurtBox)
+		{
+			const SHurtBox& box = kHurtBoxes[hurtBox];
+			hurtBoxes.Add( box.owner, box.minX, box.minY, box.maxX, box.maxY );
+		}
+		projectileBoxes.Clear();
+		pool.AddBoxes( projectileBoxes );
+		TUInt32 numOverlaps = projectileBoxes.FindOverlaps( hurtBoxes, overlaps, kMaxOverlaps );
+
+		// As CEntityManager::UpdateProjectiles, a projectile overlapping several hurtboxes hits once
+		TUInt32 numHit = 0;
+		for (TUInt32 overlap = 0; overlap < numOverlaps; ++overlap)
+		{
+			if (numHit == 0 || hitProjectiles[numHit - 1] != overlaps[overlap].iBox)
+			{
+				hitProjectiles[numHit++] = overlaps[overlap].iBox;
+			}
+		}
+		if (tick % 1000 == 0)
+		{
+			numWrong += numHit != NumHitting( pool );
+		}
+		pool.Remove( hitProjectiles, numHit );
+		numHits += numHit;
+	}
+	chrono::duration<TFloat64, micro> microseconds = chrono::steady_clock::now() - start;
+	TEST_CHECK( numWrong == 0 && numHits > 0 );
+
+	printf( "  %4u projectiles  %6.2f us/tick  (%.2f hits/tick)\n", numProjectiles,
+	        microseconds.count() / kNumTicks, static_cast<TFloat64>(numHits) / kNumTicks );
+}
+
+} // namespace
+
+
+int main()
+{
+	RunSize( 2 );
+	RunSize( 100 );
+	RunSize( 500 );
+	return TestResult( "BenchProjectilePool" );
+}
@@ -0,0 +1,196 @@
+/*******************************************
+	BenchRadixSort.cpp
+
+	Depth sort of the alpha blended bucket: the
+	radix sort against the selection sort it
+	replaced, and with the insertion sort for
+	frames where little has moved
+********************************************/
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include "CRadixSort.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32 kNumFrames = 50;
+
+struct SSprite
+{
+	TFloat32 x, y, z;
+	TFloat32 depth; // Only used by the selection sort
+};
+
+TFloat32 DistanceSquared( const SSprite& sprite )
+{
+	return sprite.x * sprite.x + sprite.y * sprite.y + sprite.z * sprite.z;
+}
+
+TFloat64 MicrosecondsSince( chrono::steady_clock::time_point start )
+{
+	chrono::duration<TFloat64, micro> microseconds = chrono::steady_clock::now() - start;
+	return microseconds.count();
+}
+
+// Whether the order is furthest first
+bool IsSorted( const vector<SSprite>& sprites, const vector<TUInt32>& order )
+{
+	for (TUInt32 i = 1; i < order.size(); ++i)
+	{
+		if (DistanceSquared( sprites[order[i - 1]] ) < DistanceSquared( sprites[order[i]] ))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// The sort that was in CEntityManager: repeatedly find the furthest of the unsorted sprites and
+// move it to the end, erasing it from the middle of the list
+TFloat64 SelectionSort( vector<SSprite>& sprites, vector<TUInt32> order )
+{
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 i = 0; i < sprites.size(); ++i)
+	{
+		sprites[i].depth = sqrt( DistanceSquared( sprites[i] ) );
+	}
+	TUInt32 numSorted = 0;
+	do
+	{
+		TUInt32 furthest = 0;
+		TFloat32 maxDepth = 0.0f;
+		for (TUInt32 i = 0; i < order.size() - numSorted; ++i)
+		{
+			if (sprites[order[i]].depth > maxDepth)
+			{
+				maxDepth = sprites[order[i]].depth;
+				furthest = i;
+			}
+		}
+		order.push_back( order[furthest] );
+		order.erase( order.begin() + furthest );
+		++numSorted;
+	} while (numSorted != order.size());
+	TFloat64 time = MicrosecondsSince( start );
+
+	// Checked on the depths it sorted by, square roots of nearly equal distances can be equal
+	TUInt32 numOutOfOrder = 0;
+	for (TUInt32 i = 1; i < order.size(); ++i)
+	{
+		numOutOfOrder += sprites[order[i - 1]].depth < sprites[order[i]].depth;
+	}
+	TEST_CHECK( numOutOfOrder == 0 );
+	return time;
+}
+
+// A frame of SortEntitiesByDepth - build the keys, sort and reorder the list. Uses only the
+// radix sort or lets the sorter choose
+TFloat64 SortFrame( CRadixSort& sorter, const vector<SSprite>& sprites, vector<TUInt32>& order,
+                    bool onlyRadix )
+{
+	vector<SSortKey> keys( order.size() );
+	vector<TUInt32> sorted( order.size() );
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 i = 0; i < order.size(); ++i)
+	{
+		keys[i].iIndex = i;
+		keys[i].iKey = ~FloatToSortKey( DistanceSquared( sprites[order[i]] ) ); // Furthest first
+	}
+	if (onlyRadix)
+	{
+		sorter.RadixSort( keys );
+	}
+	else
+	{
+		sorter.Sort( keys );
+	}
+	for (TUInt32 i = 0; i < order.size(); ++i)
+	{
+		sorted[i] = order[keys[i].iIndex];
+	}
+	order.swap( sorted );
+	return MicrosecondsSince( start );
+}
+
+void RunSize( TUInt32 numSprites )
+{
+	mt19937 random( 1 );
+	uniform_real_distribution<TFloat32> position( -500.0f, 500.0f );
+	normal_distribution<TFloat32> jitter( 0.0f, 0.5f );
+	vector<SSprite> sprites( numSprites );
+	vector<TUInt32> order( numSprites );
+	for (TUInt32 i = 0; i < numSprites; ++i)
+	{
+		sprites[i].x = position( random );
+		sprites[i].y = position( random );
+		sprites[i].z = position( random );
+		order[i] = i;
+	}
+
+	// The selection sort would take seconds above 10k sprites
+	TFloat64 selectionTime = numSprites <= 10000 ? SelectionSort( sprites, order ) : -1.0;
+
+	CRadixSort sorter;
+	SortFrame( sorter, sprites, order, true );
+	TEST_CHECK( IsSorted( sprites, order ) );
+
+	// Every sprite moving a little each frame, sorted by radix only then letting the sorter choose
+	TFloat64 radixTime = 0.0, allMovingTime = 0.0, fewMovingTime = 0.0;
+	for (TUInt32 frame = 0; frame < kNumFrames; ++frame)
+	{
+		for (TUInt32 i = 0; i < numSprites; ++i)
+		{
+			sprites[i].x += jitter( random );
+			sprites[i].y += jitter( random );
+		}
+		radixTime += SortFrame( sorter, sprites, order, true );
+	}
+	for (TUInt32 frame = 0; frame < kNumFrames; ++frame)
+	{
+		for (TUInt32 i = 0; i < numSprites; ++i)
+		{
+			sprites[i].x += jitter( random );
+			sprites[i].y += jitter( random );
+		}
+		allMovingTime += SortFrame( sorter, sprites, order, false );
+	}
+	TEST_CHECK( IsSorted( sprites, order ) );
+
+	// 1% of the sprites moving further each frame
+	uniform_int_distribution<TUInt32> pick( 0, numSprites - 1 );
+	for (TUInt32 frame = 0; frame < kNumFrames; ++frame)
+	{
+		for (TUInt32 i = 0; i < numSprites / 100; ++i)
+		{
+			sprites[pick( random )].x += jitter( random ) * 20.0f;
+		}
+		fewMovingTime += SortFrame( sorter, sprites, order, false );
+	}
+	TEST_CHECK( IsSorted( sprites, order ) );
+
+	char selection[32] = "skipped";
+	if (selectionTime >= 0.0)
+	{
+		sprintf( selection, "%.0f us", selectionTime );
+	}
+	printf( "  %6u sprites  selection %10s  radix %7.1f us/frame  all moving %7.1f us/frame  "
+	        "1%% moving %7.1f us/frame  (%u insertion, %u radix)\n",
+	        numSprites, selection, radixTime / kNumFrames, allMovingTime / kNumFrames,
+	        fewMovingTime / kNumFrames, sorter.GetNumInsertionSorts(), sorter.GetNumRadixSorts() );
+}
+
+} // namespace
+
+
+int main()
+{
+	RunSize( 1000 );
+	RunSize( 10000 );
+	RunSize( 100000 );
+	return TestResult( "BenchRadixSort" );
+}
@@ -0,0 +1,283 @@
+/*******************************************
+	TestHandleList.cpp
+
+	Tests of the handle lists used for entity
+	queries and render buckets - compaction,
+	readers and the bound on freed entries
+********************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include "CHandleTable.h"
+#include "CHandleList.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+typedef CHandleTable<bool> TTable;
+
+// The valid handles in the list, in list order
+template <class TTableType>
+vector<TUInt32> ValidHandles( const TTableType& table, const CHandleList& list )
+{
+	vector<TUInt32> handles;
+	for (TUInt32 pos = 0; pos < list.GetSize(); ++pos)
+	{
+		if (table.IsValid( list[pos] ))
+		{
+			handles.push_back( list[pos] );
+		}
+	}
+	return handles;
+}
+
+// Objects in a bucket for each kind of thing they use, as entities are in a render bucket for each
+// render method of their mesh. The slot data is a bit per bucket holding the object, removals are
+// noted in the buckets and the buckets compacted later, as CEntityManager does
+const TUInt32 kNumBuckets = 4;
+struct SBuckets
+{
+	CHandleTable<TUInt32> table;
+	CHandleList           buckets[kNumBuckets];
+	vector<CHandleList*>  withRemovals;
+	vector<TUInt32>       live; // In creation order
+
+	TUInt32 Add( TUInt32 bucketBits )
+	{
+		TUInt32 handle = table.New( 0 );
+		table.Data( handle ) = bucketBits;
+		for (TUInt32 bucket = 0; bucket < kNumBuckets; ++bucket)
+		{
+			if (bucketBits & (1 << bucket))
+			{
+				buckets[bucket].Add( handle );
+			}
+		}
+		live.push_back( handle );
+		return handle;
+	}
+
+	void Remove( TUInt32 position )
+	{
+		TUInt32 handle = live[position];
+		for (TUInt32 bucket = 0; bucket < kNumBuckets; ++bucket)
+		{
+			if ((table.Data( handle ) & (1 << bucket)) && buckets[bucket].NoteRemoval())
+			{
+				withRemovals.push_back( &buckets[bucket] );
+			}
+		}
+		table.Free( handle );
+		live.erase( live.begin() + position );
+	}
+
+	void Flush( bool onlyMostlyRemoved )
+	{
+		TUInt32 numLeft = 0;
+		for (TUInt32 list = 0; list < withRemovals.size(); ++list)
+		{
+			if ((onlyMostlyRemoved && !withRemovals[list]->IsMostlyRemoved()) ||
+			    !withRemovals[list]->Compact( table ))
+			{
+				withRemovals[numLeft++] = withRemovals[list];
+			}
+		}
+		withRemovals.resize( numLeft );
+	}
+
+	// Each bucket holds every live object using it once, in creation order, and nothing else live.
+	// Its stale entries are exactly the removals noted, and it is waiting for compaction if there
+	// are any
+	bool IsConsistent() const
+	{
+		for (TUInt32 bucket = 0; bucket < kNumBuckets; ++bucket)
+		{
+			vector<TUInt32> expected;
+			for (TUInt32 i = 0; i < live.size(); ++i)
+			{
+				if (table.Data( live[i] ) & (1 << bucket))
+				{
+					expected.push_back( live[i] );
+				}
+			}
+			const CHandleList& list = buckets[bucket];
+			bool waiting = find( withRemovals.begin(), withRemovals.end(), &list ) != withRemovals.end();
+			if (ValidHandles( table, list ) != expected ||
+			    list.GetSize() - expected.size() != list.GetNumRemoved() ||
+			    waiting != (list.GetNumRemoved() > 0))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+
+/*-----------------------------------------------------------------------------------------
+	Tests
+-----------------------------------------------------------------------------------------*/
+
+// Compaction takes out the freed handles only, keeping the order of the rest
+void CompactKeepsOrder()
+{
+	TTable table;
+	CHandleList list;
+	for (TUInt32 object = 0; object < 10; ++object)
+	{
+		list.Add( table.New( object ) );
+	}
+	const TUInt32 freed[] = { 0, 4, 5, 9 };
+	for (TUInt32 i = 0; i < 4; ++i)
+	{
+		table.Free( freed[i] );
+		TEST_CHECK( list.NoteRemoval() == (i == 0) ); // Only the first needs the list tracking
+	}
+	TEST_CHECK( list.GetSize() == 10 && list.GetNumRemoved() == 4 && !list.IsMostlyRemoved() );
+
+	vector<TUInt32> expected = ValidHandles( table, list );
+	TEST_CHECK( list.Compact( table ) );
+	TEST_CHECK( list.GetSize() == 6 && list.GetNumRemoved() == 0 );
+	TEST_CHECK( ValidHandles( table, list ) == expected && list.Handles() == expected );
+	TEST_CHECK( list.NoteRemoval() ); // First removal again after compaction
+}
+
+// A list is not compacted while a reader is stepping through it, so the reader's position still
+// points at the same entry
+void ReadersPutOffCompaction()
+{
+	TTable table;
+	CHandleList list;
+	for (TUInt32 object = 0; object < 4; ++object)
+	{
+		list.Add( table.New( object ) );
+	}
+
+	list.OpenReader();
+	list.OpenReader();
+	TUInt32 readerPos = 2;
+	table.Free( list[0] );
+	list.NoteRemoval();
+	TEST_CHECK( list.HasReaders() && !list.Compact( table ) );
+	TEST_CHECK( list.GetSize() == 4 && list[readerPos] == 2 );
+
+	list.CloseReader();
+	TEST_CHECK( !list.Compact( table ) );
+	list.CloseReader();
+	TEST_CHECK( !list.HasReaders() && list.Compact( table ) );
+	TEST_CHECK( list.GetSize() == 3 && list[0] == 1 );
+}
+
+// Objects destroyed and created with no update in between, compacting only when a list is mostly
+// freed handles as CEntityManager does outside its update - the list never gets more than twice
+// the size of the live objects plus one
+void ChurnWithoutUpdates()
+{
+	TTable table;
+	CHandleList list;
+	vector<TUInt32> live;
+	for (TUInt32 object = 0; object < 1000; ++object)
+	{
+		live.push_back( table.New( object ) );
+		list.Add( live.back() );
+	}
+
+	srand( 3 );
+	TUInt32 numCompactions = 0;
+	for (TUInt32 operation = 0; operation < 100000; ++operation)
+	{
+		if (live.empty() || rand() % 2)
+		{
+			live.push_back( table.New( 0 ) );
+			list.Add( live.back() );
+		}
+		else
+		{
+			TUInt32 pos = rand() % live.size();
+			table.Free( live[pos] );
+			live[pos] = live.back();
+			live.pop_back();
+			list.NoteRemoval();
+			if (list.IsMostlyRemoved())
+			{
+				numCompactions += list.Compact( table );
+			}
+		}
+		TEST_CHECK( list.GetSize() <= 2 * live.size() + 1 );
+	}
+	TEST_CHECK( numCompactions > 0 );
+	TEST_CHECK( ValidHandles( table, list ).size() == live.size() );
+
+	// Mass despawn - everything freed, the list ends up empty
+	for (TUInt32 pos = 0; pos < live.size(); ++pos)
+	{
+		table.Free( live[pos] );
+		list.NoteRemoval();
+		if (list.IsMostlyRemoved())
+		{
+			list.Compact( table );
+		}
+	}
+	TEST_CHECK( list.GetSize() == 0 );
+}
+
+// Objects in several buckets each, created and destroyed at random with flushes of mostly freed
+// buckets between, and full flushes as at the start of an update
+void BucketInvariants()
+{
+	SBuckets buckets;
+	srand( 9 );
+	TUInt32 numMismatches = 0;
+	for (TUInt32 operation = 0; operation < 20000; ++operation)
+	{
+		if (buckets.live.empty() || rand() % 5 < 3)
+		{
+			buckets.Add( 1 + rand() % ((1 << kNumBuckets) - 1) );
+		}
+		else
+		{
+			buckets.Remove( rand() % buckets.live.size() );
+			buckets.Flush( true );
+		}
+		if (operation % 500 == 0)
+		{
+			buckets.Flush( false );
+		}
+		if (operation % 16 == 0)
+		{
+			numMismatches += !buckets.IsConsistent();
+		}
+	}
+	TEST_CHECK( numMismatches == 0 );
+
+	// A reader in one bucket holds up only that bucket's compaction
+	buckets.buckets[0].OpenReader();
+	while (!buckets.live.empty())
+	{
+		buckets.Remove( 0 );
+	}
+	buckets.Flush( false );
+	TEST_CHECK( buckets.IsConsistent() && buckets.withRemovals.size() == 1 );
+	for (TUInt32 bucket = 1; bucket < kNumBuckets; ++bucket)
+	{
+		TEST_CHECK( buckets.buckets[bucket].GetSize() == 0 );
+	}
+	buckets.buckets[0].CloseReader();
+	buckets.Flush( false );
+	TEST_CHECK( buckets.IsConsistent() && buckets.withRemovals.empty() && buckets.buckets[0].GetSize() == 0 );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( CompactKeepsOrder );
+	TEST_RUN( ReadersPutOffCompaction );
+	TEST_RUN( ChurnWithoutUpdates );
+	TEST_RUN( BucketInvariants );
+	return TestResult( "TestHandleList" );
+}
@@ -0,0 +1,337 @@
+/*******************************************
+	TestHandleTable.cpp
+
+	Tests of the generational handle table,
+	with a packed array of objects kept as the
+	entity manager keeps its entities
+********************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include "CHandleTable.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+typedef CHandleTable<TUInt32> TTable;
+
+// Packed array of objects, each holding its own handle. Removing an object moves the last one
+// into its place, as CEntityManager::DestroyEntity does
+struct SObjects
+{
+	TTable          table;
+	vector<TUInt32> handles; // Handle of the object at each index
+
+	TUInt32 Add()
+	{
+		TUInt32 handle = table.New( static_cast<TUInt32>(handles.size()) );
+		handles.push_back( handle );
+		return handle;
+	}
+
+	bool Remove( TUInt32 handle )
+	{
+		if (!table.IsValid( handle ))
+		{
+			return false;
+		}
+		TUInt32 index = table.GetIndex( handle );
+		table.Free( handle );
+		if (index != handles.size() - 1)
+		{
+			handles[index] = handles.back();
+			table.SetIndex( handles[index], index );
+		}
+		handles.pop_back();
+		return true;
+	}
+};
+
+// The same objects with creations and destructions queued during an update and applied in one
+// pass afterwards, as CEntityManager::ApplyEntityCommands does. The slot data is 1 for objects
+// queued for destruction
+struct SQueuedObjects : SObjects
+{
+	vector<TUInt32> created; // Reserved handles of queued creations
+	vector<TUInt32> order;   // Creation count of the object at each index, to check order is kept
+	TUInt32         numCreated;
+
+	SQueuedObjects() : numCreated( 0 ) {}
+
+	TUInt32 QueueCreate()
+	{
+		TUInt32 handle = table.Reserve();
+		table.Data( handle ) = 0;
+		created.push_back( handle );
+		return handle;
+	}
+
+	bool QueueDestroy( TUInt32 handle )
+	{
+		if (table.IsValid( handle ))
+		{
+			table.Data( handle ) = 1;
+			return true;
+		}
+		vector<TUInt32>::iterator queued = find( created.begin(), created.end(), handle );
+		if (queued == created.end())
+		{
+			return false;
+		}
+		table.Free( handle );
+		created.erase( queued );
+		return true;
+	}
+
+	void Apply()
+	{
+		for (TUInt32 i = 0; i < created.size(); ++i)
+		{
+			table.Activate( created[i], static_cast<TUInt32>(handles.size()) );
+			handles.push_back( created[i] );
+			order.push_back( numCreated++ );
+		}
+		created.clear();
+
+		TUInt32 numKept = 0;
+		for (TUInt32 index = 0; index < handles.size(); ++index)
+		{
+			if (table.Data( handles[index] ))
+			{
+				table.Free( handles[index] );
+			}
+			else
+			{
+				handles[numKept] = handles[index];
+				order[numKept] = order[index];
+				table.SetIndex( handles[numKept], numKept );
+				++numKept;
+			}
+		}
+		handles.resize( numKept );
+		order.resize( numKept );
+	}
+
+	// Every live handle finds its own object and objects are still in creation order
+	bool IsConsistent() const
+	{
+		for (TUInt32 index = 0; index < handles.size(); ++index)
+		{
+			if (!table.IsValid( handles[index] ) || table.GetIndex( handles[index] ) != index ||
+			    (index > 0 && order[index] <= order[index - 1]))
+			{
+				return false;
+			}
+		}
+		return table.GetNumSlots() - table.GetNumFreeSlots() == handles.size() + created.size();
+	}
+};
+
+
+/*-----------------------------------------------------------------------------------------
+	Tests
+-----------------------------------------------------------------------------------------*/
+
+// The first handles are the slot indexes in order, as entity UIDs 0, 1, 2... were before
+void FirstHandlesInOrder()
+{
+	SObjects objects;
+	for (TUInt32 i = 0; i < 100; ++i)
+	{
+		TEST_CHECK( objects.Add() == i );
+	}
+	TEST_CHECK( objects.table.GetNumSlots() == 100 && objects.table.GetNumFreeSlots() == 0 );
+	TEST_CHECK( !objects.table.IsValid( 100 ) && !objects.table.IsValid( kiNoHandle ) );
+}
+
+// A freed handle never matches again, even once its slot is reused, and the reused slot gets a
+// new handle
+void StaleHandles()
+{
+	SObjects objects;
+	TUInt32 first = objects.Add();
+	TUInt32 second = objects.Add();
+	TEST_CHECK( objects.Remove( first ) );
+	TEST_CHECK( !objects.table.IsValid( first ) && !objects.Remove( first ) );
+
+	TUInt32 reused = objects.Add();
+	TEST_CHECK( (reused & kiHandleSlotMask) == (first & kiHandleSlotMask) );
+	TEST_CHECK( reused != first && !objects.table.IsValid( first ) );
+	TEST_CHECK( objects.table.IsValid( reused ) && objects.table.IsValid( second ) );
+	TEST_CHECK( objects.table.GetNumSlots() == 2 );
+
+	// A slot is reused 4095 times before a handle repeats
+	TUInt32 handle = reused;
+	for (TUInt32 reuse = 0; reuse < 4094; ++reuse)
+	{
+		objects.Remove( handle );
+		handle = objects.Add();
+		TEST_CHECK( handle != first );
+	}
+	objects.Remove( handle );
+	TEST_CHECK( objects.Add() == first );
+}
+
+// Reserved handles are not valid until activated and can be freed without being activated
+void ReservedHandles()
+{
+	SObjects objects;
+	objects.Add();
+	TUInt32 reserved = objects.table.Reserve();
+	TEST_CHECK( !objects.table.IsValid( reserved ) );
+	objects.table.Data( reserved ) = 42;
+
+	objects.table.Activate( reserved, 7 );
+	TEST_CHECK( objects.table.IsValid( reserved ) && objects.table.GetIndex( reserved ) == 7 );
+	TEST_CHECK( objects.table.Data( reserved ) == 42 );
+
+	TUInt32 cancelled = objects.table.Reserve();
+	objects.table.Free( cancelled );
+	TEST_CHECK( !objects.table.IsValid( cancelled ) );
+	TUInt32 next = objects.table.Reserve();
+	TEST_CHECK( next != cancelled && (next & kiHandleSlotMask) == (cancelled & kiHandleSlotMask) );
+}
+
+// Random adds and removes - every live handle finds its object, every removed one finds nothing,
+// and slots are reused rather than added
+void RandomChurn()
+{
+	SObjects objects;
+	vector<TUInt32> removed;
+	srand( 7 );
+	TUInt32 numMismatches = 0;
+	for (TUInt32 operation = 0; operation < 200000; ++operation)
+	{
+		if (objects.handles.empty() || rand() % 3 != 0)
+		{
+			objects.Add();
+		}
+		else
+		{
+			TUInt32 handle = objects.handles[rand() % objects.handles.size()];
+			objects.Remove( handle );
+			removed.push_back( handle );
+		}
+		if (objects.handles.size() > 1000)
+		{
+			while (objects.handles.size() > 500)
+			{
+				removed.push_back( objects.handles.back() );
+				objects.Remove( objects.handles.back() );
+			}
+		}
+	}
+	for (TUInt32 index = 0; index < objects.handles.size(); ++index)
+	{
+		TUInt32 handle = objects.handles[index];
+		numMismatches += !objects.table.IsValid( handle ) || objects.table.GetIndex( handle ) != index;
+	}
+	for (TUInt32 i = 0; i < removed.size(); ++i)
+	{
+		numMismatches += objects.table.IsValid( removed[i] );
+	}
+	TEST_CHECK( numMismatches == 0 );
+	TEST_CHECK( objects.table.GetNumSlots() <= 1001 );
+	TEST_CHECK( objects.table.GetNumSlots() - objects.table.GetNumFreeSlots() == objects.handles.size() );
+}
+
+// Every object destroyed in one update, some twice, while new objects are created in the same
+// update and some of those destroyed before they exist
+void MassDespawn()
+{
+	const TUInt32 kNumObjects = 10000;
+	SQueuedObjects objects;
+	for (TUInt32 i = 0; i < kNumObjects; ++i)
+	{
+		objects.QueueCreate();
+	}
+	objects.Apply();
+	TEST_CHECK( objects.IsConsistent() && objects.handles.size() == kNumObjects );
+
+	vector<TUInt32> despawned = objects.handles;
+	vector<TUInt32> spawned;
+	for (TUInt32 i = 0; i < kNumObjects; ++i)
+	{
+		TEST_CHECK( objects.QueueDestroy( despawned[i] ) );
+		if (i % 2 == 0)
+		{
+			TEST_CHECK( objects.QueueDestroy( despawned[i] ) ); // Harmless
+		}
+		if (i % 10 == 0)
+		{
+			spawned.push_back( objects.QueueCreate() );
+			TEST_CHECK( !objects.table.IsValid( spawned.back() ) );
+		}
+	}
+	TEST_CHECK( objects.QueueDestroy( spawned[0] ) && !objects.QueueDestroy( spawned[0] ) );
+	TEST_CHECK( objects.table.GetNumSlots() == kNumObjects + spawned.size() );
+	TEST_CHECK( objects.handles.size() == kNumObjects ); // Still there until the update ends
+
+	objects.Apply();
+	TEST_CHECK( objects.IsConsistent() && objects.handles.size() == spawned.size() - 1 );
+	TUInt32 numStale = 0;
+	for (TUInt32 i = 0; i < kNumObjects; ++i)
+	{
+		numStale += objects.table.IsValid( despawned[i] );
+	}
+	TEST_CHECK( numStale == 0 && !objects.table.IsValid( spawned[0] ) );
+	for (TUInt32 i = 1; i < spawned.size(); ++i)
+	{
+		TEST_CHECK( objects.handles[i - 1] == spawned[i] );
+	}
+
+	// The freed slots are reused for the next wave rather than new ones added
+	TUInt32 numSlots = objects.table.GetNumSlots();
+	for (TUInt32 i = 0; i < kNumObjects; ++i)
+	{
+		objects.QueueCreate();
+	}
+	objects.Apply();
+	TEST_CHECK( objects.IsConsistent() && objects.table.GetNumSlots() == numSlots );
+}
+
+// Most objects destroyed in each of many updates with random creations between - the survivors
+// keep their order and handles
+void RepeatedDespawns()
+{
+	SQueuedObjects objects;
+	srand( 5 );
+	TUInt32 numMismatches = 0, mostObjects = 0;
+	for (TUInt32 update = 0; update < 200; ++update)
+	{
+		TUInt32 numCreations = rand() % 2000;
+		for (TUInt32 i = 0; i < numCreations; ++i)
+		{
+			objects.QueueCreate();
+		}
+		for (TUInt32 index = 0; index < objects.handles.size(); ++index)
+		{
+			if (rand() % 10 != 0)
+			{
+				objects.QueueDestroy( objects.handles[index] );
+			}
+		}
+		mostObjects = max( mostObjects, static_cast<TUInt32>(objects.handles.size() + objects.created.size()) );
+		objects.Apply();
+		numMismatches += !objects.IsConsistent();
+	}
+	TEST_CHECK( numMismatches == 0 );
+	TEST_CHECK( objects.table.GetNumSlots() == mostObjects ); // No more slots than ever in use at once
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( FirstHandlesInOrder );
+	TEST_RUN( StaleHandles );
+	TEST_RUN( ReservedHandles );
+	TEST_RUN( RandomChurn );
+	TEST_RUN( MassDespawn );
+	TEST_RUN( RepeatedDespawns );
+	return TestResult( "TestHandleTable" );
+}
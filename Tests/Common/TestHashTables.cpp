@@ -0,0 +1,312 @@
+/*******************************************
+	TestHashTables.cpp
+
+	Tests of the list and open addressing hash
+	tables against std::unordered_map
+********************************************/
+
+#include <cstdlib>
+#include <sstream>
+#include <unordered_map>
+#include "CFlatHashTable.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+// Number of keys in a table, from its report
+template <class TTable>
+TUInt32 NumEntries( const TTable& table )
+{
+	SHashTableStats stats;
+	table.GetStats( &stats );
+	return stats.iNumEntries;
+}
+
+// Random inserts, removes and look-ups of keys in 0 to keyRange, checking every result against
+// std::unordered_map and finally that every key left in the map is in the table
+template <class TTable>
+void CheckAgainstMap( TTable& table, TUInt32 seed, TUInt32 keyRange, TUInt32 numOperations )
+{
+	unordered_map<TUInt32, TUInt32> map;
+	srand( seed );
+	TUInt32 numMismatches = 0;
+	for (TUInt32 operation = 0; operation < numOperations; ++operation)
+	{
+		TUInt32 key = rand() % keyRange;
+		TUInt32 value = rand();
+		switch (rand() % 4)
+		{
+		case 0: case 1:
+			table.SetKeyValue( key, value );
+			map[key] = value;
+			break;
+		case 2:
+			numMismatches += table.RemoveKey( key ) != (map.erase( key ) == 1);
+			break;
+		case 3:
+			{
+				TUInt32 found = 0;
+				bool inTable = table.LookUpKey( key, &found );
+				unordered_map<TUInt32, TUInt32>::iterator entry = map.find( key );
+				numMismatches += inTable != (entry != map.end()) || (inTable && found != entry->second);
+			}
+			break;
+		}
+	}
+	TEST_CHECK( numMismatches == 0 );
+	TEST_CHECK( NumEntries( table ) == map.size() );
+
+	TUInt32 numMissing = 0;
+	for (unordered_map<TUInt32, TUInt32>::iterator entry = map.begin(); entry != map.end(); ++entry)
+	{
+		TUInt32 found = 0;
+		numMissing += !table.LookUpKey( entry->first, &found ) || found != entry->second;
+	}
+	TEST_CHECK( numMissing == 0 );
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Tests
+-----------------------------------------------------------------------------------------*/
+
+// Both tables behave as a map under random use, from tiny starting sizes so they grow many times
+void MatchesMap()
+{
+	{
+		CHashTable<TUInt32, TUInt32> table( 3 );
+		CheckAgainstMap( table, 1, 5000, 400000 );
+	}
+	{
+		CFlatHashTable<TUInt32, TUInt32> table( 1 );
+		CheckAgainstMap( table, 2, 5000, 400000 );
+	}
+	{
+		// Robin Hood probing at a high load factor
+		CFlatHashTable<TUInt32, TUInt32> table( 16, 0.95f );
+		CheckAgainstMap( table, 3, 20000, 400000 );
+	}
+}
+
+// Long collision chains - adding up the bytes of a key sends most keys to a few slots, so removal
+// has to shift long runs of keys back
+void MatchesMapWithCollisions()
+{
+	CFlatHashTable<TUInt32, TUInt32, CByteHashTraits<TUInt32, AddUpHash> > table( 1 );
+	CheckAgainstMap( table, 4, 3000, 200000 );
+}
+
+// Removing every key empties the table, which can be refilled
+void RemoveAll()
+{
+	CFlatHashTable<TUInt32, TUInt32> table( 8 );
+	for (TUInt32 key = 0; key < 1000; ++key)
+	{
+		table.SetKeyValue( key * 7919, key );
+	}
+	TEST_CHECK( NumEntries( table ) == 1000 );
+	table.RemoveAllKeys();
+	TEST_CHECK( NumEntries( table ) == 0 );
+
+	TUInt32 value = 0;
+	TEST_CHECK( !table.LookUpKey( 7919, &value ) );
+	table.SetKeyValue( 7919, 5 );
+	TEST_CHECK( table.LookUpKey( 7919, &value ) && value == 5 );
+}
+
+// Setting an existing key replaces its value without adding an entry
+void ReplaceValue()
+{
+	CFlatHashTable<TUInt32, TUInt32> table( 4 );
+	table.SetKeyValue( 10, 1 );
+	table.SetKeyValue( 10, 2 );
+	TUInt32 value = 0;
+	TEST_CHECK( NumEntries( table ) == 1 );
+	TEST_CHECK( table.LookUpKey( 10, &value ) && value == 2 );
+	TEST_CHECK( !table.RemoveKey( 11 ) && table.RemoveKey( 10 ) && !table.RemoveKey( 10 ) );
+}
+
+// String keys hash their characters, so a copy of a key held in a different buffer finds the same
+// entry, including names long enough for the block hash
+void StringKeys()
+{
+	CHashTable<string, TUInt32> table( 4 );
+	CFlatHashTable<string, TUInt32> flatTable( 4 );
+	for (TUInt32 length = 0; length < 100; ++length)
+	{
+		string key( length, 'a' );
+		table.SetKeyValue( key, length );
+		flatTable.SetKeyValue( key, length );
+	}
+	TUInt32 numWrong = 0;
+	for (TUInt32 length = 0; length < 100; ++length)
+	{
+		string key;
+		key.reserve( 200 ); // Different buffer to the key inserted
+		key.assign( length, 'a' );
+		TUInt32 value = ~0u, flatValue = ~0u;
+		numWrong += !table.LookUpKey( key, &value ) || value != length;
+		numWrong += !flatTable.LookUpKey( key, &flatValue ) || flatValue != length;
+	}
+	TEST_CHECK( numWrong == 0 );
+	TUInt32 value;
+	TEST_CHECK( !table.LookUpKey( string( "b" ), &value ) && !flatTable.LookUpKey( string( "b" ), &value ) );
+}
+
+// Every byte of a key affects its block hash, including the bytes past the last whole 32-byte block
+void BlockHashUsesEveryByte()
+{
+	TUInt8 key[100];
+	for (TUInt32 i = 0; i < sizeof(key); ++i)
+	{
+		key[i] = static_cast<TUInt8>(i * 37);
+	}
+	TUInt32 numUnchanged = 0;
+	for (TUInt32 length = 1; length <= sizeof(key); ++length)
+	{
+		TUInt32 hash = BlockHash( key, length );
+		TEST_CHECK( BlockHash( key, length ) == hash );
+		for (TUInt32 i = 0; i < length; ++i)
+		{
+			key[i] ^= 1;
+			numUnchanged += BlockHash( key, length ) == hash;
+			key[i] ^= 1;
+		}
+	}
+	TEST_CHECK( numUnchanged == 0 );
+}
+
+// Table sizes are rounded up to a power of 2
+void PowerOf2Sizes()
+{
+	TEST_CHECK( HashTableSize( 0 ) == 1 && HashTableSize( 1 ) == 1 && HashTableSize( 2 ) == 2 );
+	TEST_CHECK( HashTableSize( 3 ) == 4 && HashTableSize( 1000 ) == 1024 && HashTableSize( 1024 ) == 1024 );
+
+	CHashTable<TUInt32, TUInt32> table( 100 );
+	CFlatHashTable<TUInt32, TUInt32> flatTable( 100 );
+	SHashTableStats stats, flatStats;
+	table.GetStats( &stats );
+	flatTable.GetStats( &flatStats );
+	TEST_CHECK( stats.iSize == 128 && flatStats.iSize == 128 );
+}
+
+// Incremental resizing gives the same results as resizing in one go, while keys are spread over
+// the old and new arrays
+void MatchesMapWhileResizing()
+{
+	const TUInt32 resizeSteps[] = { 1, 2, 8 };
+	for (TUInt32 step = 0; step < sizeof(resizeSteps) / sizeof(resizeSteps[0]); ++step)
+	{
+		{
+			CHashTable<TUInt32, TUInt32> table( 3, 0.7f, resizeSteps[step] );
+			CheckAgainstMap( table, 10 + step, 20000, 200000 );
+		}
+		{
+			CHashTable<TUInt32, TUInt32> table( 3, 2.0f, resizeSteps[step] );
+			CheckAgainstMap( table, 20 + step, 20000, 200000 );
+		}
+		{
+			CFlatHashTable<TUInt32, TUInt32> table( 1, 0.7f, resizeSteps[step] );
+			CheckAgainstMap( table, 30 + step, 20000, 200000 );
+		}
+		{
+			CFlatHashTable<TUInt32, TUInt32> table( 1, 0.9f, resizeSteps[step] );
+			CheckAgainstMap( table, 40 + step, 20000, 200000 );
+		}
+		{
+			CFlatHashTable<TUInt32, TUInt32, CByteHashTraits<TUInt32, AddUpHash> > table( 1, 0.7f, resizeSteps[step] );
+			CheckAgainstMap( table, 50 + step, 3000, 100000 );
+		}
+	}
+}
+
+// With a resize step no single insert moves more than a few keys, however large the table grows.
+// Without one, the last resize moves every key
+void ResizeMovesBounded()
+{
+	const TUInt32 numKeys = 1 << 20;
+	CHashTable<TUInt32, TUInt32> table( 16, 0.7f, 8 ), wholeTable( 16 );
+	CFlatHashTable<TUInt32, TUInt32> flatTable( 16, 0.7f, 8 ), wholeFlatTable( 16 );
+	for (TUInt32 key = 0; key < numKeys; ++key)
+	{
+		table.SetKeyValue( key * 2654435761u, key );
+		wholeTable.SetKeyValue( key * 2654435761u, key );
+		flatTable.SetKeyValue( key * 2654435761u, key );
+		wholeFlatTable.SetKeyValue( key * 2654435761u, key );
+	}
+	TEST_CHECK( table.GetMaxResizeMoves() <= 64 && flatTable.GetMaxResizeMoves() <= 64 );
+	TEST_CHECK( wholeTable.GetMaxResizeMoves() >= numKeys / 2 && wholeFlatTable.GetMaxResizeMoves() >= numKeys / 2 );
+	printf( "    most keys moved by one insert of %u: %u and %u with a step of 8, %u and %u without\n", numKeys,
+	        table.GetMaxResizeMoves(), flatTable.GetMaxResizeMoves(),
+	        wholeTable.GetMaxResizeMoves(), wholeFlatTable.GetMaxResizeMoves() );
+}
+
+// Reports count look-ups only when enabled, and the histograms account for every key
+void Stats()
+{
+	CHashTable<TUInt32, TUInt32, CHashTraits<TUInt32>, true> table( 64 );
+	CFlatHashTable<TUInt32, TUInt32, CHashTraits<TUInt32>, true> flatTable( 64 );
+	CFlatHashTable<TUInt32, TUInt32> uncountedTable( 64 );
+	for (TUInt32 key = 0; key < 100; ++key)
+	{
+		table.SetKeyValue( key, key );
+		flatTable.SetKeyValue( key, key );
+		uncountedTable.SetKeyValue( key, key );
+	}
+	table.ResetStats();
+	flatTable.ResetStats();
+	TUInt32 value;
+	for (TUInt32 key = 0; key < 150; ++key)
+	{
+		table.LookUpKey( key, &value );
+		flatTable.LookUpKey( key, &value );
+	}
+
+	SHashTableStats stats, flatStats, uncountedStats;
+	table.GetStats( &stats );
+	flatTable.GetStats( &flatStats );
+	uncountedTable.GetStats( &uncountedStats );
+	TEST_CHECK( stats.bCounted && stats.iLookUps == 150 && stats.iHits == 100 && stats.iMisses == 50 );
+	TEST_CHECK( flatStats.bCounted && flatStats.iLookUps == 150 && flatStats.iHits == 100 && flatStats.iProbes >= 150 );
+	TEST_CHECK( !uncountedStats.bCounted && uncountedStats.iLookUps == 0 );
+	TEST_CHECK( stats.iNumEntries == 100 && flatStats.iNumEntries == 100 && flatStats.iNumResizes == 2 );
+
+	// Bucket lengths weighted by length, and probe lengths, both add up to the number of keys
+	TUInt32 bucketKeys = 0, probeKeys = 0;
+	for (TUInt32 length = 0; length < stats.aiHistogram.size(); ++length)
+	{
+		bucketKeys += length * stats.aiHistogram[length];
+	}
+	for (TUInt32 probe = 0; probe < flatStats.aiHistogram.size(); ++probe)
+	{
+		probeKeys += flatStats.aiHistogram[probe];
+	}
+	TEST_CHECK( bucketKeys == 100 && probeKeys == 100 );
+
+	ostringstream json, csv;
+	flatStats.WriteJSON( json );
+	flatStats.WriteCSV( csv );
+	TEST_CHECK( json.str().find( "\"probe_length\"" ) != string::npos );
+	TEST_CHECK( csv.str().find( "histogram_0," ) != string::npos );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( MatchesMap );
+	TEST_RUN( MatchesMapWithCollisions );
+	TEST_RUN( RemoveAll );
+	TEST_RUN( ReplaceValue );
+	TEST_RUN( StringKeys );
+	TEST_RUN( BlockHashUsesEveryByte );
+	TEST_RUN( PowerOf2Sizes );
+	TEST_RUN( MatchesMapWhileResizing );
+	TEST_RUN( ResizeMovesBounded );
+	TEST_RUN( Stats );
+	return TestResult( "TestHashTables" );
+}
@@ -0,0 +1,221 @@
+/*******************************************
+	TestNameIndex.cpp
+
+	Tests of the name index against a list of
+	objects for each name, and that an update
+	tick does the same name table work however
+	many entities there are
+********************************************/
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <random>
+#include "CNameIndex.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+typedef CNameIndex<> TIndex;
+
+// Objects with each name in the order they were added
+typedef map< string, list<TUInt32> > TNameLists;
+
+// Every chain in the index matches the list for its name
+bool ChainsMatch( const TIndex& index, const TNameLists& lists )
+{
+	for (TNameLists::const_iterator names = lists.begin(); names != lists.end(); ++names)
+	{
+		TUInt32 handle = index.GetFirst( names->first );
+		for (list<TUInt32>::const_iterator object = names->second.begin(); object != names->second.end(); ++object)
+		{
+			if (handle != *object)
+			{
+				return false;
+			}
+			handle = index.GetNext( handle );
+		}
+		if (handle != kiNoHandle)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Name table work done by one update tick, counted by the name table's look-up counters, and the
+// number of entities checked by name look-ups
+struct STickCounts
+{
+	TUInt64 iLookUps;
+	TUInt64 iProbes;
+	TUInt32 iNumChecked;
+};
+
+// Return the first entity with a name as CEntityManager::ResolveEntity does, counting the
+// entities it checks
+TUInt32 Resolve( const CNameIndex<true>& index, const string& name, TUInt32* numChecked )
+{
+	TUInt32 handle = index.GetFirst( name );
+	*numChecked += handle != kiNoHandle;
+	return handle;
+}
+
+// Mirror of the name work in CEntityManager's update ticks, in a scene with the given number of
+// monsters sharing a name and as many clutter entities each with their own name. Each tick the
+// collision calculator resolves the player and stand, the UI resolves a bar to swap its texture,
+// and a monster is created while another is destroyed from the middle of the monsters' chain
+STickCounts TickCounts( TUInt32 numMonsters )
+{
+	const TUInt32 kNumTicks = 10;
+	CNameIndex<true> index( 256, 1024 );
+	CHandleTable<string> entities;
+	vector<TUInt32> monsters;
+	const char* const names[] = { "Player", "Stando", "Player2", "Floor", "KnivesLeft", "KnivesRight",
+	                              "PlayerHealthBar" };
+	for (TUInt32 name = 0; name < 7; ++name)
+	{
+		TUInt32 handle = entities.New( 0 );
+		entities.Data( handle ) = names[name];
+		index.Add( handle, entities.Data( handle ) );
+	}
+	for (TUInt32 entity = 0; entity < numMonsters; ++entity)
+	{
+		TUInt32 monster = entities.New( 0 );
+		entities.Data( monster ) = "Monster";
+		index.Add( monster, entities.Data( monster ) );
+		monsters.push_back( monster );
+
+		TUInt32 clutter = entities.New( 0 );
+		entities.Data( clutter ) = "Clutter" + to_string( entity );
+		index.Add( clutter, entities.Data( clutter ) );
+	}
+
+	SHashTableStats before, after;
+	index.GetStats( &before );
+	STickCounts counts = { 0, 0, 0 };
+	for (TUInt32 tick = 0; tick < kNumTicks; ++tick)
+	{
+		TEST_CHECK( Resolve( index, "Player", &counts.iNumChecked ) != kiNoHandle );
+		TEST_CHECK( Resolve( index, "Stando", &counts.iNumChecked ) != kiNoHandle );
+		TEST_CHECK( Resolve( index, "PlayerHealthBar", &counts.iNumChecked ) != kiNoHandle );
+
+		TUInt32 monster = entities.New( 0 );
+		entities.Data( monster ) = "Monster";
+		index.Add( monster, entities.Data( monster ) );
+		monsters.push_back( monster );
+
+		TUInt32 position = static_cast<TUInt32>(monsters.size() / 2);
+		index.Remove( monsters[position], "Monster" );
+		entities.Free( monsters[position] );
+		monsters.erase( monsters.begin() + position );
+	}
+	index.GetStats( &after );
+	counts.iLookUps = after.iLookUps - before.iLookUps;
+	counts.iProbes = after.iProbes - before.iProbes;
+	return counts;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Tests
+-----------------------------------------------------------------------------------------*/
+
+// Objects with the same name are returned in the order they were added, whichever is removed
+void CreationOrder()
+{
+	TIndex index( 4 );
+	TNameLists lists;
+	for (TUInt32 object = 0; object < 5; ++object)
+	{
+		index.Add( object, "Tree" );
+		lists["Tree"].push_back( object );
+	}
+	index.Add( 5, "Sun" );
+	lists["Sun"].push_back( 5 );
+	TEST_CHECK( ChainsMatch( index, lists ) );
+
+	// Last, middle, then first
+	const TUInt32 removeOrder[] = { 4, 2, 0 };
+	for (TUInt32 i = 0; i < 3; ++i)
+	{
+		index.Remove( removeOrder[i], "Tree" );
+		lists["Tree"].remove( removeOrder[i] );
+		TEST_CHECK( ChainsMatch( index, lists ) );
+	}
+
+	// Added after removals, goes on the end
+	index.Add( 6, "Tree" );
+	lists["Tree"].push_back( 6 );
+	TEST_CHECK( ChainsMatch( index, lists ) );
+
+	index.Remove( 5, "Sun" );
+	TEST_CHECK( index.GetFirst( "Sun" ) == kiNoHandle );
+	index.RemoveAll();
+	TEST_CHECK( index.GetFirst( "Tree" ) == kiNoHandle );
+}
+
+// Random adds and removes over a few names, with handles of reused slots as the entity manager
+// issues them
+void RandomChurn()
+{
+	TIndex index( 4 );
+	TNameLists lists;
+	CHandleTable<string> handles;
+	vector<TUInt32> live;
+	const char* const names[] = { "House", "Tree", "Zombie", "Sun", "Knives" };
+	mt19937 random( 11 );
+	TUInt32 numMismatches = 0;
+	for (TUInt32 operation = 0; operation < 20000; ++operation)
+	{
+		if (live.empty() || random() % 5 < 3)
+		{
+			TUInt32 handle = handles.New( 0 );
+			handles.Data( handle ) = names[random() % 5];
+			index.Add( handle, handles.Data( handle ) );
+			lists[handles.Data( handle )].push_back( handle );
+			live.push_back( handle );
+		}
+		else
+		{
+			TUInt32 position = random() % live.size();
+			TUInt32 handle = live[position];
+			index.Remove( handle, handles.Data( handle ) );
+			lists[handles.Data( handle )].remove( handle );
+			handles.Free( handle );
+			live[position] = live.back();
+			live.pop_back();
+		}
+		if (operation % 64 == 0)
+		{
+			numMismatches += !ChainsMatch( index, lists );
+		}
+	}
+	TEST_CHECK( numMismatches == 0 );
+	TEST_CHECK( ChainsMatch( index, lists ) );
+}
+
+// An update tick makes the same name table look-ups and checks the same entities with 16 or 16K
+// monsters sharing a name, so no look-up or chain update walks the entities. Each look-up
+// probes a few slots at most whatever the number of names
+void NoLinearScans()
+{
+	STickCounts small = TickCounts( 16 ), large = TickCounts( 16384 );
+	TEST_CHECK( small.iLookUps > 0 && large.iLookUps == small.iLookUps );
+	TEST_CHECK( small.iNumChecked == 30 && large.iNumChecked == small.iNumChecked );
+	TEST_CHECK( small.iProbes <= 2 * small.iLookUps && large.iProbes <= 2 * large.iLookUps );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( CreationOrder );
+	TEST_RUN( RandomChurn );
+	TEST_RUN( NoLinearScans );
+	return TestResult( "TestNameIndex" );
+}
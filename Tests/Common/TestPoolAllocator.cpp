@@ -0,0 +1,112 @@
+/*******************************************
+	TestPoolAllocator.cpp
+
+	Tests that the pool and arena allocators
+	reuse freed memory of any size, so objects
+	created and destroyed over and over do not
+	take more memory each time
+********************************************/
+
+#include <new>
+#include "CPoolAllocator.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+// Larger than the arena's directly indexed free lists, as a player entity is
+struct SLargeObject
+{
+	TFloat32 matrices[64][16];
+};
+
+// Number of times objects are created and destroyed in each test
+const TUInt32 kNumCycles = 1000;
+
+
+/*-----------------------------------------------------------------------------------------
+	Tests
+-----------------------------------------------------------------------------------------*/
+
+// A pool of objects too large for the arena's small free lists still reuses freed objects
+void PoolReusesLargeObjects()
+{
+	CPoolAllocator<SLargeObject> pool( 4 );
+	void* first = pool.Allocate();
+	pool.Free( first );
+	TEST_CHECK( pool.Allocate() == first );
+	pool.Free( first );
+
+	for (TUInt32 cycle = 0; cycle < kNumCycles; ++cycle)
+	{
+		SLargeObject* objects[3];
+		for (TUInt32 i = 0; i < 3; ++i)
+		{
+			objects[i] = new (pool.Allocate()) SLargeObject;
+		}
+		TEST_CHECK( pool.GetNumAllocations() == 3 );
+		for (TUInt32 i = 0; i < 3; ++i)
+		{
+			objects[i]->~SLargeObject();
+			pool.Free( objects[i] );
+		}
+	}
+	TEST_CHECK( pool.GetNumBlocks() == 1 && pool.GetNumAllocations() == 0 );
+
+	pool.Reset();
+	TEST_CHECK( pool.Allocate() != 0 && pool.GetNumAllocations() == 1 && pool.GetNumBlocks() == 1 );
+}
+
+// Arrays above 4KB, e.g. node matrices of meshes with many nodes, are reused by allocations of
+// the same size and not by others
+void ArenaReusesLargeSizes()
+{
+	const TUInt32 kSmall = 4096, kLarge = 4096 + 16, kLarger = 200 * 64;
+	CArenaAllocator arena( 64 * 1024 );
+	void* larger = arena.Allocate( kLarger );
+	void* large = arena.Allocate( kLarge );
+	arena.Free( larger, kLarger );
+	arena.Free( large, kLarge );
+	TEST_CHECK( arena.Allocate( kLarger ) == larger );
+	TEST_CHECK( arena.Allocate( kLarge ) == large );
+	arena.Free( larger, kLarger );
+	arena.Free( large, kLarge );
+
+	// Many large sizes freed over and over use no more blocks than the first cycle
+	TUInt32 numBlocks = 0;
+	for (TUInt32 cycle = 0; cycle < kNumCycles; ++cycle)
+	{
+		void* arrays[8];
+		for (TUInt32 i = 0; i < 8; ++i)
+		{
+			arrays[i] = arena.Allocate( kSmall + (i + 1) * 1024 );
+		}
+		for (TUInt32 i = 0; i < 8; ++i)
+		{
+			arena.Free( arrays[i], kSmall + (i + 1) * 1024 );
+		}
+		if (cycle == 0)
+		{
+			numBlocks = arena.GetNumBlocks();
+		}
+	}
+	TEST_CHECK( arena.GetNumBlocks() == numBlocks && arena.GetNumAllocations() == 0 );
+
+	// Reset forgets the free lists as well as the allocations
+	arena.Reset();
+	void* first = arena.Allocate( kLarger );
+	void* second = arena.Allocate( kLarger );
+	TEST_CHECK( first != second && arena.GetNumAllocations() == 2 );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( PoolReusesLargeObjects );
+	TEST_RUN( ArenaReusesLargeSizes );
+	return TestResult( "TestPoolAllocator" );
+}
@@ -0,0 +1,26 @@
+/**************************************************************************************************
+	Module:       PlatformDefines.h
+
+	Forced include for building engine modules with GCC in the headless tests. Supplies the few
+	Microsoft compiler definitions and CRT functions that the engine headers rely on
+**************************************************************************************************/
+
+#ifndef GEN_PLATFORM_DEFINES_H_INCLUDED
+#define GEN_PLATFORM_DEFINES_H_INCLUDED
+
+#define _MSC_VER  1900
+#define _CPPUNWIND
+
+#define __int64 long long
+
+// __declspec(align(n)) is the only declspec used by the platform independent modules
+#define __declspec( spec ) __declspec_##spec
+#define __declspec_align( a ) __attribute__((aligned(a)))
+
+// Calling convention used by expat when it sees a Microsoft compiler
+#define __cdecl
+
+#include <cstdlib>
+inline long long _abs64( long long x ) { return llabs( x ); }
+
+#endif // GEN_PLATFORM_DEFINES_H_INCLUDED
@@ -0,0 +1,21 @@
+/**************************************************************************************************
+	Module:       PlatformStubs.cpp
+
+	Console versions of the Windows utility functions in MSDefines.cpp, for the headless tests
+**************************************************************************************************/
+
+#include <cstdio>
+#include "Defines.h"
+
+namespace gen
+{
+
+// Message boxes are written to the console, a test never waits for a reply
+bool SystemMessageBox( const string& sMessage, const string& sTitle, const bool bYesNo )
+{
+	printf( "%s: %s\n", sTitle.c_str(), sMessage.c_str() );
+	return !bYesNo;
+}
+
+
+} // namespace gen
@@ -0,0 +1,110 @@
+/**************************************************************************************************
+	Module:       Windows.cpp
+
+	POSIX implementation of the Windows file calls declared in the stand-in windows.h. Handles
+	are heap records holding a file descriptor, a mapping handle holds a duplicate of its file's
+**************************************************************************************************/
+
+#include <fcntl.h>
+#include <map>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "windows.h"
+
+namespace
+{
+	struct SFileHandle
+	{
+		int fd;
+	};
+
+	// Size of each mapped view, munmap needs it
+	std::map<const void*, size_t> MappedViews;
+}
+
+HANDLE CreateFile( const char* fileName, DWORD, DWORD, void*, DWORD, DWORD, HANDLE )
+{
+	int fd = open( fileName, O_RDONLY );
+	if (fd < 0)
+	{
+		return INVALID_HANDLE_VALUE;
+	}
+	SFileHandle* file = new SFileHandle;
+	file->fd = fd;
+	return file;
+}
+
+BOOL GetFileSizeEx( HANDLE file, LARGE_INTEGER* size )
+{
+	struct stat fileStat;
+	if (fstat( static_cast<SFileHandle*>(file)->fd, &fileStat ))
+	{
+		return 0;
+	}
+	size->QuadPart = fileStat.st_size;
+	return 1;
+}
+
+HANDLE CreateFileMapping( HANDLE file, void*, DWORD, DWORD, DWORD, const char* )
+{
+	SFileHandle* mapping = new SFileHandle;
+	mapping->fd = dup( static_cast<SFileHandle*>(file)->fd );
+	return mapping;
+}
+
+void* MapViewOfFile( HANDLE mapping, DWORD, DWORD, DWORD, size_t )
+{
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx( mapping, &size ))
+	{
+		return 0;
+	}
+	void* view = mmap( 0, static_cast<size_t>(size.QuadPart), PROT_READ, MAP_PRIVATE,
+	                   static_cast<SFileHandle*>(mapping)->fd, 0 );
+	if (view == MAP_FAILED)
+	{
+		return 0;
+	}
+	MappedViews[view] = static_cast<size_t>(size.QuadPart);
+	return view;
+}
+
+BOOL UnmapViewOfFile( const void* view )
+{
+	std::map<const void*, size_t>::iterator mapped = MappedViews.find( view );
+	if (mapped == MappedViews.end())
+	{
+		return 0;
+	}
+	munmap( const_cast<void*>(view), mapped->second );
+	MappedViews.erase( mapped );
+	return 1;
+}
+
+BOOL CloseHandle( HANDLE handle )
+{
+	close( static_cast<SFileHandle*>(handle)->fd );
+	delete static_cast<SFileHandle*>(handle);
+	return 1;
+}
+
+// Write times are in 100ns units as on Windows (the epoch differs, which does not matter here)
+BOOL GetFileAttributesEx( const char* fileName, GET_FILEEX_INFO_LEVELS, void* info )
+{
+	struct stat fileStat;
+	if (stat( fileName, &fileStat ))
+	{
+		return 0;
+	}
+	WIN32_FILE_ATTRIBUTE_DATA* fileData = static_cast<WIN32_FILE_ATTRIBUTE_DATA*>(info);
+	unsigned long long size = static_cast<unsigned long long>(fileStat.st_size);
+	unsigned long long writeTime = static_cast<unsigned long long>(fileStat.st_mtim.tv_sec) * 10000000ull +
+	                               fileStat.st_mtim.tv_nsec / 100;
+	fileData->dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+	fileData->nFileSizeHigh = static_cast<DWORD>(size >> 32);
+	fileData->nFileSizeLow = static_cast<DWORD>(size & 0xffffffff);
+	fileData->ftLastWriteTime.dwHighDateTime = static_cast<DWORD>(writeTime >> 32);
+	fileData->ftLastWriteTime.dwLowDateTime = static_cast<DWORD>(writeTime & 0xffffffff);
+	return 1;
+}
@@ -0,0 +1 @@
+// Stand-in for the FMOD C header in the headless tests, everything needed is in fmod.hpp
@@ -0,0 +1,22 @@
+/**************************************************************************************************
+	Module:       fmod.hpp
+
+	Stand-in for the FMOD header in the headless tests. Declares the FMOD types named by
+	FMODManager.h so its sound enums can be used without the FMOD library
+**************************************************************************************************/
+
+#ifndef GEN_PLATFORM_FMOD_HPP_INCLUDED
+#define GEN_PLATFORM_FMOD_HPP_INCLUDED
+
+typedef int FMOD_RESULT;
+
+namespace FMOD
+{
+	class System;
+	class Sound;
+	class SoundGroup;
+	class Channel;
+	class ChannelGroup;
+}
+
+#endif // GEN_PLATFORM_FMOD_HPP_INCLUDED
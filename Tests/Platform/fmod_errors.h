@@ -0,0 +1 @@
+// Stand-in for the FMOD error header in the headless tests, nothing from it is used
@@ -0,0 +1,67 @@
+/**************************************************************************************************
+	Module:       windows.h
+
+	Stand-in for the Windows header in the headless tests. Declares only the file and memory
+	mapping calls used by CMappedFile, implemented over POSIX in Windows.cpp
+**************************************************************************************************/
+
+#ifndef GEN_PLATFORM_WINDOWS_H_INCLUDED
+#define GEN_PLATFORM_WINDOWS_H_INCLUDED
+
+#include <cstddef>
+
+typedef int           BOOL;
+typedef unsigned int  DWORD; // 32-bit as on Windows, unsigned long is 64-bit here
+typedef void*         HANDLE;
+
+typedef union
+{
+	struct
+	{
+		DWORD LowPart;
+		int   HighPart;
+	};
+	long long QuadPart;
+} LARGE_INTEGER;
+
+struct FILETIME
+{
+	DWORD dwLowDateTime;
+	DWORD dwHighDateTime;
+};
+
+struct WIN32_FILE_ATTRIBUTE_DATA
+{
+	DWORD    dwFileAttributes;
+	FILETIME ftCreationTime;
+	FILETIME ftLastAccessTime;
+	FILETIME ftLastWriteTime;
+	DWORD    nFileSizeHigh;
+	DWORD    nFileSizeLow;
+};
+
+enum GET_FILEEX_INFO_LEVELS
+{
+	GetFileExInfoStandard
+};
+
+#define GENERIC_READ          0x80000000
+#define FILE_SHARE_READ       0x00000001
+#define OPEN_EXISTING         3
+#define FILE_ATTRIBUTE_NORMAL 0x00000080
+#define PAGE_READONLY         0x02
+#define FILE_MAP_READ         0x0004
+#define INVALID_HANDLE_VALUE  ((HANDLE)(long long)-1)
+
+HANDLE CreateFile( const char* fileName, DWORD access, DWORD shareMode, void* security,
+                   DWORD creation, DWORD flags, HANDLE templateFile );
+BOOL   GetFileSizeEx( HANDLE file, LARGE_INTEGER* size );
+HANDLE CreateFileMapping( HANDLE file, void* security, DWORD protect, DWORD sizeHigh,
+                          DWORD sizeLow, const char* name );
+void*  MapViewOfFile( HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow,
+                      size_t numBytes );
+BOOL   UnmapViewOfFile( const void* view );
+BOOL   CloseHandle( HANDLE handle );
+BOOL   GetFileAttributesEx( const char* fileName, GET_FILEEX_INFO_LEVELS infoLevel, void* info );
+
+#endif // GEN_PLATFORM_WINDOWS_H_INCLUDED
@@ -0,0 +1,213 @@
+/*******************************************
+	TestFrameCache.cpp
+
+	Headless tests of the frame cache, using
+	the CPU frame loader in place of DirectX
+********************************************/
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "CFrameCache.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32 kFrameBytes = 1024;
+
+// CPU loader that also keeps its own reference counts, so leaked or early released frames show up
+class CCountingLoader : public CFrameLoaderCPU
+{
+public:
+	bool LoadFrame( const string& fileName, SFrame* frame )
+	{
+		if (!CFrameLoaderCPU::LoadFrame( fileName, frame ))
+		{
+			return false;
+		}
+		m_RefCounts[frame->handle] = 1;
+		return true;
+	}
+	void AddRefFrame( const SFrame& frame )
+	{
+		++m_RefCounts[frame.handle];
+		CFrameLoaderCPU::AddRefFrame( frame );
+	}
+	void ReleaseFrame( const SFrame& frame )
+	{
+		if (--m_RefCounts[frame.handle] == 0)
+		{
+			m_RefCounts.erase( frame.handle );
+		}
+		CFrameLoaderCPU::ReleaseFrame( frame );
+	}
+
+	TUInt32 LiveFrames()
+	{
+		return static_cast<TUInt32>(m_RefCounts.size());
+	}
+
+private:
+	map<void*, TUInt32> m_RefCounts;
+};
+
+// Write a frame file filled with a byte identifying it
+string FrameFile( const string& prefix, TUInt32 frame )
+{
+	ostringstream fileName;
+	fileName << prefix << frame << ".bin";
+	ofstream file( fileName.str().c_str(), ios::binary );
+	file << string( kFrameBytes, static_cast<char>('a' + frame % 26) );
+	return fileName.str();
+}
+
+bool IsFrame( const SFrame& frame, TUInt32 frameIndex )
+{
+	const vector<TUInt8>& data = CFrameLoaderCPU::FrameData( frame );
+	return data.size() == kFrameBytes && data[0] == static_cast<TUInt8>('a' + frameIndex % 26);
+}
+
+
+void TestHitsAndMisses()
+{
+	CCountingLoader loader;
+	{
+		CFrameCache cache( &loader );
+		string fileName = FrameFile( "hit", 0 );
+
+		SFrame first, second;
+		TEST_CHECK( cache.AcquireFrame( fileName, &first ) );
+		TEST_CHECK( cache.AcquireFrame( fileName, &second ) );
+		TEST_CHECK( first.handle == second.handle );
+		TEST_CHECK( IsFrame( first, 0 ) );
+		TEST_CHECK( cache.GetStats().misses == 1 && cache.GetStats().hits == 1 );
+		TEST_CHECK( cache.GetStats().residentFrames == 1 );
+		TEST_CHECK( cache.GetStats().residentBytes == kFrameBytes );
+		cache.ReleaseFrame( first );
+		cache.ReleaseFrame( second );
+
+		SFrame missing;
+		TEST_CHECK( !cache.AcquireFrame( "missing.bin", &missing ) );
+		TEST_CHECK( cache.GetStats().failedLoads == 1 );
+	}
+	TEST_CHECK( loader.LiveFrames() == 0 );
+}
+
+void TestLeastRecentlyUsedEviction()
+{
+	CCountingLoader loader;
+	CFrameCache cache( &loader, 3 * kFrameBytes );
+	string files[4];
+	for (TUInt32 i = 0; i < 4; ++i)
+	{
+		files[i] = FrameFile( "lru", i );
+	}
+
+	// Load 0, 1, 2 then use 0 again, so 1 is the least recently used when 3 arrives
+	SFrame frame;
+	for (TUInt32 i = 0; i < 3; ++i)
+	{
+		TEST_CHECK( cache.AcquireFrame( files[i], &frame ) );
+		cache.ReleaseFrame( frame );
+	}
+	TEST_CHECK( cache.AcquireFrame( files[0], &frame ) );
+	cache.ReleaseFrame( frame );
+	TEST_CHECK( cache.AcquireFrame( files[3], &frame ) );
+	cache.ReleaseFrame( frame );
+	TEST_CHECK( cache.GetStats().evictions == 1 );
+	TEST_CHECK( cache.GetStats().residentBytes == 3 * kFrameBytes );
+	TEST_CHECK( loader.LiveFrames() == 3 );
+
+	cache.ResetStats();
+	TEST_CHECK( cache.AcquireFrame( files[0], &frame ) );
+	cache.ReleaseFrame( frame );
+	TEST_CHECK( cache.AcquireFrame( files[1], &frame ) );
+	cache.ReleaseFrame( frame );
+	TEST_CHECK( cache.GetStats().hits == 1 && cache.GetStats().misses == 1 );
+
+	// Shrinking the budget evicts at once but never drops the most recent frame
+	cache.SetBudget( 0 );
+	TEST_CHECK( cache.GetStats().residentFrames == 1 );
+	cache.Clear();
+	TEST_CHECK( loader.LiveFrames() == 0 );
+}
+
+void TestReferenceOutlivesEviction()
+{
+	CCountingLoader loader;
+	CFrameCache cache( &loader, kFrameBytes );
+	string onScreen = FrameFile( "held", 0 );
+	string next = FrameFile( "held", 1 );
+
+	// A frame still on screen is evicted from the cache but must stay valid until released
+	SFrame held, frame;
+	TEST_CHECK( cache.AcquireFrame( onScreen, &held ) );
+	TEST_CHECK( cache.AcquireFrame( next, &frame ) );
+	TEST_CHECK( cache.GetStats().evictions == 1 );
+	TEST_CHECK( IsFrame( held, 0 ) );
+	TEST_CHECK( loader.LiveFrames() == 2 );
+	cache.ReleaseFrame( held );
+	TEST_CHECK( loader.LiveFrames() == 1 );
+	cache.ReleaseFrame( frame );
+	cache.Clear();
+	TEST_CHECK( loader.LiveFrames() == 0 );
+}
+
+// The intro video streams its frames through a cache of its own, sharing the loader. However
+// many video frames pass through, the character frames must stay resident
+void TestVideoCacheIsolation()
+{
+	const TUInt32 kCharacterFrames = 8;
+	const TUInt32 kVideoFrames = 66;
+
+	CCountingLoader loader;
+	CFrameCache frameCache( &loader, kCharacterFrames * kFrameBytes );
+	CFrameCache videoFrameCache( &loader, 4 * kFrameBytes );
+
+	string characterFiles[kCharacterFrames];
+	SFrame frame;
+	for (TUInt32 i = 0; i < kCharacterFrames; ++i)
+	{
+		characterFiles[i] = FrameFile( "character", i );
+		TEST_CHECK( frameCache.AcquireFrame( characterFiles[i], &frame ) );
+		frameCache.ReleaseFrame( frame );
+	}
+	for (TUInt32 loop = 0; loop < 2; ++loop)
+	{
+		for (TUInt32 i = 0; i < kVideoFrames; ++i)
+		{
+			TEST_CHECK( videoFrameCache.AcquireFrame( FrameFile( "video", i ), &frame ) );
+			TEST_CHECK( IsFrame( frame, i ) );
+			videoFrameCache.ReleaseFrame( frame );
+		}
+	}
+	TEST_CHECK( videoFrameCache.GetStats().residentBytes <= 4 * kFrameBytes );
+
+	frameCache.ResetStats();
+	for (TUInt32 i = 0; i < kCharacterFrames; ++i)
+	{
+		TEST_CHECK( frameCache.AcquireFrame( characterFiles[i], &frame ) );
+		frameCache.ReleaseFrame( frame );
+	}
+	TEST_CHECK( frameCache.GetStats().hits == kCharacterFrames );
+	TEST_CHECK( frameCache.GetStats().evictions == 0 );
+
+	frameCache.Clear();
+	videoFrameCache.Clear();
+	TEST_CHECK( loader.LiveFrames() == 0 );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( TestHitsAndMisses );
+	TEST_RUN( TestLeastRecentlyUsedEviction );
+	TEST_RUN( TestReferenceOutlivesEviction );
+	TEST_RUN( TestVideoCacheIsolation );
+	return TestResult( "TestFrameCache" );
+}
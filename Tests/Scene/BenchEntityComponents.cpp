@@ -0,0 +1,133 @@
+/*******************************************
+	BenchEntityComponents.cpp
+
+	Kinematics update over the entity component
+	arrays against the same update over entity
+	objects each holding their own state, as
+	entities were before
+********************************************/
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include "CEntityComponents.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32  kNumUpdates = 200;
+const TFloat32 kStep = 1.0f / 60.0f;
+
+// Stand-in for an entity holding its own state among everything else it holds - name, node
+// matrices and the rest - allocated one at a time
+class CEntityObject
+{
+public:
+	CEntityObject() : x( 0.0f ), y( 20.0f ), groundLevel( 10.0f ), gravity( 2.5f ), gravityScale( 2.0f ),
+	                  upwardVel( 0.0f ), horizontalVel( 0.0f ), flags( Kinematic_Simulated | Kinematic_InAir ) {}
+	virtual ~CEntityObject() {}
+
+	virtual void UpdateKinematics( TFloat32 step, TFloat32 timeStopScale )
+	{
+		if (!(flags & Kinematic_Simulated))
+		{
+			return;
+		}
+		x += horizontalVel;
+		y += upwardVel;
+		if (flags & Kinematic_InAir)
+		{
+			TFloat32 timeScale = (flags & Kinematic_TimeUnaffected) ? 1.0f : timeStopScale;
+			upwardVel -= gravity * gravityScale * timeScale * step;
+			if (y < groundLevel)
+			{
+				y = groundLevel;
+				upwardVel = 0.0f;
+				flags = (flags & ~Kinematic_InAir) | Kinematic_Landed;
+			}
+		}
+	}
+
+	string   name;
+	TFloat32 matrices[4][16];
+	char     otherState[512];
+
+	TFloat32 x, y;
+	TFloat32 groundLevel, gravity, gravityScale;
+	TFloat32 upwardVel, horizontalVel;
+	TUInt32  flags;
+};
+
+TFloat64 MicrosecondsPerUpdate( chrono::steady_clock::time_point start )
+{
+	chrono::duration<TFloat64, micro> microseconds = chrono::steady_clock::now() - start;
+	return microseconds.count() / kNumUpdates;
+}
+
+// Entities thrown upwards at different speeds so they land on different updates
+TFloat32 StartVel( TUInt32 entity )
+{
+	return (entity % 7) * 0.5f;
+}
+
+void RunSize( TUInt32 numEntities )
+{
+	vector< unique_ptr<CEntityObject> > objects;
+	for (TUInt32 entity = 0; entity < numEntities; ++entity)
+	{
+		objects.emplace_back( new CEntityObject );
+		objects.back()->upwardVel = StartVel( entity );
+	}
+	CEntityComponents components;
+	components.Reserve( numEntities );
+	for (TUInt32 entity = 0; entity < numEntities; ++entity)
+	{
+		components.Add();
+		components.posY[entity] = 20.0f;
+		components.upwardVel[entity] = StartVel( entity );
+		components.flags[entity] = Kinematic_Simulated | Kinematic_InAir;
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 update = 0; update < kNumUpdates; ++update)
+	{
+		for (TUInt32 entity = 0; entity < numEntities; ++entity)
+		{
+			objects[entity]->UpdateKinematics( kStep, 1.0f );
+		}
+	}
+	TFloat64 objectTime = MicrosecondsPerUpdate( start );
+
+	start = chrono::steady_clock::now();
+	for (TUInt32 update = 0; update < kNumUpdates; ++update)
+	{
+		components.UpdateKinematics( kStep, 1.0f );
+	}
+	TFloat64 componentTime = MicrosecondsPerUpdate( start );
+
+	// Both must have simulated the same thing
+	TUInt32 numDifferent = 0;
+	for (TUInt32 entity = 0; entity < numEntities; ++entity)
+	{
+		numDifferent += objects[entity]->y != components.posY[entity] ||
+		                objects[entity]->flags != components.flags[entity];
+	}
+	TEST_CHECK( numDifferent == 0 );
+
+	printf( "  %7u entities  objects %8.1f us/update  components %8.1f us/update  (%.1fx)\n",
+	        numEntities, objectTime, componentTime, objectTime / componentTime );
+}
+
+} // namespace
+
+
+int main()
+{
+	RunSize( 1000 );
+	RunSize( 10000 );
+	RunSize( 100000 );
+	return TestResult( "BenchEntityComponents" );
+}
@@ -0,0 +1,71 @@
+/*******************************************
+	BenchKinematics.cpp
+
+	Throughput of the fixed step kinematics
+	over the entity component arrays, with half
+	the bodies launched again every 30 steps
+********************************************/
+
+#include <chrono>
+#include "CEntityComponents.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TFloat32 kStep = 1.0f / 60.0f;
+const TUInt32  kBodySteps = 6000000; // Steps run for each size are about this over the size
+
+void RunSize( TUInt32 numBodies )
+{
+	CEntityComponents components;
+	components.Reserve( numBodies );
+	vector<SKinematicImpulse> impulses;
+	for (TUInt32 body = 0; body < numBodies; ++body)
+	{
+		components.Add();
+		components.posX[body] = static_cast<TFloat32>(body);
+		components.posY[body] = 10.0f + body % 7;
+		SKinematicImpulse impulse = { body, 1.0f + (body % 13) * 0.25f, (body % 5) - 2.0f };
+		impulses.push_back( impulse );
+	}
+	components.ApplyImpulses( &impulses[0], numBodies );
+
+	TUInt32 numSteps = kBodySteps / numBodies + 60;
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (TUInt32 step = 0; step < numSteps; ++step)
+	{
+		components.UpdateKinematics( kStep, 1.0f );
+		if (step % 30 == 0)
+		{
+			components.ApplyImpulses( &impulses[0], numBodies / 2 );
+		}
+	}
+	chrono::duration<TFloat64> seconds = chrono::steady_clock::now() - start;
+
+	// Every body is still above the ground
+	TUInt32 numBelow = 0;
+	for (TUInt32 body = 0; body < numBodies; ++body)
+	{
+		numBelow += components.posY[body] < components.groundLevel[body];
+	}
+	TEST_CHECK( numBelow == 0 );
+
+	printf( "  %7u bodies  %6u steps  %6.1fM body-steps/s  %9.2f us/step\n", numBodies, numSteps,
+	        numBodies * static_cast<TFloat64>(numSteps) / seconds.count() / 1e6,
+	        seconds.count() / numSteps * 1e6 );
+}
+
+} // namespace
+
+
+int main()
+{
+	RunSize( 64 );
+	RunSize( 1024 );
+	RunSize( 16384 );
+	RunSize( 262144 );
+	return TestResult( "BenchKinematics" );
+}
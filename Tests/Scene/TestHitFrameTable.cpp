@@ -0,0 +1,245 @@
+/*******************************************
+	TestHitFrameTable.cpp
+
+	Tests of the hit frame bitmasks, replaying
+	every attack sequence of both characters
+	against the frame lists they replaced
+********************************************/
+
+#include "CHitFrameTable.h"
+#include "AnimationManager.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TUInt32 kReplayFrames = MaxHitFrames + 16;
+
+// The hit frames as they were kept before the bitmasks - a list of frames for each sequence of the
+// attack range, in the same order as the old setHitFrames
+typedef pair< int, vector<int> > SOldHitFrames;
+
+void OldHitFrames( bool isPlayerJotaro, int numOraFrames, vector<SOldHitFrames>* hitFrames,
+                   int* playerAttackAnimsMax )
+{
+	*playerAttackAnimsMax = isPlayerJotaro ? AttackAnimsPlayerFinish : Ult_Num_1;
+	for (int i = AttackAnimsPlayerStart; i <= *playerAttackAnimsMax; i++)
+	{
+		hitFrames->push_back( SOldHitFrames( i, vector<int>() ) );
+		vector<int>& frames = hitFrames->back().second;
+		if (isPlayerJotaro)
+		{
+			switch (i)
+			{
+			case Light_Leg_Att:       frames.push_back( 2 ); break;
+			case Light_Crouch_Att:    frames.push_back( 6 ); break;
+			case Medium_Att:          frames.push_back( 4 ); break;
+			case Medium_Walk_Att:     frames.push_back( 4 ); break;
+			case Medium_Crouch_Att:   frames.push_back( 3 ); break;
+			case Medium_Air_Att:      frames.push_back( 2 ); break;
+			case Heavy_Att:           frames.push_back( 4 ); break;
+			case Heavy_Walk_Att:      frames.push_back( 6 ); break;
+			case Heavy_Crouch_Att:    frames.push_back( 5 ); break;
+			case Heavy_Crouch_Fr_Att: frames.push_back( 6 ); break;
+			case Heavy_Air_Att:       frames.push_back( 4 ); break;
+			case Throw:               frames.push_back( 6 ); frames.push_back( 16 ); break;
+			case Stando_OraOraOra:
+				for (int frame = 3; frame <= 15; frame += 3) frames.push_back( frame );
+				break;
+			case Stando_Sp_2:         frames.push_back( 8 ); break;
+			case Stando_Sp_3:         frames.push_back( 4 ); frames.push_back( 8 ); break;
+			case Stando_Sp_4:         frames.push_back( 12 ); break;
+			case Stando_Ult_1:
+				for (int frame = 5; frame < 105; frame += 2) frames.push_back( frame );
+				break;
+			}
+		}
+		else
+		{
+			switch (i)
+			{
+			case Light_Leg_Att:       frames.push_back( 1 ); break;
+			case Light_Crouch_Att:    frames.push_back( 1 ); break;
+			case Medium_Att:          frames.push_back( 3 ); frames.push_back( 6 ); break;
+			case Medium_Walk_Att:     frames.push_back( 3 ); frames.push_back( 6 ); break;
+			case Medium_Crouch_Att:   frames.push_back( 4 ); break;
+			case Medium_Air_Att:      frames.push_back( 2 ); break;
+			case Heavy_Att:           frames.push_back( 2 ); break;
+			case Heavy_Walk_Att:      frames.push_back( 3 ); break;
+			case Heavy_Crouch_Att:    frames.push_back( 4 ); break;
+			case Heavy_Air_Att:       frames.push_back( 4 ); break;
+			case Throw:               frames.push_back( 6 ); frames.push_back( 14 ); break;
+			case Stando_OraOraOra:
+				for (int frame = 1; frame < numOraFrames; frame += 3) frames.push_back( frame );
+				break;
+			case Special_Num_4:
+				frames.push_back( 14 ); frames.push_back( 16 ); frames.push_back( 20 ); frames.push_back( 30 );
+				break;
+			case Stando_Sp_3:         frames.push_back( 4 ); frames.push_back( 8 ); break;
+			case Stando_Sp_4:         frames.push_back( 12 ); break;
+			case Ult_Num_1:
+				frames.push_back( 1 ); frames.push_back( 2 );
+				for (int frame = 12; frame < 130; frame += 5) frames.push_back( frame );
+				break;
+			}
+		}
+	}
+}
+
+// Number of hit messages the old scan in Animate sent for a frame of the player's sequence
+int OldAnimateHits( const vector<SOldHitFrames>& hitFrames, int playerAttackAnimsMax, int sequence, int frame )
+{
+	int hits = 0;
+	for (int i = 0; i <= (playerAttackAnimsMax - AttackAnimsPlayerStart); i++)
+	{
+		if (i == sequence - AttackAnimsPlayerStart)
+		{
+			for (size_t j = 0; j < hitFrames[i].second.size(); j++)
+			{
+				if (hitFrames[i].second[j] == frame)
+				{
+					++hits;
+				}
+			}
+		}
+	}
+	return hits;
+}
+
+// Number of hit messages the old scan in the stand updates sent for a frame of the stand's sequence
+int OldStandoHits( const vector<SOldHitFrames>& hitFrames, int sequence, int frame )
+{
+	int hits = 0;
+	for (int i = 0; i <= (AttackAnimsPlayerFinish - AttackAnimsPlayerStart); i++)
+	{
+		if (i == sequence - AttackAnimsPlayerStart)
+		{
+			for (size_t j = 0; j < hitFrames[i].second.size(); j++)
+			{
+				if (hitFrames[i].second[j] == frame)
+				{
+					++hits;
+				}
+			}
+		}
+	}
+	return hits;
+}
+
+// Flags the old HitMessageComposer derived from the frame number
+TUInt32 OldHitFlags( bool isPlayerJotaro, int sequence, int frame )
+{
+	if (sequence == Throw && frame == (isPlayerJotaro ? 16 : 14))
+	{
+		return HitFrame_Finisher;
+	}
+	if (!isPlayerJotaro && sequence == Ult_Num_1 && (frame == 1 || frame == 2))
+	{
+		return HitFrame_Launcher;
+	}
+	return 0;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Tests
+-----------------------------------------------------------------------------------------*/
+
+// Every frame of every sequence of both characters sends the same hits through the table as through
+// the old lists, from the player's sequence and from the stand's
+void ReplayAllSequences()
+{
+	const int oraFrameCounts[] = { 0, 1, 29, 33, MaxHitFrames };
+	for (int character = 0; character < 2; ++character)
+	{
+		for (size_t ora = 0; ora < sizeof(oraFrameCounts) / sizeof(oraFrameCounts[0]); ++ora)
+		{
+			bool isPlayerJotaro = character == 0;
+			vector<SOldHitFrames> oldFrames;
+			int playerAttackAnimsMax;
+			OldHitFrames( isPlayerJotaro, oraFrameCounts[ora], &oldFrames, &playerAttackAnimsMax );
+
+			CHitFrameTable table( PlayerAnimationTypes );
+			SetPlayerHitFrames( &table, isPlayerJotaro, oraFrameCounts[ora] );
+
+			int numHits = 0;
+			for (int sequence = 0; sequence < PlayerAnimationTypes; ++sequence)
+			{
+				for (TUInt32 frame = 0; frame < kReplayFrames; ++frame)
+				{
+					int oldHits = OldAnimateHits( oldFrames, playerAttackAnimsMax, sequence, frame );
+					TEST_CHECK( oldHits <= 1 );
+					TEST_CHECK( table.IsHitFrame( sequence, frame ) == (oldHits == 1) );
+
+					int oldStandoHits = OldStandoHits( oldFrames, sequence, frame );
+					bool standoHit = sequence <= AttackAnimsPlayerFinish && table.IsHitFrame( sequence, frame );
+					TEST_CHECK( standoHit == (oldStandoHits == 1) );
+
+					const SHitFrame* hit = table.GetHitFrame( sequence, frame );
+					TEST_CHECK( (hit != 0) == (oldHits == 1) );
+					if (hit)
+					{
+						TEST_CHECK( hit->frame == frame );
+						TEST_CHECK( hit->flags == OldHitFlags( isPlayerJotaro, sequence, frame ) );
+					}
+					numHits += oldHits;
+				}
+			}
+			TEST_CHECK( numHits > 30 );
+		}
+	}
+}
+
+// Hit data is found by its frame wherever it was added, and adding a frame twice replaces its flags
+void HitDataInFrameOrder()
+{
+	CHitFrameTable table( 4 );
+	const TUInt32 frames[] = { 200, 3, 64, 63, 0, 128, 255 };
+	for (TUInt32 i = 0; i < sizeof(frames) / sizeof(frames[0]); ++i)
+	{
+		table.AddHitFrame( 2, frames[i], i );
+	}
+	TEST_CHECK( table.GetNumHitFrames( 2 ) == 7 );
+	for (TUInt32 i = 0; i < sizeof(frames) / sizeof(frames[0]); ++i)
+	{
+		const SHitFrame* hit = table.GetHitFrame( 2, frames[i] );
+		TEST_CHECK( hit && hit->frame == frames[i] && hit->flags == i );
+	}
+
+	table.AddHitFrame( 2, 64, HitFrame_Launcher );
+	TEST_CHECK( table.GetNumHitFrames( 2 ) == 7 );
+	TEST_CHECK( table.GetHitFrame( 2, 64 )->flags == HitFrame_Launcher );
+	TEST_CHECK( table.GetHitFrame( 2, 63 )->flags == 3 );
+
+	TEST_CHECK( !table.IsHitFrame( 1, 3 ) && !table.IsHitFrame( 3, 3 ) );
+	TEST_CHECK( !table.IsHitFrame( 2, 65 ) && table.GetHitFrame( 2, 65 ) == 0 );
+}
+
+// Frames and sequences out of range are ignored when added and never hit
+void OutOfRange()
+{
+	CHitFrameTable table( 2 );
+	table.AddHitFrame( 2, 1 );
+	table.AddHitFrame( 0, MaxHitFrames );
+	TEST_CHECK( table.GetNumHitFrames( 0 ) == 0 && table.GetNumHitFrames( 2 ) == 0 );
+	TEST_CHECK( !table.IsHitFrame( 2, 1 ) && !table.IsHitFrame( 0, MaxHitFrames ) );
+	TEST_CHECK( !table.IsHitFrame( ~0u, 0 ) && !table.IsHitFrame( 0, ~0u ) );
+
+	table.AddHitFrame( 1, MaxHitFrames - 1 );
+	TEST_CHECK( table.IsHitFrame( 1, MaxHitFrames - 1 ) );
+	table.Clear();
+	TEST_CHECK( !table.IsHitFrame( 1, MaxHitFrames - 1 ) && table.GetNumHitFrames( 1 ) == 0 );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( ReplayAllSequences );
+	TEST_RUN( HitDataInFrameOrder );
+	TEST_RUN( OutOfRange );
+	return TestResult( "TestHitFrameTable" );
+}
@@ -0,0 +1,182 @@
+/*******************************************
+	TestKinematics.cpp
+
+	Tests of the fixed step kinematics over the
+	entity component arrays: runs repeat exactly,
+	and players jump, fall in stopped time and
+	are knocked up as they did when they moved
+	themselves each update
+********************************************/
+
+#include <cmath>
+#include <cstring>
+#include "CEntityComponents.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+const TFloat32 kStep = 1.0f / 60.0f;
+const TFloat32 kGravity = 2.5f;
+const TFloat32 kGroundLevel = 10.0f;
+
+// Scales passed by CEntityManager::UpdateComponents and set by CPlayerEntity::f_physGravity
+const TFloat32 kTimeStopScale = 15.0f / 16.0f;
+const TFloat32 kPlayerScale = 2.0f;
+const TFloat32 kKnockedUpScale = 6.0f;
+
+// Path of a body in the air, one height per step until it lands
+typedef vector<TFloat32> TPath;
+
+TPath SimulatedPath( TFloat32 upwardVel, TFloat32 gravityScale, TFloat32 timeStopScale )
+{
+	CEntityComponents components;
+	components.Add();
+	components.posY[0] = kGroundLevel;
+	components.groundLevel[0] = kGroundLevel;
+	components.gravity[0] = kGravity;
+	components.gravityScale[0] = gravityScale;
+	SKinematicImpulse launch = { 0, upwardVel, 0.0f };
+	components.ApplyImpulses( &launch, 1 );
+
+	TPath path;
+	while (!(components.flags[0] & Kinematic_Landed) && path.size() < 1000)
+	{
+		components.UpdateKinematics( kStep, timeStopScale );
+		path.push_back( components.posY[0] );
+	}
+	return path;
+}
+
+// The old CPlayerEntity::f_physGravity, called with the player's update time
+bool OldGravity( TFloat32& y, TFloat32& upwardVel, TFloat32 updateTime, TFloat32 scaling )
+{
+	y += upwardVel;
+	upwardVel -= kGravity * updateTime * scaling;
+	if (y < kGroundLevel)
+	{
+		y = kGroundLevel;
+		upwardVel = 0.0f;
+		return true;
+	}
+	return false;
+}
+
+bool SamePath( const TPath& path, const TPath& oldPath, TFloat32 tolerance )
+{
+	if (path.size() + 1 < oldPath.size() || path.size() > oldPath.size() + 1)
+	{
+		return false;
+	}
+	for (TUInt32 i = 0; i < path.size() && i < oldPath.size(); ++i)
+	{
+		if (fabs( path[i] - oldPath[i] ) > tolerance)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Tests
+-----------------------------------------------------------------------------------------*/
+
+// Two runs of many bodies with impulses part way through end bit for bit the same
+void Deterministic()
+{
+	const TUInt32 kNumBodies = 5000, kNumSteps = 600;
+	CEntityComponents runs[2];
+	for (TUInt32 run = 0; run < 2; ++run)
+	{
+		CEntityComponents& components = runs[run];
+		vector<SKinematicImpulse> impulses;
+		for (TUInt32 body = 0; body < kNumBodies; ++body)
+		{
+			components.Add();
+			components.posX[body] = static_cast<TFloat32>(body);
+			components.posY[body] = kGroundLevel + body % 7;
+			SKinematicImpulse impulse = { body, 1.0f + (body % 13) * 0.25f, (body % 5) - 2.0f };
+			impulses.push_back( impulse );
+		}
+		components.ApplyImpulses( &impulses[0], kNumBodies );
+		for (TUInt32 step = 0; step < kNumSteps; ++step)
+		{
+			components.UpdateKinematics( kStep, step < kNumSteps / 2 ? 1.0f : kTimeStopScale );
+			if (step % 30 == 0)
+			{
+				components.ApplyImpulses( &impulses[0], kNumBodies / 2 );
+			}
+		}
+	}
+
+	const TUInt32 bytes = kNumBodies * sizeof(TFloat32);
+	TEST_CHECK( memcmp( &runs[0].posX[0], &runs[1].posX[0], bytes ) == 0 );
+	TEST_CHECK( memcmp( &runs[0].posY[0], &runs[1].posY[0], bytes ) == 0 );
+	TEST_CHECK( memcmp( &runs[0].upwardVel[0], &runs[1].upwardVel[0], bytes ) == 0 );
+	TEST_CHECK( memcmp( &runs[0].flags[0], &runs[1].flags[0], kNumBodies * sizeof(TUInt32) ) == 0 );
+}
+
+// A jump follows the path it did at 60 updates a second, at normal speed and slowed by time stop,
+// where the update time was divided by 8 and the gravity scaled by 15 rather than 2
+void Jump()
+{
+	const TFloat32 kJumpVel = 2.0f, kSlowedJumpVel = 0.4f;
+	TPath oldPath, oldSlowedPath;
+	TFloat32 y = kGroundLevel, upwardVel = kJumpVel;
+	while (!OldGravity( y, upwardVel, kStep, 2.0f ))
+	{
+		oldPath.push_back( y );
+	}
+	oldPath.push_back( y );
+	y = kGroundLevel, upwardVel = kSlowedJumpVel;
+	while (!OldGravity( y, upwardVel, kStep / 8.0f, 15.0f ))
+	{
+		oldSlowedPath.push_back( y );
+	}
+	oldSlowedPath.push_back( y );
+
+	TEST_CHECK( SamePath( SimulatedPath( kJumpVel, kPlayerScale, 1.0f ), oldPath, 0.001f ) );
+	TEST_CHECK( SamePath( SimulatedPath( kSlowedJumpVel, kPlayerScale, kTimeStopScale ), oldSlowedPath, 0.001f ) );
+}
+
+// A knocked up player used to fall with half an update of gravity in its controls and a full one
+// in the hit sequence, each moving it by its velocity, and also drifted up by a third of the
+// knock up velocity each update until it landed. Launched at that drift with 6 times gravity it
+// lands on the same update, having drifted apart by at most one update of gravity per update
+void KnockUp()
+{
+	const TFloat32 kKnockUpVel = 10.0f;
+	const TFloat32 drift = kKnockUpVel * 0.33f;
+	TPath oldPath;
+	TFloat32 y = kGroundLevel, upwardVel = 0.0f;
+	bool landed = false;
+	while (!landed && oldPath.size() < 1000)
+	{
+		landed = OldGravity( y, upwardVel, kStep / 2.0f, 2.0f );
+		if (!landed)
+		{
+			y += drift;
+			landed = OldGravity( y, upwardVel, kStep, 2.0f );
+		}
+		oldPath.push_back( y );
+	}
+
+	TPath path = SimulatedPath( drift, kKnockedUpScale, 1.0f );
+	TEST_CHECK( oldPath.size() > 10 && path.size() == oldPath.size() );
+	TEST_CHECK( SamePath( path, oldPath, kGravity * kStep * oldPath.size() ) );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( Deterministic );
+	TEST_RUN( Jump );
+	TEST_RUN( KnockUp );
+	return TestResult( "TestKinematics" );
+}
@@ -0,0 +1,116 @@
+/*******************************************
+	TestKnivesThrow.cpp
+
+	Tests that Dio's knives throw spawns one
+	projectile per throw at any frame rate,
+	though the throwing frame is shown for
+	several updates
+********************************************/
+
+#include "CProjectilePool.h"
+#include "TestCheck.h"
+
+using namespace gen;
+
+namespace
+{
+
+// Timing of the throw sequence in CPlayerEntity::SwitchAnimStateDio: the animation timer goes up
+// by the update time times AnimMultSlow, and the frame changes when it reaches animCycleDelay
+const TFloat32 kAnimMultSlow = 75.0f;
+const TFloat32 kAnimCycleDelay = 10.5f;
+const TUInt32  kThrowFrame = 14;
+const TUInt32  kNumFrames = 16;
+
+// Mirror of the player state used by the throw
+struct SThrower
+{
+	TUInt32  currentAnim;
+	TFloat32 animChangeTimer;
+	bool     knivesThrown;
+};
+
+void SpawnKnives( CProjectilePool& pool )
+{
+	SProjectileDesc knives = { 1, 0, 0.0f, 0.0f, 0.0f, 5.0f, 0.0f, 8.0f, 3.0f, 4.0f, 65, 0, 0 };
+	pool.Spawn( knives );
+}
+
+// One update of the throw as SwitchAnimStateDio runs it: the sequence switch, then the frame
+// advance. The ungated version is the throw before knivesThrown, spawning on every update the
+// throwing frame is shown
+void UpdateThrow( SThrower& thrower, CProjectilePool& pool, TFloat32 updateTime, bool gated )
+{
+	if (!gated)
+	{
+		if (thrower.currentAnim == kThrowFrame)
+		{
+			SpawnKnives( pool );
+		}
+	}
+	else if (thrower.currentAnim != kThrowFrame)
+	{
+		thrower.knivesThrown = false;
+	}
+	else if (!thrower.knivesThrown)
+	{
+		thrower.knivesThrown = true;
+		SpawnKnives( pool );
+	}
+
+	if (thrower.animChangeTimer >= kAnimCycleDelay)
+	{
+		thrower.currentAnim = (thrower.currentAnim + 1) % kNumFrames;
+		thrower.animChangeTimer = 0.0f;
+	}
+	thrower.animChangeTimer += updateTime * kAnimMultSlow;
+}
+
+// Number of projectiles spawned by the given number of throws, one straight after another
+TUInt32 NumSpawned( TUInt32 numThrows, TFloat32 updatesPerSecond, bool gated )
+{
+	CProjectilePool pool( 256 );
+	SThrower thrower = { 0, 0.0f, false };
+	TUInt32 numFramesShown = 0;
+	while (numFramesShown < numThrows * kNumFrames)
+	{
+		TUInt32 frame = thrower.currentAnim;
+		UpdateThrow( thrower, pool, 1.0f / updatesPerSecond, gated );
+		numFramesShown += thrower.currentAnim != frame;
+	}
+	return pool.GetNumProjectiles();
+}
+
+
+/*-----------------------------------------------------------------------------------------
+	Tests
+-----------------------------------------------------------------------------------------*/
+
+// One projectile per throw however many updates the throwing frame is shown for
+void OneKnifePerThrow()
+{
+	const TFloat32 frameRates[] = { 30.0f, 60.0f, 144.0f };
+	for (TUInt32 rate = 0; rate < 3; ++rate)
+	{
+		TEST_CHECK( NumSpawned( 1, frameRates[rate], true ) == 1 );
+		TEST_CHECK( NumSpawned( 3, frameRates[rate], true ) == 3 );
+	}
+}
+
+// Without the gate a throw spawned a projectile on every update of the throwing frame, more the
+// higher the frame rate
+void UngatedThrowRepeats()
+{
+	TUInt32 at30 = NumSpawned( 1, 30.0f, false ), at144 = NumSpawned( 1, 144.0f, false );
+	TEST_CHECK( at30 > 1 && at144 > at30 );
+}
+
+} // namespace
+
+
+int main()
+{
+	TEST_RUN( OneKnifePerThrow );
+	TEST_RUN( UngatedThrowRepeats );
+	return TestResult( "TestKnivesThrow" );
+}
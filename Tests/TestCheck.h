@@ -0,0 +1,49 @@
+/**************************************************************************************************
+	Module:       TestCheck.h
+
+	Minimal checks for the headless tests. Each test is a separate program that reports failed
+	checks on the console and returns the failure count as its exit code
+**************************************************************************************************/
+
+#ifndef GEN_TEST_CHECK_H_INCLUDED
+#define GEN_TEST_CHECK_H_INCLUDED
+
+#include <cstdio>
+
+namespace gen
+{
+
+// Number of failed checks in this program
+inline int& TestFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+// Check a condition, reporting the expression and location if it is false
+#define TEST_CHECK( bCondition )\
+	if (!(bCondition)) { printf( "%s(%d): check failed: %s\n", __FILE__, __LINE__, #bCondition );\
+	                     ++gen::TestFailures(); }
+
+// Run one test function, named on the console
+#define TEST_RUN( testFunction )\
+	{ printf( "  %s\n", #testFunction ); testFunction(); }
+
+// Result for main - reports the totals and returns non-zero if any check failed
+inline int TestResult( const char* testName )
+{
+	if (TestFailures())
+	{
+		printf( "%s: %d check(s) FAILED\n", testName, TestFailures() );
+	}
+	else
+	{
+		printf( "%s: passed\n", testName );
+	}
+	return TestFailures();
+}
+
+
+} // namespace gen
+
+#endif // GEN_TEST_CHECK_H_INCLUDED